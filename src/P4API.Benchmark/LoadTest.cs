@@ -0,0 +1,617 @@
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Globalization;
+using System.Threading;
+
+namespace P4API.Benchmark
+{
+
+    /// <summary>
+    /// Runs a mix of commands from many connections at once and reports throughput, errors,
+    /// latency percentiles and GC pauses.
+    /// </summary>
+    /// <remarks>
+    /// Usage: P4API.Benchmark /load [options]
+    ///   /port: /user: /client: /password: /charset:
+    ///                     target server, defaults come from the Perforce environment
+    ///   /replay:session   replay a recorded session on every connection instead of using a server;
+    ///                     the session's commands are the mix
+    ///   /threads:N        connections, one thread each (default 8)
+    ///   /duration:S       measured seconds (default 30), after /warmup:S (default 5)
+    ///   /rate:R           open loop: R commands per second spread over all threads.  Without it
+    ///                     each thread sends its next command when the last one is done (closed loop)
+    ///   /think:MS         closed loop pause after each command
+    ///   /expected:MS      closed loop interval used to correct for coordinated omission
+    ///                     (default: think time plus the median latency)
+    ///   /mix:fstat=40,changes=20,print=20,describe=20
+    ///                     other command names are run with /path as their only argument
+    ///   /path:P           depot path the commands work on (default //depot/...)
+    ///
+    /// Open loop latencies are measured from when the command was due, not when it was sent, so a
+    /// stalled connection is charged for the commands queued behind it.  Closed loop latencies are
+    /// corrected after the run with P4Histogram.CopyCorrectedForCoordinatedOmission.
+    /// </remarks>
+    internal sealed class LoadTest
+    {
+
+        private string _port;
+        private string _user;
+        private string _client;
+        private string _password;
+        private string _charset;
+        private string _replay;
+        private int _threads = 8;
+        private double _duration = 30;
+        private double _warmup = 5;
+        private double _rate = 0;
+        private int _think = 0;
+        private double _expected = 0;
+        private string _path = "//depot/...";
+        private List<string> _mixNames = new List<string>();
+        private List<int> _mixWeights = new List<int>();
+        private int _mixTotal;
+
+        // picked from before the run starts
+        private string[] _files = new string[0];
+        private string[] _changes = new string[0];
+
+        private long _start;
+        private long _measureFrom;
+        private long _stopAt;
+        private readonly ManualResetEvent _go = new ManualResetEvent(false);
+
+
+        /// <summary>
+        /// Runs the load test described by the command line.
+        /// </summary>
+        public static int Run(string[] args)
+        {
+            LoadTest test = new LoadTest();
+            try
+            {
+                test.Parse(args);
+            }
+            catch (FormatException e)
+            {
+                Console.Error.WriteLine(e.Message);
+                return 1;
+            }
+            return test.Run();
+        }
+
+        private void Parse(string[] args)
+        {
+            string mix = "fstat=40,changes=20,print=20,describe=20";
+            foreach (string arg in args)
+            {
+                if (string.Equals(arg, "/load", StringComparison.OrdinalIgnoreCase)) continue;
+
+                int colon = arg.IndexOf(':');
+                string name = (colon < 0 ? arg : arg.Substring(0, colon)).ToLowerInvariant();
+                string value = colon < 0 ? "" : arg.Substring(colon + 1);
+                switch (name)
+                {
+                    case "/port": _port = value; break;
+                    case "/user": _user = value; break;
+                    case "/client": _client = value; break;
+                    case "/password": _password = value; break;
+                    case "/charset": _charset = value; break;
+                    case "/replay": _replay = value; break;
+                    case "/threads": _threads = (int)ParseNumber(name, value); break;
+                    case "/duration": _duration = ParseNumber(name, value); break;
+                    case "/warmup": _warmup = ParseNumber(name, value); break;
+                    case "/rate": _rate = ParseNumber(name, value); break;
+                    case "/think": _think = (int)ParseNumber(name, value); break;
+                    case "/expected": _expected = ParseNumber(name, value); break;
+                    case "/mix": mix = value; break;
+                    case "/path": _path = value; break;
+                    default: throw new FormatException("Unknown option " + arg);
+                }
+            }
+            if (_threads < 1) throw new FormatException("/threads must be at least 1");
+
+            foreach (string part in mix.Split(','))
+            {
+                string[] nw = part.Split('=');
+                int weight = nw.Length > 1 ? (int)ParseNumber("/mix", nw[1]) : 1;
+                if (nw[0].Length == 0 || weight <= 0) continue;
+                _mixNames.Add(nw[0]);
+                _mixWeights.Add(weight);
+                _mixTotal += weight;
+            }
+            if (_mixTotal == 0) throw new FormatException("/mix has no commands");
+        }
+
+        private static double ParseNumber(string name, string value)
+        {
+            double d;
+            if (!double.TryParse(value, NumberStyles.Float, CultureInfo.InvariantCulture, out d) || d < 0)
+            {
+                throw new FormatException(name + " needs a non-negative number, not '" + value + "'");
+            }
+            return d;
+        }
+
+
+        //**************************************************
+        //* Setup
+        //**************************************************
+
+        private P4Connection Open()
+        {
+            P4Connection p4 = new P4Connection();
+            if (_replay != null)
+            {
+                // each connection plays the whole session on its own
+                P4SessionReplay replay = new P4SessionReplay(_replay);
+                replay.Loop = true;
+                p4.SessionReplay = replay;
+            }
+            else
+            {
+                if (_port != null) p4.Port = _port;
+                if (_user != null) p4.User = _user;
+                if (_client != null) p4.Client = _client;
+                if (_charset != null) p4.Charset = _charset;
+            }
+            p4.ExceptionLevel = P4ExceptionLevels.NoExceptionOnErrors;
+            p4.Connect();
+            if (_password != null && _replay == null) p4.Login(_password);
+            return p4;
+        }
+
+        private static void Close(P4Connection p4)
+        {
+            P4SessionReplay replay = p4.SessionReplay;
+            p4.Disconnect();
+            if (replay != null) replay.Dispose();
+        }
+
+        private void PickTestData()
+        {
+            if (_replay != null) return;
+
+            P4Connection p4 = Open();
+            try
+            {
+                if (_mixNames.Contains("fstat") || _mixNames.Contains("print"))
+                {
+                    List<string> files = new List<string>();
+                    foreach (P4Record r in p4.Run("files", "-e", "-m", "1000", _path))
+                    {
+                        files.Add(r["depotFile"]);
+                    }
+                    if (files.Count == 0) throw new InvalidOperationException("No files under " + _path);
+                    _files = files.ToArray();
+                }
+                if (_mixNames.Contains("describe"))
+                {
+                    List<string> changes = new List<string>();
+                    foreach (P4Record r in p4.Run("changes", "-s", "submitted", "-m", "500", _path))
+                    {
+                        changes.Add(r["change"]);
+                    }
+                    if (changes.Count == 0) throw new InvalidOperationException("No changes under " + _path);
+                    _changes = changes.ToArray();
+                }
+            }
+            finally
+            {
+                Close(p4);
+            }
+        }
+
+        private string[] GetArgs(string command, Random random)
+        {
+            switch (command)
+            {
+                case "fstat":
+                    return new string[] { _files[random.Next(_files.Length)] };
+                case "print":
+                    return new string[] { "-q", _files[random.Next(_files.Length)] };
+                case "changes":
+                    return new string[] { "-m", "50", _path };
+                case "describe":
+                    return new string[] { "-s", _changes[random.Next(_changes.Length)] };
+                default:
+                    return new string[] { _path };
+            }
+        }
+
+        private string Pick(Random random)
+        {
+            int n = random.Next(_mixTotal);
+            for (int i = 0; i < _mixNames.Count; i++)
+            {
+                n -= _mixWeights[i];
+                if (n < 0) return _mixNames[i];
+            }
+            return _mixNames[_mixNames.Count - 1];
+        }
+
+
+        //**************************************************
+        //* Run
+        //**************************************************
+
+        private int Run()
+        {
+            try
+            {
+                PickTestData();
+            }
+            catch (Exception e)
+            {
+                Console.Error.WriteLine("Setup failed: " + e.Message);
+                return 1;
+            }
+
+            Worker[] workers = new Worker[_threads];
+            for (int i = 0; i < workers.Length; i++)
+            {
+                workers[i] = new Worker(this, i);
+                workers[i].Thread.Start();
+            }
+            foreach (Worker w in workers) w.Connected.WaitOne();
+
+            PauseMeter pauses = new PauseMeter();
+
+            long freq = Stopwatch.Frequency;
+            _start = Stopwatch.GetTimestamp();
+            _measureFrom = _start + (long)(_warmup * freq);
+            _stopAt = _measureFrom + (long)(_duration * freq);
+            _go.Set();
+
+            // GC counts and pauses only cover the measured part of the run
+            Thread.Sleep(TimeSpan.FromSeconds(_warmup));
+            pauses.Start();
+            int[] gcBefore = CollectionCounts();
+            foreach (Worker w in workers) w.Thread.Join();
+            pauses.Stop();
+            int[] gcAfter = CollectionCounts();
+
+            Report(workers, pauses, gcBefore, gcAfter);
+            return 0;
+        }
+
+        private static int[] CollectionCounts()
+        {
+            int[] counts = new int[GC.MaxGeneration + 1];
+            for (int i = 0; i < counts.Length; i++) counts[i] = GC.CollectionCount(i);
+            return counts;
+        }
+
+        private static long ToMicroseconds(long ticks)
+        {
+            return (long)(ticks * (1000000.0 / Stopwatch.Frequency));
+        }
+
+
+        //**************************************************
+        //* Report
+        //**************************************************
+
+        private void Report(Worker[] workers, PauseMeter pauses, int[] gcBefore, int[] gcAfter)
+        {
+            SortedDictionary<string, CommandStats> byCommand = new SortedDictionary<string, CommandStats>();
+            CommandStats total = new CommandStats("total");
+            int failedWorkers = 0;
+            foreach (Worker w in workers)
+            {
+                if (w.Failure != null)
+                {
+                    failedWorkers++;
+                    Console.Error.WriteLine("connection {0}: {1}", w.Index, w.Failure.Message);
+                }
+                foreach (CommandStats s in w.Stats.Values)
+                {
+                    CommandStats c;
+                    if (!byCommand.TryGetValue(s.Name, out c))
+                    {
+                        c = new CommandStats(s.Name);
+                        byCommand.Add(s.Name, c);
+                    }
+                    c.Add(s);
+                    total.Add(s);
+                }
+            }
+
+            bool openLoop = _rate > 0;
+            Console.WriteLine("{0} connections, {1}, {2}s measured after {3}s warmup, against {4}",
+                _threads,
+                openLoop ? string.Format(CultureInfo.InvariantCulture, "open loop at {0}/s", _rate) : "closed loop",
+                _duration, _warmup,
+                _replay != null ? "replay of " + _replay : (_port ?? "P4PORT"));
+            if (failedWorkers > 0) Console.WriteLine("{0} connections failed", failedWorkers);
+            Console.WriteLine();
+
+            Console.WriteLine("Service time (sent to done), ms");
+            WriteHeader();
+            foreach (CommandStats c in byCommand.Values) WriteRow(c.Name, c, c.Service);
+            WriteRow("total", total, total.Service);
+            Console.WriteLine();
+
+            if (openLoop)
+            {
+                Console.WriteLine("Response time (due to done), ms");
+                WriteHeader();
+                foreach (CommandStats c in byCommand.Values) WriteRow(c.Name, c, c.Response);
+                WriteRow("total", total, total.Response);
+            }
+            else
+            {
+                long expected = _expected > 0
+                    ? (long)(_expected * 1000)
+                    : _think * 1000L + total.Service.GetPercentile(50);
+                Console.WriteLine("Corrected for coordinated omission (expected interval {0:0.000} ms), ms", expected / 1000.0);
+                WriteHeader();
+                foreach (CommandStats c in byCommand.Values)
+                {
+                    WriteRow(c.Name, c, c.Service.CopyCorrectedForCoordinatedOmission(expected));
+                }
+                WriteRow("total", total, total.Service.CopyCorrectedForCoordinatedOmission(expected));
+            }
+            Console.WriteLine();
+
+            Console.Write("GC collections:");
+            for (int i = 0; i < gcAfter.Length; i++) Console.Write(" gen{0} {1}", i, gcAfter[i] - gcBefore[i]);
+            Console.WriteLine();
+            P4Histogram p = pauses.Pauses;
+            Console.WriteLine("Pauses (1 ms timer overshoot): p99 {0:0.000} ms, p99.9 {1:0.000} ms, max {2:0.000} ms, {3:0.0} ms stalled over 1 ms",
+                p.GetPercentile(99) / 1000.0, p.GetPercentile(99.9) / 1000.0, p.Max / 1000.0, pauses.Stalled / 1000.0);
+        }
+
+        private static void WriteHeader()
+        {
+            Console.WriteLine("{0,-16} {1,10} {2,10} {3,8} {4,10} {5,10} {6,10} {7,10}",
+                "command", "ops", "ops/s", "errors", "p50", "p99", "p99.9", "max");
+        }
+
+        private void WriteRow(string name, CommandStats c, P4Histogram h)
+        {
+            Console.WriteLine("{0,-16} {1,10} {2,10:0.0} {3,8} {4,10:0.000} {5,10:0.000} {6,10:0.000} {7,10:0.000}",
+                name, c.Completed, c.Completed / _duration, c.Errors,
+                h.GetPercentile(50) / 1000.0, h.GetPercentile(99) / 1000.0, h.GetPercentile(99.9) / 1000.0, h.Max / 1000.0);
+        }
+
+
+        //**************************************************
+        //* Per connection
+        //**************************************************
+
+        private sealed class CommandStats
+        {
+            public readonly string Name;
+            public long Completed;
+            public long Errors;
+
+            // microseconds from sending the command until it returned
+            public readonly P4Histogram Service = new P4Histogram();
+
+            // open loop only: microseconds from when the command was due until it returned
+            public readonly P4Histogram Response = new P4Histogram();
+
+            public CommandStats(string name)
+            {
+                Name = name;
+            }
+
+            public void Add(CommandStats other)
+            {
+                Completed += other.Completed;
+                Errors += other.Errors;
+                Service.Add(other.Service);
+                Response.Add(other.Response);
+            }
+        }
+
+        private sealed class Worker
+        {
+            private readonly LoadTest _test;
+            private readonly Random _random;
+            private string[][] _session;
+            private int _sessionNext;
+
+            public readonly int Index;
+            public readonly Thread Thread;
+            public readonly ManualResetEvent Connected = new ManualResetEvent(false);
+            public readonly Dictionary<string, CommandStats> Stats = new Dictionary<string, CommandStats>();
+            public Exception Failure;
+
+            public Worker(LoadTest test, int index)
+            {
+                _test = test;
+                _random = new Random(20110215 + index);
+                Index = index;
+                Thread = new Thread(Work);
+                Thread.IsBackground = true;
+                Thread.Name = "load " + index;
+            }
+
+            private void Work()
+            {
+                P4Connection p4 = null;
+                try
+                {
+                    p4 = _test.Open();
+                    if (p4.SessionReplay != null)
+                    {
+                        _session = new string[p4.SessionReplay.Commands][];
+                        for (int i = 0; i < _session.Length; i++) _session[i] = p4.SessionReplay.GetCommand(i);
+                        if (_session.Length == 0) throw new InvalidOperationException("The session is empty");
+                    }
+                }
+                catch (Exception e)
+                {
+                    Failure = e;
+                    Connected.Set();
+                    return;
+                }
+                Connected.Set();
+                _test._go.WaitOne();
+
+                try
+                {
+                    Loop(p4);
+                }
+                catch (Exception e)
+                {
+                    Failure = e;
+                }
+                finally
+                {
+                    Close(p4);
+                }
+            }
+
+            private void Loop(P4Connection p4)
+            {
+                bool openLoop = _test._rate > 0;
+                long freq = Stopwatch.Frequency;
+
+                // each thread keeps its own schedule, staggered so the threads don't fire together
+                long interval = openLoop ? (long)(freq * _test._threads / _test._rate) : 0;
+                long due = _test._start + interval * Index / _test._threads;
+
+                while (true)
+                {
+                    long now = Stopwatch.GetTimestamp();
+                    if (openLoop)
+                    {
+                        if (due >= _test._stopAt) break;
+                        if (due > now) Wait(due);
+                    }
+                    else
+                    {
+                        if (now >= _test._stopAt) break;
+                        due = now;
+                    }
+
+                    string command;
+                    string[] args;
+                    Next(out command, out args);
+
+                    long sent = Stopwatch.GetTimestamp();
+                    bool failed;
+                    try
+                    {
+                        P4RecordSet r = p4.Run(command, args);
+                        failed = r.HasErrors();
+                    }
+                    catch (P4API.Exceptions.P4APIExceptions)
+                    {
+                        failed = true;
+                    }
+                    long done = Stopwatch.GetTimestamp();
+
+                    if (sent >= _test._measureFrom && done <= _test._stopAt)
+                    {
+                        CommandStats s;
+                        if (!Stats.TryGetValue(command, out s))
+                        {
+                            s = new CommandStats(command);
+                            Stats.Add(command, s);
+                        }
+                        s.Completed++;
+                        if (failed) s.Errors++;
+                        s.Service.Record(ToMicroseconds(done - sent));
+                        if (openLoop) s.Response.Record(ToMicroseconds(done - due));
+                    }
+
+                    if (openLoop) due += interval;
+                    else if (_test._think > 0) Thread.Sleep(_test._think);
+                }
+            }
+
+            private void Next(out string command, out string[] args)
+            {
+                if (_session != null)
+                {
+                    // a replayed connection must run the session's commands in order
+                    string[] line = _session[_sessionNext];
+                    _sessionNext = (_sessionNext + 1) % _session.Length;
+                    command = line[0];
+                    args = new string[line.Length - 1];
+                    Array.Copy(line, 1, args, 0, args.Length);
+                }
+                else
+                {
+                    command = _test.Pick(_random);
+                    args = _test.GetArgs(command, _random);
+                }
+            }
+
+            private static void Wait(long due)
+            {
+                long left = due - Stopwatch.GetTimestamp();
+                long ms = left * 1000 / Stopwatch.Frequency;
+                if (ms > 1) Thread.Sleep((int)(ms - 1));
+                while (Stopwatch.GetTimestamp() < due) Thread.SpinWait(20);
+            }
+        }
+
+
+        //**************************************************
+        //* GC pauses
+        //**************************************************
+
+        /// <summary>
+        /// Neither runtime reports GC pause times, so a high priority thread sleeps 1 ms at a time
+        /// and records how late it wakes up.  Stalls that hit every thread (GC suspensions, paging)
+        /// show up here; the collection counts say how many collections there were.
+        /// </summary>
+        private sealed class PauseMeter
+        {
+            private readonly P4Histogram _pauses = new P4Histogram();
+            private long _stalled;
+            private volatile bool _stop;
+            private Thread _thread;
+
+            public void Start()
+            {
+                _thread = new Thread(Measure);
+                _thread.IsBackground = true;
+                _thread.Priority = ThreadPriority.Highest;
+                _thread.Name = "pause meter";
+                _thread.Start();
+            }
+
+            public void Stop()
+            {
+                _stop = true;
+                _thread.Join();
+            }
+
+            public P4Histogram Pauses
+            {
+                get
+                {
+                    return _pauses;
+                }
+            }
+
+            // microseconds lost to overshoots longer than 1 ms
+            public long Stalled
+            {
+                get
+                {
+                    return _stalled;
+                }
+            }
+
+            private void Measure()
+            {
+                while (!_stop)
+                {
+                    long t0 = Stopwatch.GetTimestamp();
+                    Thread.Sleep(1);
+                    long over = ToMicroseconds(Stopwatch.GetTimestamp() - t0) - 1000;
+                    _pauses.Record(over);
+                    if (over > 1000) _stalled += over;
+                }
+            }
+        }
+    }
+
+}
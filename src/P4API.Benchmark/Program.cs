@@ -0,0 +1,386 @@
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Text;
+
+namespace P4API.Benchmark
+{
+
+    /// <summary>
+    /// Micro-benchmarks for the p4dn bridge.  No Perforce server is needed:
+    /// the native side is fed synthetic output through p4dn.BridgeBenchmark.
+    /// </summary>
+    /// <remarks>
+    /// Usage: P4API.Benchmark [filter] [/replay:session]
+    /// Only benchmarks whose name contains the filter are run.  /replay plays a session
+    /// captured with P4SessionRecorder through a P4Connection, end to end.
+    /// P4API.Benchmark /load ... runs the multi-connection load test instead, see LoadTest.
+    /// </remarks>
+    public static class Program
+    {
+
+        private const int Seed = 20110215;
+        private static readonly TimeSpan TargetTime = TimeSpan.FromMilliseconds(500);
+        private static string _filter;
+        private static string _session;
+
+        private delegate void Loop(int iterations);
+
+
+        /// <summary>
+        /// </summary>
+        static Program()
+        {
+            P4API.Bootstrapper.Initialize();
+        }
+
+
+        /// <summary>
+        /// </summary>
+        public static int Main(string[] args)
+        {
+            foreach (string arg in args)
+            {
+                if (string.Equals(arg, "/load", StringComparison.OrdinalIgnoreCase)) return LoadTest.Run(args);
+            }
+            foreach (string arg in args)
+            {
+                if (arg.StartsWith("/replay:", StringComparison.OrdinalIgnoreCase)) _session = arg.Substring(8);
+                else _filter = arg;
+            }
+#if CLR4
+            // exact allocation counts; without this we fall back to heap growth
+            AppDomain.MonitoringIsEnabled = true;
+#endif
+            Console.WriteLine("{0,-36} {1,12} {2,12} {3,12} {4,12}", "benchmark", "ops", "ns/op", "alloc B/op", "bytes/rec");
+            Console.WriteLine(new string('-', 88));
+
+            RunBridge(Encoding.GetEncoding(1252), "ansi");
+            RunBridge(new UTF8Encoding(false), "utf8");
+            RunStrings();
+            RunRecords();
+            RunMaps();
+            RunSpecs();
+            if (_session != null) RunReplay(_session);
+            return 0;
+        }
+
+
+        //**************************************************
+        //* ClientUserDelegate callbacks
+        //**************************************************
+
+        private static void RunBridge(Encoding encoding, string suffix)
+        {
+            Workloads w = new Workloads(Seed);
+            NullCallback callback = new NullCallback();
+            CallbackClientUser cu = new CallbackClientUser(callback);
+            cu.SetEncoding(encoding);
+
+            using (p4dn.BridgeBenchmark b = new p4dn.BridgeBenchmark(cu, encoding))
+            {
+                SetRecord(b, w.Fstat());
+                Measure("OutputStat fstat " + suffix, b.RecordBytes, b.OutputStatLoop);
+                SetRecord(b, w.Filelog(20));
+                Measure("OutputStat filelog(20) " + suffix, b.RecordBytes, b.OutputStatLoop);
+                SetRecord(b, w.Describe(200));
+                Measure("OutputStat describe(200) " + suffix, b.RecordBytes, b.OutputStatLoop);
+
+                b.SetMessage(1, "%depotFile%#%rev% - updating %localPath%",
+                    new string[] { "//depot/" + w.DepotPath(), "12", "c:\\work\\" + w.DepotPath() });
+                Measure("Message info " + suffix, -1, b.MessageLoop);
+
+                b.SetInfo(w.Sentence(80));
+                Measure("OutputInfo " + suffix, -1, b.OutputInfoLoop);
+
+                b.SetContent(w.TextChunk(4096));
+                Measure("OutputText 4k " + suffix, 4096, b.OutputTextLoop);
+                b.SetContent(w.BinaryChunk(4096));
+                Measure("OutputBinary 4k " + suffix, 4096, b.OutputBinaryLoop);
+            }
+            GC.KeepAlive(callback);
+        }
+
+        private static void SetRecord(p4dn.BridgeBenchmark b, Workloads.Record r)
+        {
+            b.SetRecord(r.Keys.ToArray(), r.Values.ToArray());
+        }
+
+
+        //**************************************************
+        //* P4String
+        //**************************************************
+
+        private static void RunStrings()
+        {
+            Workloads w = new Workloads(Seed);
+            string path = "//depot/" + w.DepotPath();
+            string desc = w.Sentence(2000);
+            Encoding ansi = Encoding.GetEncoding(1252);
+            Encoding utf8 = new UTF8Encoding(false);
+
+            Measure("P4String encode path ansi", path.Length, delegate(int n) { p4dn.BridgeBenchmark.EncodeLoop(path, ansi, n); });
+            Measure("P4String encode path utf8", path.Length, delegate(int n) { p4dn.BridgeBenchmark.EncodeLoop(path, utf8, n); });
+            Measure("P4String encode 2k utf8", desc.Length, delegate(int n) { p4dn.BridgeBenchmark.EncodeLoop(desc, utf8, n); });
+
+            byte[] pathBytes = utf8.GetBytes(path);
+            byte[] descBytes = utf8.GetBytes(desc);
+            Measure("P4String decode path ansi", pathBytes.Length, delegate(int n) { p4dn.BridgeBenchmark.DecodeLoop(pathBytes, ansi, n); });
+            Measure("P4String decode path utf8", pathBytes.Length, delegate(int n) { p4dn.BridgeBenchmark.DecodeLoop(pathBytes, utf8, n); });
+            Measure("P4String decode 2k utf8", descBytes.Length, delegate(int n) { p4dn.BridgeBenchmark.DecodeLoop(descBytes, utf8, n); });
+        }
+
+
+        //**************************************************
+        //* P4Record
+        //**************************************************
+
+        private static void RunRecords()
+        {
+            Workloads w = new Workloads(Seed);
+            RunRecord("P4Record.Reset fstat", w.Fstat());
+            RunRecord("P4Record.Reset filelog(20)", w.Filelog(20));
+            RunRecord("P4Record.Reset describe(200)", w.Describe(200));
+        }
+
+        private static void RunRecord(string name, Workloads.Record r)
+        {
+            Dictionary<string, string> dict = r.ToDictionary();
+            P4Record record = new P4Record(dict);
+            Measure(name, -1, delegate(int n)
+            {
+                for (int i = 0; i < n; i++) record.Reset(dict);
+            });
+        }
+
+
+        //**************************************************
+        //* P4MapMaker
+        //**************************************************
+
+        private static void RunMaps()
+        {
+            Workloads w = new Workloads(Seed);
+            Encoding encoding = Encoding.GetEncoding(1252);
+
+            // a 50 line client view with a few exclusions
+            string[] lhs = new string[50];
+            string[] rhs = new string[50];
+            for (int i = 0; i < lhs.Length; i++)
+            {
+                string dir = w.Word(6) + "/" + w.Word(8);
+                lhs[i] = (i % 10 == 9 ? "-" : "") + "//depot/" + dir + "/...";
+                rhs[i] = "//ws/" + dir + "/...";
+            }
+
+            Measure("P4MapMaker.Insert 50 lines", -1, delegate(int n)
+            {
+                for (int i = 0; i < n; i++)
+                {
+                    p4dn.P4MapMaker map = new p4dn.P4MapMaker(encoding);
+                    for (int j = 0; j < lhs.Length; j++) map.Insert(lhs[j], rhs[j]);
+                    map.Dispose();
+                }
+            });
+
+            p4dn.P4MapMaker view = new p4dn.P4MapMaker(encoding);
+            for (int j = 0; j < lhs.Length; j++) view.Insert(lhs[j], rhs[j]);
+
+            // half the paths are mapped, half are not
+            string[] paths = new string[256];
+            for (int i = 0; i < paths.Length; i++)
+            {
+                paths[i] = i % 2 == 0
+                    ? lhs[(i / 2) % lhs.Length].TrimStart('-').Replace("...", w.DepotPath())
+                    : "//depot/" + w.DepotPath();
+            }
+            Measure("P4MapMaker.Translate", -1, delegate(int n)
+            {
+                for (int i = 0; i < n; i++) view.Translate(paths[i & 255], true);
+            });
+            view.Dispose();
+        }
+
+
+        //**************************************************
+        //* Spec
+        //**************************************************
+
+        private const string ClientSpecDef =
+            "Client;code:301;rq;ro;fmt:L;len:32;;Update;code:302;type:date;ro;fmt:L;len:20;;" +
+            "Access;code:303;type:date;ro;fmt:L;len:20;;Owner;code:304;fmt:R;len:32;;" +
+            "Host;code:305;type:line;len:32;;Description;code:306;type:text;len:128;;" +
+            "Root;code:307;rq;type:line;len:64;;AltRoots;code:333;type:llist;len:64;cnt:2;;" +
+            "Options;code:309;type:line;len:64;val:noallwrite/allwrite,noclobber/clobber,nocompress/compress,unlocked/locked,nomodtime/modtime,normdir/rmdir;;" +
+            "SubmitOptions;code:313;type:select;len:25;val:submitunchanged/submitunchanged+reopen/revertunchanged/revertunchanged+reopen/leaveunchanged/leaveunchanged+reopen;;" +
+            "LineEnd;code:310;type:select;len:12;val:local/unix/mac/win/share;;" +
+            "View;code:311;type:wlist;words:2;len:64;;";
+
+        private static void RunSpecs()
+        {
+            Workloads w = new Workloads(Seed);
+            Encoding encoding = Encoding.GetEncoding(1252);
+            p4dn.Spec spec = new p4dn.Spec(ClientSpecDef, encoding);
+
+            Dictionary<string, string> client = new Dictionary<string, string>();
+            client.Add("Client", w.Word(12));
+            client.Add("Owner", w.Word(8));
+            client.Add("Host", w.Word(10));
+            client.Add("Description", w.Sentence(200));
+            client.Add("Root", "c:\\work\\" + w.Word(8));
+            client.Add("Options", "noallwrite noclobber nocompress unlocked nomodtime normdir");
+            client.Add("SubmitOptions", "submitunchanged");
+            client.Add("LineEnd", "local");
+            for (int i = 0; i < 50; i++)
+            {
+                string dir = w.Word(6) + "/" + w.Word(8);
+                client.Add("View" + i.ToString(), "//depot/" + dir + "/... //" + client["Client"] + "/" + dir + "/...");
+            }
+
+            using (p4dn.Error err = new p4dn.Error(encoding))
+            {
+                string form = spec.Format(client, err);
+                Measure("Spec.Format client(50)", form.Length, delegate(int n)
+                {
+                    for (int i = 0; i < n; i++) spec.Format(client, err);
+                });
+                Measure("Spec.Parse client(50)", form.Length, delegate(int n)
+                {
+                    for (int i = 0; i < n; i++) spec.Parse(form, err);
+                });
+            }
+        }
+
+
+        //**************************************************
+        //* Recorded session, through the whole stack
+        //**************************************************
+
+        private static void RunReplay(string path)
+        {
+            using (P4SessionReplay replay = new P4SessionReplay(path))
+            {
+                replay.Loop = true;
+                P4Connection p4 = new P4Connection();
+                p4.SessionReplay = replay;
+                p4.ExceptionLevel = P4ExceptionLevels.NoExceptionOnErrors;
+                p4.Connect();
+
+                int commands = replay.Commands;
+                string[][] lines = new string[commands][];
+                for (int i = 0; i < commands; i++) lines[i] = replay.GetCommand(i);
+
+                Measure("replay " + System.IO.Path.GetFileName(path) + " (" + commands + " cmds)", -1, delegate(int n)
+                {
+                    for (int i = 0; i < n; i++)
+                    {
+                        foreach (string[] line in lines)
+                        {
+                            string[] cmdArgs = new string[line.Length - 1];
+                            Array.Copy(line, 1, cmdArgs, 0, cmdArgs.Length);
+                            p4.Run(line[0], cmdArgs);
+                        }
+                    }
+                });
+                p4.Disconnect();
+            }
+        }
+
+
+        //**************************************************
+        //* Harness
+        //**************************************************
+
+        private static void Measure(string name, int bytesPerOp, Loop loop)
+        {
+            if (_filter != null && name.IndexOf(_filter, StringComparison.OrdinalIgnoreCase) < 0) return;
+
+            // warm up (JIT, caches), then grow the batch until it runs long enough to time
+            loop(1);
+            int n = 1;
+            Stopwatch sw = Stopwatch.StartNew();
+            loop(n);
+            while (sw.Elapsed < TimeSpan.FromMilliseconds(50) && n < (1 << 28))
+            {
+                n *= 2;
+                sw = Stopwatch.StartNew();
+                loop(n);
+            }
+            double perOp = sw.Elapsed.TotalMilliseconds / n;
+            int iterations = (int)Math.Min(int.MaxValue / 2, Math.Max(1, TargetTime.TotalMilliseconds / Math.Max(perOp, 1e-6)));
+
+            GC.Collect();
+            GC.WaitForPendingFinalizers();
+            GC.Collect();
+
+            int gcBefore = GC.CollectionCount(0);
+            long allocBefore = AllocatedBytes();
+            sw = Stopwatch.StartNew();
+            loop(iterations);
+            sw.Stop();
+            long allocated = AllocatedBytes() - allocBefore;
+            bool collected = GC.CollectionCount(0) != gcBefore;
+
+            double ns = sw.Elapsed.TotalMilliseconds * 1000000.0 / iterations;
+            string alloc = (collected && !ExactAllocations)
+                ? "n/a"
+                : (Math.Max(0, allocated) / (double)iterations).ToString("0.0");
+            Console.WriteLine("{0,-36} {1,12} {2,12:0.0} {3,12} {4,12}", name, iterations, ns, alloc,
+                bytesPerOp >= 0 ? bytesPerOp.ToString() : "");
+        }
+
+        private static bool ExactAllocations
+        {
+            get
+            {
+#if CLR4
+                return AppDomain.MonitoringIsEnabled;
+#else
+                return false;
+#endif
+            }
+        }
+
+        private static long AllocatedBytes()
+        {
+#if CLR4
+            if (AppDomain.MonitoringIsEnabled)
+            {
+                return AppDomain.CurrentDomain.MonitoringTotalAllocatedMemorySize;
+            }
+#endif
+            return GC.GetTotalMemory(false);
+        }
+
+
+        /// <summary>
+        /// Swallows everything, but touches it so nothing is optimized away.
+        /// </summary>
+        private sealed class NullCallback : P4Callback
+        {
+            public long Count;
+
+            public override void OutputRecord(P4Record record)
+            {
+                Count += record.Fields.Count;
+            }
+
+            public override void OutputMessage(P4Message message)
+            {
+                Count += message.Identity;
+            }
+
+            public override void OutputInfo(string data)
+            {
+                Count += data.Length;
+            }
+
+            public override void OutputContent(byte[] buffer, bool IsText)
+            {
+                Count += buffer.Length;
+            }
+        }
+
+    }
+
+}
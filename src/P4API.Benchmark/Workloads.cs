@@ -0,0 +1,251 @@
+using System;
+using System.Collections.Generic;
+using System.Text;
+
+namespace P4API.Benchmark
+{
+
+    /// <summary>
+    /// Synthetic server output shaped like real commands.  Everything is
+    /// generated from a fixed seed so runs are comparable.
+    /// </summary>
+    public sealed class Workloads
+    {
+
+        private readonly Random _random;
+
+
+        /// <summary>
+        /// </summary>
+        public Workloads(int seed)
+        {
+            _random = new Random(seed);
+        }
+
+
+        /// <summary>
+        /// A tagged record, as parallel key/value arrays.
+        /// </summary>
+        public sealed class Record
+        {
+            public readonly List<string> Keys = new List<string>();
+            public readonly List<string> Values = new List<string>();
+
+            public void Add(string key, string value)
+            {
+                Keys.Add(key);
+                Values.Add(value);
+            }
+
+            public Dictionary<string, string> ToDictionary()
+            {
+                Dictionary<string, string> ret = new Dictionary<string, string>(Keys.Count);
+                for (int i = 0; i < Keys.Count; i++)
+                {
+                    ret.Add(Keys[i], Values[i]);
+                }
+                return ret;
+            }
+        }
+
+
+        /// <summary>
+        /// fstat of one file (about 20 fields).
+        /// </summary>
+        public Record Fstat()
+        {
+            Record r = new Record();
+            string path = DepotPath();
+            r.Add("depotFile", "//depot/" + path);
+            r.Add("clientFile", "c:\\work\\" + path.Replace('/', '\\'));
+            r.Add("isMapped", "");
+            r.Add("headAction", Action());
+            r.Add("headType", "text");
+            r.Add("headTime", Time());
+            r.Add("headRev", Number(1, 40));
+            r.Add("headChange", Number(1000, 900000));
+            r.Add("headModTime", Time());
+            r.Add("haveRev", Number(1, 40));
+            r.Add("fileSize", Number(100, 2000000));
+            r.Add("digest", Hex(32));
+            r.Add("action", "edit");
+            r.Add("change", "default");
+            r.Add("type", "text");
+            r.Add("actionOwner", Word(8));
+            r.Add("otherOpen0", Word(8) + "@" + Word(10));
+            r.Add("otherAction0", "edit");
+            r.Add("otherChange0", Number(1000, 900000));
+            r.Add("otherOpen", "1");
+            return r;
+        }
+
+
+        /// <summary>
+        /// filelog of one file with the given number of revisions.
+        /// </summary>
+        public Record Filelog(int revisions)
+        {
+            Record r = new Record();
+            r.Add("depotFile", "//depot/" + DepotPath());
+            for (int i = 0; i < revisions; i++)
+            {
+                string n = i.ToString();
+                r.Add("rev" + n, (revisions - i).ToString());
+                r.Add("change" + n, Number(1000, 900000));
+                r.Add("action" + n, Action());
+                r.Add("type" + n, "text");
+                r.Add("time" + n, Time());
+                r.Add("user" + n, Word(8));
+                r.Add("client" + n, Word(12));
+                r.Add("fileSize" + n, Number(100, 2000000));
+                r.Add("digest" + n, Hex(32));
+                r.Add("desc" + n, Sentence(30));
+            }
+            return r;
+        }
+
+
+        /// <summary>
+        /// describe -s of a change with the given number of files.
+        /// </summary>
+        public Record Describe(int files)
+        {
+            Record r = new Record();
+            r.Add("change", Number(1000, 900000));
+            r.Add("user", Word(8));
+            r.Add("client", Word(12));
+            r.Add("time", Time());
+            r.Add("desc", Sentence(400));
+            r.Add("status", "submitted");
+            for (int i = 0; i < files; i++)
+            {
+                string n = i.ToString();
+                r.Add("depotFile" + n, "//depot/" + DepotPath());
+                r.Add("action" + n, Action());
+                r.Add("type" + n, "text");
+                r.Add("rev" + n, Number(1, 40));
+            }
+            return r;
+        }
+
+
+        /// <summary>
+        /// A chunk of printable text (as "print" sends text files).
+        /// </summary>
+        public byte[] TextChunk(int size)
+        {
+            StringBuilder sb = new StringBuilder(size);
+            while (sb.Length < size)
+            {
+                sb.Append(Sentence(60));
+                sb.Append('\n');
+            }
+            return Encoding.ASCII.GetBytes(sb.ToString(0, size));
+        }
+
+
+        /// <summary>
+        /// A chunk of random bytes (as "print" sends binary files).
+        /// </summary>
+        public byte[] BinaryChunk(int size)
+        {
+            byte[] ret = new byte[size];
+            _random.NextBytes(ret);
+            return ret;
+        }
+
+
+        /// <summary>
+        /// Paths for a client view, used by the map benchmarks.
+        /// </summary>
+        public string[] DepotPaths(int count)
+        {
+            string[] ret = new string[count];
+            for (int i = 0; i < count; i++)
+            {
+                ret[i] = "//depot/" + DepotPath();
+            }
+            return ret;
+        }
+
+
+        /// <summary>
+        /// </summary>
+        public string DepotPath()
+        {
+            int depth = _random.Next(2, 7);
+            StringBuilder sb = new StringBuilder();
+            for (int i = 0; i < depth; i++)
+            {
+                sb.Append(Word(_random.Next(3, 12)));
+                sb.Append('/');
+            }
+            sb.Append(Word(_random.Next(4, 16)));
+            sb.Append(Extensions[_random.Next(Extensions.Length)]);
+            return sb.ToString();
+        }
+
+
+        /// <summary>
+        /// </summary>
+        public string Sentence(int length)
+        {
+            StringBuilder sb = new StringBuilder(length + 12);
+            while (sb.Length < length)
+            {
+                if (sb.Length > 0) sb.Append(' ');
+                sb.Append(Word(_random.Next(2, 10)));
+            }
+            return sb.ToString(0, length);
+        }
+
+
+        /// <summary>
+        /// </summary>
+        public string Word(int length)
+        {
+            char[] c = new char[length];
+            for (int i = 0; i < length; i++)
+            {
+                c[i] = (char)('a' + _random.Next(26));
+            }
+            return new string(c);
+        }
+
+
+        private string Number(int min, int max)
+        {
+            return _random.Next(min, max).ToString();
+        }
+
+
+        private string Time()
+        {
+            return _random.Next(1000000000, 1300000000).ToString();
+        }
+
+
+        private string Hex(int length)
+        {
+            const string digits = "0123456789ABCDEF";
+            char[] c = new char[length];
+            for (int i = 0; i < length; i++)
+            {
+                c[i] = digits[_random.Next(16)];
+            }
+            return new string(c);
+        }
+
+
+        private string Action()
+        {
+            return Actions[_random.Next(Actions.Length)];
+        }
+
+
+        private static readonly string[] Actions = new string[] { "add", "edit", "edit", "edit", "delete", "integrate", "branch" };
+        private static readonly string[] Extensions = new string[] { ".cs", ".cpp", ".h", ".txt", ".xml", ".png", ".dll" };
+
+    }
+
+}
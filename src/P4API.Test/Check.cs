@@ -0,0 +1,53 @@
+﻿using System;
+
+namespace P4API.Test
+{
+
+    /// <summary>
+    /// A test, or the code a check expects to throw.  (Action isn't in the 2.0 framework.)
+    /// </summary>
+    public delegate void TestMethod();
+
+    /// <summary>
+    /// Assertions for the offline tests; a failed check throws, which fails the test it is in.
+    /// </summary>
+    public static class Check
+    {
+
+        /// <summary>
+        /// </summary>
+        public static void IsTrue(bool condition, string what)
+        {
+            if (!condition) throw new Exception("Expected true: " + what);
+        }
+
+
+        /// <summary>
+        /// </summary>
+        public static void AreEqual(object expected, object actual, string what)
+        {
+            if (!Equals(expected, actual))
+            {
+                throw new Exception(string.Format("{0}: expected <{1}>, got <{2}>", what, expected ?? "null", actual ?? "null"));
+            }
+        }
+
+
+        /// <summary>
+        /// </summary>
+        public static void Throws<TException>(TestMethod action, string what) where TException : Exception
+        {
+            try
+            {
+                action();
+            }
+            catch (TException)
+            {
+                return;
+            }
+            throw new Exception("Expected " + typeof(TException).Name + ": " + what);
+        }
+
+    }
+
+}
@@ -0,0 +1,86 @@
+﻿using System;
+
+namespace P4API.Test
+{
+
+    /// <summary>
+    /// P4DepotPathTrie lookups.
+    /// </summary>
+    public static class DepotPathTrieTests
+    {
+
+        /// <summary>
+        /// </summary>
+        public static void AddAndFind()
+        {
+            var trie = new P4DepotPathTrie(true);
+            int a = trie.Add("//depot/main/src/a.c");
+            int b = trie.Add("//depot/main/src/b.c");
+            int c = trie.Add("//depot/rel/src/a.c");
+
+            Check.AreEqual(a, trie.Add("//depot/main/src/a.c"), "adding again returns the same node");
+            Check.AreEqual(3, trie.FileCount, "FileCount");
+            // root, depot, main, main/src, rel, rel/src and the three files
+            Check.AreEqual(9, trie.NodeCount, "NodeCount");
+
+            Check.AreEqual(a, trie.Find("//depot/main/src/a.c"), "Find file");
+            Check.AreEqual(-1, trie.Find("//depot/main/src/c.c"), "Find missing file");
+            Check.AreEqual(-1, trie.Find("//depot/main/SRC/a.c"), "Find is case sensitive");
+
+            int src = trie.Find("//depot/main/src/...");
+            Check.IsTrue(src > 0, "Find folder with /...");
+            Check.AreEqual(src, trie.Find("//depot/main/src/"), "Find folder with /");
+            Check.IsTrue(!trie.IsFile(src), "folder isn't a file");
+            Check.IsTrue(trie.IsFile(b), "file is a file");
+
+            Check.AreEqual("//depot/main/src/b.c", trie.GetPath(b), "GetPath");
+            Check.AreEqual("//depot/main/src", trie.GetPath(src), "GetPath of a folder");
+            Check.AreEqual("//", trie.GetPath(P4DepotPathTrie.Root), "GetPath of the root");
+            Check.AreEqual("a.c", trie.GetName(c), "GetName");
+            Check.AreEqual(src, trie.GetParent(a), "GetParent");
+
+            int[] children = trie.GetChildren(src);
+            Check.AreEqual(2, children.Length, "GetChildren count");
+            Check.AreEqual(a, children[0], "children in the order added");
+            Check.AreEqual(b, children[1], "children in the order added");
+
+            int[] files = trie.GetFilesUnder("//depot/...");
+            Check.AreEqual(3, files.Length, "GetFilesUnder count");
+            Check.AreEqual(a, files[0], "depth first");
+            Check.AreEqual(b, files[1], "depth first");
+            Check.AreEqual(c, files[2], "depth first");
+            Check.AreEqual(0, trie.GetFilesUnder("//other/...").Length, "GetFilesUnder missing path");
+        }
+
+
+        /// <summary>
+        /// </summary>
+        public static void CaseInsensitive()
+        {
+            var trie = new P4DepotPathTrie(false);
+            int a = trie.Add("//depot/Main/a.c");
+            Check.AreEqual(a, trie.Add("//DEPOT/main/A.C"), "same file in another case");
+            Check.AreEqual(a, trie.Find("//depot/MAIN/a.c"), "Find ignores case");
+            Check.AreEqual("//depot/Main/a.c", trie.GetPath(a), "keeps the case first added");
+
+            // the same name in another folder keeps its own case
+            int b = trie.Add("//other/main/b.c");
+            Check.AreEqual("//other/main/b.c", trie.GetPath(b), "case of another folder");
+            Check.AreEqual("main", trie.GetName(trie.GetParent(b)), "GetName of another folder");
+            Check.AreEqual(b, trie.Find("//OTHER/MAIN/B.C"), "Find in another folder ignores case");
+            Check.AreEqual(2, trie.FileCount, "FileCount");
+        }
+
+
+        /// <summary>
+        /// </summary>
+        public static void BadPaths()
+        {
+            var trie = new P4DepotPathTrie(true);
+            Check.Throws<ArgumentException>(delegate { trie.Add("main/a.c"); }, "not a depot path");
+            Check.Throws<ArgumentException>(delegate { trie.Add("//depot//a.c"); }, "empty segment");
+        }
+
+    }
+
+}
@@ -0,0 +1,87 @@
+﻿using System;
+
+namespace P4API.Test
+{
+
+    /// <summary>
+    /// P4Histogram recording and percentiles.
+    /// </summary>
+    public static class HistogramTests
+    {
+
+        /// <summary>
+        /// </summary>
+        public static void Percentiles()
+        {
+            var h = new P4Histogram();
+            Check.AreEqual(0L, h.GetPercentile(50), "empty percentile");
+            Check.AreEqual(0L, h.Min, "empty Min");
+
+            for (long v = 1; v <= 1000; v++)
+            {
+                h.Record(v);
+            }
+            Check.AreEqual(1000L, h.Count, "Count");
+            Check.AreEqual(500500L, h.Sum, "Sum");
+            Check.AreEqual(1L, h.Min, "Min");
+            Check.AreEqual(1000L, h.Max, "Max");
+            Check.AreEqual(500.5, h.Mean, "Mean");
+
+            // reported to within the bucket width, about 6%, and never below the true value
+            long p50 = h.GetPercentile(50);
+            Check.IsTrue(p50 >= 500 && p50 <= 530, "p50 " + p50);
+            long p99 = h.GetPercentile(99);
+            Check.IsTrue(p99 >= 990 && p99 <= 1000, "p99 " + p99);
+            Check.AreEqual(1000L, h.GetPercentile(100), "p100 is Max");
+            Check.AreEqual(1L, h.GetPercentile(0), "p0 is the smallest bucket");
+        }
+
+
+        /// <summary>
+        /// </summary>
+        public static void SmallValuesAreExact()
+        {
+            var h = new P4Histogram();
+            h.Record(3, 10);
+            h.Record(-5);
+            Check.AreEqual(11L, h.Count, "Count");
+            Check.AreEqual(0L, h.Min, "negative recorded as 0");
+            Check.AreEqual(3L, h.GetPercentile(50), "p50");
+        }
+
+
+        /// <summary>
+        /// </summary>
+        public static void AddCloneReset()
+        {
+            var a = new P4Histogram();
+            a.Record(10);
+            var b = new P4Histogram();
+            b.Record(long.MaxValue);
+            a.Add(b);
+            Check.AreEqual(2L, a.Count, "Count after Add");
+            Check.AreEqual(long.MaxValue, a.Max, "Max after Add");
+
+            var copy = a.Clone();
+            a.Reset();
+            Check.AreEqual(0L, a.Count, "Count after Reset");
+            Check.AreEqual(2L, copy.Count, "a clone is independent");
+        }
+
+
+        /// <summary>
+        /// </summary>
+        public static void CoordinatedOmission()
+        {
+            var h = new P4Histogram();
+            h.Record(100);
+            var corrected = h.CopyCorrectedForCoordinatedOmission(10);
+            // 100 plus the 90, 80, ... 10 the stalled client never sent
+            Check.AreEqual(10L, corrected.Count, "corrected Count");
+            Check.AreEqual(550L, corrected.Sum, "corrected Sum");
+            Check.AreEqual(1L, h.Count, "original unchanged");
+        }
+
+    }
+
+}
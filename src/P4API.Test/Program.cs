@@ -1,44 +1,89 @@
-﻿using System;
-
-namespace P4API.Test
-{
-
-    /// <summary>
-    /// </summary>
-    public static class Program
-    {
-
-        /// <summary>
-        /// </summary>
-        static Program()
-        {
-            P4API.Bootstrapper.Initialize();
-        }
-
-
-        /// <summary>
-        /// </summary>
-        public static int Main(string[] args)
-        {
-            using (var c = new P4Connection())
-            {
-                try
-                {
-                    c.Connect();
-                }
-                catch (Exception ex)
-                {
-                    Console.ForegroundColor = ConsoleColor.Red;
-                    Console.Write(ex.GetType().FullName);
-                    Console.Write(": ");
-                    Console.WriteLine(ex.Message);
-                    Console.WriteLine(ex.StackTrace);
-                    Console.ResetColor();
-                }
-            }
-            return 0;
-        }
-
-    }
-
-}
+﻿using System;
+
+namespace P4API.Test
+{
+
+    /// <summary>
+    /// </summary>
+    public static class Program
+    {
+
+        /// <summary>
+        /// </summary>
+        static Program()
+        {
+            P4API.Bootstrapper.Initialize();
+        }
+
+
+        /// <summary>
+        /// </summary>
+        public static int Main(string[] args)
+        {
+            // offline tests first; none of them need a server
+            int failed = 0;
+            failed += RunTest("RecordFile.Plain", RecordFileTests.Plain);
+            failed += RunTest("RecordFile.Deflate", RecordFileTests.Deflate);
+            failed += RunTest("RecordFile.AbandonedFileIsDeleted", RecordFileTests.AbandonedFileIsDeleted);
+            failed += RunTest("RecordFile.MissingFooterWontOpen", RecordFileTests.MissingFooterWontOpen);
+            failed += RunTest("SnapshotCache.PinnedFileSpecs", SnapshotCacheTests.PinnedFileSpecs);
+            failed += RunTest("SnapshotCache.UnpinnedFileSpecs", SnapshotCacheTests.UnpinnedFileSpecs);
+            failed += RunTest("SnapshotCache.DepotName", SnapshotCacheTests.DepotName);
+            failed += RunTest("Scheduler.BulkLeavesReserveForInteractive", SchedulerTests.BulkLeavesReserveForInteractive);
+            failed += RunTest("Scheduler.KeysShareFairly", SchedulerTests.KeysShareFairly);
+            failed += RunTest("Scheduler.KeysShareByWeight", SchedulerTests.KeysShareByWeight);
+            failed += RunTest("DepotPathTrie.AddAndFind", DepotPathTrieTests.AddAndFind);
+            failed += RunTest("DepotPathTrie.CaseInsensitive", DepotPathTrieTests.CaseInsensitive);
+            failed += RunTest("DepotPathTrie.BadPaths", DepotPathTrieTests.BadPaths);
+            failed += RunTest("Histogram.Percentiles", HistogramTests.Percentiles);
+            failed += RunTest("Histogram.SmallValuesAreExact", HistogramTests.SmallValuesAreExact);
+            failed += RunTest("Histogram.AddCloneReset", HistogramTests.AddCloneReset);
+            failed += RunTest("Histogram.CoordinatedOmission", HistogramTests.CoordinatedOmission);
+            failed += RunTest("ServerTracking.Parse", ServerTrackingTests.Parse);
+            failed += RunTest("ServerTracking.OlderServerAndNoise", ServerTrackingTests.OlderServerAndNoise);
+
+            using (var c = new P4Connection())
+            {
+                try
+                {
+                    c.Connect();
+                }
+                catch (Exception ex)
+                {
+                    Console.ForegroundColor = ConsoleColor.Red;
+                    Console.Write(ex.GetType().FullName);
+                    Console.Write(": ");
+                    Console.WriteLine(ex.Message);
+                    Console.WriteLine(ex.StackTrace);
+                    Console.ResetColor();
+                }
+            }
+            return failed == 0 ? 0 : 1;
+        }
+
+
+        // Runs one test, printing its result; returns 1 if it failed.
+        private static int RunTest(string name, TestMethod test)
+        {
+            try
+            {
+                test();
+                Console.WriteLine("PASS " + name);
+                return 0;
+            }
+            catch (Exception ex)
+            {
+                Console.ForegroundColor = ConsoleColor.Red;
+                Console.Write("FAIL " + name + " - ");
+                Console.Write(ex.GetType().FullName);
+                Console.Write(": ");
+                Console.WriteLine(ex.Message);
+                Console.WriteLine(ex.StackTrace);
+                Console.ResetColor();
+                return 1;
+            }
+        }
+
+    }
+
+}
@@ -0,0 +1,168 @@
+﻿using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Text;
+
+namespace P4API.Test
+{
+
+    /// <summary>
+    /// Round trips through P4RecordFileWriter and P4RecordFile, with blocks encoded the way p4dn's RecordWriter does.
+    /// </summary>
+    public static class RecordFileTests
+    {
+
+        private static readonly string[] Strings = { "depotFile", "rev", "1" };
+
+
+        /// <summary>
+        /// </summary>
+        public static void Plain()
+        {
+            RoundTrip(false);
+        }
+
+
+        /// <summary>
+        /// </summary>
+        public static void Deflate()
+        {
+            RoundTrip(true);
+        }
+
+
+        /// <summary>
+        /// </summary>
+        public static void AbandonedFileIsDeleted()
+        {
+            string path = Path.GetTempFileName();
+            var writer = new P4RecordFileWriter(path, false);
+            WriteBlock(writer, Record(Inline("depotFile"), Inline("//depot/a.c")));
+            writer.Abandon();
+            Check.IsTrue(!File.Exists(path), "abandoned file is gone");
+        }
+
+
+        /// <summary>
+        /// </summary>
+        public static void MissingFooterWontOpen()
+        {
+            string path = Path.GetTempFileName();
+            try
+            {
+                var writer = new P4RecordFileWriter(path, false);
+                WriteBlock(writer, Record(Inline("depotFile"), Inline("//depot/a.c")));
+                writer.Dispose();
+                Check.Throws<InvalidDataException>(delegate { new P4RecordFile(path).Dispose(); }, "file without a footer");
+            }
+            finally
+            {
+                File.Delete(path);
+            }
+        }
+
+
+        private static void RoundTrip(bool compress)
+        {
+            string path = Path.GetTempFileName();
+            try
+            {
+                var writer = new P4RecordFileWriter(path, compress);
+
+                // keys and "1" from the string table, the rest inline; the second block has a non-ASCII path
+                WriteBlock(writer,
+                    Record(Table(0), Inline("//depot/a.c"), Table(1), Table(2)),
+                    Record(Table(0), Inline("//depot/b.c"), Table(1), Inline("12")));
+                WriteBlock(writer,
+                    Record(Table(0), Inline("//depot/ü.c"), Table(1), Table(2)));
+
+                var table = new MemoryStream();
+                foreach (string s in Strings)
+                {
+                    byte[] b = Encoding.UTF8.GetBytes(s);
+                    WriteVarint(table, b.Length);
+                    table.Write(b, 0, b.Length);
+                }
+                writer.WriteStrings(table.ToArray(), (int)table.Length, Strings.Length);
+                Check.AreEqual(3L, writer.Close(Encoding.UTF8.CodePage), "records written");
+
+                using (var file = new P4RecordFile(path))
+                {
+                    Check.AreEqual(3, file.Count, "Count");
+                    Check.AreEqual(compress, file.IsCompressed, "IsCompressed");
+                    Check.AreEqual("//depot/a.c", file[0].Fields["depotFile"], "record 0 depotFile");
+                    Check.AreEqual("1", file[0].Fields["rev"], "record 0 rev");
+                    Check.AreEqual("12", file[1].Fields["rev"], "record 1 rev");
+                    Check.AreEqual("//depot/ü.c", file[2].Fields["depotFile"], "record 2 depotFile");
+
+                    var paths = new List<string>();
+                    foreach (P4Record r in file)
+                    {
+                        paths.Add(r.Fields["depotFile"]);
+                    }
+                    Check.AreEqual("//depot/a.c|//depot/b.c|//depot/ü.c", string.Join("|", paths.ToArray()), "enumerated");
+                }
+            }
+            finally
+            {
+                File.Delete(path);
+            }
+        }
+
+
+        private static void WriteBlock(P4RecordFileWriter writer, params byte[][] records)
+        {
+            var block = new MemoryStream();
+            foreach (byte[] r in records)
+            {
+                block.Write(r, 0, r.Length);
+            }
+            writer.WriteBlock(block.ToArray(), (int)block.Length, records.Length);
+        }
+
+
+        // a record: the field count, then a key ref and a value ref per field
+        private static byte[] Record(params byte[][] refs)
+        {
+            var ms = new MemoryStream();
+            WriteVarint(ms, refs.Length / 2);
+            foreach (byte[] r in refs)
+            {
+                ms.Write(r, 0, r.Length);
+            }
+            return ms.ToArray();
+        }
+
+
+        private static byte[] Table(int id)
+        {
+            var ms = new MemoryStream();
+            WriteVarint(ms, id << 1);
+            return ms.ToArray();
+        }
+
+
+        private static byte[] Inline(string s)
+        {
+            byte[] b = Encoding.UTF8.GetBytes(s);
+            var ms = new MemoryStream();
+            WriteVarint(ms, (b.Length << 1) | 1);
+            ms.Write(b, 0, b.Length);
+            return ms.ToArray();
+        }
+
+
+        private static void WriteVarint(Stream s, int value)
+        {
+            uint v = (uint)value;
+            while (v >= 0x80)
+            {
+                s.WriteByte((byte)(v | 0x80));
+                v >>= 7;
+            }
+            s.WriteByte((byte)v);
+        }
+
+    }
+
+}
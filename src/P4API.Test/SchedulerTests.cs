@@ -0,0 +1,168 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Threading;
+
+namespace P4API.Test
+{
+
+    /// <summary>
+    /// P4CommandScheduler's interactive reserve and fair queueing.  The sessions are never connected; the work
+    /// doesn't use them.
+    /// </summary>
+    public static class SchedulerTests
+    {
+
+        private static readonly TimeSpan Timeout = TimeSpan.FromSeconds(10);
+
+        private delegate bool Condition();
+
+
+        /// <summary>
+        /// </summary>
+        public static void BulkLeavesReserveForInteractive()
+        {
+            var scheduler = new P4CommandScheduler(new P4Connection[] { new P4Connection(), new P4Connection() });
+            Check.AreEqual(1, scheduler.InteractiveReserve, "default reserve");
+            scheduler.QueueTimeout = Timeout;
+
+            var started = new ManualResetEvent(false);
+            var release = new ManualResetEvent(false);
+            var errors = new List<Exception>();
+            Thread crawler = Start(errors, delegate
+            {
+                scheduler.Execute(P4CommandPriority.Bulk, "crawler", delegate(P4Connection c)
+                {
+                    started.Set();
+                    release.WaitOne();
+                    return 0;
+                });
+            });
+            Check.IsTrue(started.WaitOne(Timeout, false), "first bulk command started");
+
+            // only the reserved session is idle, so more bulk work waits
+            Thread second = Start(errors, delegate
+            {
+                scheduler.Execute(P4CommandPriority.Bulk, "crawler", delegate(P4Connection c) { return 0; });
+            });
+            WaitFor(delegate { return scheduler.GetWaitingCount(P4CommandPriority.Bulk) == 1; }, "second bulk command queued");
+
+            // but interactive work gets it straight away
+            int result = scheduler.Execute(P4CommandPriority.Interactive, "user", delegate(P4Connection c) { return 42; });
+            Check.AreEqual(42, result, "interactive result");
+            Check.AreEqual(1, scheduler.GetWaitingCount(P4CommandPriority.Bulk), "bulk still waiting");
+
+            release.Set();
+            Join(errors, crawler, second);
+            Check.AreEqual(2L, scheduler.GetDispatchedCount(P4CommandPriority.Bulk), "bulk dispatched");
+            Check.AreEqual(1L, scheduler.GetDispatchedCount(P4CommandPriority.Interactive), "interactive dispatched");
+        }
+
+
+        /// <summary>
+        /// </summary>
+        public static void KeysShareFairly()
+        {
+            Check.AreEqual("a,b,a,b,a,a", RunQueued(1), "equal weights");
+        }
+
+
+        /// <summary>
+        /// </summary>
+        public static void KeysShareByWeight()
+        {
+            Check.AreEqual("b,a,b,a,a,a", RunQueued(2), "b weighted 2");
+        }
+
+
+        // One session, held while key a queues four commands and then key b two; returns the order they ran in.
+        private static string RunQueued(double weightOfB)
+        {
+            var scheduler = new P4CommandScheduler(new P4Connection[] { new P4Connection() });
+            scheduler.QueueTimeout = Timeout;
+            scheduler.SetWeight("b", weightOfB);
+
+            var started = new ManualResetEvent(false);
+            var release = new ManualResetEvent(false);
+            var errors = new List<Exception>();
+            var threads = new List<Thread>();
+            threads.Add(Start(errors, delegate
+            {
+                scheduler.Execute(P4CommandPriority.Normal, "x", delegate(P4Connection c)
+                {
+                    started.Set();
+                    release.WaitOne();
+                    return 0;
+                });
+            }));
+            Check.IsTrue(started.WaitOne(Timeout, false), "blocking command started");
+
+            var order = new List<string>();
+            foreach (string key in new string[] { "a", "a", "a", "a", "b", "b" })
+            {
+                string k = key;
+                int queued = threads.Count;
+                threads.Add(Start(errors, delegate
+                {
+                    scheduler.Execute(P4CommandPriority.Normal, k, delegate(P4Connection c)
+                    {
+                        lock (order)
+                        {
+                            order.Add(k);
+                        }
+                        return 0;
+                    });
+                }));
+                WaitFor(delegate { return scheduler.GetWaitingCount(P4CommandPriority.Normal) == queued; }, "queued " + queued);
+            }
+
+            release.Set();
+            Join(errors, threads.ToArray());
+            return string.Join(",", order.ToArray());
+        }
+
+
+        private static Thread Start(List<Exception> errors, ThreadStart work)
+        {
+            var t = new Thread(delegate()
+            {
+                try
+                {
+                    work();
+                }
+                catch (Exception e)
+                {
+                    lock (errors)
+                    {
+                        errors.Add(e);
+                    }
+                }
+            });
+            t.IsBackground = true;
+            t.Start();
+            return t;
+        }
+
+
+        private static void Join(List<Exception> errors, params Thread[] threads)
+        {
+            foreach (Thread t in threads)
+            {
+                Check.IsTrue(t.Join(Timeout), "thread finished");
+            }
+            if (errors.Count > 0) throw errors[0];
+        }
+
+
+        private static void WaitFor(Condition condition, string what)
+        {
+            DateTime end = DateTime.Now + Timeout;
+            while (!condition())
+            {
+                if (DateTime.Now > end) throw new Exception("Timed out waiting: " + what);
+                Thread.Sleep(10);
+            }
+        }
+
+    }
+
+}
@@ -0,0 +1,83 @@
+﻿using System;
+
+namespace P4API.Test
+{
+
+    /// <summary>
+    /// Parsing the server's tracking block into P4ServerTracking.
+    /// </summary>
+    public static class ServerTrackingTests
+    {
+
+        private const string Block =
+            "--- lapse .044s\n" +
+            "--- usage 10+11us 12+13io 14+15net 4104k 3pf\n" +
+            "--- rpc msgs/size in+out 2+3/4mb+5mb himarks 318788/318788 snd/rcv .001s/.002s\n" +
+            "--- db.rev\n" +
+            "---   pages in+out+cached 3+1+2\n" +
+            "---   locks read/write 1/0 rows get+pos+scan put+del 1+2+3 4+5\n" +
+            "---   total lock wait+held read/write 6ms+7ms/8ms+9ms\n" +
+            "---   max lock wait+held read/write 1ms+2ms/3ms+4ms\n" +
+            "--- db.counters\n" +
+            "---   pages in+out+cached 1+0+0\n";
+
+
+        /// <summary>
+        /// </summary>
+        public static void Parse()
+        {
+            var t = new P4ServerTracking(Block);
+            Check.AreEqual(10, t.Lines.Length, "Lines");
+            Check.AreEqual(TimeSpan.FromMilliseconds(44), t.Lapse, "Lapse");
+            Check.AreEqual(TimeSpan.FromMilliseconds(10), t.UserTime, "UserTime");
+            Check.AreEqual(TimeSpan.FromMilliseconds(11), t.SystemTime, "SystemTime");
+            Check.AreEqual(12L, t.IoIn, "IoIn");
+            Check.AreEqual(13L, t.IoOut, "IoOut");
+            Check.AreEqual(14L, t.NetIn, "NetIn");
+            Check.AreEqual(15L, t.NetOut, "NetOut");
+            Check.AreEqual(4104L, t.MaxMemoryKB, "MaxMemoryKB");
+            Check.AreEqual(3L, t.PageFaults, "PageFaults");
+            Check.AreEqual(2L, t.RpcMessagesIn, "RpcMessagesIn");
+            Check.AreEqual(3L, t.RpcMessagesOut, "RpcMessagesOut");
+            Check.AreEqual(4L, t.RpcMBIn, "RpcMBIn");
+            Check.AreEqual(5L, t.RpcMBOut, "RpcMBOut");
+            Check.AreEqual(TimeSpan.FromMilliseconds(1), t.RpcSendTime, "RpcSendTime");
+            Check.AreEqual(TimeSpan.FromMilliseconds(2), t.RpcReceiveTime, "RpcReceiveTime");
+
+            P4TrackedTable[] tables = t.Tables;
+            Check.AreEqual(2, tables.Length, "Tables");
+            P4TrackedTable rev = tables[0];
+            Check.AreEqual("db.rev", rev.Name, "Name");
+            Check.AreEqual(3L, rev.PagesRead, "PagesRead");
+            Check.AreEqual(1L, rev.PagesWritten, "PagesWritten");
+            Check.AreEqual(2L, rev.PagesFromCache, "PagesFromCache");
+            Check.AreEqual(1L, rev.ReadLocks, "ReadLocks");
+            Check.AreEqual(0L, rev.WriteLocks, "WriteLocks");
+            Check.AreEqual(6L, rev.RowsRead, "RowsRead");
+            Check.AreEqual(9L, rev.RowsWritten, "RowsWritten");
+            Check.AreEqual(TimeSpan.FromMilliseconds(6), rev.ReadLockWait, "ReadLockWait");
+            Check.AreEqual(TimeSpan.FromMilliseconds(7), rev.ReadLockHeld, "ReadLockHeld");
+            Check.AreEqual(TimeSpan.FromMilliseconds(8), rev.WriteLockWait, "WriteLockWait");
+            Check.AreEqual(TimeSpan.FromMilliseconds(9), rev.WriteLockHeld, "WriteLockHeld");
+            Check.AreEqual(TimeSpan.FromMilliseconds(1), rev.MaxReadLockWait, "MaxReadLockWait");
+            Check.AreEqual(TimeSpan.FromMilliseconds(3), rev.MaxWriteLockWait, "MaxWriteLockWait");
+            Check.AreEqual(1L, tables[1].PagesRead, "second table");
+            Check.AreEqual(TimeSpan.FromMilliseconds(14), t.TotalLockWait, "TotalLockWait");
+        }
+
+
+        /// <summary>
+        /// </summary>
+        public static void OlderServerAndNoise()
+        {
+            // older servers send less; anything not a tracking line is left out
+            var t = new P4ServerTracking("info line\n--- lapse 1.5s\n--- rpc\n--- unknown 1 2 3\n");
+            Check.AreEqual(3, t.Lines.Length, "Lines");
+            Check.AreEqual(TimeSpan.FromSeconds(1.5), t.Lapse, "Lapse");
+            Check.AreEqual(0L, t.RpcMessagesIn, "missing fields read as zero");
+            Check.AreEqual(0, t.Tables.Length, "no tables");
+        }
+
+    }
+
+}
@@ -0,0 +1,78 @@
+﻿using System;
+
+namespace P4API.Test
+{
+
+    /// <summary>
+    /// Which commands P4SnapshotCache treats as pinned to history.
+    /// </summary>
+    public static class SnapshotCacheTests
+    {
+
+        /// <summary>
+        /// </summary>
+        public static void PinnedFileSpecs()
+        {
+            Pinned(123, "files", "//depot/...@123");
+            Pinned(200, "files", "//depot/main/...@100,@200");
+            Pinned(0, "print", "//depot/main/a.c#3");
+            Pinned(0, "annotate", "//depot/main/a.c#1,#3");
+            Pinned(7, "files", "-a", "//depot/main/a.c@7", "//depot/rel/b.c#2");
+        }
+
+
+        /// <summary>
+        /// </summary>
+        public static void UnpinnedFileSpecs()
+        {
+            NotPinned("files", "//depot/...");
+            NotPinned("files", "//depot/...@now");
+            NotPinned("files", "//depot/...@=5");
+            NotPinned("files", "//depot/...@label");
+            NotPinned("files", "main/a.c@5");
+            NotPinned("files", "//depot/main/a.c@5", "//depot/main/b.c");
+            NotPinned("print", "-o", "out.c", "//depot/main/a.c@5");
+            NotPinned("sync", "//depot/...@5");
+            NotPinned("files", "-m", "1");
+
+            // filelog gains later integrations, describe later fixes
+            NotPinned("filelog", "//depot/main/a.c#3");
+            NotPinned("describe", "-s", "5");
+
+            // a file added later can match a wildcard at its own #N
+            NotPinned("files", "//depot/...#3");
+            NotPinned("files", "//depot/main/*.c#1");
+            NotPinned("files", "//depot/%%1/a.c#1");
+        }
+
+
+        /// <summary>
+        /// </summary>
+        public static void DepotName()
+        {
+            Check.AreEqual("depot", P4SnapshotCache.GetDepotName("//depot/main/...@5"), "//depot/main/...@5");
+            Check.AreEqual(null, P4SnapshotCache.GetDepotName("//depot@5"), "//depot@5");
+            Check.AreEqual(null, P4SnapshotCache.GetDepotName("///a.c@5"), "///a.c@5");
+            Check.AreEqual(null, P4SnapshotCache.GetDepotName("main/a.c@5"), "main/a.c@5");
+        }
+
+
+        private static void Pinned(long expected, string command, params string[] args)
+        {
+            long change;
+            string what = command + " " + string.Join(" ", args);
+            Check.IsTrue(P4SnapshotCache.IsPinned(command, args, out change), what);
+            Check.AreEqual(expected, change, what + " change");
+        }
+
+
+        private static void NotPinned(string command, params string[] args)
+        {
+            long change;
+            Check.IsTrue(!P4SnapshotCache.IsPinned(command, args, out change),
+                "not pinned: " + command + " " + string.Join(" ", args));
+        }
+
+    }
+
+}
@@ -1,68 +1,73 @@
-/*
- * P4.Net *
-Copyright (c) 2007-2010 Shawn Hladky
-
-Permission is hereby granted, free of charge, to any person obtaining a copy of this software
-and associated documentation files (the "Software"), to deal in the Software without
-restriction, including without limitation the rights to use, copy, modify, merge, publish,
-distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
-Software is furnished to do so, subject to the following conditions:
-
-The above copyright notice and this permission notice shall be included in all copies or
-substantial portions of the Software.
-
-THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
-BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
-NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
-DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
-OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
- */
-
-
-using System.Reflection;
-using System.Runtime.InteropServices;
-
-// General Information about an assembly is controlled through the following
-// set of attributes. Change these attribute values to modify the information
-// associated with an assembly.
-[assembly: AssemblyTitle("P4.Net P4API")]
-[assembly: AssemblyDescription("P4.Net P4API")]
-[assembly: AssemblyCompany("")]
-[assembly: AssemblyCopyright("Copyright (c) 2007-2011 Shawn Hladky")]
-[assembly: AssemblyTrademark("")]
-[assembly: AssemblyCulture("")]
-
-// Setting ComVisible to false makes the types in this assembly not visible
-// to COM components.  If you need to access a type in this assembly from
-// COM, set the ComVisible attribute to true on that type.
-[assembly: ComVisible(false)]
-
-// The following GUID is for the ID of the typelib if this project is exposed to COM
-[assembly: Guid("262e437e-352a-40dc-abbe-876930b73c2a")]
-
-// Version information for an assembly consists of the following four values:
-//
-//      Major Version
-//      Minor Version
-//      Build Number
-//      Revision
-//
-// You can specify all the values or you can default the Revision and Build Numbers
-// by using the '*' as shown below:
-[assembly: AssemblyVersion("2.0.0.0")]
-[assembly: AssemblyFileVersion("2.0.0.3")]
-[assembly: AssemblyProduct("P4.Net v2.0.0 "
-#if DEBUG
-	+ "(debug)"
-#else
-	+ "(release)"
-#endif
-)]
-
-[assembly: AssemblyConfiguration(
-#if DEBUG
-	"DEBUG"
-#else
-	"RELEASE"
-#endif
-)]
+/*
+ * P4.Net *
+Copyright (c) 2007-2010 Shawn Hladky
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+and associated documentation files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+using System.Reflection;
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+
+// General Information about an assembly is controlled through the following
+// set of attributes. Change these attribute values to modify the information
+// associated with an assembly.
+[assembly: AssemblyTitle("P4.Net P4API")]
+[assembly: AssemblyDescription("P4.Net P4API")]
+[assembly: AssemblyCompany("")]
+[assembly: AssemblyCopyright("Copyright (c) 2007-2011 Shawn Hladky")]
+[assembly: AssemblyTrademark("")]
+[assembly: AssemblyCulture("")]
+
+// Setting ComVisible to false makes the types in this assembly not visible
+// to COM components.  If you need to access a type in this assembly from
+// COM, set the ComVisible attribute to true on that type.
+[assembly: ComVisible(false)]
+
+// The following GUID is for the ID of the typelib if this project is exposed to COM
+[assembly: Guid("262e437e-352a-40dc-abbe-876930b73c2a")]
+
+// The benchmark project drives P4Record.Reset directly; the offline tests reach the parsers and file format.
+[assembly: InternalsVisibleTo("P4API.Benchmark, PublicKey=0024000004800000940000000602000000240000525341310004000001000100959fe9a18a54bf98a2bb25cb740dbfa3b4963d45eca80221e092cd18e412c89787aec8c674c3ec74b19c9d1816dca4588d45842320e7716b84f1a9bd16c17e5b1b01d23d1f7f2e9129d73130fc51f051be44c5502e20375322108ea2bcab4b17795987467dc41cd61085e494fe393ed1e78ed3509719c79a21398a41c24acacc")]
+[assembly: InternalsVisibleTo("P4API.Test, PublicKey=0024000004800000940000000602000000240000525341310004000001000100959fe9a18a54bf98a2bb25cb740dbfa3b4963d45eca80221e092cd18e412c89787aec8c674c3ec74b19c9d1816dca4588d45842320e7716b84f1a9bd16c17e5b1b01d23d1f7f2e9129d73130fc51f051be44c5502e20375322108ea2bcab4b17795987467dc41cd61085e494fe393ed1e78ed3509719c79a21398a41c24acacc")]
+
+// Version information for an assembly consists of the following four values:
+//
+//      Major Version
+//      Minor Version
+//      Build Number
+//      Revision
+//
+// You can specify all the values or you can default the Revision and Build Numbers
+// by using the '*' as shown below:
+[assembly: AssemblyVersion("2.0.0.0")]
+[assembly: AssemblyFileVersion("2.0.0.3")]
+[assembly: AssemblyProduct("P4.Net v2.0.0 "
+#if DEBUG
+	+ "(debug)"
+#else
+	+ "(release)"
+#endif
+)]
+
+[assembly: AssemblyConfiguration(
+#if DEBUG
+	"DEBUG"
+#else
+	"RELEASE"
+#endif
+)]
@@ -0,0 +1,149 @@
+/*
+ * P4.Net *
+Copyright (c) 2007-2010 Shawn Hladky
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+and associated documentation files (the "Software"), to deal in the Software without 
+restriction, including without limitation the rights to use, copy, modify, merge, publish, 
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or 
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+ */
+
+
+using System;
+
+namespace P4API
+{
+    /// <summary>
+    /// Arguments provided for a <see cref="P4ChangeFeed.OnChange"/> event: one submitted change, as reported by describe -s.
+    /// </summary>
+    public class P4ChangeEventArgs : EventArgs
+    {
+        private int _change;
+        private P4Record _record;
+        private DateTime _time;
+
+        //don't allow to be created outside this assembly
+        internal P4ChangeEventArgs(int change, P4Record record, DateTime time)
+        {
+            _change = change;
+            _record = record;
+            _time = time;
+        }
+
+        /// <summary>
+        /// The change number.
+        /// </summary>
+        public int Change
+        {
+            get
+            {
+                return _change;
+            }
+        }
+
+        /// <summary>
+        /// The user who submitted the change.
+        /// </summary>
+        public string User
+        {
+            get
+            {
+                return _record.Fields["user"];
+            }
+        }
+
+        /// <summary>
+        /// The client workspace the change was submitted from.
+        /// </summary>
+        public string Client
+        {
+            get
+            {
+                return _record.Fields["client"];
+            }
+        }
+
+        /// <summary>
+        /// When the change was submitted, in the client's time zone.
+        /// </summary>
+        public DateTime Time
+        {
+            get
+            {
+                return _time;
+            }
+        }
+
+        /// <summary>
+        /// The change description.
+        /// </summary>
+        public string Description
+        {
+            get
+            {
+                return _record.Fields["desc"];
+            }
+        }
+
+        /// <summary>
+        /// The depot paths of the files in the change.
+        /// </summary>
+        public string[] DepotFiles
+        {
+            get
+            {
+                return GetArray("depotFile");
+            }
+        }
+
+        /// <summary>
+        /// The action on each file (add, edit, delete, ...), in the same order as <see cref="DepotFiles"/>.
+        /// </summary>
+        public string[] Actions
+        {
+            get
+            {
+                return GetArray("action");
+            }
+        }
+
+        /// <summary>
+        /// The revision of each file, in the same order as <see cref="DepotFiles"/>.
+        /// </summary>
+        public string[] Revisions
+        {
+            get
+            {
+                return GetArray("rev");
+            }
+        }
+
+        /// <summary>
+        /// The full describe record.
+        /// </summary>
+        public P4Record Record
+        {
+            get
+            {
+                return _record;
+            }
+        }
+
+        private string[] GetArray(string name)
+        {
+            // a change with no visible files has no array fields at all
+            string[] value = _record.ArrayFields[name];
+            return (value == null) ? new string[0] : (string[])value.Clone();
+        }
+    }
+}
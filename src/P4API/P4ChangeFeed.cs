@@ -0,0 +1,461 @@
+/*
+ * P4.Net *
+Copyright (c) 2007-2010 Shawn Hladky
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+and associated documentation files (the "Software"), to deal in the Software without 
+restriction, including without limitation the rights to use, copy, modify, merge, publish, 
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or 
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+ */
+
+
+using System;
+using System.Collections.Generic;
+using System.Globalization;
+using System.IO;
+using System.Text;
+using System.Threading;
+
+namespace P4API
+{
+    /// <summary>
+    /// Delegate to handle the OnChange event.
+    /// </summary>
+    /// <param name="sender">The <see cref="P4ChangeFeed"/>.</param>
+    /// <param name="args">P4ChangeEventArgs</param>
+    public delegate void OnChangeEventHandler(object sender, P4ChangeEventArgs args);
+
+    /// <summary>
+    /// Delivers newly submitted changes, in order, each with its file list.
+    /// </summary>
+    /// <remarks>
+    /// <para>Create one with <see cref="P4Connection.CreateChangeFeed"/>.  The feed remembers the last change it
+    /// delivered (<see cref="Position"/>).  Each poll reads the cheap "change" counter first; only when it is past
+    /// Position does it ask for the submitted changes after Position, and then describes them <see cref="BatchSize"/>
+    /// at a time with one multi-argument describe -s.</para>
+    /// <para>A change's number is taken when its submit starts, so a lower-numbered change can finish after a higher
+    /// one has been delivered.  Each query also looks back <see cref="RescanWindow"/> changes below Position (at least
+    /// every <see cref="MaxPollInterval"/>, even when the counter hasn't moved) and delivers any it hasn't delivered
+    /// yet; such a change arrives after higher-numbered ones.</para>
+    /// <para>Call <see cref="Poll"/> yourself, or <see cref="Start"/> a background thread that polls every
+    /// <see cref="MinPollInterval"/> while changes keep coming, backing off to <see cref="MaxPollInterval"/> when
+    /// they don't.  The server has no way to wait for a change, so this is as close to a long poll as it gets.</para>
+    /// <para>With a <see cref="CheckpointFile"/>, Position is read from it when the feed is created and written after
+    /// each batch, so a consumer that restarts carries on where it left off.  Delivery is at least once: a change
+    /// whose handler was running when the process died is delivered again.</para>
+    /// <para>The feed has the connection to itself while it polls.  Changes the user can't describe are skipped.</para>
+    /// </remarks>
+    public class P4ChangeFeed : IDisposable
+    {
+        private readonly P4Connection _connection;
+        private readonly string[] _paths;
+        private readonly object _pollLock = new object();
+        private int _position;
+        private Dictionary<int, bool> _handled = null;
+        private DateTime _nextRescan = DateTime.MinValue;
+        private int _batchSize = 50;
+        private int _rescanWindow = 100;
+        private TimeSpan _minPollInterval = TimeSpan.FromSeconds(1);
+        private TimeSpan _maxPollInterval = TimeSpan.FromSeconds(30);
+        private string _checkpointFile = null;
+        private Exception _lastError = null;
+        private Thread _thread = null;
+        private ManualResetEvent _stop = null;
+
+        /// <summary>
+        /// Raised for each new submitted change, oldest first.
+        /// </summary>
+        /// <remarks>Raised on the thread that polls.  Position has not moved past the change until the handler returns.</remarks>
+        public event OnChangeEventHandler OnChange;
+
+        internal P4ChangeFeed(P4Connection connection, string[] paths, int position)
+        {
+            _connection = connection;
+            _paths = paths;
+            _position = position;
+        }
+
+        #region Public Properties
+        /// <summary>
+        /// Gets/Sets the last change delivered.  The next poll delivers the submitted changes after it.
+        /// </summary>
+        /// <remarks>Setting Position while the feed is started takes effect at the next poll.</remarks>
+        public int Position
+        {
+            get
+            {
+                return _position;
+            }
+            set
+            {
+                if (value < 0) throw new ArgumentOutOfRangeException("value");
+                lock (_pollLock)
+                {
+                    _position = value;
+                    _handled = null;
+                    _nextRescan = DateTime.MinValue;
+                }
+            }
+        }
+
+        /// <summary>
+        /// Gets/Sets how many changes each describe asks for.
+        /// </summary>
+        /// <value>Defaults to 50.</value>
+        public int BatchSize
+        {
+            get
+            {
+                return _batchSize;
+            }
+            set
+            {
+                if (value < 1) throw new ArgumentOutOfRangeException("value");
+                _batchSize = value;
+            }
+        }
+
+        /// <summary>
+        /// Gets/Sets how many change numbers below <see cref="Position"/> are looked at again for submits that
+        /// finished late.
+        /// </summary>
+        /// <value>Defaults to 100.  0 turns the look back off.</value>
+        /// <remarks>When the feed doesn't know which of those it delivered (a new feed, or Position was set), the ones
+        /// already submitted are taken as delivered.</remarks>
+        public int RescanWindow
+        {
+            get
+            {
+                return _rescanWindow;
+            }
+            set
+            {
+                if (value < 0) throw new ArgumentOutOfRangeException("value");
+                _rescanWindow = value;
+            }
+        }
+
+        /// <summary>
+        /// Gets/Sets the wait between polls while changes are arriving.
+        /// </summary>
+        /// <value>Defaults to 1 second.</value>
+        public TimeSpan MinPollInterval
+        {
+            get
+            {
+                return _minPollInterval;
+            }
+            set
+            {
+                if (value < TimeSpan.Zero) throw new ArgumentOutOfRangeException("value");
+                _minPollInterval = value;
+            }
+        }
+
+        /// <summary>
+        /// Gets/Sets the longest wait between polls when nothing is happening (or the server is failing).
+        /// </summary>
+        /// <value>Defaults to 30 seconds.</value>
+        public TimeSpan MaxPollInterval
+        {
+            get
+            {
+                return _maxPollInterval;
+            }
+            set
+            {
+                if (value < TimeSpan.Zero) throw new ArgumentOutOfRangeException("value");
+                _maxPollInterval = value;
+            }
+        }
+
+        /// <summary>
+        /// Gets/Sets the file Position is saved to after each batch.  Setting it loads the position saved there, if any.
+        /// </summary>
+        /// <value>Defaults to null (no checkpoint).</value>
+        public string CheckpointFile
+        {
+            get
+            {
+                return _checkpointFile;
+            }
+            set
+            {
+                lock (_pollLock)
+                {
+                    _checkpointFile = value;
+                    if (value != null && File.Exists(value))
+                    {
+                        LoadCheckpoint(value);
+                    }
+                }
+            }
+        }
+
+        /// <summary>
+        /// Gets the exception that stopped the last background poll, or null if it succeeded.
+        /// </summary>
+        public Exception LastError
+        {
+            get
+            {
+                return _lastError;
+            }
+        }
+        #endregion
+
+        #region Public Methods
+        /// <summary>
+        /// Delivers the changes submitted since <see cref="Position"/>, and any within <see cref="RescanWindow"/> of
+        /// it that finished late.
+        /// </summary>
+        /// <returns>The number of changes delivered.</returns>
+        public int Poll()
+        {
+            lock (_pollLock)
+            {
+                P4RecordSet counter = _connection.Run("counter", "change");
+                long value = long.Parse(counter.Records[0].Fields["value"], CultureInfo.InvariantCulture);
+
+                // the counter also moves for new pending changes, so past Position only says there may be something;
+                // a late submit below Position doesn't move it at all, hence the periodic look back
+                if (value <= _position && (_rescanWindow == 0 || DateTime.UtcNow < _nextRescan)) return 0;
+                _nextRescan = DateTime.UtcNow + _maxPollInterval;
+
+                List<int> changes = GetNewChanges();
+                int delivered = 0;
+                for (int i = 0; i < changes.Count; i += _batchSize)
+                {
+                    delivered += Describe(changes.GetRange(i, Math.Min(_batchSize, changes.Count - i)));
+                    SaveCheckpoint();
+                }
+                return delivered;
+            }
+        }
+
+        /// <summary>
+        /// Starts polling on a background thread.
+        /// </summary>
+        public void Start()
+        {
+            if (_thread != null) throw new InvalidOperationException("The change feed is already started.");
+
+            _stop = new ManualResetEvent(false);
+            _thread = new Thread(PollLoop);
+            _thread.IsBackground = true;
+            _thread.Name = "P4ChangeFeed";
+            _thread.Start();
+        }
+
+        /// <summary>
+        /// Stops the background thread, waiting for the current poll (and its handlers) to finish.
+        /// </summary>
+        public void Stop()
+        {
+            if (_thread == null) return;
+            _stop.Set();
+            _thread.Join();
+            _stop.Close();
+            _thread = null;
+            _stop = null;
+        }
+
+        /// <summary>
+        /// Calls Stop.
+        /// </summary>
+        public void Dispose()
+        {
+            Stop();
+        }
+        #endregion
+
+        #region Private Helper Methods
+        // Records a change below Position as already delivered (P4ChangeHistory knows what it has stored).
+        internal void MarkHandled(int change)
+        {
+            lock (_pollLock)
+            {
+                if (_handled == null) _handled = new Dictionary<int, bool>();
+                _handled[change] = true;
+            }
+        }
+
+        private void PollLoop()
+        {
+            TimeSpan wait = _minPollInterval;
+            while (!_stop.WaitOne(wait, false))
+            {
+                try
+                {
+                    int delivered = Poll();
+                    _lastError = null;
+                    wait = (delivered > 0) ? _minPollInterval : Backoff(wait);
+                }
+                catch (Exception e)
+                {
+                    _lastError = e;
+                    wait = Backoff(wait);
+                }
+            }
+        }
+
+        private TimeSpan Backoff(TimeSpan wait)
+        {
+            TimeSpan next = TimeSpan.FromTicks(Math.Max(wait.Ticks * 2, TimeSpan.TicksPerMillisecond));
+            return (next > _maxPollInterval) ? _maxPollInterval : next;
+        }
+
+        // Submitted changes after Position, and those in the window below it not delivered yet, oldest first.
+        private List<int> GetNewChanges()
+        {
+            int from = Math.Max(_position + 1 - _rescanWindow, 1);
+            string range = string.Format(CultureInfo.InvariantCulture, "@{0},@now", from);
+            List<string> args = new List<string>();
+            args.Add("-s");
+            args.Add("submitted");
+            if (_paths.Length == 0)
+            {
+                args.Add("//..." + range);
+            }
+            foreach (string path in _paths)
+            {
+                args.Add(path + range);
+            }
+
+            bool known = (_handled != null);
+            if (!known) _handled = new Dictionary<int, bool>();
+
+            // from Position 0 this is every change on the server, so no list scans
+            List<int> changes = new List<int>();
+            Dictionary<int, bool> listed = new Dictionary<int, bool>();
+            foreach (P4Record r in _connection.Run("changes", args.ToArray()))
+            {
+                int change = int.Parse(r.Fields["change"], CultureInfo.InvariantCulture);
+                if (change <= _position)
+                {
+                    // without a record of what was delivered, what's there already counts as delivered
+                    if (!known) _handled[change] = true;
+                    if (_handled.ContainsKey(change)) continue;
+                }
+                // a change under several of the paths is listed once for each
+                if (listed.ContainsKey(change)) continue;
+                listed.Add(change, true);
+                changes.Add(change);
+            }
+            changes.Sort();
+            return changes;
+        }
+
+        private int Describe(List<int> batch)
+        {
+            string[] args = new string[batch.Count + 1];
+            args[0] = "-s";
+            for (int i = 0; i < batch.Count; i++)
+            {
+                args[i + 1] = batch[i].ToString(CultureInfo.InvariantCulture);
+            }
+
+            P4RecordSet described;
+            P4ExceptionLevels level = _connection.ExceptionLevel;
+            _connection.ExceptionLevel = P4ExceptionLevels.NoExceptionOnErrors;
+            try
+            {
+                described = _connection.Run("describe", args);
+            }
+            finally
+            {
+                _connection.ExceptionLevel = level;
+            }
+
+            Dictionary<int, P4Record> byChange = new Dictionary<int, P4Record>();
+            foreach (P4Record r in described)
+            {
+                byChange[int.Parse(r.Fields["change"], CultureInfo.InvariantCulture)] = r;
+            }
+
+            int delivered = 0;
+            foreach (int change in batch)
+            {
+                P4Record r;
+                if (byChange.TryGetValue(change, out r))
+                {
+                    if (OnChange != null)
+                    {
+                        OnChange(this, new P4ChangeEventArgs(change, r, _connection.ConvertDate(r.Fields["time"])));
+                    }
+                    delivered++;
+                }
+                _handled[change] = true;
+                if (change > _position) _position = change;
+            }
+
+            List<int> old = new List<int>();
+            foreach (int change in _handled.Keys)
+            {
+                if (change <= _position - _rescanWindow) old.Add(change);
+            }
+            foreach (int change in old)
+            {
+                _handled.Remove(change);
+            }
+            return delivered;
+        }
+
+        private void SaveCheckpoint()
+        {
+            if (_checkpointFile == null) return;
+
+            // Position, then the changes in the window below it already delivered
+            StringBuilder text = new StringBuilder();
+            text.Append(_position.ToString(CultureInfo.InvariantCulture)).Append('\n');
+            List<int> handled = new List<int>(_handled.Keys);
+            handled.Sort();
+            for (int i = 0; i < handled.Count; i++)
+            {
+                if (i > 0) text.Append(',');
+                text.Append(handled[i].ToString(CultureInfo.InvariantCulture));
+            }
+
+            // write then rename, so a crash never leaves half a number behind
+            string temp = _checkpointFile + ".tmp";
+            File.WriteAllText(temp, text.ToString());
+            if (File.Exists(_checkpointFile))
+            {
+                File.Replace(temp, _checkpointFile, null);
+            }
+            else
+            {
+                File.Move(temp, _checkpointFile);
+            }
+        }
+
+        private void LoadCheckpoint(string file)
+        {
+            string[] lines = File.ReadAllText(file).Split('\n');
+            _position = int.Parse(lines[0].Trim(), CultureInfo.InvariantCulture);
+            _nextRescan = DateTime.MinValue;
+
+            // a checkpoint from before the window was kept has only the position
+            _handled = null;
+            if (lines.Length > 1)
+            {
+                _handled = new Dictionary<int, bool>();
+                foreach (string change in lines[1].Split(','))
+                {
+                    if (change.Trim().Length > 0) _handled[int.Parse(change.Trim(), CultureInfo.InvariantCulture)] = true;
+                }
+            }
+        }
+        #endregion
+    }
+}
@@ -0,0 +1,519 @@
+/*
+ * P4.Net *
+Copyright (c) 2007-2010 Shawn Hladky
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+and associated documentation files (the "Software"), to deal in the Software without 
+restriction, including without limitation the rights to use, copy, modify, merge, publish, 
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or 
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+ */
+
+
+using System;
+using System.Collections.Generic;
+using System.Globalization;
+using System.IO;
+using System.Text;
+#if CLR4
+using System.IO.MemoryMappedFiles;
+#endif
+
+namespace P4API
+{
+    /// <summary>
+    /// Local, append-only store of submitted changes, filled incrementally from the server.
+    /// </summary>
+    /// <remarks>
+    /// <para>Submitted changes don't change, so tools that keep asking for years of changes and describes can ask
+    /// the store instead.  <see cref="Sync"/> appends the changes submitted since the last one stored (its high-water
+    /// mark, <see cref="LastChange"/>), described in batches by a <see cref="P4ChangeFeed"/>.
+    /// <see cref="GetChanges(P4Connection, string, string, string, DateTime, DateTime, int)"/> syncs that tail and then
+    /// answers from the store.</para>
+    /// <para>Changes are indexed in memory by number, user, client, time and depot path root (the first two levels,
+    /// e.g. //depot/main); the records themselves stay on disk and are read through a memory-mapped view (a plain
+    /// file stream in the .NET 2.0 build).</para>
+    /// <para>One process at a time may open a store.  A record cut short by a crash is dropped when the store is
+    /// opened again.  All members are thread safe.</para>
+    /// </remarks>
+    public class P4ChangeHistory : IDisposable
+    {
+        private const byte FormatVersion = 1;
+        private static readonly byte[] Magic = Encoding.ASCII.GetBytes("P4HIST");
+        private static readonly DateTime Epoch = new DateTime(1970, 1, 1, 0, 0, 0, DateTimeKind.Utc);
+
+        private readonly object _lock = new object();
+        private readonly string _path;
+        private FileStream _file;
+#if CLR4
+        private MemoryMappedFile _map = null;
+        private MemoryMappedViewStream _view = null;
+        private long _mappedLength = 0;
+#else
+        private FileStream _reader;
+#endif
+        private int _syncBatchSize = 200;
+
+        // index: position i is the i-th change by number, wherever its record is in the file
+        private readonly List<long> _offsets = new List<long>();
+        private readonly List<int> _changes = new List<int>();
+        private readonly List<int> _times = new List<int>();
+        private readonly Dictionary<string, List<int>> _byUser = new Dictionary<string, List<int>>();
+        private readonly Dictionary<string, List<int>> _byClient = new Dictionary<string, List<int>>();
+        private readonly Dictionary<string, List<int>> _byRoot = new Dictionary<string, List<int>>();
+
+        /// <summary>
+        /// Opens (or creates) a change history store.
+        /// </summary>
+        /// <param name="path">The store's file.</param>
+        public P4ChangeHistory(string path)
+        {
+            if (path == null) throw new ArgumentNullException("path");
+            _path = Path.GetFullPath(path);
+
+            _file = new FileStream(_path, FileMode.OpenOrCreate, FileAccess.ReadWrite, FileShare.Read);
+            try
+            {
+                if (_file.Length == 0)
+                {
+                    _file.Write(Magic, 0, Magic.Length);
+                    _file.WriteByte(FormatVersion);
+                    _file.Flush();
+                }
+#if !CLR4
+                _reader = new FileStream(_path, FileMode.Open, FileAccess.Read, FileShare.ReadWrite);
+#endif
+                Load();
+            }
+            catch
+            {
+                Dispose();
+                throw;
+            }
+        }
+
+        #region Public Properties
+        /// <summary>
+        /// Gets the store's file.
+        /// </summary>
+        public string Path
+        {
+            get
+            {
+                return _path;
+            }
+        }
+
+        /// <summary>
+        /// Gets the number of changes stored.
+        /// </summary>
+        public int Count
+        {
+            get
+            {
+                lock (_lock)
+                {
+                    return _changes.Count;
+                }
+            }
+        }
+
+        /// <summary>
+        /// Gets the last (highest) change stored, or 0 for an empty store.
+        /// </summary>
+        public int LastChange
+        {
+            get
+            {
+                lock (_lock)
+                {
+                    return (_changes.Count == 0) ? 0 : _changes[_changes.Count - 1];
+                }
+            }
+        }
+
+        /// <summary>
+        /// Gets/Sets how many changes each describe asks for while syncing.
+        /// </summary>
+        /// <value>Defaults to 200.</value>
+        public int SyncBatchSize
+        {
+            get
+            {
+                return _syncBatchSize;
+            }
+            set
+            {
+                if (value < 1) throw new ArgumentOutOfRangeException("value");
+                _syncBatchSize = value;
+            }
+        }
+        #endregion
+
+        #region Public Methods
+        /// <summary>
+        /// Appends the changes submitted since <see cref="LastChange"/>, and any below it whose submit finished late
+        /// (within the feed's <see cref="P4ChangeFeed.RescanWindow"/>).
+        /// </summary>
+        /// <param name="connection">Connection to the server.  The whole depot is stored, so use a user that can see it.</param>
+        /// <returns>The number of changes added.</returns>
+        public int Sync(P4Connection connection)
+        {
+            if (connection == null) throw new ArgumentNullException("connection");
+
+            lock (_lock)
+            {
+                P4ChangeFeed feed = connection.CreateChangeFeed(LastChange);
+                feed.BatchSize = _syncBatchSize;
+                int last = LastChange;
+                for (int i = _changes.Count - 1; i >= 0 && _changes[i] > last - feed.RescanWindow; i--)
+                {
+                    feed.MarkHandled(_changes[i]);
+                }
+                feed.OnChange += delegate(object sender, P4ChangeEventArgs e)
+                {
+                    Append(e);
+                };
+                try
+                {
+                    return feed.Poll();
+                }
+                finally
+                {
+                    _file.Flush();
+                }
+            }
+        }
+
+        /// <summary>
+        /// Gets a stored change.
+        /// </summary>
+        /// <param name="change">The change number.</param>
+        /// <returns>The change, or null if it isn't stored.</returns>
+        public P4HistoryChange GetChange(int change)
+        {
+            lock (_lock)
+            {
+                int i = _changes.BinarySearch(change);
+                return (i < 0) ? null : Read(i);
+            }
+        }
+
+        /// <summary>
+        /// Answers a changes-style query from the store only.
+        /// </summary>
+        /// <param name="pathPrefix">Depot path the changes must touch (e.g. //depot/main/...), or null for any.</param>
+        /// <param name="user">Submitting user, or null for any.</param>
+        /// <param name="client">Client workspace, or null for any.</param>
+        /// <param name="from">Earliest submit time (inclusive), or DateTime.MinValue.</param>
+        /// <param name="to">Latest submit time (inclusive), or DateTime.MaxValue.</param>
+        /// <param name="max">Most changes to return (like changes -m), or 0 for all.</param>
+        /// <returns>The matching changes, newest first.</returns>
+        public P4HistoryChange[] GetChanges(string pathPrefix, string user, string client, DateTime from, DateTime to, int max)
+        {
+            string prefix = (pathPrefix == null) ? null : TrimWildcard(pathPrefix);
+            long fromSeconds = ToSeconds(from);
+            long toSeconds = ToSeconds(to);
+
+            lock (_lock)
+            {
+                // start from the smallest index that applies, then filter
+                List<int> candidates = null;
+                if (user != null) candidates = Narrow(candidates, _byUser, user);
+                if (client != null) candidates = Narrow(candidates, _byClient, client);
+                if (prefix != null)
+                {
+                    string root = GetRoot(prefix);
+                    if (root != null) candidates = Narrow(candidates, _byRoot, root);
+                }
+
+                List<P4HistoryChange> ret = new List<P4HistoryChange>();
+                int count = (candidates == null) ? _changes.Count : candidates.Count;
+                for (int n = count - 1; n >= 0 && (max <= 0 || ret.Count < max); n--)
+                {
+                    int i = (candidates == null) ? n : candidates[n];
+                    if (_times[i] < fromSeconds || _times[i] > toSeconds) continue;
+
+                    P4HistoryChange c = Read(i);
+                    if (user != null && c.User != user) continue;
+                    if (client != null && c.Client != client) continue;
+                    if (prefix != null && !Touches(c, prefix)) continue;
+                    ret.Add(c);
+                }
+                return ret.ToArray();
+            }
+        }
+
+        /// <summary>
+        /// Syncs the changes submitted since <see cref="LastChange"/>, then answers a changes-style query from the store.
+        /// </summary>
+        /// <param name="connection">Connection to the server, used only for the tail of new changes.</param>
+        /// <param name="pathPrefix">Depot path the changes must touch (e.g. //depot/main/...), or null for any.</param>
+        /// <param name="user">Submitting user, or null for any.</param>
+        /// <param name="client">Client workspace, or null for any.</param>
+        /// <param name="from">Earliest submit time (inclusive), or DateTime.MinValue.</param>
+        /// <param name="to">Latest submit time (inclusive), or DateTime.MaxValue.</param>
+        /// <param name="max">Most changes to return (like changes -m), or 0 for all.</param>
+        /// <returns>The matching changes, newest first.</returns>
+        public P4HistoryChange[] GetChanges(P4Connection connection, string pathPrefix, string user, string client,
+            DateTime from, DateTime to, int max)
+        {
+            Sync(connection);
+            return GetChanges(pathPrefix, user, client, from, to, max);
+        }
+
+        /// <summary>
+        /// Closes the store.
+        /// </summary>
+        public void Dispose()
+        {
+            lock (_lock)
+            {
+#if CLR4
+                Unmap();
+#else
+                if (_reader != null) _reader.Close();
+                _reader = null;
+#endif
+                if (_file != null) _file.Close();
+                _file = null;
+            }
+        }
+        #endregion
+
+        #region Private Helper Methods
+        private void Load()
+        {
+            byte[] header = new byte[Magic.Length + 1];
+            _file.Position = 0;
+            if (_file.Read(header, 0, header.Length) != header.Length) throw new InvalidDataException(_path + " is not a change history store.");
+            for (int i = 0; i < Magic.Length; i++)
+            {
+                if (header[i] != Magic[i]) throw new InvalidDataException(_path + " is not a change history store.");
+            }
+            if (header[Magic.Length] != FormatVersion) throw new InvalidDataException(_path + " was written by a different version of P4.Net.");
+
+            // one sequential pass to build the index
+            BinaryReader r = new BinaryReader(new BufferedStream(_file, 64 * 1024), Encoding.UTF8);
+            long offset = header.Length;
+            long length = _file.Length;
+            while (offset + 4 <= length)
+            {
+                int size = r.ReadInt32();
+                if (size <= 0 || offset + 4 + size > length) break;
+
+                P4HistoryChange c;
+                try
+                {
+                    c = ReadRecord(r);
+                }
+                catch (EndOfStreamException)
+                {
+                    break;
+                }
+                Index(offset, c);
+                offset += 4 + size;
+            }
+
+            // drop a record cut short by a crash
+            if (offset != length) _file.SetLength(offset);
+            _file.Position = offset;
+        }
+
+        private void Append(P4ChangeEventArgs e)
+        {
+            if (_changes.BinarySearch(e.Change) >= 0) return;
+
+            string[] files = e.DepotFiles;
+            string[] actions = e.Actions;
+            string[] revs = e.Revisions;
+            int seconds = int.Parse(e.Record.Fields["time"], CultureInfo.InvariantCulture);
+            P4HistoryChange c = new P4HistoryChange(e.Change, Epoch.AddSeconds(seconds), e.User ?? string.Empty,
+                e.Client ?? string.Empty, e.Description ?? string.Empty, files, actions, revs);
+
+            MemoryStream ms = new MemoryStream();
+            BinaryWriter w = new BinaryWriter(ms, Encoding.UTF8);
+            w.Write(0);
+            w.Write(c.Change);
+            w.Write(seconds);
+            w.Write(c.User);
+            w.Write(c.Client);
+            w.Write(c.Description);
+            w.Write(files.Length);
+            for (int i = 0; i < files.Length; i++)
+            {
+                w.Write(files[i]);
+                w.Write(i < actions.Length ? actions[i] : string.Empty);
+                w.Write(i < revs.Length ? revs[i] : string.Empty);
+            }
+            w.Flush();
+            ms.Position = 0;
+            w.Write((int)ms.Length - 4);
+
+            long offset = _file.Length;
+            _file.Position = offset;
+            _file.Write(ms.GetBuffer(), 0, (int)ms.Length);
+            Index(offset, c);
+        }
+
+        private void Index(long offset, P4HistoryChange c)
+        {
+            // records are in the order they were synced; a change whose submit finished late goes in among them
+            int i = _changes.BinarySearch(c.Change);
+            if (i >= 0) return;
+            i = ~i;
+            if (i < _changes.Count)
+            {
+                Shift(_byUser, i);
+                Shift(_byClient, i);
+                Shift(_byRoot, i);
+            }
+            _offsets.Insert(i, offset);
+            _changes.Insert(i, c.Change);
+            _times.Insert(i, (int)ToSeconds(c.Time));
+            AddTo(_byUser, c.User, i);
+            AddTo(_byClient, c.Client, i);
+
+            List<string> roots = new List<string>();
+            foreach (string f in c.DepotFiles)
+            {
+                string root = GetRoot(f);
+                if (root != null && !roots.Contains(root)) roots.Add(root);
+            }
+            foreach (string root in roots)
+            {
+                AddTo(_byRoot, root, i);
+            }
+        }
+
+        private P4HistoryChange Read(int i)
+        {
+            Stream s = GetReader();
+            s.Position = _offsets[i] + 4;
+            return ReadRecord(new BinaryReader(s, Encoding.UTF8));
+        }
+
+        private static P4HistoryChange ReadRecord(BinaryReader r)
+        {
+            int change = r.ReadInt32();
+            int seconds = r.ReadInt32();
+            string user = r.ReadString();
+            string client = r.ReadString();
+            string desc = r.ReadString();
+            int count = r.ReadInt32();
+            string[] files = new string[count];
+            string[] actions = new string[count];
+            string[] revs = new string[count];
+            for (int i = 0; i < count; i++)
+            {
+                files[i] = r.ReadString();
+                actions[i] = r.ReadString();
+                revs[i] = r.ReadString();
+            }
+            return new P4HistoryChange(change, Epoch.AddSeconds(seconds), user, client, desc, files, actions, revs);
+        }
+
+#if CLR4
+        private Stream GetReader()
+        {
+            // the file only grows, so map again once there's more than the current view covers
+            if (_view == null || _mappedLength != _file.Length)
+            {
+                _file.Flush();
+                Unmap();
+                _mappedLength = _file.Length;
+                _map = MemoryMappedFile.CreateFromFile(_file, null, _mappedLength, MemoryMappedFileAccess.Read, null,
+                    HandleInheritability.None, true);
+                _view = _map.CreateViewStream(0, _mappedLength, MemoryMappedFileAccess.Read);
+            }
+            return _view;
+        }
+
+        private void Unmap()
+        {
+            if (_view != null) _view.Dispose();
+            if (_map != null) _map.Dispose();
+            _view = null;
+            _map = null;
+        }
+#else
+        private Stream GetReader()
+        {
+            _file.Flush();
+            return _reader;
+        }
+#endif
+
+        private static List<int> Narrow(List<int> current, Dictionary<string, List<int>> index, string key)
+        {
+            List<int> found;
+            if (!index.TryGetValue(key, out found)) return new List<int>();
+            return (current == null || found.Count < current.Count) ? found : current;
+        }
+
+        private static void AddTo(Dictionary<string, List<int>> index, string key, int i)
+        {
+            List<int> list;
+            if (!index.TryGetValue(key, out list))
+            {
+                list = new List<int>();
+                index.Add(key, list);
+            }
+            list.Insert(~list.BinarySearch(i), i);
+        }
+
+        private static void Shift(Dictionary<string, List<int>> index, int from)
+        {
+            foreach (List<int> list in index.Values)
+            {
+                for (int j = list.Count - 1; j >= 0 && list[j] >= from; j--)
+                {
+                    list[j]++;
+                }
+            }
+        }
+
+        private static bool Touches(P4HistoryChange c, string prefix)
+        {
+            foreach (string f in c.DepotFiles)
+            {
+                if (f.StartsWith(prefix, StringComparison.Ordinal)) return true;
+            }
+            return false;
+        }
+
+        // "//depot/main/..." -> "//depot/main/"
+        private static string TrimWildcard(string path)
+        {
+            return path.EndsWith("...") ? path.Substring(0, path.Length - 3) : path;
+        }
+
+        // "//depot/main/src/a.c" -> "//depot/main"; null when there aren't two full levels
+        private static string GetRoot(string path)
+        {
+            if (!path.StartsWith("//")) return null;
+            int first = path.IndexOf('/', 2);
+            if (first < 0) return null;
+            int second = path.IndexOf('/', first + 1);
+            if (second < 0) return null;
+            return path.Substring(0, second);
+        }
+
+        private static long ToSeconds(DateTime time)
+        {
+            if (time == DateTime.MinValue) return long.MinValue;
+            if (time == DateTime.MaxValue) return long.MaxValue;
+            return (long)(time.ToUniversalTime() - Epoch).TotalSeconds;
+        }
+        #endregion
+    }
+}
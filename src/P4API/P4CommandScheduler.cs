@@ -0,0 +1,470 @@
+/*
+ * P4.Net *
+Copyright (c) 2007-2010 Shawn Hladky
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+and associated documentation files (the "Software"), to deal in the Software without 
+restriction, including without limitation the rights to use, copy, modify, merge, publish, 
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or 
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+ */
+
+
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Threading;
+
+namespace P4API
+{
+    /// <summary>
+    /// Priority classes for <see cref="P4CommandScheduler"/>.
+    /// </summary>
+    public enum P4CommandPriority
+    {
+        /// <summary>
+        /// A user is waiting on the result.  Always dispatched first, and may use the sessions held back from bulk work.
+        /// </summary>
+        Interactive = 0,
+
+        /// <summary>
+        /// Ordinary work.
+        /// </summary>
+        Normal = 1,
+
+        /// <summary>
+        /// Crawlers, reports and other long-running background work.
+        /// </summary>
+        Bulk = 2
+    }
+
+    /// <summary>
+    /// Work run by <see cref="P4CommandScheduler.Execute{T}"/> on the session it was given.
+    /// </summary>
+    /// <typeparam name="T">Type of the result.</typeparam>
+    /// <param name="connection">A connected session, used by nobody else until the work returns.</param>
+    /// <returns>The result of the work.</returns>
+    public delegate T P4ScheduledCommand<T>(P4Connection connection);
+
+    /// <summary>
+    /// Shares a fixed set of <see cref="P4Connection"/> sessions between callers, by priority class and fairly between keys.
+    /// </summary>
+    /// <remarks>
+    /// A caller asks for a session with a priority and a key (a tenant, user or crawler name) and blocks until it gets one.
+    /// Sessions go to <see cref="P4CommandPriority.Interactive"/> waiters first, then Normal, then Bulk, subject to each
+    /// class's concurrency limit.  Within a class, keys share sessions in proportion to their weight (weighted fair
+    /// queueing), so one busy key can't starve the others no matter how much it queues.
+    /// <para>Bulk work never takes one of the last <see cref="InteractiveReserve"/> idle sessions, so an interactive
+    /// command that arrives while a crawler is busy still finds a session free.</para>
+    /// <para>The scheduler does not own the sessions; connect them before handing them over, and dispose them afterwards.
+    /// All members are thread safe.</para>
+    /// </remarks>
+    public class P4CommandScheduler
+    {
+        private const int ClassCount = 3;
+
+        private readonly object _lock = new object();
+        private readonly Stack<P4Connection> _idle = new Stack<P4Connection>();
+        private readonly int _sessions;
+        private int _interactiveReserve;
+        private TimeSpan _queueTimeout = TimeSpan.Zero;
+        private long _sequence;
+
+        private readonly int[] _limits = new int[ClassCount];
+        private readonly int[] _running = new int[ClassCount];
+        private readonly long[] _dispatched = new long[ClassCount];
+        private readonly long[] _timedOut = new long[ClassCount];
+        private readonly P4Histogram[] _queueTime = new P4Histogram[ClassCount];
+        private readonly List<Waiter>[] _waiting = new List<Waiter>[ClassCount];
+
+        // weighted fair queueing: virtual time per class, and the last finish tag per class and key
+        private readonly double[] _virtualTime = new double[ClassCount];
+        private readonly Dictionary<string, double>[] _lastFinish = new Dictionary<string, double>[ClassCount];
+        private readonly Dictionary<string, double> _weights = new Dictionary<string, double>();
+
+        private sealed class Waiter
+        {
+            public P4CommandPriority Priority;
+            public string Key;
+            public double Tag;
+            public long Sequence;
+            public long Enqueued;
+            public P4Connection Connection;
+        }
+
+        /// <summary>
+        /// Initializes a new instance of the <see cref="P4CommandScheduler"/> class.
+        /// </summary>
+        /// <param name="sessions">Connected sessions to share.  Each must not be used outside the scheduler.</param>
+        public P4CommandScheduler(IEnumerable<P4Connection> sessions)
+        {
+            if (sessions == null) throw new ArgumentNullException("sessions");
+            foreach (P4Connection c in sessions)
+            {
+                if (c == null) throw new ArgumentNullException("sessions");
+                _idle.Push(c);
+            }
+            if (_idle.Count == 0) throw new ArgumentException("At least one session is required.", "sessions");
+
+            _sessions = _idle.Count;
+            _interactiveReserve = _sessions > 1 ? 1 : 0;
+            for (int i = 0; i < ClassCount; i++)
+            {
+                _limits[i] = _sessions;
+                _queueTime[i] = new P4Histogram();
+                _waiting[i] = new List<Waiter>();
+                _lastFinish[i] = new Dictionary<string, double>();
+            }
+        }
+
+        #region Settings
+        /// <summary>
+        /// Gets the number of sessions the scheduler shares.
+        /// </summary>
+        public int Sessions
+        {
+            get
+            {
+                return _sessions;
+            }
+        }
+
+        /// <summary>
+        /// Gets/Sets how many idle sessions bulk work leaves for interactive work.
+        /// </summary>
+        /// <value>Defaults to 1 (0 with a single session).</value>
+        public int InteractiveReserve
+        {
+            get
+            {
+                lock (_lock)
+                {
+                    return _interactiveReserve;
+                }
+            }
+            set
+            {
+                if (value < 0 || value >= _sessions) throw new ArgumentOutOfRangeException("value");
+                lock (_lock)
+                {
+                    _interactiveReserve = value;
+                    Dispatch();
+                }
+            }
+        }
+
+        /// <summary>
+        /// Gets/Sets how long a caller waits for a session before giving up with a <see cref="TimeoutException"/>.
+        /// </summary>
+        /// <value>Defaults to TimeSpan.Zero, which waits forever.</value>
+        public TimeSpan QueueTimeout
+        {
+            get
+            {
+                lock (_lock)
+                {
+                    return _queueTimeout;
+                }
+            }
+            set
+            {
+                lock (_lock)
+                {
+                    _queueTimeout = value;
+                }
+            }
+        }
+
+        /// <summary>
+        /// Gets the most sessions a priority class may use at once.
+        /// </summary>
+        /// <param name="priority">The priority class.</param>
+        /// <returns>The concurrency limit.</returns>
+        public int GetConcurrencyLimit(P4CommandPriority priority)
+        {
+            lock (_lock)
+            {
+                return _limits[(int)priority];
+            }
+        }
+
+        /// <summary>
+        /// Sets the most sessions a priority class may use at once.
+        /// </summary>
+        /// <param name="priority">The priority class.</param>
+        /// <param name="limit">The limit, from 1 to <see cref="Sessions"/> (the default).</param>
+        public void SetConcurrencyLimit(P4CommandPriority priority, int limit)
+        {
+            if (limit < 1 || limit > _sessions) throw new ArgumentOutOfRangeException("limit");
+            lock (_lock)
+            {
+                _limits[(int)priority] = limit;
+                Dispatch();
+            }
+        }
+
+        /// <summary>
+        /// Sets a key's share of the sessions, relative to other keys in the same priority class.
+        /// </summary>
+        /// <param name="key">The key.</param>
+        /// <param name="weight">The weight (keys default to 1).</param>
+        public void SetWeight(string key, double weight)
+        {
+            if (key == null) throw new ArgumentNullException("key");
+            if (!(weight > 0)) throw new ArgumentOutOfRangeException("weight");
+            lock (_lock)
+            {
+                _weights[key] = weight;
+            }
+        }
+        #endregion
+
+        #region Running commands
+        /// <summary>
+        /// Waits for a session, then runs a tagged command on it.
+        /// </summary>
+        /// <param name="priority">Priority class of the command.</param>
+        /// <param name="key">The tenant (or user, or crawler) the command is for.  Null is a key of its own.</param>
+        /// <param name="command">The command.</param>
+        /// <param name="args">The arguments to the Perforce command.</param>
+        /// <returns>A P4Recordset containing the results of the command.</returns>
+        public P4RecordSet Run(P4CommandPriority priority, string key, string command, params string[] args)
+        {
+            return Execute<P4RecordSet>(priority, key, delegate(P4Connection c) { return c.Run(command, args); });
+        }
+
+        /// <summary>
+        /// Waits for a session, then runs an untagged command on it.
+        /// </summary>
+        /// <param name="priority">Priority class of the command.</param>
+        /// <param name="key">The tenant (or user, or crawler) the command is for.  Null is a key of its own.</param>
+        /// <param name="command">The command.</param>
+        /// <param name="args">The arguments to the Perforce command.</param>
+        /// <returns>A P4UnParsedRecordSet.</returns>
+        public P4UnParsedRecordSet RunUnParsed(P4CommandPriority priority, string key, string command, params string[] args)
+        {
+            return Execute<P4UnParsedRecordSet>(priority, key, delegate(P4Connection c) { return c.RunUnParsed(command, args); });
+        }
+
+        /// <summary>
+        /// Waits for a session, then runs arbitrary work on it.
+        /// </summary>
+        /// <typeparam name="T">Type of the result.</typeparam>
+        /// <param name="priority">Priority class of the work.</param>
+        /// <param name="key">The tenant (or user, or crawler) the work is for.  Null is a key of its own.</param>
+        /// <param name="work">The work.  It has the session to itself until it returns.</param>
+        /// <returns>The result of the work.</returns>
+        /// <exception cref="TimeoutException">No session became available within <see cref="QueueTimeout"/>.</exception>
+        public T Execute<T>(P4CommandPriority priority, string key, P4ScheduledCommand<T> work)
+        {
+            if (work == null) throw new ArgumentNullException("work");
+            if (priority < P4CommandPriority.Interactive || priority > P4CommandPriority.Bulk)
+            {
+                throw new ArgumentOutOfRangeException("priority");
+            }
+
+            P4Connection connection = Acquire(priority, key ?? string.Empty);
+            try
+            {
+                return work(connection);
+            }
+            finally
+            {
+                Release(priority, connection);
+            }
+        }
+        #endregion
+
+        #region Metrics
+        /// <summary>
+        /// Gets how long commands of a priority class waited for a session, in microseconds.
+        /// </summary>
+        /// <param name="priority">The priority class.</param>
+        /// <returns>A copy of the queue time histogram.</returns>
+        public P4Histogram GetQueueTime(P4CommandPriority priority)
+        {
+            lock (_lock)
+            {
+                return _queueTime[(int)priority].Clone();
+            }
+        }
+
+        /// <summary>
+        /// Gets the number of commands of a priority class waiting for a session.
+        /// </summary>
+        /// <param name="priority">The priority class.</param>
+        /// <returns>The number of waiting commands.</returns>
+        public int GetWaitingCount(P4CommandPriority priority)
+        {
+            lock (_lock)
+            {
+                return _waiting[(int)priority].Count;
+            }
+        }
+
+        /// <summary>
+        /// Gets the number of sessions running commands of a priority class.
+        /// </summary>
+        /// <param name="priority">The priority class.</param>
+        /// <returns>The number of busy sessions.</returns>
+        public int GetRunningCount(P4CommandPriority priority)
+        {
+            lock (_lock)
+            {
+                return _running[(int)priority];
+            }
+        }
+
+        /// <summary>
+        /// Gets the number of commands of a priority class that have been given a session.
+        /// </summary>
+        /// <param name="priority">The priority class.</param>
+        /// <returns>The number of dispatched commands.</returns>
+        public long GetDispatchedCount(P4CommandPriority priority)
+        {
+            lock (_lock)
+            {
+                return _dispatched[(int)priority];
+            }
+        }
+
+        /// <summary>
+        /// Gets the number of commands of a priority class that gave up waiting (see <see cref="QueueTimeout"/>).
+        /// </summary>
+        /// <param name="priority">The priority class.</param>
+        /// <returns>The number of timed out commands.</returns>
+        public long GetTimedOutCount(P4CommandPriority priority)
+        {
+            lock (_lock)
+            {
+                return _timedOut[(int)priority];
+            }
+        }
+
+        /// <summary>
+        /// Clears the queue time histograms and counts.
+        /// </summary>
+        public void ResetMetrics()
+        {
+            lock (_lock)
+            {
+                for (int i = 0; i < ClassCount; i++)
+                {
+                    _queueTime[i].Reset();
+                    _dispatched[i] = 0;
+                    _timedOut[i] = 0;
+                }
+            }
+        }
+        #endregion
+
+        #region Private Helper Methods
+        private P4Connection Acquire(P4CommandPriority priority, string key)
+        {
+            int cls = (int)priority;
+            Waiter w = new Waiter();
+            w.Priority = priority;
+            w.Key = key;
+            w.Enqueued = Stopwatch.GetTimestamp();
+
+            lock (_lock)
+            {
+                // finish tag = max(class virtual time, key's last finish) + 1/weight
+                double weight;
+                if (!_weights.TryGetValue(key, out weight)) weight = 1;
+                double last;
+                if (!_lastFinish[cls].TryGetValue(key, out last)) last = 0;
+                w.Tag = Math.Max(_virtualTime[cls], last) + 1.0 / weight;
+                w.Sequence = _sequence++;
+                _lastFinish[cls][key] = w.Tag;
+
+                _waiting[cls].Add(w);
+                Dispatch();
+
+                TimeSpan timeout = _queueTimeout;
+                long deadline = timeout > TimeSpan.Zero ? w.Enqueued + (long)(timeout.TotalSeconds * Stopwatch.Frequency) : 0;
+                while (w.Connection == null)
+                {
+                    if (deadline == 0)
+                    {
+                        Monitor.Wait(_lock);
+                        continue;
+                    }
+
+                    long left = deadline - Stopwatch.GetTimestamp();
+                    if (left <= 0 || !Monitor.Wait(_lock, (int)Math.Max(1, left * 1000 / Stopwatch.Frequency)))
+                    {
+                        if (w.Connection != null) break;
+                        if (Stopwatch.GetTimestamp() < deadline) continue;
+
+                        _waiting[cls].Remove(w);
+                        _timedOut[cls]++;
+                        throw new TimeoutException(string.Format(
+                            "No Perforce session became available for {0} work within {1}.", priority, timeout));
+                    }
+                }
+                return w.Connection;
+            }
+        }
+
+        private void Release(P4CommandPriority priority, P4Connection connection)
+        {
+            lock (_lock)
+            {
+                _running[(int)priority]--;
+                _idle.Push(connection);
+                Dispatch();
+            }
+        }
+
+        // Hands idle sessions to waiters.  Called with _lock held.
+        private void Dispatch()
+        {
+            bool handedOut = false;
+            while (_idle.Count > 0)
+            {
+                Waiter next = null;
+                for (int cls = 0; cls < ClassCount && next == null; cls++)
+                {
+                    if (_waiting[cls].Count == 0 || _running[cls] >= _limits[cls]) continue;
+                    if (cls == (int)P4CommandPriority.Bulk && _idle.Count <= _interactiveReserve) continue;
+                    next = NextInClass(cls);
+                }
+                if (next == null) break;
+
+                int c = (int)next.Priority;
+                _waiting[c].Remove(next);
+                _virtualTime[c] = next.Tag;
+                _running[c]++;
+                _dispatched[c]++;
+                _queueTime[c].Record((long)((Stopwatch.GetTimestamp() - next.Enqueued) * (1000000.0 / Stopwatch.Frequency)));
+                next.Connection = _idle.Pop();
+                handedOut = true;
+            }
+            if (handedOut) Monitor.PulseAll(_lock);
+        }
+
+        private Waiter NextInClass(int cls)
+        {
+            Waiter best = null;
+            foreach (Waiter w in _waiting[cls])
+            {
+                if (best == null || w.Tag < best.Tag || (w.Tag == best.Tag && w.Sequence < best.Sequence))
+                {
+                    best = w;
+                }
+            }
+            return best;
+        }
+        #endregion
+    }
+}
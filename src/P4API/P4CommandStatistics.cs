@@ -0,0 +1,304 @@
+/*
+ * P4.Net *
+Copyright (c) 2007-2010 Shawn Hladky
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+and associated documentation files (the "Software"), to deal in the Software without 
+restriction, including without limitation the rights to use, copy, modify, merge, publish, 
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or 
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+ */
+
+
+using System;
+using System.Diagnostics;
+
+namespace P4API
+{
+    /// <summary>
+    /// Performance counters for a single Perforce command.
+    /// </summary>
+    /// <remarks>
+    /// Times are split by where they were spent:
+    /// <list>
+    /// <li>ServerWaitTime: waiting on the server and the network (wall time not spent in a callback).</li>
+    /// <li>NativeCallbackTime: converting results from the Perforce API to .NET types.</li>
+    /// <li>ManagedCallbackTime: in P4.Net and your callbacks, including building records.</li>
+    /// </list>
+    /// <para>AllocatedBytes is approximate: on .NET 4 with <c>AppDomain.MonitoringIsEnabled</c> set it counts every allocation
+    /// in the AppDomain during the command, otherwise it is the growth of the managed heap and reads 0 when a collection runs.</para>
+    /// </remarks>
+    public class P4CommandStatistics
+    {
+        private string _command;
+        private P4CommandStatus _status;
+        private TimeSpan _wallTime;
+        private TimeSpan _timeToFirstByte;
+        private TimeSpan _callbackTime;
+        private TimeSpan _managedCallbackTime;
+        private long _textBytes;
+        private long _binaryBytes;
+        private int _records;
+        private int _messages;
+        private int _infoLines;
+        private int _managedTransitions;
+        private int _internLookups;
+        private int _internHits;
+        private int _internedStrings;
+        private long _internBytesSaved;
+        private long _allocatedBytes;
+        private int _gcCollections;
+
+        internal P4CommandStatistics(string command, P4CommandStatus status, p4dn.RunCounters counters, long allocatedBytes, int gcCollections)
+        {
+            _command = command;
+            _status = status;
+            _wallTime = ToTimeSpan(counters.EndTimestamp - counters.StartTimestamp);
+            if (counters.FirstByteTimestamp != 0)
+            {
+                _timeToFirstByte = ToTimeSpan(counters.FirstByteTimestamp - counters.StartTimestamp);
+            }
+            _callbackTime = ToTimeSpan(counters.CallbackTicks);
+            _managedCallbackTime = ToTimeSpan(counters.ManagedTicks);
+            _textBytes = counters.TextBytes;
+            _binaryBytes = counters.BinaryBytes;
+            _records = counters.Records;
+            _messages = counters.Messages;
+            _infoLines = counters.InfoLines;
+            _managedTransitions = counters.ManagedTransitions;
+            _internLookups = counters.PoolLookups;
+            _internHits = counters.PoolHits;
+            _internedStrings = counters.PoolEntries;
+            _internBytesSaved = counters.PoolBytesSaved;
+            _allocatedBytes = allocatedBytes;
+            _gcCollections = gcCollections;
+        }
+
+        private static TimeSpan ToTimeSpan(long stopwatchTicks)
+        {
+            if (stopwatchTicks <= 0) return TimeSpan.Zero;
+            return TimeSpan.FromTicks((long)(stopwatchTicks * ((double)TimeSpan.TicksPerSecond / Stopwatch.Frequency)));
+        }
+
+        /// <summary>
+        /// Gets the name of the command.
+        /// </summary>
+        public string Command
+        {
+            get
+            {
+                return _command;
+            }
+        }
+
+        /// <summary>
+        /// Gets how the command ended.
+        /// </summary>
+        public P4CommandStatus Status
+        {
+            get
+            {
+                return _status;
+            }
+        }
+
+        /// <summary>
+        /// Gets the total time to run the command.
+        /// </summary>
+        public TimeSpan WallTime
+        {
+            get
+            {
+                return _wallTime;
+            }
+        }
+
+        /// <summary>
+        /// Gets the time until the first result came back from the server (zero if nothing came back).
+        /// </summary>
+        public TimeSpan TimeToFirstByte
+        {
+            get
+            {
+                return _timeToFirstByte;
+            }
+        }
+
+        /// <summary>
+        /// Gets the time spent waiting on the server and the network.
+        /// </summary>
+        public TimeSpan ServerWaitTime
+        {
+            get
+            {
+                TimeSpan ret = _wallTime - _callbackTime;
+                return ret < TimeSpan.Zero ? TimeSpan.Zero : ret;
+            }
+        }
+
+        /// <summary>
+        /// Gets the time spent converting results in the native layer.
+        /// </summary>
+        public TimeSpan NativeCallbackTime
+        {
+            get
+            {
+                TimeSpan ret = _callbackTime - _managedCallbackTime;
+                return ret < TimeSpan.Zero ? TimeSpan.Zero : ret;
+            }
+        }
+
+        /// <summary>
+        /// Gets the time spent in managed callbacks (P4.Net and user code).
+        /// </summary>
+        public TimeSpan ManagedCallbackTime
+        {
+            get
+            {
+                return _managedCallbackTime;
+            }
+        }
+
+        /// <summary>
+        /// Gets the number of bytes of text file content.
+        /// </summary>
+        public long TextBytes
+        {
+            get
+            {
+                return _textBytes;
+            }
+        }
+
+        /// <summary>
+        /// Gets the number of bytes of binary file content.
+        /// </summary>
+        public long BinaryBytes
+        {
+            get
+            {
+                return _binaryBytes;
+            }
+        }
+
+        /// <summary>
+        /// Gets the number of tagged records.
+        /// </summary>
+        public int Records
+        {
+            get
+            {
+                return _records;
+            }
+        }
+
+        /// <summary>
+        /// Gets the number of messages (errors, warnings and info messages) that were passed on.
+        /// </summary>
+        public int Messages
+        {
+            get
+            {
+                return _messages;
+            }
+        }
+
+        /// <summary>
+        /// Gets the number of untagged info lines.
+        /// </summary>
+        public int InfoLines
+        {
+            get
+            {
+                return _infoLines;
+            }
+        }
+
+        /// <summary>
+        /// Gets the number of calls from the native layer into managed callbacks.
+        /// </summary>
+        public int ManagedTransitions
+        {
+            get
+            {
+                return _managedTransitions;
+            }
+        }
+
+        /// <summary>
+        /// Gets the number of keys and values looked up in the intern pool.
+        /// </summary>
+        /// <remarks>Always 0 unless <see cref="P4Connection.InternValues"/> was on.</remarks>
+        public int InternLookups
+        {
+            get
+            {
+                return _internLookups;
+            }
+        }
+
+        /// <summary>
+        /// Gets the number of lookups that reused a string already in the intern pool.
+        /// </summary>
+        public int InternHits
+        {
+            get
+            {
+                return _internHits;
+            }
+        }
+
+        /// <summary>
+        /// Gets the number of distinct strings the intern pool held.
+        /// </summary>
+        public int InternedStrings
+        {
+            get
+            {
+                return _internedStrings;
+            }
+        }
+
+        /// <summary>
+        /// Gets the approximate managed memory not allocated thanks to the intern pool.
+        /// </summary>
+        public long InternBytesSaved
+        {
+            get
+            {
+                return _internBytesSaved;
+            }
+        }
+
+        /// <summary>
+        /// Gets the approximate number of managed bytes allocated while the command ran.
+        /// </summary>
+        public long AllocatedBytes
+        {
+            get
+            {
+                return _allocatedBytes;
+            }
+        }
+
+        /// <summary>
+        /// Gets the number of generation 0 garbage collections while the command ran.
+        /// </summary>
+        public int GcCollections
+        {
+            get
+            {
+                return _gcCollections;
+            }
+        }
+    }
+}
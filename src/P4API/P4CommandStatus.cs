@@ -0,0 +1,47 @@
+/*
+ * P4.Net *
+Copyright (c) 2007-2010 Shawn Hladky
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+and associated documentation files (the "Software"), to deal in the Software without 
+restriction, including without limitation the rights to use, copy, modify, merge, publish, 
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or 
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+ */
+
+
+using System;
+using System.Text;
+
+namespace P4API
+{
+    /// <summary>
+    /// Defines how the last Perforce command ended.
+    /// </summary>
+    public enum P4CommandStatus
+    {
+        /// <summary>
+        /// The command ran to completion (it may still have returned errors).
+        /// </summary>
+        Completed = 1,
+
+        /// <summary>
+        /// The command was stopped by <see cref="P4Connection.Cancel"/>, a cancellation token, or a callback's Cancel method.
+        /// </summary>
+        Cancelled = 2,
+
+        /// <summary>
+        /// The command was stopped because it ran past <see cref="P4Connection.CommandTimeout"/> or <see cref="P4Connection.CommandDeadline"/>.
+        /// </summary>
+        TimedOut = 3
+    }
+}
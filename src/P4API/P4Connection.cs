@@ -1,1244 +1,2651 @@
-/*
- * P4.Net *
-Copyright (c) 2007-2010 Shawn Hladky
-
-Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
-and associated documentation files (the "Software"), to deal in the Software without 
-restriction, including without limitation the rights to use, copy, modify, merge, publish, 
-distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
-Software is furnished to do so, subject to the following conditions:
-
-The above copyright notice and this permission notice shall be included in all copies or 
-substantial portions of the Software.
-
-THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
-BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
-NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
-DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
-OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
- */
-
-using System;
-using System.Text;
-using p4dn;
-using P4API.Exceptions;
-using System.IO;
-using System.Collections.Generic;
-
-namespace P4API
-{
-    /// <summary>
-    /// Delegate to handle the OnPrompt event.
-    /// </summary>
-    /// <param name="sender">Sender</param>
-    /// <param name="args">P4PromptEventArgs</param>
-    /// <remarks>Handle Perforce "prompts".  Prompts are from commands that ask the user to respond, such as:
-    /// <list>
-    /// <li>login</li>
-    /// <li>passwd</li>
-    /// <li>resolve (without an -a* switch)</li>
-    /// </list>
-    /// </remarks>
-    /// <seealso  cref="P4API.P4Connection.OnPrompt"/>
-    public delegate void OnPromptEventHandler(object sender, P4PromptEventArgs args);
-
-    /// <summary>
-    /// A connection to a Perforce server instance.
-    /// </summary>
-    /// <include file='CodeDocuments.xml' path='//P4Connection/remarks' />
-    public class P4Connection : IDisposable
-    {
-
-        /// <summary>
-        /// Static constructor makes sure custom assembly
-        /// resolver (Bootstrapper) is registered.
-        /// </summary>
-        static P4Connection()
-        {
-            Bootstrapper.Initialize();
-        }
-
-
-        #region Private Variables
-        private ClientApi m_ClientApi;
-        private bool _tagged = true;
-        private bool _Initialized;
-
-        private System.Collections.Specialized.StringDictionary cachedSpecDefs;
-        private string _CallingProgram;
-        private string _CallingProgramVersion;
-        private string _Client = null;
-        private string _Port = null;
-        private string _User = null;
-        private string _Host = null;
-        private string _CWD = null;
-        private string _Charset = null;
-        private string _Password = null;
-        private string _TicketFile = null;
-        private DateTime _p4epoch = new DateTime(1970, 1, 1);
-        private P4ExceptionLevels _exceptionLevel = P4ExceptionLevels.NoExceptionOnWarnings ;
-
-        private int _maxScanRows = 0;
-        private int _maxResults = 0;
-        private int _maxLockTime = 0;
-        private int _ApiLevel = 0;
-        #endregion
-
-        #region Events
-        /// <summary>
-        /// Raised when Perforce is prompting for a response.
-        /// </summary>
-        /// <remarks>Handle Perforce "prompts".  Prompts are from commands that ask the user to respond, such as:
-        /// <list>
-        /// <li>login</li>
-        /// <li>passwd</li>
-        /// <li>resolve (without an -a* switch)</li>
-        /// </list>
-        /// </remarks>
-        /// <include file='CodeDocuments.xml' path='//OnPrompt/example' />
-        public event OnPromptEventHandler OnPrompt;
-
-        /// <summary>
-        /// Raised from P4PrintStreamEvents before a file is printed.
-        /// </summary>
-        /// <remarks> Handle this event to initialize a stream that P4API will write to.</remarks>
-        public event OnPrintStreamEventHandler OnPrintStream;
-
-        /// <summary>
-        /// Raised from P4PrintStreamEvents after a file is printed.
-        /// </summary>
-        /// <remarks>
-        /// Use this event to close any streams that were created by the OnPrintStreamEventHandler event.
-        /// </remarks>
-        public event OnPrintEndEventHandler OnPrintEndFile;
-
-        #endregion
-
-        #region Contructors
-        /// <summary>
-        /// Initializes a new instance of the P4Connection class.
-        /// </summary>
-        public P4Connection()
-        {
-            this._Initialized = false;
-            this._CallingProgram = "P4.Net API";
-            this._CallingProgramVersion = System.Reflection.Assembly.GetExecutingAssembly().GetName().Version.ToString();
-            cachedSpecDefs = new System.Collections.Specialized.StringDictionary();
-
-        }
-        #endregion
-
-        #region Public Properties
-        /// <summary>
-        /// Gets/Sets a value that overrides the defined MaxScanRows.
-        /// </summary>
-        /// <remarks>Servers may set a limit for MaxScanRows for certain users.  Set this value to override.  
-        /// A value of 0 indicates no override.</remarks>
-        /// <value>Overrides the MaxScanRows defined at the server.</value>
-        public int MaxScanRows
-        {
-            get
-            {
-                return _maxScanRows ;
-            }
-            set
-            {
-                _maxScanRows  = value;
-                //_ClientAPI.SetMaxScanRows(value);
-            }
-        }
-
-        /// <summary>
-        /// Gets/Sets a value that overrides the defined MaxLockTime.
-        /// </summary>
-        /// <remarks>Servers may set a limit for MaxLockTime for certain users.  Set this value to override.  
-        /// A value of 0 indicates no override.</remarks>
-        /// <value>Overrides the MaxLockTime defined at the server.</value>
-        public int MaxLockTime
-        {
-            get
-            {
-                return _maxLockTime;
-            }
-            set
-            {
-                _maxLockTime = value;
-                //_ClientAPI.SetMaxScanRows(value);
-            }
-        }        
-
-        /// <summary>
-        /// Gets/Sets a value that overrides the defined MaxResults.
-        /// </summary>
-        /// <remarks>Servers may set a limit for MaxResults for certain users.  Set this value to override.  
-        /// A value of 0 indicates no override.</remarks>
-        /// <value>Overrides the MaxResults defined at the server.</value>
-        public int MaxResults
-        {
-            get
-            {
-                return _maxResults;
-            }
-            set
-            {
-                _maxResults = value;
-                //_ClientAPI.SetMaxResults(value);
-            }
-        }
-
-        /// <summary>
-        /// Gets/Sets the Host-name of the client.
-        /// </summary>
-        /// <remarks>Forcing the Host to a different name is useful when using a client that
-        /// was defined on a different host.  Of course, that can cause issues with the client's
-        /// have list, so use with caution.</remarks>
-        /// <value>The client Host name.</value>
-        public string Host
-        {
-            get
-            {
-                return _ClientAPI.Host;
-            }
-            set
-            {
-                _Host = value;
-                _ClientAPI.SetHost(value);
-            }
-        }
-
-        /// <summary>
-        /// Gets/Sets the Perforce Server port.
-        /// </summary>
-        /// <value>The port.</value>
-        /// <remarks>Defaults to the value set in your Perforce environment.  Port can not be
-        /// changed after running Connect (not even after a Disconnect).  
-        /// To connect to a server on another port, create a new instance of P4Connection.
-        /// </remarks>
-        public string Port
-        {
-            get
-            {
-                return _ClientAPI.Port;
-            }
-            set
-            {
-                if (_Initialized) throw new ServerAlreadyConnected();
-                _Port = value;
-                _ClientAPI.SetPort(value);
-            }
-        }
-
-        /// <summary>
-        /// Gets/Sets the User login used to connect to Perforce.
-        /// </summary>
-        /// <value>The user.</value>
-        /// <remarks>Defaults to the value set in your Perforce environment.  
-        /// After you've set User, you can unset (revert to the default) by setting to User to null.</remarks>
-        public string User
-        {
-            get
-            {
-                return _ClientAPI.User;
-            }
-            set
-            {
-                _User = value;
-                _ClientAPI.SetUser(value);
-            }
-        }
-
-        /// <summary>
-        /// Gets/Sets the client character set.
-        /// </summary>
-        /// <remarks>Defaults to the value set in your Perforce environment.  
-        /// After you've set Charset, you can unset (revert to the default) by setting to Charset to null.</remarks>
-        /// <value>The client's charset.</value>
-        public string Charset
-        {
-            get
-            {
-                return _ClientAPI.Charset;
-            }
-            set
-            {
-                _Charset = value;
-                _ClientAPI.SetCharset(value);
-            }
-        }
-
-        /// <summary>
-        /// Get/Sets the name of the calling program.
-        /// </summary>
-        /// <remarks>This value is seen in p4 monitor and in the server log files.</remarks>
-        /// <value>Defaults to "P4.Net API".</value>
-        public string CallingProgram
-        {
-            get
-            {
-                return _CallingProgram;
-            }
-            set
-            {
-                if (_Initialized) throw new ServerNotConnected_SetVar_AfterInit();
-                _CallingProgram = value;
-                // Set these in the initialize section
-            }
-        }
-
-        /// <summary>
-        /// Gets/Sets the version of the calling program's version.
-        /// </summary>
-        /// <remarks>This value is seen in p4 monitor and the server log files.</remarks>
-        /// <value>Defaults to the assembly version of the P4API.dll.</value>
-        public string CallingVersion
-        {
-            get
-            {
-                return _CallingProgramVersion;
-            }
-            set
-            {
-                if (_Initialized) throw new ServerNotConnected_SetVar_AfterInit();
-                _CallingProgramVersion = value;
-                // Set these in the initialize section
-            }
-        }
-
-        /// <summary>
-        /// Sets the password to conenct with.
-        /// </summary>
-        /// <remarks>
-        /// Do not set the literal password with a server running security level 2 or higher.  
-        /// For those servers, Use the Login method and/or a ticket in place of the Password.
-        /// </remarks>
-        /// <value>The user's password.</value>
-        public string Password
-        {
-            get
-            {
-                return _ClientAPI.Password;
-            }
-            set
-            {
-                _Password = value;
-                _ClientAPI.SetPassword(value);
-            }
-        }
-
-        /// <summary>
-        /// Sets the ticket file used for Authentication.
-        /// </summary>
-        /// <remarks>
-        /// Use this to override the default location of the TicketFile.
-        /// </remarks>
-        /// <value>Overrided the ticket file location.</value>
-        public string TicketFile
-        {
-            get
-            {
-                return _TicketFile;
-            }
-            set
-            {
-                _TicketFile = value;
-                _ClientAPI.SetTicketFile(value);
-            }
-        }
-
-        /// <summary>
-        /// Sets the Language for message translations.
-        /// </summary>
-        /// <remarks>
-        /// Use this to override the default location of the TicketFile.
-        /// </remarks>
-        /// <value>Overrided the ticket file location.</value>
-        public string Language
-        {
-            get
-            {
-                return _ClientAPI.Language;
-            }
-            set
-            {
-                _ClientAPI.SetLanguage(value);
-            }
-        }
-
-
-        /// <summary>
-        /// Gets/Sets the client workspace.
-        /// </summary>
-        /// <remarks>Many Perforce commands require a valid client spec to be set in order to run.  
-        /// Defaults to the value set in your Perforce environment.  After you've set Client, you
-        /// can unset (revert to the default) by setting to Client to null.</remarks>
-        /// <value>The client name.</value>
-        public string Client
-        {
-            get
-            {
-                return _ClientAPI.Client;
-            }
-            set
-            {
-                _Client = value;
-                _ClientAPI.SetClient(value);
-            }
-        }
-
-        /// <summary>
-        /// Gets/Sets the current working directory.
-        /// </summary>
-        /// <remarks>Setting CWD can be used so that relative paths are specified.  Keep in mind that changing
-        /// the CWD also might cause P4CONFIG settings to change.</remarks>
-        /// <value>The current working directory for the Perforce connection.</value>
-        public string CWD
-        {
-            get
-            {
-                return _ClientAPI.Cwd;
-            }
-            set
-            {
-                _CWD = value;
-                _ClientAPI.SetCwd(value);
-            }
-        }
-
-        /// <summary>
-        /// Sets the client API protocol level.
-        /// </summary>
-        /// <remarks> Sets the API compatibility level desired. 
-        /// This is useful when writing scripts using Perforce commands that do not yet support tagged output. 
-        /// In these cases, upgrading to a later server that supports tagged output for the commands in question 
-        /// can break your script. Using this method allows you to lock your script to the 
-        /// output format of an older Perforce release and facilitate seamless upgrades. 
-        /// Note that this method must be called prior to calling Connect.
-        /// <br/>
-        /// See the http://kb.perforce.com/P4dServerReference/ProtocolLevels/PerforceClientLevels for the API integer levels that correspond to each Perforce release.
-        /// </remarks>
-        /// <value>The Perforce API level.</value>
-        public int Api
-        {
-            get
-            {
-                return _ApiLevel;
-            }
-            set
-            {
-                _ApiLevel = value;
-                _ClientAPI.SetProtocol("api", value.ToString());
-            }
-        }
-
-        /// <summary>
-        /// Gets/Sets the Exception level when running Perforce commands.
-        /// </summary>
-        /// <remarks>
-        /// <para>This property controls when P4.Net will throw exceptions
-        /// when the underlying Perforce commands raise errors and warnings.</para>
-        /// <para>The default is NoExceptionOnWarnings</para></remarks>
-        /// <value>The exception level for the connection.</value>
-        public P4ExceptionLevels ExceptionLevel
-        {
-            get
-            {
-                return _exceptionLevel;
-            }
-            set
-            {
-                _exceptionLevel = value;
-            }
-        }
-
-        /// <summary>
-        /// Checks the server level (version) of the Perforce server.
-        /// </summary>
-        /// <returns>The server's version level.</returns>
-        /// <remarks>See http://kb.perforce.com/P4dServerReference/ProtocolLevels/PerforceServerLevels for more informantion.</remarks>
-        /// <value>The server's version level.</value>
-        public int ServerLevel
-        {
-            get
-            {
-                if (!_Initialized) throw new P4API.Exceptions.ServerNotConnected();
-
-                string serverLevel = _ClientAPI.GetProtocol("server2");
-                if (serverLevel == null)
-                {
-                    return 0;
-                }
-                else
-                {
-                    return int.Parse(serverLevel);
-                }
-            }
-        }
-           
-
-        #endregion
-
-        #region Public Methods
-
-        #region Date Converion Methods
-        /// <summary>
-        /// Converts Perforce date (integer) to .Net DateTime.
-        /// </summary>
-        /// <remarks>
-        /// The Perforce API returns most dates as an integer representing the number of seconds
-        /// since 1/1/1970 in UTC.  The command line client generally returns dates as strings
-        /// in the Perforce <b>server's</b> time zone.  The ConvertDate methods use the <b>client's</b> time zone for
-        /// the offset.
-        /// </remarks>
-        /// <returns>DateTime in .Net format.</returns>
-        public DateTime ConvertDate(int p4Date)
-        {
-            DateTime utc = _p4epoch.AddSeconds(p4Date);
-            return TimeZone.CurrentTimeZone.ToLocalTime(utc);
-        }
-
-        /// <summary>
-        /// Converts Perforce date (integer value as a string) to .Net DateTime.
-        /// </summary> 
-        /// <remarks>
-        /// The Perforce API returns most dates as an integer representing the number of seconds
-        /// since 1/1/1970 in UTC.  The command line client generally returns dates as strings
-        /// in the Perforce <b>server's</b> time zone.  The ConvertDate methods use the <b>client's</b> time zone for
-        /// the offset.
-        /// </remarks>
-        public DateTime ConvertDate(string p4Date)
-        {
-            return ConvertDate(int.Parse(p4Date));
-        }
-
-        /// <summary>
-        /// Converts .Net DateTime to Perforce date (integer).
-        /// </summary>
-        /// <remarks>
-        /// The Perforce API returns most dates as an integer representing the number of seconds
-        /// since 1/1/1970 in UTC.  The command line client generally returns dates as strings
-        /// in the Perforce <b>server's</b> time zone.  The ConvertDate methods use the <b>client's</b> time zone for
-        /// the offset.
-        /// </remarks>
-        public int ConvertDate(DateTime date)
-        {
-            DateTime utc = TimeZone.CurrentTimeZone.ToUniversalTime(date);
-            TimeSpan ts = utc.Subtract(_p4epoch);
-            return (int) ts.TotalSeconds;
-        }
-
-        #endregion
-
-        #region General Methods
-        /// <summary>
-        /// Checks the case-sensitivity of the Perforce server.
-        /// </summary>
-        /// <returns>True when the connected server is case-sensitive.</returns>
-        /// <remarks>This must be called after connecting to the server.</remarks>
-        public bool IsServerCaseSensitive()
-        {
-            if (!_Initialized) throw new P4API.Exceptions.ServerNotConnected();
-
-            string serverCase = _ClientAPI.GetProtocol("nocase");
-            if (serverCase == null)
-            {
-                return true;
-            }
-            else
-            {
-                return false;
-            }
-        }
-
-        /// <summary>
-        /// Connect to the Perforce server
-        /// </summary>
-        public void Connect()
-        {
-        
-            // reset the cached SpecDefs
-            cachedSpecDefs = new System.Collections.Specialized.StringDictionary();
-
-            EstablishConnection(_tagged);
-
-        }
-
-        /// <summary>
-        /// Disconnect from the Perforce Server
-        /// </summary>
-        public void Disconnect()
-        {
-            CloseConnection();
-         }
-
-        /// <summary>
-        /// Login to the Perforce Server
-        /// </summary>
-        /// <param name="password">The password.</param>
-        public void Login(string password)
-        {
-            if (password == null) throw new ArgumentNullException();
-            
-            // if password is empty, then don't do anything
-            if (password == string.Empty) return;
-
-            P4ExceptionLevels oldLevel = _exceptionLevel;
-            try
-            {
-                P4UnParsedRecordSet r = new P4UnParsedRecordSet();
-                P4RecordsetCallback cb = new P4RecordsetCallback(r);
-                r.LoginPassword = password;
-                string[] Args = { };
-                _exceptionLevel = P4ExceptionLevels.NoExceptionOnErrors;
-                
-               
-                RunCallbackUnparsed(cb, "login", Args);
-
-                //for good measure delete the password
-                r.LoginPassword = null;
-
-                if (r.HasErrors())
-                {
-                    throw new P4API.Exceptions.InvalidLogin(r.ErrorMessage);
-                }
-            }
-            finally
-            {
-                _exceptionLevel = oldLevel;
-            }
-
-        }
-
-        /// <summary>
-        /// Creates a new pending changelist.
-        /// </summary>
-        /// <param name="Description">The description.</param>
-        /// <returns>P4PendingChangelist object representing the named pending changelist</returns>
-        public P4PendingChangelist CreatePendingChangelist(string Description)
-        {
-            if (Description == null) throw new ArgumentNullException();
-            if (Description == string.Empty) throw new ArgumentException("Descrition can not be empty!");
-            
-            EstablishConnection(false);
-            return new P4PendingChangelist(Description, this);
-
-        }
-
-        /// <summary>
-        /// Determines if the Perforce connection is valid.
-        /// </summary>
-        /// <param name="checkLogin">if set to <c>true</c> it will check if the user is logged in.</param>
-        /// <param name="checkClient">if set to <c>true</c> it will verify the client exists.</param>
-        /// <returns>
-        /// 	<c>true</c> if the connection is valid; otherwise, <c>false</c>.
-        /// </returns>
-        /// <remarks>
-        /// IsValidConnection performs the following 3 checks (depending on the arguments passed).
-        /// <list type="numbered">
-        /// <li>Runs p4 info, and verifies the server is valid.</li>
-        /// <li>If checkClient is true, verifies that p4 info returns a clientName that is not "*unknown*.</li>
-        /// <li>If checkLogin is true, verifies that p4 login -s does not have errors.</li>
-        /// </list>
-        /// </remarks>
-        public bool IsValidConnection(bool checkLogin, bool checkClient)
-        {
-            P4ExceptionLevels oldExLevel = this.ExceptionLevel;
-            try
-            {
-                this.ExceptionLevel = P4ExceptionLevels.NoExceptionOnErrors;
-                P4RecordSet r = Run("info");
-                if (r.HasErrors()) return false;
-                if (r.Records.Length != 1) return false;
-                if (checkClient)
-                {
-                    if (!r.Records[0].Fields.ContainsKey("clientName")) return false;
-                    if (r.Records[0].Fields["clientName"] == "*unknown*") return false;
-                }
-                if (checkLogin)
-                {
-                    P4UnParsedRecordSet ur = RunUnParsed("login", "-s");
-                    if (ur.HasErrors()) return false;
-                }
-
-            }
-            catch
-            {
-                // something went way wrong
-                return false;
-            }
-            finally
-            {
-                // set the ExceptionLevel back
-                this.ExceptionLevel = oldExLevel;
-            }
-            return true;
-        }
-
-        /// <summary>
-        /// Executes a Perforce command in tagged mode.
-        /// </summary>
-        /// <param name="Command">The command.</param>
-        /// <param name="Args">The arguments to the Perforce command.  Remember to use a dash (-) in front of all switches</param>
-        /// <returns>A P4Recordset containing the results of the command.</returns>
-        public P4RecordSet Run(string Command, params string[] Args)
-        {
-            EstablishConnection(true);
-            P4RecordSet r = new P4RecordSet();
-            P4RecordsetCallback cb = new P4RecordsetCallback(r);
-
-            RunCallback(cb, Command, Args);
-            if (((_exceptionLevel == P4ExceptionLevels.ExceptionOnBothErrorsAndWarnings
-                 || _exceptionLevel == P4ExceptionLevels.NoExceptionOnWarnings)
-                 && r.HasErrors())
-                ||
-                  (_exceptionLevel == P4ExceptionLevels.ExceptionOnBothErrorsAndWarnings
-                   && r.HasWarnings())
-                )
-            {
-                throw new RunException(r);
-            }
-
-
-            return r;
-        }
-
-        /// <summary>
-        /// Runs the specified command, calling the appropriate callback methods as Perforce returns information.
-        /// </summary>
-        /// <param name="Command">The Perforce command to run.</param>
-        /// <param name="Callback">A callback instance to recieve information as the command is run.</param>
-        /// <param name="Args">Arguments to the Perforce command</param>
-        public void RunCallback(P4Callback Callback, string Command, params string[] Args)
-        {
-            CallbackClientUser cu = new CallbackClientUser(Callback);
-            CallbackKeepAlive keepAlive = new CallbackKeepAlive(cu);
-            EstablishConnection(true, keepAlive);
-            Callback.SetEncoding(m_ClientApi.Encoding);
-            RunIt(Command, Args, cu);
-
-            // always throw a defered exception (means something went WAY wrong)
-            if (cu.DeferedException != null)
-            {
-                throw cu.DeferedException;
-            }
-        }
-
-        /// <summary>
-        /// Runs the callback unparsed.
-        /// </summary>
-        /// <param name="Command">The command.</param>
-        /// <param name="Callback">The callback.</param>
-        /// <param name="Args">The args.</param>
-        public void RunCallbackUnparsed(P4Callback Callback, string Command, params string[] Args)
-        {
-            CallbackClientUser cu = new CallbackClientUser(Callback);
-            CallbackKeepAlive keepAlive = new CallbackKeepAlive(cu);
-            EstablishConnection(false, keepAlive);
-            Callback.SetEncoding(m_ClientApi.Encoding);
-            RunIt(Command, Args, cu);
-
-            // always throw a defered exception (means something went WAY wrong)
-            if (cu.DeferedException != null)
-            {
-                throw cu.DeferedException;
-            }
-        }
-
-        /// <summary>
-        /// Executes a Perforce command in non-tagged mode.
-        /// </summary>
-        /// <param name="Command">The command.</param>
-        /// <param name="Args">The args.</param>
-        /// <returns></returns>
-        public P4UnParsedRecordSet RunUnParsed(string Command, params string[] Args)
-        {
-            P4UnParsedRecordSet r = new P4UnParsedRecordSet();
-            P4RecordsetCallback cb = new P4RecordsetCallback(r);
-            P4BaseRecordSet.OnPromptEventHandler handler = new P4BaseRecordSet.OnPromptEventHandler(this.HandleOnPrompt);
-            r.OnPrompt += handler;
-            RunCallbackUnparsed(cb, Command, Args);
-            r.OnPrompt -= handler;
-
-            if (((_exceptionLevel == P4ExceptionLevels.ExceptionOnBothErrorsAndWarnings
-                 || _exceptionLevel == P4ExceptionLevels.NoExceptionOnWarnings)
-                 && r.HasErrors())
-                ||
-                  (_exceptionLevel == P4ExceptionLevels.ExceptionOnBothErrorsAndWarnings
-                   && r.HasWarnings())
-                )
-            {
-                throw new RunUnParsedException(r);
-            }
-
-            return r;
-        }
-        #endregion
-
-        #region Form Methods
-        /// <summary>
-        /// Parse the raw text of a Perforce form into a P4Form object
-        /// </summary>
-        /// <param name="formCommand">The form command.</param>
-        /// <param name="formContents">Raw contents of the form spec.</param>
-        /// <returns>
-        /// A P4Form object.  The fields of the form can be read or updated.  If you update a filed, you can save it with Save_Form.
-        /// </returns>
-        /// <include file='CodeDocuments.xml' path='//Forms/remarks' />
-        public P4Form Parse_Form(string formCommand, string formContents)
-        {
-            // logic stolen from P4Ruby.  Cache the spec defs, and load a form from the cached specdefs.
-
-            // If we don't have a cached Spec def, we need to create a dummy form to get it in the cache
-            if (!cachedSpecDefs.ContainsKey(formCommand))
-            {
-                string bogusSpec = "__p4net_bogus_spec__";
-                P4Form outputForm;
-
-                // 
-                // For specs of the following types we need the bogus spec name
-                //
-                if (formCommand == "branch" || formCommand == "label" || formCommand == "depot" || formCommand == "group")
-                {
-                    outputForm = Fetch_Form(formCommand, bogusSpec);
-                }
-                else
-                {
-                    outputForm = Fetch_Form(formCommand);
-                }                
-            }
-
-            return P4Form.LoadFromSpec(formCommand, cachedSpecDefs[formCommand], formContents, m_ClientApi.Encoding);
-        }
-
-        /// <summary>
-        /// Fetch a form object from Perforce.
-        /// </summary>
-        /// <param name="FormCommand">The form command.</param>
-        /// <param name="Args">The args.</param>
-        /// <returns>
-        /// A Form object.  The fields of the form can be read or updated.  If you update a filed, you can save it with Save_Form.
-        /// </returns>
-        /// <include file='CodeDocuments.xml' path='//Forms/remarks' />
-        public P4Form Fetch_Form(string FormCommand, params string[] Args)
-        {
-            if (FormCommand == null) throw new ArgumentNullException();
-            if (Args == null) throw new ArgumentNullException();
-
-            string[] AllArgs = new string[Args.Length + 1];
-            AllArgs[0] = "-o";
-
-            for (int i = 0; i < Args.Length ; i++)
-            {
-                if (Args[i] == null)
-                {
-                    throw new ArgumentNullException();
-                }
-                if (Args[i] == "-o")
-                {
-                    throw new InvalidFormArgument();
-                }
-                AllArgs[i+1] = Args[i];
-            }
-
-            EstablishConnection(true);
-
-            P4FormRecordSet r = new P4FormRecordSet(FormCommand, m_ClientApi.Encoding);
-            P4RecordsetCallback cb = new P4RecordsetCallback(r);
-
-            //RunIt(FormCommand, AllArgs, r.ResultClientUser);
-            RunCallback(cb, FormCommand, AllArgs);
-
-            // The Fetch_Form command must always throw an error
-            // because there will be no form to return if there's a 
-            // problem
-            if (r.HasErrors())
-            {
-                throw new FormFetchException(FormCommand, r.ErrorMessage);
-            }
-
-            // save the spec def, in case Parse_Form is called in the future
-            cachedSpecDefs[FormCommand] = r.Form.SpecDef;
-
-            return r.Form;
-        }
-
-        /// <summary>
-        /// Saves the form to Perforce.
-        /// </summary>
-        /// <param name="Form">The P4Form object retrieved from Fetch_Form.</param>
-        /// <include file='CodeDocuments.xml' path='//Forms/remarks' />
-        /// <returns>P4UnParsedRecordSet.  Output can be parsed to verify the form was processed correctly.</returns>
-        public P4UnParsedRecordSet Save_Form(P4Form Form)
-        {
-            return Save_Form(Form, false);
-        }
-
-        /// <summary>
-        /// Saves the form to Perforce.
-        /// </summary>
-        /// <param name="formCommand">The form command to run.</param>
-        /// <param name="formSpec">The formatted spec.</param>
-        /// <param name="args">Arguments to the form command.</param>
-        /// <returns>P4UnParsedRecordSet.  Output can be parsed to verify the form was processed correctly.</returns>
-        public P4UnParsedRecordSet Save_Form(string formCommand, string formSpec, params string[] args)
-        {
-            if (formCommand == null) throw new ArgumentNullException("formCommand");
-            if (formCommand == string.Empty) throw new ArgumentException("Parameter 'formCommand' can not be empty");
-            if (formSpec == null) throw new ArgumentNullException("formSpec");
-            if (formSpec == string.Empty) throw new ArgumentException("Parameter 'formSpec' can not be empt");
-
-            P4UnParsedRecordSet r = new P4UnParsedRecordSet();
-            P4RecordsetCallback cb = new P4RecordsetCallback(r);
-            r.InputData = formSpec;
-            List<string> formargs = new List<string>();
-            foreach (string arg in args)
-            {
-                if (arg == "-i" || arg == "-o")
-                {
-                    throw new InvalidFormArgument();
-                }
-                formargs.Add(arg);
-            }
-            formargs.Add("-i");
-
-            RunCallbackUnparsed(cb, formCommand, formargs.ToArray());
-        
-            if (((_exceptionLevel == P4ExceptionLevels.ExceptionOnBothErrorsAndWarnings
-                 || _exceptionLevel == P4ExceptionLevels.NoExceptionOnWarnings)
-                 && r.HasErrors())
-                ||
-                  (_exceptionLevel == P4ExceptionLevels.ExceptionOnBothErrorsAndWarnings
-                   && r.HasWarnings())
-                )
-            {
-                throw new RunUnParsedException(r);
-            }
-            return r;
-        }
-
-        /// <summary>
-        /// Saves the form to Perforce.
-        /// </summary>
-        /// <param name="formCommand">The form command to run.</param>
-        /// <param name="formSpec">The formatted spec.</param>
-        /// <param name="Force">True to pass the '-f' flag when saving.</param>
-        /// <returns>P4UnParsedRecordSet.  Output can be parsed to verify the form was processed correctly.</returns>
-        public P4UnParsedRecordSet Save_Form(string formCommand, string formSpec, bool Force)
-        {
-            if (formCommand == null) throw new ArgumentNullException("formCommand");
-            if (formCommand == string.Empty) throw new ArgumentException("Parameter 'formCommand' can not be empty");
-            if (formSpec == null) throw new ArgumentNullException("formSpec");
-            if (formSpec == string.Empty) throw new ArgumentException("Parameter 'formSpec' can not be empt");
-
-            if (Force)
-            {
-                return Save_Form(formCommand, formSpec, "-f");
-            }
-            return Save_Form(formCommand, formSpec);
-        }
-
-        /// <summary>
-        /// Saves the form to Perforce.
-        /// </summary>
-        /// <param name="Form">The P4Form object retrieved from Fetch_Form.</param>
-        /// <param name="Force">True to pass the '-f' flag when saving.</param>
-        /// <include file='CodeDocuments.xml' path='//Forms/remarks' />
-        /// <returns>P4UnParsedRecordSet.  Output can be parsed to verify the form was processed correctly.</returns>
-        public P4UnParsedRecordSet Save_Form(P4Form Form, bool Force)
-        {
-            if (Form == null) throw new ArgumentNullException("Form");
-            return Save_Form(Form.FormCommand, Form.FormatSpec(), Force);
-        }
-
-        /// <summary>
-        /// Saves the form to Perforce.
-        /// </summary>
-        /// <param name="Form">The P4Form object retrieved from Fetch_Form.</param>
-        /// <param name="args">Arguments passed to the form command.</param>
-        /// <include file='CodeDocuments.xml' path='//Forms/remarks' />
-        /// <returns>P4UnParsedRecordSet.  Output can be parsed to verify the form was processed correctly.</returns>
-        public P4UnParsedRecordSet Save_Form(P4Form Form, params string[] args)
-        {
-            if (Form == null) throw new ArgumentNullException("Form");
-            return Save_Form(Form.FormCommand, Form.FormatSpec(), args);
-        }
-
-        #endregion
-
-        #endregion
-
-        #region Print Methods
-        /// <summary>
-        /// Print the contents of a file in Perforce to a byte array.
-        /// </summary>
-        /// <param name="depotPath">Perforce path to the file.</param>
-        /// <returns>
-        /// Contents of the file.
-        /// Text files will be encoded with ANSI encodinge.  
-        /// Unicode files will be encoded as UTF-8 (regardless of P4CHARSET setting).
-        ///</returns>
-        public byte[] PrintBinary(string depotPath)
-        {
-            // use utf-16 encoding.  In theory this will be more effient, b/c 
-            // it will do only one conversion.
-            MemoryStream ms = new MemoryStream();
-            PrintStream(ms, depotPath);
-            byte[] ret = new byte[ms.Position];
-            ms.Position = 0;
-            ms.Read(ret, 0, ret.Length);
-            ms.Close();
-            return ret;
-        }
-
-        /// <summary>
-        /// Print the contents of a file in Perforce to a string.
-        /// </summary>
-        /// <param name="depotPath">Perforce path to the file.</param>
-        /// <returns>Contents of the file.</returns>
-        /// <remarks>
-        /// Attempting to call PrintText on a binary file will likely cause corruption.<br/>
-        /// If a file is does not exist, a FileNotFound exception will be thrown (regardless
-        /// of the ExceptionLevel setting).<br/>
-        /// Depot Path, Client Path or Local Path can generally be used for the argument
-        /// depotPath (so long as the argument is valid for the <code>p4 print</code> command line.
-        ///</remarks>
-        public string PrintText(string depotPath)
-        {
-            // use utf-16 encoding.  In theory this will be more effient, b/c 
-            // it will do only one conversion.
-            MemoryStream ms = new MemoryStream();
-            StreamReader sr = new StreamReader(ms, Encoding.Unicode);
-            PrintStream(ms, depotPath, Encoding.Unicode);
-            ms.Position = 0;
-            string ret = sr.ReadToEnd();
-            sr.Close();
-            ms.Close();
-            return ret;
-        }
-
-        /// <summary>
-        /// Prints the contents of a Perforce file to a Stream.
-        /// </summary>
-        /// <param name="stream">Writable stream to write the contents to.</param>
-        /// <param name="depotPath">Perforce path of the file to print.</param>
-        /// <param name="encoding">Text encoding of the Stream.</param>
-        /// <remarks>
-        /// If a file is does not exist, a FileNotFound exception will be thrown (regardless
-        /// of the ExceptionLevel setting).<br/>
-        /// Depot Path, Client Path or Local Path can generally be used for the argument
-        /// depotPath (so long as the argument is valid for the <code>p4 print</code> command line.<br/>
-        /// Encoding will only be applied to files with a Perforce type of 'text' or 'unicode'.<br/>
-        /// The stream argument can be any valid stream, so long as it is initialized and writable.<br/>
-        ///</remarks>
-        public void PrintStream(Stream stream, string depotPath, Encoding encoding)
-        {
-            if (stream == null) throw new ArgumentNullException();
-            if (depotPath == null) throw new ArgumentNullException();
-            if (depotPath == string.Empty) throw new ArgumentException("Argument depotPath can not be empty.");
-            if (!stream.CanWrite) throw new StreamNotWriteable();
-
-            PrintStreamHelper ph = new PrintStreamHelper(this);
-            int filesPrinted = ph.PrintStream(stream, depotPath, encoding);
-            if (filesPrinted < 1)
-            {
-                throw new Exceptions.FileNotFound(depotPath);
-            }
-        }
-
-        /// <summary>
-        /// Prints the contents of a Perforce file to a Stream.
-        /// </summary>
-        /// <param name="stream">Writable stream to write the contents to.</param>
-        /// <param name="depotPath">Perforce path of the file to print.</param>        
-        /// <remarks>
-        /// If a file is does not exist, a FileNotFound exception will be thrown (regardless
-        /// of the ExceptionLevel setting).<br/>
-        /// Depot Path, Client Path or Local Path can generally be used for the argument
-        /// depotPath (so long as the argument is valid for the <code>p4 print</code> command line.<br/>
-        /// The stream argument can be any valid stream, so long as it is initialized and writable.<br/>
-        ///</remarks>
-        public void PrintStream(Stream stream, string depotPath)
-        {
-            PrintStream(stream, depotPath, null);
-        }
-
-        /// <summary>
-        /// Runs a print command, and raises events for each file printed.
-        /// </summary>
-        /// <param name="args">Arguments to the <code>p4 print</code> command.</param>
-        /// <event>OnPrintStream</event>
-        /// <event>OnPrintEndFile</event>
-        /// <remarks>
-        /// This method is useful when you need to print several files with a single call
-        /// to the Perforce server.
-        /// </remarks>
-        /// <example><code language='c#'></code></example>
-        public void PrintStreamEvents(params string[] args)
-        {
-            P4PrintCallback pcb = new P4PrintCallback(this, OnPrintStream, OnPrintEndFile);
-            RunCallback(pcb, "print", args);
-        }
-
-        #endregion
-
-        #region Private Helper Methods
-        private ClientApi _ClientAPI
-        {
-            get
-            {
-                if (m_ClientApi == null)
-                {
-                    m_ClientApi = new ClientApi();
-                }
-                return m_ClientApi;
-            }
-        }
-
-        private void EstablishConnection(bool tagged)
-        {
-            EstablishConnection(tagged, null);
-        }
-        private void EstablishConnection(bool tagged, KeepAlive keepAlive)
-        {
-            if (m_ClientApi != null && m_ClientApi.Dropped() != 0)
-            {
-                // I can't figure out how to force this artificially, so currently untested :-(
-                CloseConnection();
-            }
-            if (m_ClientApi == null)
-            {
-                m_ClientApi = new ClientApi();
-            }
-            if (!_Initialized)
-            {
-                Error err = null;
-                try
-                {
-                    _tagged = tagged;
-                    err = m_ClientApi.CreateError();
-                   
-                    // Always use the specstring protocol.  We'll controll form output via SetTag
-                    // before each run
-                    m_ClientApi.SetProtocol("specstring", "");                    
-                    
-                    //May have lost our settings... reset here
-                    if (_Client != null) m_ClientApi.SetClient(_Client);
-                    if (_User != null) m_ClientApi.SetUser(_User);
-                    if (_CWD != null) m_ClientApi.SetCwd(_CWD);
-                    if (_Charset != null) m_ClientApi.SetCharset(_Charset);
-                    if (_Host != null) m_ClientApi.SetHost(_Host); 
-                    if (_Port != null) m_ClientApi.SetPort(_Port);
-                    if (_Password != null) m_ClientApi.SetPassword(_Password);
-                    if (_TicketFile != null) m_ClientApi.SetTicketFile(_TicketFile);
-                    if (_maxResults != 0) m_ClientApi.SetMaxResults(_maxResults);
-                    if (_maxScanRows != 0) m_ClientApi.SetMaxScanRows(_maxResults);
-                    if (_maxLockTime != 0) m_ClientApi.SetMaxLockTime(_maxLockTime);
-                    if (_ApiLevel != 0) m_ClientApi.SetProtocol("api", _ApiLevel.ToString());
-                    
-                    m_ClientApi.Init(err);
-                    if (err.Severity == Error.ErrorSeverity.Failed || err.Severity == Error.ErrorSeverity.Fatal)
-                    {
-                        throw new Exception("Unable to connect to Perforce!");
-                    }
-                    _Initialized = true;
-                    err.Dispose();
-                }
-                catch (Exception e)
-                {
-                    string message = "Perforce connection error.";
-                    try
-                    {
-                        m_ClientApi.Final(err);
-                        message = e.Message;
-                        err.Dispose();
-                        m_ClientApi.Dispose();
-                        m_ClientApi = null;
-                    }
-                    catch { }
-                    throw new PerforceInitializationError(message);
-                }
-            }
-            if (tagged) m_ClientApi.SetTag();
-            if (_CallingProgram != null) m_ClientApi.SetProg(_CallingProgram);
-            if (_CallingProgramVersion != null) m_ClientApi.SetVersion(_CallingProgramVersion);
-            m_ClientApi.SetBreak(keepAlive);
-        }
-        private void CloseConnection()
-        {
-            // Need to reset the connection
-            if (_Initialized)
-            {
-                Error err = m_ClientApi.CreateError();
-                m_ClientApi.Final(err);
-                err.Dispose();
-            }
-            if (m_ClientApi != null)
-            {
-                m_ClientApi.Dispose();
-                m_ClientApi = null;
-            }
-            _Initialized = false;            
-        }
-
-        private void RunIt(string command, string[] args, ClientUser cu)
-        {
-            // validate that none of the args are null
-            if (args == null)
-            {
-                throw new System.ArgumentNullException();
-            }
-
-            foreach (string arg in args)
-            {
-                if (arg == null)
-                {
-                    throw new System.ArgumentNullException();
-                }
-            }
-
-            m_ClientApi.SetArgv(args);
-            m_ClientApi.Run(command, cu);
-
-        }
-        private void HandleOnPrompt(object sender, P4PromptEventArgs e)
-        {
-            e.Response = RaiseOnPromptEvent(e.Message);
-        }
-        // Wrap event invocations inside a protected virtual method
-        // to allow derived classes to override the event invocation behavior
-        private string RaiseOnPromptEvent(string Message)
-        {
-            // Make a temporary copy of the event to avoid possibility of
-            // a race condition if the last subscriber unsubscribes
-            // immediately after the null check and before the event is raised.
-            OnPromptEventHandler handler = OnPrompt;
-
-            // Event will be null if there are no subscribers
-            if (handler != null)
-            {
-                P4PromptEventArgs e = new P4PromptEventArgs(Message);
-                
-                // Use the () operator to raise the event.
-                handler(this, e);
-                return e.Response; 
-            }
-            else
-            {
-                return string.Empty;
-            }
-        }
-        #endregion
-
-        #region IDisposable Members
-
-        /// <summary>
-        /// Calls Disconnect.
-        /// </summary>
-        public void Dispose()
-        {
-            this.Disconnect();
-        }
-
-        #endregion
-
-    }
-}
+/*
+ * P4.Net *
+Copyright (c) 2007-2010 Shawn Hladky
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+and associated documentation files (the "Software"), to deal in the Software without 
+restriction, including without limitation the rights to use, copy, modify, merge, publish, 
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or 
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+ */
+
+using System;
+using System.Text;
+using p4dn;
+using P4API.Exceptions;
+using System.IO;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Threading;
+#if CLR4
+using System.Threading.Tasks;
+#endif
+
+namespace P4API
+{
+    /// <summary>
+    /// Delegate to handle the OnPrompt event.
+    /// </summary>
+    /// <param name="sender">Sender</param>
+    /// <param name="args">P4PromptEventArgs</param>
+    /// <remarks>Handle Perforce "prompts".  Prompts are from commands that ask the user to respond, such as:
+    /// <list>
+    /// <li>login</li>
+    /// <li>passwd</li>
+    /// <li>resolve (without an -a* switch)</li>
+    /// </list>
+    /// </remarks>
+    /// <seealso  cref="P4API.P4Connection.OnPrompt"/>
+    public delegate void OnPromptEventHandler(object sender, P4PromptEventArgs args);
+
+    /// <summary>
+    /// Delegate to handle the OnRetry event.
+    /// </summary>
+    /// <param name="sender">Sender</param>
+    /// <param name="args">P4RetryEventArgs</param>
+    /// <seealso cref="P4API.P4Connection.OnRetry"/>
+    public delegate void OnRetryEventHandler(object sender, P4RetryEventArgs args);
+
+    /// <summary>
+    /// Delegate to handle the OnFailover event.
+    /// </summary>
+    /// <param name="sender">Sender</param>
+    /// <param name="args">P4FailoverEventArgs</param>
+    /// <seealso cref="P4API.P4Connection.OnFailover"/>
+    public delegate void OnFailoverEventHandler(object sender, P4FailoverEventArgs args);
+
+    /// <summary>
+    /// A connection to a Perforce server instance.
+    /// </summary>
+    /// <include file='CodeDocuments.xml' path='//P4Connection/remarks' />
+    public class P4Connection : IDisposable
+    {
+
+        /// <summary>
+        /// Static constructor makes sure custom assembly
+        /// resolver (Bootstrapper) is registered.
+        /// </summary>
+        static P4Connection()
+        {
+            Bootstrapper.Initialize();
+        }
+
+
+        #region Private Variables
+        private ClientApi m_ClientApi;
+        private bool _tagged = true;
+        private bool _Initialized;
+
+        private System.Collections.Specialized.StringDictionary cachedSpecDefs;
+        private string _CallingProgram;
+        private string _CallingProgramVersion;
+        private string _Client = null;
+        private string _Port = null;
+        private string _User = null;
+        private string _Host = null;
+        private string _CWD = null;
+        private string _Charset = null;
+        private string _Password = null;
+        private string _TicketFile = null;
+        private DateTime _p4epoch = new DateTime(1970, 1, 1);
+        private P4ExceptionLevels _exceptionLevel = P4ExceptionLevels.NoExceptionOnWarnings ;
+
+        private int _maxScanRows = 0;
+        private int _maxResults = 0;
+        private int _maxLockTime = 0;
+        private int _ApiLevel = 0;
+        private P4MessageFilter _messageFilter = null;
+        private TimeSpan _commandTimeout = TimeSpan.Zero;
+        private DateTime? _commandDeadline = null;
+        private P4CommandStatus _lastCommandStatus = P4CommandStatus.Completed;
+        private P4CommandStatistics _lastCommandStatistics = null;
+        private bool _serverTracking = false;
+        private TimeSpan _serverTrackingThreshold = TimeSpan.Zero;
+        private TextWriter _serverTrackingLog = null;
+        private P4ServerTracking _lastServerTracking = null;
+        private P4SessionRecorder _sessionRecorder = null;
+        private P4SessionReplay _sessionReplay = null;
+        private string[] _retryCommands = new string[] { "changes", "clients", "counters", "describe", "dirs",
+            "filelog", "files", "fstat", "info", "labels", "print", "sizes", "users" };
+        private int _maxRetries = 3;
+        private TimeSpan _retryBaseDelay = TimeSpan.FromMilliseconds(200);
+        private TimeSpan _retryMaxDelay = TimeSpan.FromSeconds(5);
+        private P4ResultCache _resultCache = null;
+        private P4SnapshotCache _snapshotCache = null;
+        private bool _warmStandby = false;
+        private bool _internValues = false;
+        private long _recordSetMemoryBudget = 0;
+        private string[] _internFields = new string[] { "action", "change", "client", "fileSize", "haveRev", "headAction",
+            "headChange", "headRev", "headType", "rev", "status", "type", "user" };
+        private readonly object _standbyLock = new object();
+        private ClientApi _standby = null;
+        private string _standbySettings = null;
+        private bool _standbyPreparing = false;
+        private int _standbyGeneration = 0;
+#if CLR4
+        private CancellationToken _cancellationToken = CancellationToken.None;
+        private P4IOScheduler _ioScheduler = null;
+        private SynchronizationContext _callbackContext = null;
+        private Queue<Action> _asyncQueue = new Queue<Action>();
+        private bool _asyncRunning = false;
+#endif
+        #endregion
+
+        #region Events
+        /// <summary>
+        /// Raised when Perforce is prompting for a response.
+        /// </summary>
+        /// <remarks>Handle Perforce "prompts".  Prompts are from commands that ask the user to respond, such as:
+        /// <list>
+        /// <li>login</li>
+        /// <li>passwd</li>
+        /// <li>resolve (without an -a* switch)</li>
+        /// </list>
+        /// </remarks>
+        /// <include file='CodeDocuments.xml' path='//OnPrompt/example' />
+        public event OnPromptEventHandler OnPrompt;
+
+        /// <summary>
+        /// Raised from P4PrintStreamEvents before a file is printed.
+        /// </summary>
+        /// <remarks> Handle this event to initialize a stream that P4API will write to.</remarks>
+        public event OnPrintStreamEventHandler OnPrintStream;
+
+        /// <summary>
+        /// Raised from P4PrintStreamEvents after a file is printed.
+        /// </summary>
+        /// <remarks>
+        /// Use this event to close any streams that were created by the OnPrintStreamEventHandler event.
+        /// </remarks>
+        public event OnPrintEndEventHandler OnPrintEndFile;
+
+        /// <summary>
+        /// Raised before a read-only command is retried after the connection dropped.
+        /// </summary>
+        /// <remarks>Set Cancel on the event arguments to give up instead.</remarks>
+        /// <seealso cref="RetryCommands"/>
+        public event OnRetryEventHandler OnRetry;
+
+        /// <summary>
+        /// Raised after a dropped connection has been re-established.
+        /// </summary>
+        /// <remarks>
+        /// Raised on the thread that runs the next command, before that command is sent.
+        /// </remarks>
+        /// <seealso cref="WarmStandby"/>
+        public event OnFailoverEventHandler OnFailover;
+
+        #endregion
+
+        #region Contructors
+        /// <summary>
+        /// Initializes a new instance of the P4Connection class.
+        /// </summary>
+        public P4Connection()
+        {
+            this._Initialized = false;
+            this._CallingProgram = "P4.Net API";
+            this._CallingProgramVersion = System.Reflection.Assembly.GetExecutingAssembly().GetName().Version.ToString();
+            cachedSpecDefs = new System.Collections.Specialized.StringDictionary();
+
+        }
+        #endregion
+
+        #region Public Properties
+        /// <summary>
+        /// Gets/Sets a value that overrides the defined MaxScanRows.
+        /// </summary>
+        /// <remarks>Servers may set a limit for MaxScanRows for certain users.  Set this value to override.  
+        /// A value of 0 indicates no override.</remarks>
+        /// <value>Overrides the MaxScanRows defined at the server.</value>
+        public int MaxScanRows
+        {
+            get
+            {
+                return _maxScanRows ;
+            }
+            set
+            {
+                _maxScanRows  = value;
+                //_ClientAPI.SetMaxScanRows(value);
+            }
+        }
+
+        /// <summary>
+        /// Gets/Sets a value that overrides the defined MaxLockTime.
+        /// </summary>
+        /// <remarks>Servers may set a limit for MaxLockTime for certain users.  Set this value to override.  
+        /// A value of 0 indicates no override.</remarks>
+        /// <value>Overrides the MaxLockTime defined at the server.</value>
+        public int MaxLockTime
+        {
+            get
+            {
+                return _maxLockTime;
+            }
+            set
+            {
+                _maxLockTime = value;
+                //_ClientAPI.SetMaxScanRows(value);
+            }
+        }        
+
+        /// <summary>
+        /// Gets/Sets a value that overrides the defined MaxResults.
+        /// </summary>
+        /// <remarks>Servers may set a limit for MaxResults for certain users.  Set this value to override.  
+        /// A value of 0 indicates no override.</remarks>
+        /// <value>Overrides the MaxResults defined at the server.</value>
+        public int MaxResults
+        {
+            get
+            {
+                return _maxResults;
+            }
+            set
+            {
+                _maxResults = value;
+                //_ClientAPI.SetMaxResults(value);
+            }
+        }
+
+        /// <summary>
+        /// Gets/Sets the Host-name of the client.
+        /// </summary>
+        /// <remarks>Forcing the Host to a different name is useful when using a client that
+        /// was defined on a different host.  Of course, that can cause issues with the client's
+        /// have list, so use with caution.</remarks>
+        /// <value>The client Host name.</value>
+        public string Host
+        {
+            get
+            {
+                return _ClientAPI.Host;
+            }
+            set
+            {
+                _Host = value;
+                _ClientAPI.SetHost(value);
+            }
+        }
+
+        /// <summary>
+        /// Gets/Sets the Perforce Server port.
+        /// </summary>
+        /// <value>The port.</value>
+        /// <remarks>Defaults to the value set in your Perforce environment.  Port can not be
+        /// changed after running Connect (not even after a Disconnect).  
+        /// To connect to a server on another port, create a new instance of P4Connection.
+        /// </remarks>
+        public string Port
+        {
+            get
+            {
+                return _ClientAPI.Port;
+            }
+            set
+            {
+                if (_Initialized) throw new ServerAlreadyConnected();
+                _Port = value;
+                _ClientAPI.SetPort(value);
+            }
+        }
+
+        /// <summary>
+        /// Gets/Sets the User login used to connect to Perforce.
+        /// </summary>
+        /// <value>The user.</value>
+        /// <remarks>Defaults to the value set in your Perforce environment.  
+        /// After you've set User, you can unset (revert to the default) by setting to User to null.</remarks>
+        public string User
+        {
+            get
+            {
+                return _ClientAPI.User;
+            }
+            set
+            {
+                _User = value;
+                _ClientAPI.SetUser(value);
+            }
+        }
+
+        /// <summary>
+        /// Gets/Sets the client character set.
+        /// </summary>
+        /// <remarks>Defaults to the value set in your Perforce environment.  
+        /// After you've set Charset, you can unset (revert to the default) by setting to Charset to null.</remarks>
+        /// <value>The client's charset.</value>
+        public string Charset
+        {
+            get
+            {
+                return _ClientAPI.Charset;
+            }
+            set
+            {
+                _Charset = value;
+                _ClientAPI.SetCharset(value);
+            }
+        }
+
+        /// <summary>
+        /// Get/Sets the name of the calling program.
+        /// </summary>
+        /// <remarks>This value is seen in p4 monitor and in the server log files.</remarks>
+        /// <value>Defaults to "P4.Net API".</value>
+        public string CallingProgram
+        {
+            get
+            {
+                return _CallingProgram;
+            }
+            set
+            {
+                if (_Initialized) throw new ServerNotConnected_SetVar_AfterInit();
+                _CallingProgram = value;
+                // Set these in the initialize section
+            }
+        }
+
+        /// <summary>
+        /// Gets/Sets the version of the calling program's version.
+        /// </summary>
+        /// <remarks>This value is seen in p4 monitor and the server log files.</remarks>
+        /// <value>Defaults to the assembly version of the P4API.dll.</value>
+        public string CallingVersion
+        {
+            get
+            {
+                return _CallingProgramVersion;
+            }
+            set
+            {
+                if (_Initialized) throw new ServerNotConnected_SetVar_AfterInit();
+                _CallingProgramVersion = value;
+                // Set these in the initialize section
+            }
+        }
+
+        /// <summary>
+        /// Sets the password to conenct with.
+        /// </summary>
+        /// <remarks>
+        /// Do not set the literal password with a server running security level 2 or higher.  
+        /// For those servers, Use the Login method and/or a ticket in place of the Password.
+        /// </remarks>
+        /// <value>The user's password.</value>
+        public string Password
+        {
+            get
+            {
+                return _ClientAPI.Password;
+            }
+            set
+            {
+                _Password = value;
+                _ClientAPI.SetPassword(value);
+            }
+        }
+
+        /// <summary>
+        /// Sets the ticket file used for Authentication.
+        /// </summary>
+        /// <remarks>
+        /// Use this to override the default location of the TicketFile.
+        /// </remarks>
+        /// <value>Overrided the ticket file location.</value>
+        public string TicketFile
+        {
+            get
+            {
+                return _TicketFile;
+            }
+            set
+            {
+                _TicketFile = value;
+                _ClientAPI.SetTicketFile(value);
+            }
+        }
+
+        /// <summary>
+        /// Sets the Language for message translations.
+        /// </summary>
+        /// <remarks>
+        /// Use this to override the default location of the TicketFile.
+        /// </remarks>
+        /// <value>Overrided the ticket file location.</value>
+        public string Language
+        {
+            get
+            {
+                return _ClientAPI.Language;
+            }
+            set
+            {
+                _ClientAPI.SetLanguage(value);
+            }
+        }
+
+
+        /// <summary>
+        /// Gets/Sets the client workspace.
+        /// </summary>
+        /// <remarks>Many Perforce commands require a valid client spec to be set in order to run.  
+        /// Defaults to the value set in your Perforce environment.  After you've set Client, you
+        /// can unset (revert to the default) by setting to Client to null.</remarks>
+        /// <value>The client name.</value>
+        public string Client
+        {
+            get
+            {
+                return _ClientAPI.Client;
+            }
+            set
+            {
+                _Client = value;
+                _ClientAPI.SetClient(value);
+            }
+        }
+
+        /// <summary>
+        /// Gets/Sets the current working directory.
+        /// </summary>
+        /// <remarks>Setting CWD can be used so that relative paths are specified.  Keep in mind that changing
+        /// the CWD also might cause P4CONFIG settings to change.</remarks>
+        /// <value>The current working directory for the Perforce connection.</value>
+        public string CWD
+        {
+            get
+            {
+                return _ClientAPI.Cwd;
+            }
+            set
+            {
+                _CWD = value;
+                _ClientAPI.SetCwd(value);
+            }
+        }
+
+        /// <summary>
+        /// Sets the client API protocol level.
+        /// </summary>
+        /// <remarks> Sets the API compatibility level desired. 
+        /// This is useful when writing scripts using Perforce commands that do not yet support tagged output. 
+        /// In these cases, upgrading to a later server that supports tagged output for the commands in question 
+        /// can break your script. Using this method allows you to lock your script to the 
+        /// output format of an older Perforce release and facilitate seamless upgrades. 
+        /// Note that this method must be called prior to calling Connect.
+        /// <br/>
+        /// See the http://kb.perforce.com/P4dServerReference/ProtocolLevels/PerforceClientLevels for the API integer levels that correspond to each Perforce release.
+        /// </remarks>
+        /// <value>The Perforce API level.</value>
+        public int Api
+        {
+            get
+            {
+                return _ApiLevel;
+            }
+            set
+            {
+                _ApiLevel = value;
+                _ClientAPI.SetProtocol("api", value.ToString());
+            }
+        }
+
+        /// <summary>
+        /// Gets/Sets the Exception level when running Perforce commands.
+        /// </summary>
+        /// <remarks>
+        /// <para>This property controls when P4.Net will throw exceptions
+        /// when the underlying Perforce commands raise errors and warnings.</para>
+        /// <para>The default is NoExceptionOnWarnings</para></remarks>
+        /// <value>The exception level for the connection.</value>
+        public P4ExceptionLevels ExceptionLevel
+        {
+            get
+            {
+                return _exceptionLevel;
+            }
+            set
+            {
+                _exceptionLevel = value;
+            }
+        }
+
+        /// <summary>
+        /// Gets/Sets the filter applied to messages returned from Perforce commands.
+        /// </summary>
+        /// <remarks>
+        /// Messages rejected by the filter are dropped before they reach P4.Net, so they do not show up in
+        /// Messages, Errors or Warnings (and do not cause exceptions).  Use <see cref="P4BaseRecordSet.SuppressedMessageCount"/>
+        /// to see how many were dropped.  Set to null (the default) to receive all messages.
+        /// </remarks>
+        /// <value>The message filter for subsequent commands.</value>
+        public P4MessageFilter MessageFilter
+        {
+            get
+            {
+                return _messageFilter;
+            }
+            set
+            {
+                _messageFilter = value;
+            }
+        }
+
+        /// <summary>
+        /// Gets/Sets the recorder that captures subsequent commands to a session file.
+        /// </summary>
+        /// <remarks>
+        /// Set to null (the default) to stop recording.  The connection does not own the recorder; dispose it when done.
+        /// </remarks>
+        /// <value>The session recorder.</value>
+        public P4SessionRecorder SessionRecorder
+        {
+            get
+            {
+                return _sessionRecorder;
+            }
+            set
+            {
+                _sessionRecorder = value;
+            }
+        }
+
+        /// <summary>
+        /// Gets/Sets a recorded session to play back instead of connecting to a server.
+        /// </summary>
+        /// <remarks>
+        /// SessionReplay can not be changed after running Connect (not even after a Disconnect).
+        /// Output is decoded with the encoding of the connection that recorded the session.
+        /// </remarks>
+        /// <value>The session replay, or null (the default) to talk to the server.</value>
+        public P4SessionReplay SessionReplay
+        {
+            get
+            {
+                return _sessionReplay;
+            }
+            set
+            {
+                if (_Initialized) throw new ServerAlreadyConnected();
+                _sessionReplay = value;
+            }
+        }
+
+#if CLR4
+        /// <summary>
+        /// Gets/Sets the scheduler whose threads run this connection's asynchronous commands.
+        /// </summary>
+        /// <value>Defaults to <see cref="P4IOScheduler.DefaultScheduler"/>.</value>
+        public P4IOScheduler IOScheduler
+        {
+            get
+            {
+                return _ioScheduler ?? P4IOScheduler.DefaultScheduler;
+            }
+            set
+            {
+                _ioScheduler = value;
+            }
+        }
+
+        /// <summary>
+        /// Gets/Sets the context that RunCallbackAsync raises callback methods on.
+        /// </summary>
+        /// <remarks>
+        /// Output is posted to the context in order, and the command keeps running without waiting for it.  Prompt, InputData,
+        /// ResolveFile and Edit are sent, so the command waits for their answer.  Cancel is always called on the I/O thread.
+        /// The returned Task completes after every callback has been delivered, so don't block the context's thread on it.
+        /// </remarks>
+        /// <value>Null (the default) raises callbacks directly on the I/O thread.</value>
+        public SynchronizationContext CallbackContext
+        {
+            get
+            {
+                return _callbackContext;
+            }
+            set
+            {
+                _callbackContext = value;
+            }
+        }
+#endif
+
+        /// <summary>
+        /// Gets/Sets the maximum time a single command may run.
+        /// </summary>
+        /// <remarks>
+        /// When the timeout expires the command is stopped and <see cref="LastCommandStatus"/> is TimedOut.
+        /// The check is made natively each time the Perforce API polls for a break, so it is not exact.
+        /// Use TimeSpan.Zero (the default) for no timeout.
+        /// </remarks>
+        /// <value>The per-command timeout.</value>
+        public TimeSpan CommandTimeout
+        {
+            get
+            {
+                return _commandTimeout;
+            }
+            set
+            {
+                if (value < TimeSpan.Zero)
+                {
+                    throw new ArgumentOutOfRangeException("value");
+                }
+                _commandTimeout = value;
+            }
+        }
+
+        /// <summary>
+        /// Gets/Sets an absolute time after which commands are stopped.
+        /// </summary>
+        /// <remarks>
+        /// Applies to every command run while set, together with <see cref="CommandTimeout"/> (whichever expires first wins).
+        /// Set to null (the default) for no deadline.
+        /// </remarks>
+        /// <value>The deadline (local time) for subsequent commands.</value>
+        public DateTime? CommandDeadline
+        {
+            get
+            {
+                return _commandDeadline;
+            }
+            set
+            {
+                _commandDeadline = value;
+            }
+        }
+
+        /// <summary>
+        /// Gets how the last command ended.
+        /// </summary>
+        /// <value>Completed, Cancelled or TimedOut.</value>
+        public P4CommandStatus LastCommandStatus
+        {
+            get
+            {
+                return _lastCommandStatus;
+            }
+        }
+
+        /// <summary>
+        /// Gets the performance counters for the last command.
+        /// </summary>
+        /// <value>Statistics for the last command, or null if no command has been run.</value>
+        public P4CommandStatistics LastCommandStatistics
+        {
+            get
+            {
+                return _lastCommandStatistics;
+            }
+        }
+
+        /// <summary>
+        /// Gets/Sets whether the server is asked for performance tracking data on each command.
+        /// </summary>
+        /// <remarks>
+        /// This is the same data as <c>p4 -Ztrack</c>.  The tracking lines are not returned as messages or info lines; they
+        /// are parsed into <see cref="P4BaseRecordSet.ServerTracking"/> and <see cref="LastServerTracking"/>.
+        /// The server only sends tracking for commands that are tracked by its configuration, and may send none for cheap commands.
+        /// </remarks>
+        /// <value>True to request tracking.  The default is false.</value>
+        public bool ServerTracking
+        {
+            get
+            {
+                return _serverTracking;
+            }
+            set
+            {
+                _serverTracking = value;
+            }
+        }
+
+        /// <summary>
+        /// Gets/Sets the server lapse time above which tracking is written to <see cref="ServerTrackingLog"/>.
+        /// </summary>
+        /// <value>The threshold.  TimeSpan.Zero (the default) logs every tracked command.</value>
+        public TimeSpan ServerTrackingThreshold
+        {
+            get
+            {
+                return _serverTrackingThreshold;
+            }
+            set
+            {
+                _serverTrackingThreshold = value;
+            }
+        }
+
+        /// <summary>
+        /// Gets/Sets where tracking for slow commands is written.
+        /// </summary>
+        /// <remarks>Each entry is the command, its arguments and the raw tracking lines.  Set to null (the default) to turn logging off.</remarks>
+        /// <value>The log writer.</value>
+        public TextWriter ServerTrackingLog
+        {
+            get
+            {
+                return _serverTrackingLog;
+            }
+            set
+            {
+                _serverTrackingLog = value;
+            }
+        }
+
+        /// <summary>
+        /// Gets the server's performance tracking for the last command.
+        /// </summary>
+        /// <value>The tracking data, or null if tracking was off or the server sent none.</value>
+        public P4ServerTracking LastServerTracking
+        {
+            get
+            {
+                return _lastServerTracking;
+            }
+        }
+
+        /// <summary>
+        /// Gets/Sets whether tagged keys and repeated values share one string per distinct value.
+        /// </summary>
+        /// <remarks>
+        /// <para>Large result sets repeat the same few values (actions, file types, users, changes) thousands of times.
+        /// With this on, each command gets a bounded pool, keyed by the raw bytes from the server, that hands back the same
+        /// string for every repeat of a key, of a value from a field in <see cref="InternFields"/>, or of a value of four
+        /// bytes or less.  Other values are converted as usual.</para>
+        /// <para>The pool is dropped when the command ends.  <see cref="P4CommandStatistics.InternHits"/> and
+        /// <see cref="P4CommandStatistics.InternBytesSaved"/> on the recordset's <see cref="P4BaseRecordSet.Statistics"/>
+        /// show what it saved.</para>
+        /// </remarks>
+        /// <value>True to intern.  The default is false.</value>
+        public bool InternValues
+        {
+            get
+            {
+                return _internValues;
+            }
+            set
+            {
+                _internValues = value;
+            }
+        }
+
+        /// <summary>
+        /// Gets/Sets the fields whose values are interned when <see cref="InternValues"/> is on.
+        /// </summary>
+        /// <remarks>List fields with few distinct values.  Values longer than 64 bytes are never interned.</remarks>
+        /// <value>Defaults to action, change, client, fileSize, haveRev, headAction, headChange, headRev, headType, rev,
+        /// status, type and user.</value>
+        public string[] InternFields
+        {
+            get
+            {
+                return (string[])_internFields.Clone();
+            }
+            set
+            {
+                _internFields = (value == null) ? new string[0] : (string[])value.Clone();
+            }
+        }
+
+        /// <summary>
+        /// Gets/Sets roughly how much memory the records of one <see cref="Run"/> may take before they go to disk.
+        /// </summary>
+        /// <remarks>
+        /// <para>Past the budget the records collected so far, and any that follow, are written in a compact binary
+        /// form to a temp file.  The recordset reads them back one at a time through its indexer and enumerator;
+        /// see <see cref="P4RecordSet.IsSpilled"/>.  Messages and info lines stay in memory.</para>
+        /// <para>Spilled recordsets aren't kept by <see cref="ResultCache"/> or <see cref="SnapshotCache"/>.</para>
+        /// </remarks>
+        /// <value>The budget in bytes.  0 (the default) keeps every record in memory.</value>
+        public long RecordSetMemoryBudget
+        {
+            get
+            {
+                return _recordSetMemoryBudget;
+            }
+            set
+            {
+                if (value < 0) throw new ArgumentOutOfRangeException("value");
+                _recordSetMemoryBudget = value;
+            }
+        }
+
+        /// <summary>
+        /// Gets the process-wide Perforce API diagnostics (debug levels, tunables and debug output capture).
+        /// </summary>
+        /// <remarks>The same instance is shared by all connections.</remarks>
+        public static P4Diagnostics Diagnostics
+        {
+            get
+            {
+                return P4Diagnostics.Instance;
+            }
+        }
+
+        /// <summary>
+        /// Gets/Sets the commands that are retried when the connection drops while they run.
+        /// </summary>
+        /// <remarks>
+        /// <para>Only list commands that don't change anything on the server: a retried command is simply run again.</para>
+        /// <para>Only Run and RunUnParsed retry.  Callback and print-stream runs have already handed output to the caller,
+        /// so they return what they got and the connection is re-established on the next command.</para>
+        /// </remarks>
+        /// <value>Defaults to changes, clients, counters, describe, dirs, filelog, files, fstat, info, labels, print,
+        /// sizes and users.</value>
+        public string[] RetryCommands
+        {
+            get
+            {
+                return (string[])_retryCommands.Clone();
+            }
+            set
+            {
+                _retryCommands = (value == null) ? new string[0] : (string[])value.Clone();
+            }
+        }
+
+        /// <summary>
+        /// Gets/Sets how many times a command in <see cref="RetryCommands"/> is retried after the connection drops.
+        /// </summary>
+        /// <value>Defaults to 3.  Set to 0 to turn off retries.</value>
+        public int MaxRetries
+        {
+            get
+            {
+                return _maxRetries;
+            }
+            set
+            {
+                if (value < 0) throw new ArgumentOutOfRangeException("value");
+                _maxRetries = value;
+            }
+        }
+
+        /// <summary>
+        /// Gets/Sets the wait before the first retry.  Each further retry waits twice as long, up to <see cref="RetryMaxDelay"/>.
+        /// </summary>
+        /// <value>Defaults to 200 milliseconds.</value>
+        public TimeSpan RetryBaseDelay
+        {
+            get
+            {
+                return _retryBaseDelay;
+            }
+            set
+            {
+                if (value < TimeSpan.Zero) throw new ArgumentOutOfRangeException("value");
+                _retryBaseDelay = value;
+            }
+        }
+
+        /// <summary>
+        /// Gets/Sets the longest wait between retries.
+        /// </summary>
+        /// <value>Defaults to 5 seconds.</value>
+        public TimeSpan RetryMaxDelay
+        {
+            get
+            {
+                return _retryMaxDelay;
+            }
+            set
+            {
+                if (value < TimeSpan.Zero) throw new ArgumentOutOfRangeException("value");
+                _retryMaxDelay = value;
+            }
+        }
+
+        /// <summary>
+        /// Gets/Sets the cache that Run and RunUnParsed use for hot read-only commands.
+        /// </summary>
+        /// <remarks>
+        /// One cache can be shared by many connections (and threads), which is where it pays off: identical commands
+        /// that overlap run once.  Results of cached commands are read-only.  See <see cref="P4ResultCache"/>.
+        /// </remarks>
+        /// <value>Defaults to null (no caching).</value>
+        public P4ResultCache ResultCache
+        {
+            get
+            {
+                return _resultCache;
+            }
+            set
+            {
+                _resultCache = value;
+            }
+        }
+
+        /// <summary>
+        /// Gets/Sets the on-disk cache that Run and RunUnParsed use for queries pinned to submitted history.
+        /// </summary>
+        /// <remarks>
+        /// Queries like <c>files //depot/...@12345</c> or <c>print //depot/a.c#3</c> are answered from disk when they were
+        /// seen before, without connecting.  See <see cref="P4SnapshotCache"/> for what is admitted.
+        /// </remarks>
+        /// <value>Defaults to null (no snapshot cache).</value>
+        public P4SnapshotCache SnapshotCache
+        {
+            get
+            {
+                return _snapshotCache;
+            }
+            set
+            {
+                _snapshotCache = value;
+            }
+        }
+
+        /// <summary>
+        /// Gets/Sets whether a second, already connected session is kept ready in the background.
+        /// </summary>
+        /// <remarks>
+        /// <para>When the connection drops, the next command normally reconnects from scratch on the caller's thread.
+        /// With WarmStandby on, the standby session is swapped in instead, and a new standby is prepared in the
+        /// background.</para>
+        /// <para>The standby is thrown away (and the reconnect done the slow way) if connection settings such as
+        /// User or Client changed since it was prepared.  It counts as a connection to the server.</para>
+        /// <para>Not used while replaying a session.</para>
+        /// </remarks>
+        /// <value>Defaults to false.</value>
+        public bool WarmStandby
+        {
+            get
+            {
+                return _warmStandby;
+            }
+            set
+            {
+                _warmStandby = value;
+                if (value)
+                {
+                    PrepareStandby();
+                }
+                else
+                {
+                    DiscardStandby();
+                }
+            }
+        }
+
+        /// <summary>
+        /// Requests that the running command stop.
+        /// </summary>
+        /// <remarks>
+        /// This is the only member of P4Connection that may be called from another thread while a command is running.
+        /// It just sets a flag that the Perforce API checks periodically; it does nothing if no command is running.
+        /// </remarks>
+        public void Cancel()
+        {
+            ClientApi api = m_ClientApi;
+            if (api != null)
+            {
+                api.Cancel();
+            }
+        }
+
+        /// <summary>
+        /// Checks the server level (version) of the Perforce server.
+        /// </summary>
+        /// <returns>The server's version level.</returns>
+        /// <remarks>See http://kb.perforce.com/P4dServerReference/ProtocolLevels/PerforceServerLevels for more informantion.</remarks>
+        /// <value>The server's version level.</value>
+        public int ServerLevel
+        {
+            get
+            {
+                if (!_Initialized) throw new P4API.Exceptions.ServerNotConnected();
+
+                string serverLevel = _ClientAPI.GetProtocol("server2");
+                if (serverLevel == null)
+                {
+                    return 0;
+                }
+                else
+                {
+                    return int.Parse(serverLevel);
+                }
+            }
+        }
+           
+
+        #endregion
+
+        #region Public Methods
+
+        #region Date Converion Methods
+        /// <summary>
+        /// Converts Perforce date (integer) to .Net DateTime.
+        /// </summary>
+        /// <remarks>
+        /// The Perforce API returns most dates as an integer representing the number of seconds
+        /// since 1/1/1970 in UTC.  The command line client generally returns dates as strings
+        /// in the Perforce <b>server's</b> time zone.  The ConvertDate methods use the <b>client's</b> time zone for
+        /// the offset.
+        /// </remarks>
+        /// <returns>DateTime in .Net format.</returns>
+        public DateTime ConvertDate(int p4Date)
+        {
+            DateTime utc = _p4epoch.AddSeconds(p4Date);
+            return TimeZone.CurrentTimeZone.ToLocalTime(utc);
+        }
+
+        /// <summary>
+        /// Converts Perforce date (integer value as a string) to .Net DateTime.
+        /// </summary> 
+        /// <remarks>
+        /// The Perforce API returns most dates as an integer representing the number of seconds
+        /// since 1/1/1970 in UTC.  The command line client generally returns dates as strings
+        /// in the Perforce <b>server's</b> time zone.  The ConvertDate methods use the <b>client's</b> time zone for
+        /// the offset.
+        /// </remarks>
+        public DateTime ConvertDate(string p4Date)
+        {
+            return ConvertDate(int.Parse(p4Date));
+        }
+
+        /// <summary>
+        /// Converts .Net DateTime to Perforce date (integer).
+        /// </summary>
+        /// <remarks>
+        /// The Perforce API returns most dates as an integer representing the number of seconds
+        /// since 1/1/1970 in UTC.  The command line client generally returns dates as strings
+        /// in the Perforce <b>server's</b> time zone.  The ConvertDate methods use the <b>client's</b> time zone for
+        /// the offset.
+        /// </remarks>
+        public int ConvertDate(DateTime date)
+        {
+            DateTime utc = TimeZone.CurrentTimeZone.ToUniversalTime(date);
+            TimeSpan ts = utc.Subtract(_p4epoch);
+            return (int) ts.TotalSeconds;
+        }
+
+        #endregion
+
+        #region General Methods
+        /// <summary>
+        /// Checks the case-sensitivity of the Perforce server.
+        /// </summary>
+        /// <returns>True when the connected server is case-sensitive.</returns>
+        /// <remarks>This must be called after connecting to the server.</remarks>
+        public bool IsServerCaseSensitive()
+        {
+            if (!_Initialized) throw new P4API.Exceptions.ServerNotConnected();
+
+            string serverCase = _ClientAPI.GetProtocol("nocase");
+            if (serverCase == null)
+            {
+                return true;
+            }
+            else
+            {
+                return false;
+            }
+        }
+
+        /// <summary>
+        /// Connect to the Perforce server
+        /// </summary>
+        public void Connect()
+        {
+        
+            // reset the cached SpecDefs
+            cachedSpecDefs = new System.Collections.Specialized.StringDictionary();
+
+            EstablishConnection(_tagged);
+
+        }
+
+        /// <summary>
+        /// Disconnect from the Perforce Server
+        /// </summary>
+        public void Disconnect()
+        {
+            CloseConnection();
+         }
+
+        /// <summary>
+        /// Login to the Perforce Server
+        /// </summary>
+        /// <param name="password">The password.</param>
+        public void Login(string password)
+        {
+            if (password == null) throw new ArgumentNullException();
+            
+            // if password is empty, then don't do anything
+            if (password == string.Empty) return;
+
+            P4ExceptionLevels oldLevel = _exceptionLevel;
+            try
+            {
+                P4UnParsedRecordSet r = new P4UnParsedRecordSet();
+                P4RecordsetCallback cb = new P4RecordsetCallback(r);
+                r.LoginPassword = password;
+                string[] Args = { };
+                _exceptionLevel = P4ExceptionLevels.NoExceptionOnErrors;
+                
+               
+                RunCallbackUnparsed(cb, "login", Args);
+
+                //for good measure delete the password
+                r.LoginPassword = null;
+
+                if (r.HasErrors())
+                {
+                    throw new P4API.Exceptions.InvalidLogin(r.ErrorMessage);
+                }
+            }
+            finally
+            {
+                _exceptionLevel = oldLevel;
+            }
+
+        }
+
+        /// <summary>
+        /// Creates a feed of the changes submitted from now on.
+        /// </summary>
+        /// <param name="paths">Depot paths to watch (e.g. //depot/main/...).  None means the whole depot.</param>
+        /// <returns>A P4ChangeFeed positioned at the last submitted change.</returns>
+        /// <remarks>The feed has the connection to itself while it polls; give it a connection of its own.</remarks>
+        public P4ChangeFeed CreateChangeFeed(params string[] paths)
+        {
+            if (paths == null) throw new ArgumentNullException("paths");
+
+            string[] args = new string[paths.Length + 3];
+            args[0] = "-m1";
+            args[1] = "-s";
+            args[2] = "submitted";
+            paths.CopyTo(args, 3);
+
+            P4RecordSet r = Run("changes", args);
+            int position = (r.Records.Length == 0) ? 0 : int.Parse(r.Records[0].Fields["change"]);
+            return new P4ChangeFeed(this, (string[])paths.Clone(), position);
+        }
+
+        /// <summary>
+        /// Creates a feed of the changes submitted after a given change.
+        /// </summary>
+        /// <param name="position">The last change already seen.  Overridden by the feed's CheckpointFile, if set.</param>
+        /// <param name="paths">Depot paths to watch (e.g. //depot/main/...).  None means the whole depot.</param>
+        /// <returns>A P4ChangeFeed.</returns>
+        /// <remarks>The feed has the connection to itself while it polls; give it a connection of its own.</remarks>
+        public P4ChangeFeed CreateChangeFeed(int position, params string[] paths)
+        {
+            if (paths == null) throw new ArgumentNullException("paths");
+            if (position < 0) throw new ArgumentOutOfRangeException("position");
+            return new P4ChangeFeed(this, (string[])paths.Clone(), position);
+        }
+
+        /// <summary>
+        /// Creates a new pending changelist.
+        /// </summary>
+        /// <param name="Description">The description.</param>
+        /// <returns>P4PendingChangelist object representing the named pending changelist</returns>
+        public P4PendingChangelist CreatePendingChangelist(string Description)
+        {
+            if (Description == null) throw new ArgumentNullException();
+            if (Description == string.Empty) throw new ArgumentException("Descrition can not be empty!");
+            
+            EstablishConnection(false);
+            return new P4PendingChangelist(Description, this);
+
+        }
+
+        /// <summary>
+        /// Determines if the Perforce connection is valid.
+        /// </summary>
+        /// <param name="checkLogin">if set to <c>true</c> it will check if the user is logged in.</param>
+        /// <param name="checkClient">if set to <c>true</c> it will verify the client exists.</param>
+        /// <returns>
+        /// 	<c>true</c> if the connection is valid; otherwise, <c>false</c>.
+        /// </returns>
+        /// <remarks>
+        /// IsValidConnection performs the following 3 checks (depending on the arguments passed).
+        /// <list type="numbered">
+        /// <li>Runs p4 info, and verifies the server is valid.</li>
+        /// <li>If checkClient is true, verifies that p4 info returns a clientName that is not "*unknown*.</li>
+        /// <li>If checkLogin is true, verifies that p4 login -s does not have errors.</li>
+        /// </list>
+        /// </remarks>
+        public bool IsValidConnection(bool checkLogin, bool checkClient)
+        {
+            P4ExceptionLevels oldExLevel = this.ExceptionLevel;
+            try
+            {
+                this.ExceptionLevel = P4ExceptionLevels.NoExceptionOnErrors;
+                P4RecordSet r = Run("info");
+                if (r.HasErrors()) return false;
+                if (r.Records.Length != 1) return false;
+                if (checkClient)
+                {
+                    if (!r.Records[0].Fields.ContainsKey("clientName")) return false;
+                    if (r.Records[0].Fields["clientName"] == "*unknown*") return false;
+                }
+                if (checkLogin)
+                {
+                    P4UnParsedRecordSet ur = RunUnParsed("login", "-s");
+                    if (ur.HasErrors()) return false;
+                }
+
+            }
+            catch
+            {
+                // something went way wrong
+                return false;
+            }
+            finally
+            {
+                // set the ExceptionLevel back
+                this.ExceptionLevel = oldExLevel;
+            }
+            return true;
+        }
+
+        /// <summary>
+        /// Executes a Perforce command in tagged mode.
+        /// </summary>
+        /// <param name="Command">The command.</param>
+        /// <param name="Args">The arguments to the Perforce command.  Remember to use a dash (-) in front of all switches</param>
+        /// <returns>A P4Recordset containing the results of the command.</returns>
+        public P4RecordSet Run(string Command, params string[] Args)
+        {
+            P4RecordSet r = RunSnapshot<P4RecordSet>(true, Command, Args, delegate
+            {
+                EstablishConnection(true);
+                P4RecordSet attempt = new P4RecordSet();
+                attempt.SpillThreshold = _recordSetMemoryBudget;
+                RunCallback(new P4RecordsetCallback(attempt), Command, Args);
+                attempt.CommandStatus = _lastCommandStatus;
+                attempt.Statistics = _lastCommandStatistics;
+                attempt.ServerTracking = _lastServerTracking;
+                return attempt;
+            });
+            if (((_exceptionLevel == P4ExceptionLevels.ExceptionOnBothErrorsAndWarnings
+                 || _exceptionLevel == P4ExceptionLevels.NoExceptionOnWarnings)
+                 && r.HasErrors())
+                ||
+                  (_exceptionLevel == P4ExceptionLevels.ExceptionOnBothErrorsAndWarnings
+                   && r.HasWarnings())
+                )
+            {
+                throw new RunException(r);
+            }
+
+
+            return r;
+        }
+
+        /// <summary>
+        /// Executes a Perforce command in tagged mode, writing its records to a file instead of a recordset.
+        /// </summary>
+        /// <remarks>
+        /// The records are encoded as they arrive, before any .NET strings are made for them, in the compact format
+        /// described on <see cref="P4RecordFile"/>.  Open the file with a P4RecordFile, in this process or another, to
+        /// read them.  When the command is cancelled, times out or loses its connection, no file is left behind.
+        /// </remarks>
+        /// <param name="path">The file to write; an existing file is replaced.</param>
+        /// <param name="compress">True to deflate-compress each block of records.</param>
+        /// <param name="Command">The command.</param>
+        /// <param name="Args">The arguments to the Perforce command.  Remember to use a dash (-) in front of all switches</param>
+        /// <returns>A P4Recordset with the command's messages, errors and statistics, and no records.</returns>
+        public P4RecordSet RunToFile(string path, bool compress, string Command, params string[] Args)
+        {
+            if (path == null) throw new ArgumentNullException("path");
+
+            P4RecordSet r = RunWithRetry<P4RecordSet>(Command, delegate
+            {
+                P4RecordSet attempt = new P4RecordSet();
+                P4RecordFileWriter writer = new P4RecordFileWriter(path, compress);
+                bool written = false;
+                try
+                {
+                    EstablishConnection(true);
+                    ClientApi api = m_ClientApi;
+                    api.SetRecordSink(writer);
+                    try
+                    {
+                        RunCallback(new P4RecordsetCallback(attempt), Command, Args);
+                    }
+                    finally
+                    {
+                        api.SetRecordSink(null);
+                    }
+
+                    // only a run that got all its records gets a footer; a retry writes the file again
+                    if (_lastCommandStatus == P4CommandStatus.Completed && api.Dropped() == 0)
+                    {
+                        writer.Close(api.Encoding.CodePage);
+                        written = true;
+                    }
+                }
+                finally
+                {
+                    if (!written) writer.Abandon();
+                }
+                attempt.CommandStatus = _lastCommandStatus;
+                attempt.Statistics = _lastCommandStatistics;
+                attempt.ServerTracking = _lastServerTracking;
+                return attempt;
+            });
+            if (((_exceptionLevel == P4ExceptionLevels.ExceptionOnBothErrorsAndWarnings
+                 || _exceptionLevel == P4ExceptionLevels.NoExceptionOnWarnings)
+                 && r.HasErrors())
+                ||
+                  (_exceptionLevel == P4ExceptionLevels.ExceptionOnBothErrorsAndWarnings
+                   && r.HasWarnings())
+                )
+            {
+                throw new RunException(r);
+            }
+            return r;
+        }
+
+        // Runs a tagged command with just one field of each record going to sink, natively encoded (see
+        // ClientApi.SetRecordSink); everything else goes to the callback as usual.
+        internal void RunToSink(p4dn.RecordSink sink, string field, P4Callback callback, string command, params string[] args)
+        {
+            EstablishConnection(true);
+            ClientApi api = m_ClientApi;
+            api.SetRecordSink(sink, field);
+            try
+            {
+                RunCallback(callback, command, args);
+            }
+            finally
+            {
+                api.SetRecordSink(null);
+            }
+        }
+
+        /// <summary>
+        /// Executes a Perforce command in tagged mode, writing each record to a stream as a line of JSON.
+        /// </summary>
+        /// <remarks>
+        /// <para>Records are written as they arrive, straight from the Perforce API's buffers, without making .NET
+        /// strings for them.  Each line is one JSON object in UTF-8.  Numbered fields are grouped into arrays the way
+        /// <see cref="P4Record.ArrayFields"/> groups them, e.g. <c>"depotFile":["//depot/a","//depot/b"]</c>; when a
+        /// record also has a plain field of the same name, the array is written as <c>"name[]"</c>.</para>
+        /// <para>With <paramref name="includeMessages"/>, each server message is also written, as
+        /// <c>{"severity":n,"id":n,"message":"..."}</c>.  Messages are returned in the recordset either way.</para>
+        /// <para>Strings in a non-UTF-8 encoding, single-byte or multi-byte, are converted to UTF-8 as they are
+        /// written.</para>
+        /// <para>The stream is written in 64KB pieces and isn't flushed or closed.  To write to a file or handle, pass a
+        /// FileStream.  If the stream throws, the command is cancelled and the exception rethrown once it stops.
+        /// Commands aren't retried, since output has already been written when a connection drops.</para>
+        /// </remarks>
+        /// <param name="output">The stream to write to.</param>
+        /// <param name="includeMessages">True to write messages as well as records.</param>
+        /// <param name="Command">The command.</param>
+        /// <param name="Args">The arguments to the Perforce command.  Remember to use a dash (-) in front of all switches</param>
+        /// <returns>A P4Recordset with the command's messages, errors and statistics, and no records.</returns>
+        public P4RecordSet RunToJson(Stream output, bool includeMessages, string Command, params string[] Args)
+        {
+            if (output == null) throw new ArgumentNullException("output");
+
+            P4RecordSet r = new P4RecordSet();
+            EstablishConnection(true);
+            ClientApi api = m_ClientApi;
+            api.SetJsonOutput(output, includeMessages);
+            try
+            {
+                RunCallback(new P4RecordsetCallback(r), Command, Args);
+            }
+            finally
+            {
+                api.SetJsonOutput(null, false);
+            }
+            r.CommandStatus = _lastCommandStatus;
+            r.Statistics = _lastCommandStatistics;
+            r.ServerTracking = _lastServerTracking;
+
+            if (((_exceptionLevel == P4ExceptionLevels.ExceptionOnBothErrorsAndWarnings
+                 || _exceptionLevel == P4ExceptionLevels.NoExceptionOnWarnings)
+                 && r.HasErrors())
+                ||
+                  (_exceptionLevel == P4ExceptionLevels.ExceptionOnBothErrorsAndWarnings
+                   && r.HasWarnings())
+                )
+            {
+                throw new RunException(r);
+            }
+            return r;
+        }
+
+        /// <summary>
+        /// Runs the specified command, calling the appropriate callback methods as Perforce returns information.
+        /// </summary>
+        /// <param name="Command">The Perforce command to run.</param>
+        /// <param name="Callback">A callback instance to recieve information as the command is run.</param>
+        /// <param name="Args">Arguments to the Perforce command</param>
+        public void RunCallback(P4Callback Callback, string Command, params string[] Args)
+        {
+            CallbackClientUser cu = new CallbackClientUser(Callback);
+            EstablishConnection(true, CreateKeepAlive(Callback, cu));
+            Callback.SetEncoding(m_ClientApi.Encoding);
+            cu.SetEncoding(m_ClientApi.Encoding);
+            cu.SetClientApi(m_ClientApi);
+            Callback.SetSuppressedMessages(null);
+            RunIt(Command, Args, cu);
+
+            // always throw a defered exception (means something went WAY wrong)
+            if (cu.DeferedException != null)
+            {
+                throw cu.DeferedException;
+            }
+        }
+
+        /// <summary>
+        /// Runs the callback unparsed.
+        /// </summary>
+        /// <param name="Command">The command.</param>
+        /// <param name="Callback">The callback.</param>
+        /// <param name="Args">The args.</param>
+        public void RunCallbackUnparsed(P4Callback Callback, string Command, params string[] Args)
+        {
+            CallbackClientUser cu = new CallbackClientUser(Callback);
+            EstablishConnection(false, CreateKeepAlive(Callback, cu));
+            Callback.SetEncoding(m_ClientApi.Encoding);
+            cu.SetEncoding(m_ClientApi.Encoding);
+            cu.SetClientApi(m_ClientApi);
+            Callback.SetSuppressedMessages(null);
+            RunIt(Command, Args, cu);
+
+            // always throw a defered exception (means something went WAY wrong)
+            if (cu.DeferedException != null)
+            {
+                throw cu.DeferedException;
+            }
+        }
+
+        /// <summary>
+        /// Executes a Perforce command in non-tagged mode.
+        /// </summary>
+        /// <param name="Command">The command.</param>
+        /// <param name="Args">The args.</param>
+        /// <returns></returns>
+        public P4UnParsedRecordSet RunUnParsed(string Command, params string[] Args)
+        {
+            P4BaseRecordSet.OnPromptEventHandler handler = new P4BaseRecordSet.OnPromptEventHandler(this.HandleOnPrompt);
+            P4UnParsedRecordSet r = RunSnapshot<P4UnParsedRecordSet>(false, Command, Args, delegate
+            {
+                P4UnParsedRecordSet attempt = new P4UnParsedRecordSet();
+                attempt.OnPrompt += handler;
+                RunCallbackUnparsed(new P4RecordsetCallback(attempt), Command, Args);
+                attempt.OnPrompt -= handler;
+                attempt.CommandStatus = _lastCommandStatus;
+                attempt.Statistics = _lastCommandStatistics;
+                attempt.ServerTracking = _lastServerTracking;
+                return attempt;
+            });
+
+            if (((_exceptionLevel == P4ExceptionLevels.ExceptionOnBothErrorsAndWarnings
+                 || _exceptionLevel == P4ExceptionLevels.NoExceptionOnWarnings)
+                 && r.HasErrors())
+                ||
+                  (_exceptionLevel == P4ExceptionLevels.ExceptionOnBothErrorsAndWarnings
+                   && r.HasWarnings())
+                )
+            {
+                throw new RunUnParsedException(r);
+            }
+
+            return r;
+        }
+
+#if CLR4
+        /// <summary>
+        /// Executes a Perforce command in tagged mode, stopping it if the token is cancelled.
+        /// </summary>
+        /// <param name="cancellationToken">Token used to cancel the command.</param>
+        /// <param name="Command">The command.</param>
+        /// <param name="Args">The arguments to the Perforce command.</param>
+        /// <returns>A P4Recordset containing the results of the command.  Check CommandStatus to see if it was cancelled.</returns>
+        public P4RecordSet Run(CancellationToken cancellationToken, string Command, params string[] Args)
+        {
+            CancellationToken old = _cancellationToken;
+            _cancellationToken = cancellationToken;
+            try
+            {
+                return Run(Command, Args);
+            }
+            finally
+            {
+                _cancellationToken = old;
+            }
+        }
+
+        /// <summary>
+        /// Executes a Perforce command in non-tagged mode, stopping it if the token is cancelled.
+        /// </summary>
+        /// <param name="cancellationToken">Token used to cancel the command.</param>
+        /// <param name="Command">The command.</param>
+        /// <param name="Args">The args.</param>
+        /// <returns>A P4UnParsedRecordSet.  Check CommandStatus to see if it was cancelled.</returns>
+        public P4UnParsedRecordSet RunUnParsed(CancellationToken cancellationToken, string Command, params string[] Args)
+        {
+            CancellationToken old = _cancellationToken;
+            _cancellationToken = cancellationToken;
+            try
+            {
+                return RunUnParsed(Command, Args);
+            }
+            finally
+            {
+                _cancellationToken = old;
+            }
+        }
+
+        /// <summary>
+        /// Runs the specified command with a callback, stopping it if the token is cancelled.
+        /// </summary>
+        /// <param name="cancellationToken">Token used to cancel the command.</param>
+        /// <param name="Callback">A callback instance to recieve information as the command is run.</param>
+        /// <param name="Command">The Perforce command to run.</param>
+        /// <param name="Args">Arguments to the Perforce command</param>
+        public void RunCallback(CancellationToken cancellationToken, P4Callback Callback, string Command, params string[] Args)
+        {
+            CancellationToken old = _cancellationToken;
+            _cancellationToken = cancellationToken;
+            try
+            {
+                RunCallback(Callback, Command, Args);
+            }
+            finally
+            {
+                _cancellationToken = old;
+            }
+        }
+
+        /// <summary>
+        /// Executes a Perforce command in tagged mode on one of the connection's I/O threads.
+        /// </summary>
+        /// <param name="Command">The command.</param>
+        /// <param name="Args">The arguments to the Perforce command.</param>
+        /// <returns>A task that completes with the results of the command.</returns>
+        /// <remarks>Asynchronous commands on one connection run one at a time, in the order they were started.</remarks>
+        public Task<P4RecordSet> RunAsync(string Command, params string[] Args)
+        {
+            return RunAsync(CancellationToken.None, Command, Args);
+        }
+
+        /// <summary>
+        /// Executes a Perforce command in tagged mode on one of the connection's I/O threads.
+        /// </summary>
+        /// <param name="cancellationToken">Token used to cancel the command, whether it is still queued or already running.</param>
+        /// <param name="Command">The command.</param>
+        /// <param name="Args">The arguments to the Perforce command.</param>
+        /// <returns>A task that completes with the results of the command, or is cancelled.</returns>
+        /// <remarks>Asynchronous commands on one connection run one at a time, in the order they were started.</remarks>
+        public Task<P4RecordSet> RunAsync(CancellationToken cancellationToken, string Command, params string[] Args)
+        {
+            return RunOnIOThread<P4RecordSet>(cancellationToken, null, delegate
+            {
+                return Run(cancellationToken, Command, Args);
+            });
+        }
+
+        /// <summary>
+        /// Runs the specified command with a callback on one of the connection's I/O threads.
+        /// </summary>
+        /// <param name="Callback">A callback instance to recieve information as the command is run.</param>
+        /// <param name="Command">The Perforce command to run.</param>
+        /// <param name="Args">Arguments to the Perforce command</param>
+        /// <returns>A task that completes when the command and all its callbacks are done.</returns>
+        /// <remarks>Callbacks are raised on <see cref="CallbackContext"/> when it is set, otherwise on the I/O thread.</remarks>
+        public Task RunCallbackAsync(P4Callback Callback, string Command, params string[] Args)
+        {
+            return RunCallbackAsync(CancellationToken.None, Callback, Command, Args);
+        }
+
+        /// <summary>
+        /// Runs the specified command with a callback on one of the connection's I/O threads.
+        /// </summary>
+        /// <param name="cancellationToken">Token used to cancel the command, whether it is still queued or already running.</param>
+        /// <param name="Callback">A callback instance to recieve information as the command is run.</param>
+        /// <param name="Command">The Perforce command to run.</param>
+        /// <param name="Args">Arguments to the Perforce command</param>
+        /// <returns>A task that completes when the command and all its callbacks are done, or is cancelled.</returns>
+        /// <remarks>Callbacks are raised on <see cref="CallbackContext"/> when it is set, otherwise on the I/O thread.</remarks>
+        public Task RunCallbackAsync(CancellationToken cancellationToken, P4Callback Callback, string Command, params string[] Args)
+        {
+            if (Callback == null) throw new ArgumentNullException("Callback");
+            P4ContextCallback context = (_callbackContext == null) ? null : new P4ContextCallback(Callback, _callbackContext);
+            P4Callback cb = (context == null) ? Callback : context;
+
+            return RunOnIOThread<object>(cancellationToken, context, delegate
+            {
+                RunCallback(cancellationToken, cb, Command, Args);
+                return null;
+            });
+        }
+#endif
+        #endregion
+
+        #region Form Methods
+        /// <summary>
+        /// Parse the raw text of a Perforce form into a P4Form object
+        /// </summary>
+        /// <param name="formCommand">The form command.</param>
+        /// <param name="formContents">Raw contents of the form spec.</param>
+        /// <returns>
+        /// A P4Form object.  The fields of the form can be read or updated.  If you update a filed, you can save it with Save_Form.
+        /// </returns>
+        /// <include file='CodeDocuments.xml' path='//Forms/remarks' />
+        public P4Form Parse_Form(string formCommand, string formContents)
+        {
+            // logic stolen from P4Ruby.  Cache the spec defs, and load a form from the cached specdefs.
+
+            // If we don't have a cached Spec def, we need to create a dummy form to get it in the cache
+            if (!cachedSpecDefs.ContainsKey(formCommand))
+            {
+                string bogusSpec = "__p4net_bogus_spec__";
+                P4Form outputForm;
+
+                // 
+                // For specs of the following types we need the bogus spec name
+                //
+                if (formCommand == "branch" || formCommand == "label" || formCommand == "depot" || formCommand == "group")
+                {
+                    outputForm = Fetch_Form(formCommand, bogusSpec);
+                }
+                else
+                {
+                    outputForm = Fetch_Form(formCommand);
+                }                
+            }
+
+            return P4Form.LoadFromSpec(formCommand, cachedSpecDefs[formCommand], formContents, m_ClientApi.Encoding);
+        }
+
+        /// <summary>
+        /// Fetch a form object from Perforce.
+        /// </summary>
+        /// <param name="FormCommand">The form command.</param>
+        /// <param name="Args">The args.</param>
+        /// <returns>
+        /// A Form object.  The fields of the form can be read or updated.  If you update a filed, you can save it with Save_Form.
+        /// </returns>
+        /// <include file='CodeDocuments.xml' path='//Forms/remarks' />
+        public P4Form Fetch_Form(string FormCommand, params string[] Args)
+        {
+            if (FormCommand == null) throw new ArgumentNullException();
+            if (Args == null) throw new ArgumentNullException();
+
+            string[] AllArgs = new string[Args.Length + 1];
+            AllArgs[0] = "-o";
+
+            for (int i = 0; i < Args.Length ; i++)
+            {
+                if (Args[i] == null)
+                {
+                    throw new ArgumentNullException();
+                }
+                if (Args[i] == "-o")
+                {
+                    throw new InvalidFormArgument();
+                }
+                AllArgs[i+1] = Args[i];
+            }
+
+            EstablishConnection(true);
+
+            P4FormRecordSet r = new P4FormRecordSet(FormCommand, m_ClientApi.Encoding);
+            P4RecordsetCallback cb = new P4RecordsetCallback(r);
+
+            //RunIt(FormCommand, AllArgs, r.ResultClientUser);
+            RunCallback(cb, FormCommand, AllArgs);
+
+            // The Fetch_Form command must always throw an error
+            // because there will be no form to return if there's a 
+            // problem
+            if (r.HasErrors())
+            {
+                throw new FormFetchException(FormCommand, r.ErrorMessage);
+            }
+
+            // save the spec def, in case Parse_Form is called in the future
+            cachedSpecDefs[FormCommand] = r.Form.SpecDef;
+
+            return r.Form;
+        }
+
+        /// <summary>
+        /// Saves the form to Perforce.
+        /// </summary>
+        /// <param name="Form">The P4Form object retrieved from Fetch_Form.</param>
+        /// <include file='CodeDocuments.xml' path='//Forms/remarks' />
+        /// <returns>P4UnParsedRecordSet.  Output can be parsed to verify the form was processed correctly.</returns>
+        public P4UnParsedRecordSet Save_Form(P4Form Form)
+        {
+            return Save_Form(Form, false);
+        }
+
+        /// <summary>
+        /// Saves the form to Perforce.
+        /// </summary>
+        /// <param name="formCommand">The form command to run.</param>
+        /// <param name="formSpec">The formatted spec.</param>
+        /// <param name="args">Arguments to the form command.</param>
+        /// <returns>P4UnParsedRecordSet.  Output can be parsed to verify the form was processed correctly.</returns>
+        public P4UnParsedRecordSet Save_Form(string formCommand, string formSpec, params string[] args)
+        {
+            if (formCommand == null) throw new ArgumentNullException("formCommand");
+            if (formCommand == string.Empty) throw new ArgumentException("Parameter 'formCommand' can not be empty");
+            if (formSpec == null) throw new ArgumentNullException("formSpec");
+            if (formSpec == string.Empty) throw new ArgumentException("Parameter 'formSpec' can not be empt");
+
+            P4UnParsedRecordSet r = new P4UnParsedRecordSet();
+            P4RecordsetCallback cb = new P4RecordsetCallback(r);
+            r.InputData = formSpec;
+            List<string> formargs = new List<string>();
+            foreach (string arg in args)
+            {
+                if (arg == "-i" || arg == "-o")
+                {
+                    throw new InvalidFormArgument();
+                }
+                formargs.Add(arg);
+            }
+            formargs.Add("-i");
+
+            RunCallbackUnparsed(cb, formCommand, formargs.ToArray());
+        
+            if (((_exceptionLevel == P4ExceptionLevels.ExceptionOnBothErrorsAndWarnings
+                 || _exceptionLevel == P4ExceptionLevels.NoExceptionOnWarnings)
+                 && r.HasErrors())
+                ||
+                  (_exceptionLevel == P4ExceptionLevels.ExceptionOnBothErrorsAndWarnings
+                   && r.HasWarnings())
+                )
+            {
+                throw new RunUnParsedException(r);
+            }
+            return r;
+        }
+
+        /// <summary>
+        /// Saves the form to Perforce.
+        /// </summary>
+        /// <param name="formCommand">The form command to run.</param>
+        /// <param name="formSpec">The formatted spec.</param>
+        /// <param name="Force">True to pass the '-f' flag when saving.</param>
+        /// <returns>P4UnParsedRecordSet.  Output can be parsed to verify the form was processed correctly.</returns>
+        public P4UnParsedRecordSet Save_Form(string formCommand, string formSpec, bool Force)
+        {
+            if (formCommand == null) throw new ArgumentNullException("formCommand");
+            if (formCommand == string.Empty) throw new ArgumentException("Parameter 'formCommand' can not be empty");
+            if (formSpec == null) throw new ArgumentNullException("formSpec");
+            if (formSpec == string.Empty) throw new ArgumentException("Parameter 'formSpec' can not be empt");
+
+            if (Force)
+            {
+                return Save_Form(formCommand, formSpec, "-f");
+            }
+            return Save_Form(formCommand, formSpec);
+        }
+
+        /// <summary>
+        /// Saves the form to Perforce.
+        /// </summary>
+        /// <param name="Form">The P4Form object retrieved from Fetch_Form.</param>
+        /// <param name="Force">True to pass the '-f' flag when saving.</param>
+        /// <include file='CodeDocuments.xml' path='//Forms/remarks' />
+        /// <returns>P4UnParsedRecordSet.  Output can be parsed to verify the form was processed correctly.</returns>
+        public P4UnParsedRecordSet Save_Form(P4Form Form, bool Force)
+        {
+            if (Form == null) throw new ArgumentNullException("Form");
+            return Save_Form(Form.FormCommand, Form.FormatSpec(), Force);
+        }
+
+        /// <summary>
+        /// Saves the form to Perforce.
+        /// </summary>
+        /// <param name="Form">The P4Form object retrieved from Fetch_Form.</param>
+        /// <param name="args">Arguments passed to the form command.</param>
+        /// <include file='CodeDocuments.xml' path='//Forms/remarks' />
+        /// <returns>P4UnParsedRecordSet.  Output can be parsed to verify the form was processed correctly.</returns>
+        public P4UnParsedRecordSet Save_Form(P4Form Form, params string[] args)
+        {
+            if (Form == null) throw new ArgumentNullException("Form");
+            return Save_Form(Form.FormCommand, Form.FormatSpec(), args);
+        }
+
+        #endregion
+
+        #endregion
+
+        #region Print Methods
+        /// <summary>
+        /// Print the contents of a file in Perforce to a byte array.
+        /// </summary>
+        /// <param name="depotPath">Perforce path to the file.</param>
+        /// <returns>
+        /// Contents of the file.
+        /// Text files will be encoded with ANSI encodinge.  
+        /// Unicode files will be encoded as UTF-8 (regardless of P4CHARSET setting).
+        ///</returns>
+        public byte[] PrintBinary(string depotPath)
+        {
+            // use utf-16 encoding.  In theory this will be more effient, b/c 
+            // it will do only one conversion.
+            MemoryStream ms = new MemoryStream();
+            PrintStream(ms, depotPath);
+            byte[] ret = new byte[ms.Position];
+            ms.Position = 0;
+            ms.Read(ret, 0, ret.Length);
+            ms.Close();
+            return ret;
+        }
+
+        /// <summary>
+        /// Print the contents of a file in Perforce to a string.
+        /// </summary>
+        /// <param name="depotPath">Perforce path to the file.</param>
+        /// <returns>Contents of the file.</returns>
+        /// <remarks>
+        /// Attempting to call PrintText on a binary file will likely cause corruption.<br/>
+        /// If a file is does not exist, a FileNotFound exception will be thrown (regardless
+        /// of the ExceptionLevel setting).<br/>
+        /// Depot Path, Client Path or Local Path can generally be used for the argument
+        /// depotPath (so long as the argument is valid for the <code>p4 print</code> command line.
+        ///</remarks>
+        public string PrintText(string depotPath)
+        {
+            // use utf-16 encoding.  In theory this will be more effient, b/c 
+            // it will do only one conversion.
+            MemoryStream ms = new MemoryStream();
+            StreamReader sr = new StreamReader(ms, Encoding.Unicode);
+            PrintStream(ms, depotPath, Encoding.Unicode);
+            ms.Position = 0;
+            string ret = sr.ReadToEnd();
+            sr.Close();
+            ms.Close();
+            return ret;
+        }
+
+        /// <summary>
+        /// Prints the contents of a Perforce file to a Stream.
+        /// </summary>
+        /// <param name="stream">Writable stream to write the contents to.</param>
+        /// <param name="depotPath">Perforce path of the file to print.</param>
+        /// <param name="encoding">Text encoding of the Stream.</param>
+        /// <remarks>
+        /// If a file is does not exist, a FileNotFound exception will be thrown (regardless
+        /// of the ExceptionLevel setting).<br/>
+        /// Depot Path, Client Path or Local Path can generally be used for the argument
+        /// depotPath (so long as the argument is valid for the <code>p4 print</code> command line.<br/>
+        /// Encoding will only be applied to files with a Perforce type of 'text' or 'unicode'.<br/>
+        /// The stream argument can be any valid stream, so long as it is initialized and writable.<br/>
+        ///</remarks>
+        public void PrintStream(Stream stream, string depotPath, Encoding encoding)
+        {
+            if (stream == null) throw new ArgumentNullException();
+            if (depotPath == null) throw new ArgumentNullException();
+            if (depotPath == string.Empty) throw new ArgumentException("Argument depotPath can not be empty.");
+            if (!stream.CanWrite) throw new StreamNotWriteable();
+
+            PrintStreamHelper ph = new PrintStreamHelper(this);
+            int filesPrinted = ph.PrintStream(stream, depotPath, encoding);
+            if (filesPrinted < 1)
+            {
+                throw new Exceptions.FileNotFound(depotPath);
+            }
+        }
+
+        /// <summary>
+        /// Prints the contents of a Perforce file to a Stream.
+        /// </summary>
+        /// <param name="stream">Writable stream to write the contents to.</param>
+        /// <param name="depotPath">Perforce path of the file to print.</param>        
+        /// <remarks>
+        /// If a file is does not exist, a FileNotFound exception will be thrown (regardless
+        /// of the ExceptionLevel setting).<br/>
+        /// Depot Path, Client Path or Local Path can generally be used for the argument
+        /// depotPath (so long as the argument is valid for the <code>p4 print</code> command line.<br/>
+        /// The stream argument can be any valid stream, so long as it is initialized and writable.<br/>
+        ///</remarks>
+        public void PrintStream(Stream stream, string depotPath)
+        {
+            PrintStream(stream, depotPath, null);
+        }
+
+        /// <summary>
+        /// Runs a print command, and raises events for each file printed.
+        /// </summary>
+        /// <param name="args">Arguments to the <code>p4 print</code> command.</param>
+        /// <event>OnPrintStream</event>
+        /// <event>OnPrintEndFile</event>
+        /// <remarks>
+        /// This method is useful when you need to print several files with a single call
+        /// to the Perforce server.
+        /// </remarks>
+        /// <example><code language='c#'></code></example>
+        public void PrintStreamEvents(params string[] args)
+        {
+            P4PrintCallback pcb = new P4PrintCallback(this, OnPrintStream, OnPrintEndFile);
+            RunCallback(pcb, "print", args);
+        }
+
+#if CLR4
+        /// <summary>
+        /// Prints the contents of a Perforce file to a Stream on one of the connection's I/O threads.
+        /// </summary>
+        /// <param name="stream">Writable stream to write the contents to.</param>
+        /// <param name="depotPath">Perforce path of the file to print.</param>
+        /// <returns>A task that completes when the file has been written to the stream.</returns>
+        /// <remarks>See <see cref="PrintStream(Stream, string, Encoding)"/>.  The stream is written from the I/O thread.</remarks>
+        public Task PrintStreamAsync(Stream stream, string depotPath)
+        {
+            return PrintStreamAsync(stream, depotPath, null, CancellationToken.None);
+        }
+
+        /// <summary>
+        /// Prints the contents of a Perforce file to a Stream on one of the connection's I/O threads.
+        /// </summary>
+        /// <param name="stream">Writable stream to write the contents to.</param>
+        /// <param name="depotPath">Perforce path of the file to print.</param>
+        /// <param name="encoding">Text encoding of the Stream.</param>
+        /// <param name="cancellationToken">Token used to cancel the print, whether it is still queued or already running.</param>
+        /// <returns>A task that completes when the file has been written to the stream, or is cancelled.</returns>
+        /// <remarks>See <see cref="PrintStream(Stream, string, Encoding)"/>.  The stream is written from the I/O thread.</remarks>
+        public Task PrintStreamAsync(Stream stream, string depotPath, Encoding encoding, CancellationToken cancellationToken)
+        {
+            return RunOnIOThread<object>(cancellationToken, null, delegate
+            {
+                CancellationToken old = _cancellationToken;
+                _cancellationToken = cancellationToken;
+                try
+                {
+                    PrintStream(stream, depotPath, encoding);
+                }
+                finally
+                {
+                    _cancellationToken = old;
+                }
+                return null;
+            });
+        }
+#endif
+
+        #endregion
+
+        #region Private Helper Methods
+        private ClientApi _ClientAPI
+        {
+            get
+            {
+                if (m_ClientApi == null)
+                {
+                    m_ClientApi = new ClientApi();
+                }
+                return m_ClientApi;
+            }
+        }
+
+        private void EstablishConnection(bool tagged)
+        {
+            EstablishConnection(tagged, null);
+        }
+        private void EstablishConnection(bool tagged, KeepAlive keepAlive)
+        {
+            Stopwatch failover = null;
+            if (m_ClientApi != null && m_ClientApi.Dropped() != 0)
+            {
+                // I can't figure out how to force this artificially, so currently untested :-(
+                if (Tracer.Enabled) Tracer.Instant(TracePoint.Reconnect, _Port);
+                failover = Stopwatch.StartNew();
+                ReleaseClientApi();
+
+                ClientApi standby = TakeStandby();
+                if (standby != null)
+                {
+                    m_ClientApi = standby;
+                    _Initialized = true;
+                    RaiseOnFailoverEvent(true, failover.Elapsed);
+                    failover = null;
+                    PrepareStandby();
+                }
+            }
+            if (m_ClientApi == null)
+            {
+                m_ClientApi = new ClientApi();
+            }
+            if (!_Initialized)
+            {
+                long traceStart = Tracer.Timestamp();
+                Error err = null;
+                try
+                {
+                    _tagged = tagged;
+                    err = m_ClientApi.CreateError();
+                    ApplySettings(m_ClientApi);
+                    
+                    m_ClientApi.Init(err);
+                    if (P4Diagnostics.Instance.IsCapturing) P4Diagnostics.Instance.Flush();
+                    if (err.Severity == Error.ErrorSeverity.Failed || err.Severity == Error.ErrorSeverity.Fatal)
+                    {
+                        throw new Exception("Unable to connect to Perforce!");
+                    }
+                    _Initialized = true;
+                    err.Dispose();
+                    if (Tracer.Enabled) Tracer.Complete(TracePoint.Connect, traceStart, _Port);
+                    if (failover != null) RaiseOnFailoverEvent(false, failover.Elapsed);
+                    PrepareStandby();
+                }
+                catch (Exception e)
+                {
+                    string message = "Perforce connection error.";
+                    try
+                    {
+                        m_ClientApi.Final(err);
+                        message = e.Message;
+                        err.Dispose();
+                        m_ClientApi.Dispose();
+                        m_ClientApi = null;
+                    }
+                    catch { }
+                    throw new PerforceInitializationError(message);
+                }
+            }
+            if (tagged) m_ClientApi.SetTag();
+            if (_CallingProgram != null) m_ClientApi.SetProg(_CallingProgram);
+            if (_CallingProgramVersion != null) m_ClientApi.SetVersion(_CallingProgramVersion);
+            m_ClientApi.SetBreak(keepAlive);
+        }
+        private void CloseConnection()
+        {
+            DiscardStandby();
+            ReleaseClientApi();
+        }
+        private void ReleaseClientApi()
+        {
+            // Need to reset the connection
+            if (_Initialized)
+            {
+                if (Tracer.Enabled) Tracer.Instant(TracePoint.Disconnect, _Port);
+                Error err = m_ClientApi.CreateError();
+                m_ClientApi.Final(err);
+                err.Dispose();
+            }
+            if (m_ClientApi != null)
+            {
+                m_ClientApi.Dispose();
+                m_ClientApi = null;
+            }
+            _Initialized = false;            
+        }
+
+        private void ApplySettings(ClientApi api)
+        {
+            // Always use the specstring protocol.  We'll controll form output via SetTag
+            // before each run
+            api.SetProtocol("specstring", "");
+
+            //May have lost our settings... reset here
+            if (_Client != null) api.SetClient(_Client);
+            if (_User != null) api.SetUser(_User);
+            if (_CWD != null) api.SetCwd(_CWD);
+            if (_Charset != null) api.SetCharset(_Charset);
+            if (_Host != null) api.SetHost(_Host);
+            if (_Port != null) api.SetPort(_Port);
+            if (_Password != null) api.SetPassword(_Password);
+            if (_TicketFile != null) api.SetTicketFile(_TicketFile);
+            if (_maxResults != 0) api.SetMaxResults(_maxResults);
+            if (_maxScanRows != 0) api.SetMaxScanRows(_maxScanRows);
+            if (_maxLockTime != 0) api.SetMaxLockTime(_maxLockTime);
+            if (_ApiLevel != 0) api.SetProtocol("api", _ApiLevel.ToString());
+            api.SetSessionReplay(_sessionReplay == null ? null : _sessionReplay.Native);
+        }
+
+        // Everything ApplySettings uses.  A standby prepared with different settings is no good.
+        private string GetSettingsSignature()
+        {
+            return string.Join("\n", new string[] { _Client, _User, _CWD, _Charset, _Host, _Port, _Password, _TicketFile,
+                _maxResults.ToString(), _maxScanRows.ToString(), _maxLockTime.ToString(), _ApiLevel.ToString() });
+        }
+
+        // Starts connecting a standby session on the thread pool, unless there is one already.
+        private void PrepareStandby()
+        {
+            if (!_warmStandby || !_Initialized || _sessionReplay != null) return;
+
+            ClientApi api;
+            int generation;
+            lock (_standbyLock)
+            {
+                if (_standby != null || _standbyPreparing) return;
+                _standbyPreparing = true;
+                generation = _standbyGeneration;
+
+                // settings are read on this thread; only the connect happens in the background
+                api = new ClientApi();
+                ApplySettings(api);
+                _standbySettings = GetSettingsSignature();
+            }
+
+            ThreadPool.QueueUserWorkItem(delegate
+            {
+                bool connected = false;
+                try
+                {
+                    Error err = api.CreateError();
+                    api.Init(err);
+                    connected = err.Severity != Error.ErrorSeverity.Failed && err.Severity != Error.ErrorSeverity.Fatal;
+                    err.Dispose();
+                }
+                catch
+                {
+                    // the next failover will just reconnect the slow way
+                }
+
+                lock (_standbyLock)
+                {
+                    _standbyPreparing = false;
+                    if (connected && generation == _standbyGeneration)
+                    {
+                        _standby = api;
+                        api = null;
+                    }
+                }
+                if (api != null) FinalizeApi(api, connected);
+            });
+        }
+
+        private ClientApi TakeStandby()
+        {
+            ClientApi api;
+            bool usable;
+            lock (_standbyLock)
+            {
+                api = _standby;
+                _standby = null;
+                usable = (_standbySettings == GetSettingsSignature());
+            }
+            if (api == null) return null;
+            if (usable && api.Dropped() == 0) return api;
+
+            FinalizeApi(api, true);
+            return null;
+        }
+
+        private void DiscardStandby()
+        {
+            ClientApi api;
+            lock (_standbyLock)
+            {
+                // a standby still connecting sees the new generation and throws itself away
+                _standbyGeneration++;
+                api = _standby;
+                _standby = null;
+            }
+            if (api != null) FinalizeApi(api, true);
+        }
+
+        private static void FinalizeApi(ClientApi api, bool connected)
+        {
+            try
+            {
+                if (connected)
+                {
+                    Error err = api.CreateError();
+                    api.Final(err);
+                    err.Dispose();
+                }
+                api.Dispose();
+            }
+            catch { }
+        }
+
+        private delegate T RetryableRun<T>();
+
+        // Runs a command, running it again (after a backoff) if it is in RetryCommands and the connection dropped.
+        private T RunWithRetry<T>(string command, RetryableRun<T> run)
+        {
+            int attempt = 0;
+            while (true)
+            {
+                T result = default(T);
+                Exception reconnectError = null;
+                try
+                {
+                    result = run();
+                }
+                catch (PerforceInitializationError e)
+                {
+                    // only a reconnect for a retry gets another chance; a failed first connect is the caller's problem
+                    if (attempt == 0) throw;
+                    reconnectError = e;
+                }
+
+                bool dropped = reconnectError != null ||
+                    (_lastCommandStatus == P4CommandStatus.Completed && m_ClientApi != null && m_ClientApi.Dropped() != 0);
+                if (!dropped || attempt >= _maxRetries || !IsRetryCommand(command) || !WaitToRetry(command, ++attempt, reconnectError))
+                {
+                    if (reconnectError != null) throw reconnectError;
+                    return result;
+                }
+            }
+        }
+
+        // Runs a query P4.Net needs for its own bookkeeping, leaving LastCommandStatus, LastCommandStatistics and
+        // LastServerTracking describing the caller's command.
+        internal P4RecordSet RunInternal(string command, params string[] args)
+        {
+            P4CommandStatus status = _lastCommandStatus;
+            P4CommandStatistics statistics = _lastCommandStatistics;
+            P4ServerTracking tracking = _lastServerTracking;
+            try
+            {
+                return Run(command, args);
+            }
+            finally
+            {
+                _lastCommandStatus = status;
+                _lastCommandStatistics = statistics;
+                _lastServerTracking = tracking;
+            }
+        }
+
+        // Answers queries pinned to history from the snapshot cache, and stores them there after a miss.
+        private T RunSnapshot<T>(bool tagged, string command, string[] args, RetryableRun<T> run) where T : P4BaseRecordSet
+        {
+            P4SnapshotCache snapshots = _snapshotCache;
+            long change;
+            // a filtered result isn't what an unfiltered caller would get, and the other way round
+            if (snapshots == null || _messageFilter != null || args == null || Array.IndexOf(args, null) >= 0 ||
+                !P4SnapshotCache.IsPinned(command, args, out change))
+            {
+                return RunCached<T>(tagged, command, args, run);
+            }
+
+            string key = GetSnapshotKey(tagged, command, args);
+            T r = snapshots.Load<T>(key);
+            if (r == null)
+            {
+                r = RunCached<T>(tagged, command, args, run);
+                snapshots.Store(this, key, command, args, r);
+            }
+            return r;
+        }
+
+        // Only what changes history's output.  Port, User and Charset come from the environment when not set, and
+        // reading them doesn't connect.
+        private string GetSnapshotKey(bool tagged, string command, string[] args)
+        {
+            StringBuilder key = new StringBuilder();
+            key.Append(Port).Append('\0').Append(User).Append('\0').Append(Charset).Append('\0').Append(_ApiLevel);
+            key.Append('\0').Append(tagged ? 't' : 'u').Append('\0').Append(command);
+            foreach (string arg in args)
+            {
+                key.Append('\0').Append(arg);
+            }
+            return key.ToString();
+        }
+
+        // Goes through the result cache when there is one and it takes this command; retries either way.
+        private T RunCached<T>(bool tagged, string command, string[] args, RetryableRun<T> run) where T : P4BaseRecordSet
+        {
+            P4ResultCache cache = _resultCache;
+            // a filtered result can hide errors, and isn't what an unfiltered caller would get
+            if (cache == null || _messageFilter != null || args == null || !cache.IsCacheable(command, args))
+            {
+                return RunWithRetry<T>(command, run);
+            }
+            WaitHandle cancelled = null;
+#if CLR4
+            if (_cancellationToken.CanBeCanceled) cancelled = _cancellationToken.WaitHandle;
+#endif
+            T r = cache.Run<T>(GetCacheKey(tagged, command, args), command, GetCommandTimeoutMilliseconds(), cancelled, delegate
+            {
+                return RunWithRetry<T>(command, run);
+            },
+            delegate
+            {
+                // out of time (or cancelled) waiting for the identical command: run it with no time left, so it
+                // stops at the first check and ends like any other command stopped part way
+                DateTime? deadline = _commandDeadline;
+                if (cancelled == null || !cancelled.WaitOne(0, false)) _commandDeadline = DateTime.Now;
+                try
+                {
+                    return RunWithRetry<T>(command, run);
+                }
+                finally
+                {
+                    _commandDeadline = deadline;
+                }
+            });
+
+            // after a hit, or a wait for another caller's run, these would still describe the previous command
+            _lastCommandStatus = r.CommandStatus;
+            _lastCommandStatistics = r.Statistics;
+            _lastServerTracking = r.ServerTracking;
+            return r;
+        }
+
+        // Starts with the command (P4ResultCache.Invalidate depends on that), then everything that changes the output.
+        private string GetCacheKey(bool tagged, string command, string[] args)
+        {
+            StringBuilder key = new StringBuilder(command);
+            key.Append('\0').Append(tagged ? 't' : 'u');
+            foreach (string s in new string[] { _Port, _User, _Client, _CWD, _Charset, _Host })
+            {
+                key.Append('\0').Append(s);
+            }
+            key.Append('\0').Append(_ApiLevel).Append('\0').Append(_maxResults).Append('\0').Append(_maxScanRows);
+            key.Append('\0').Append(_serverTracking ? 'T' : '-').Append(_internValues ? 'I' : '-');
+            foreach (string arg in args)
+            {
+                key.Append('\0').Append(arg);
+            }
+            return key.ToString();
+        }
+
+        private bool IsRetryCommand(string command)
+        {
+            foreach (string c in _retryCommands)
+            {
+                if (string.Equals(c, command, StringComparison.OrdinalIgnoreCase)) return true;
+            }
+            return false;
+        }
+
+        private bool WaitToRetry(string command, int attempt, Exception reconnectError)
+        {
+            double ms = _retryBaseDelay.TotalMilliseconds * Math.Pow(2, Math.Min(attempt - 1, 30));
+            TimeSpan delay = TimeSpan.FromMilliseconds(Math.Min(ms, _retryMaxDelay.TotalMilliseconds));
+
+            // don't sleep past the caller's deadline just to time out
+            if (_commandDeadline.HasValue && DateTime.Now + delay >= _commandDeadline.Value) return false;
+
+            if (OnRetry != null)
+            {
+                P4RetryEventArgs args = new P4RetryEventArgs(command, attempt, delay, reconnectError);
+                OnRetry(this, args);
+                if (args.Cancel) return false;
+            }
+            if (Tracer.Enabled) Tracer.Instant(TracePoint.Reconnect, _Port);
+
+#if CLR4
+            if (_cancellationToken.CanBeCanceled)
+            {
+                return !_cancellationToken.WaitHandle.WaitOne(delay);
+            }
+#endif
+            Thread.Sleep(delay);
+            return true;
+        }
+
+        private void RaiseOnFailoverEvent(bool usedStandby, TimeSpan elapsed)
+        {
+            if (OnFailover != null)
+            {
+                OnFailover(this, new P4FailoverEventArgs(_Port ?? m_ClientApi.Port, usedStandby, elapsed));
+            }
+        }
+
+        private void RunIt(string command, string[] args, ClientUser cu)
+        {
+            // validate that none of the args are null
+            if (args == null)
+            {
+                throw new System.ArgumentNullException();
+            }
+
+            foreach (string arg in args)
+            {
+                if (arg == null)
+                {
+                    throw new System.ArgumentNullException();
+                }
+            }
+
+            if (_messageFilter != null)
+            {
+                // ClientApi keeps its own native copy
+                using (p4dn.MessageFilter filter = _messageFilter.CreateNativeFilter())
+                {
+                    m_ClientApi.SetMessageFilter(filter);
+                }
+            }
+            else
+            {
+                m_ClientApi.SetMessageFilter(null);
+            }
+
+            m_ClientApi.SetServerTracking(_serverTracking);
+            m_ClientApi.SetValuePool(_internValues ? _internFields : null);
+            m_ClientApi.SetSessionRecorder(_sessionRecorder == null ? null : _sessionRecorder.Native);
+            m_ClientApi.SetArgv(args);
+            m_ClientApi.BeginCommand(GetCommandTimeoutMilliseconds());
+            long allocatedBefore = GetAllocatedBytes();
+            int gcBefore = GC.CollectionCount(0);
+#if CLR4
+            CancellationTokenRegistration reg = new CancellationTokenRegistration();
+            if (_cancellationToken.CanBeCanceled)
+            {
+                ClientApi api = m_ClientApi;
+                reg = _cancellationToken.Register(delegate { api.Cancel(); });
+            }
+            try
+            {
+                m_ClientApi.Run(command, cu);
+            }
+            finally
+            {
+                reg.Dispose();
+            }
+#else
+            m_ClientApi.Run(command, cu);
+#endif
+            _lastCommandStatus = (P4CommandStatus)m_ClientApi.GetCommandStatus();
+
+            // whatever this changed on the server mustn't be answered from before it
+            P4ResultCache cache = _resultCache;
+            if (cache != null && cache.Invalidates(command, args)) cache.InvalidateServer(_Port ?? string.Empty);
+
+            long allocated = GetAllocatedBytes() - allocatedBefore;
+            _lastCommandStatistics = new P4CommandStatistics(command, _lastCommandStatus, m_ClientApi.LastRunCounters,
+                allocated < 0 ? 0 : allocated, GC.CollectionCount(0) - gcBefore);
+            P4PerformanceCounters.Record(_lastCommandStatistics);
+
+            string tracking = m_ClientApi.LastServerTracking;
+            _lastServerTracking = (tracking == null) ? null : new P4ServerTracking(tracking);
+            if (_lastServerTracking != null && _serverTrackingLog != null && _lastServerTracking.Lapse >= _serverTrackingThreshold)
+            {
+                LogServerTracking(command, args, _lastServerTracking);
+            }
+            if (P4Diagnostics.Instance.IsCapturing) P4Diagnostics.Instance.Flush();
+        }
+
+        private void LogServerTracking(string command, string[] args, P4ServerTracking tracking)
+        {
+            lock (_serverTrackingLog)
+            {
+                _serverTrackingLog.WriteLine("{0:u} {1} {2} (lapse {3:0.000}s)", DateTime.UtcNow, command,
+                    string.Join(" ", args), tracking.Lapse.TotalSeconds);
+                foreach (string line in tracking.Lines)
+                {
+                    _serverTrackingLog.WriteLine(line);
+                }
+                _serverTrackingLog.Flush();
+            }
+        }
+
+#if CLR4
+        // Queues a command for this connection's I/O thread.  The task is cancelled right away if the token fires while
+        // the command is queued, and when the command itself stopped because of the token.
+        private Task<T> RunOnIOThread<T>(CancellationToken cancellationToken, P4ContextCallback context, Func<T> run)
+        {
+            TaskCompletionSource<T> tcs = new TaskCompletionSource<T>();
+            if (cancellationToken.IsCancellationRequested)
+            {
+                tcs.SetCanceled();
+                return tcs.Task;
+            }
+            CancellationTokenRegistration queued = cancellationToken.Register(delegate { tcs.TrySetCanceled(); });
+
+            EnqueueAsync(delegate
+            {
+                queued.Dispose();
+                if (tcs.Task.IsCompleted) return;
+
+                T result = default(T);
+                Exception error = null;
+                try
+                {
+                    result = run();
+                }
+                catch (Exception e)
+                {
+                    error = e;
+                }
+                bool cancelled = cancellationToken.IsCancellationRequested && _lastCommandStatus == P4CommandStatus.Cancelled;
+
+                Action complete = delegate
+                {
+                    if (error == null && context != null) error = context.Failure;
+                    if (error != null) tcs.TrySetException(error);
+                    else if (cancelled) tcs.TrySetCanceled();
+                    else tcs.TrySetResult(result);
+                };
+                if (context != null) context.Complete(complete);
+                else complete();
+            });
+            return tcs.Task;
+        }
+
+        // Commands on one connection can't overlap, so each connection drains its own queue on one I/O thread at a time.
+        private void EnqueueAsync(Action work)
+        {
+            bool start;
+            lock (_asyncQueue)
+            {
+                _asyncQueue.Enqueue(work);
+                start = !_asyncRunning;
+                _asyncRunning = true;
+            }
+            if (start)
+            {
+                Task.Factory.StartNew(DrainAsyncQueue, CancellationToken.None, TaskCreationOptions.None, IOScheduler);
+            }
+        }
+
+        private void DrainAsyncQueue()
+        {
+            while (true)
+            {
+                Action work;
+                lock (_asyncQueue)
+                {
+                    if (_asyncQueue.Count == 0)
+                    {
+                        _asyncRunning = false;
+                        return;
+                    }
+                    work = _asyncQueue.Dequeue();
+                }
+                work();
+            }
+        }
+#endif
+
+        // see P4CommandStatistics.AllocatedBytes
+        private static long GetAllocatedBytes()
+        {
+#if CLR4
+            if (AppDomain.MonitoringIsEnabled)
+            {
+                return AppDomain.CurrentDomain.MonitoringTotalAllocatedMemorySize;
+            }
+#endif
+            return GC.GetTotalMemory(false);
+        }
+
+        // Milliseconds until the earlier of CommandTimeout and CommandDeadline, 0 for no limit.
+        private int GetCommandTimeoutMilliseconds()
+        {
+            double ms = 0;
+            if (_commandTimeout > TimeSpan.Zero)
+            {
+                ms = _commandTimeout.TotalMilliseconds;
+            }
+            if (_commandDeadline.HasValue)
+            {
+                double remaining = (_commandDeadline.Value - DateTime.Now).TotalMilliseconds;
+                if (ms == 0 || remaining < ms)
+                {
+                    ms = remaining;
+                }
+                // deadline already passed, stop at the first check
+                if (ms < 1) ms = 1;
+            }
+            if (ms > int.MaxValue) return int.MaxValue;
+            return (int)Math.Ceiling(ms);
+        }
+
+        // Only poll the callback from the Perforce API thread when it can actually cancel.
+        private static KeepAlive CreateKeepAlive(P4Callback callback, CallbackClientUser cu)
+        {
+            if (!callback.PollsCancel)
+            {
+                return null;
+            }
+            return new CallbackKeepAlive(cu);
+        }
+
+        private void HandleOnPrompt(object sender, P4PromptEventArgs e)
+        {
+            e.Response = RaiseOnPromptEvent(e.Message);
+        }
+        // Wrap event invocations inside a protected virtual method
+        // to allow derived classes to override the event invocation behavior
+        private string RaiseOnPromptEvent(string Message)
+        {
+            // Make a temporary copy of the event to avoid possibility of
+            // a race condition if the last subscriber unsubscribes
+            // immediately after the null check and before the event is raised.
+            OnPromptEventHandler handler = OnPrompt;
+
+            // Event will be null if there are no subscribers
+            if (handler != null)
+            {
+                P4PromptEventArgs e = new P4PromptEventArgs(Message);
+                
+                // Use the () operator to raise the event.
+                handler(this, e);
+                return e.Response; 
+            }
+            else
+            {
+                return string.Empty;
+            }
+        }
+        #endregion
+
+        #region IDisposable Members
+
+        /// <summary>
+        /// Calls Disconnect.
+        /// </summary>
+        public void Dispose()
+        {
+            this.Disconnect();
+        }
+
+        #endregion
+
+    }
+}
@@ -0,0 +1,209 @@
+/*
+ * P4.Net *
+Copyright (c) 2007-2010 Shawn Hladky
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+and associated documentation files (the "Software"), to deal in the Software without 
+restriction, including without limitation the rights to use, copy, modify, merge, publish, 
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or 
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+ */
+
+
+#if CLR4
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Text;
+using System.Threading;
+
+namespace P4API
+{
+    /// <summary>
+    /// Raises another callback's methods on a SynchronizationContext, in the order the command produced them.
+    /// </summary>
+    /// <remarks>
+    /// Output is queued and posted, so the I/O thread never waits for the consumer.  Methods that need an answer
+    /// (Prompt, InputData, ResolveFile, Edit) are sent, and wait until everything queued ahead of them has been
+    /// delivered.  Cancel is called on the I/O thread.  If the callback throws, the first exception is kept,
+    /// the command is cancelled and the rest of its output is still delivered.
+    /// </remarks>
+    internal sealed class P4ContextCallback : P4Callback
+    {
+        private readonly P4Callback _inner;
+        private readonly SynchronizationContext _context;
+        private readonly Queue<Action> _pending = new Queue<Action>();
+        private readonly object _drainLock = new object();
+        private bool _posted;
+        private volatile Exception _failure;
+
+        internal P4ContextCallback(P4Callback inner, SynchronizationContext context)
+        {
+            _inner = inner;
+            _context = context;
+        }
+
+        /// <summary>
+        /// Gets the first exception thrown by the wrapped callback.
+        /// </summary>
+        internal Exception Failure
+        {
+            get
+            {
+                return _failure;
+            }
+        }
+
+        /// <summary>
+        /// Runs an action on the context once all output queued so far has been delivered.
+        /// </summary>
+        internal void Complete(Action complete)
+        {
+            Enqueue(complete);
+        }
+
+        internal override void SetEncoding(Encoding encoding)
+        {
+            base.SetEncoding(encoding);
+            _inner.SetEncoding(encoding);
+        }
+
+        internal override void SetSpecDef(string specDef)
+        {
+            base.SetSpecDef(specDef);
+            _inner.SetSpecDef(specDef);
+        }
+
+        internal override void SetSuppressedMessages(int[] bySeverity)
+        {
+            base.SetSuppressedMessages(bySeverity);
+            _inner.SetSuppressedMessages(bySeverity);
+        }
+
+        public override void OutputMessage(P4Message message)
+        {
+            Enqueue(delegate { _inner.OutputMessage(message); });
+        }
+
+        public override void OutputRecord(P4Record record)
+        {
+            Enqueue(delegate { _inner.OutputRecord(record); });
+        }
+
+        public override void OutputInfo(string data)
+        {
+            Enqueue(delegate { _inner.OutputInfo(data); });
+        }
+
+        public override void OutputContent(byte[] buffer, bool IsText)
+        {
+            Enqueue(delegate { _inner.OutputContent(buffer, IsText); });
+        }
+
+        public override void Finished()
+        {
+            Enqueue(delegate { _inner.Finished(); });
+        }
+
+        public override bool Cancel()
+        {
+            return _failure != null || _inner.Cancel();
+        }
+
+        // a failure on the context stops the command through Cancel, so it is always polled
+        internal override bool PollsCancel
+        {
+            get { return true; }
+        }
+
+        public override void Prompt(string message, ref string response)
+        {
+            string rsp = response;
+            Send(delegate { _inner.Prompt(message, ref rsp); });
+            response = rsp;
+        }
+
+        public override void InputData(StringBuilder buffer)
+        {
+            Send(delegate { _inner.InputData(buffer); });
+        }
+
+        public override void Edit(FileInfo f1)
+        {
+            Send(delegate { _inner.Edit(f1); });
+        }
+
+        public override MergeAction ResolveFile(MergeData mergeData)
+        {
+            // mergeData is disposed as soon as this returns, so it never leaves the Send
+            MergeAction action = MergeAction.Quit;
+            Send(delegate { action = _inner.ResolveFile(mergeData); });
+            return action;
+        }
+
+        private void Enqueue(Action action)
+        {
+            bool post;
+            lock (_pending)
+            {
+                _pending.Enqueue(action);
+                post = !_posted;
+                _posted = true;
+            }
+            if (post) _context.Post(Drain, null);
+        }
+
+        private void Send(Action action)
+        {
+            _context.Send(delegate
+            {
+                Drain(null);
+                Invoke(action);
+            }, null);
+        }
+
+        private void Drain(object state)
+        {
+            // posted drains may land on different threads (the default context uses the thread pool)
+            lock (_drainLock)
+            {
+                while (true)
+                {
+                    Action action;
+                    lock (_pending)
+                    {
+                        if (_pending.Count == 0)
+                        {
+                            _posted = false;
+                            return;
+                        }
+                        action = _pending.Dequeue();
+                    }
+                    Invoke(action);
+                }
+            }
+        }
+
+        private void Invoke(Action action)
+        {
+            try
+            {
+                action();
+            }
+            catch (Exception e)
+            {
+                if (_failure == null) _failure = e;
+            }
+        }
+    }
+}
+#endif
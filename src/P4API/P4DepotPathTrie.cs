@@ -0,0 +1,446 @@
+/*
+ * P4.Net *
+Copyright (c) 2007-2010 Shawn Hladky
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+and associated documentation files (the "Software"), to deal in the Software without 
+restriction, including without limitation the rights to use, copy, modify, merge, publish, 
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or 
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+ */
+
+
+using System;
+using System.Collections.Generic;
+using System.Text;
+
+namespace P4API
+{
+    /// <summary>
+    /// Compact index of depot paths, stored as a trie of path segments.
+    /// </summary>
+    /// <remarks>
+    /// <para>Every folder and file is a node with an integer ID.  A node holds its parent, its own segment (e.g. "src"
+    /// or "main.c"), and links to its children.  Segments are stored once however many folders share them.  A large
+    /// fstat result can keep node IDs in place of depot path strings, using a small fraction of the memory, and rebuild
+    /// the full path with <see cref="GetPath"/> when needed.</para>
+    /// <para>On a case-insensitive server, lookups ignore case and a path keeps the case it had when first added, as
+    /// the server does.</para>
+    /// <para>This class is not thread safe.</para>
+    /// </remarks>
+    public class P4DepotPathTrie
+    {
+        // Gets the one field p4dn's RecordWriter keeps of each record (see SetRecordSink), a block at a time,
+        // so no P4Record is made for it.
+        private sealed class PathSink : p4dn.RecordSink
+        {
+            private readonly P4DepotPathTrie _owner;
+            public readonly List<int> Nodes = new List<int>();
+            public Exception Error = null;
+            private Encoding _encoding = null;
+
+            public PathSink(P4DepotPathTrie owner)
+            {
+                _owner = owner;
+            }
+
+            public void SetEncoding(Encoding encoding)
+            {
+                _encoding = encoding;
+            }
+
+            // Called from inside the running command, so errors are kept for AddResults rather than thrown.
+            public override void WriteBlock(byte[] data, int length, int count)
+            {
+                if (Error != null) return;
+                try
+                {
+                    // the records are in P4RecordFile's block format, each with one field whose value is always
+                    // inline; see RecordWriter::SetField
+                    int pos = 0;
+                    for (int i = 0; i < count; i++)
+                    {
+                        P4RecordFile.ReadVarint(data, ref pos);
+                        P4RecordFile.SkipRef(data, ref pos);
+                        int value = P4RecordFile.ReadVarint(data, ref pos) >> 1;
+                        Nodes.Add(_owner.Add(_encoding.GetString(data, pos, value)));
+                        pos += value;
+                    }
+                }
+                catch (Exception e)
+                {
+                    Error = e;
+                }
+            }
+
+            public override void WriteStrings(byte[] data, int length, int count)
+            {
+            }
+        }
+
+        // Everything but the records, which go to the PathSink.
+        private sealed class PathCallback : P4Callback
+        {
+            private readonly PathSink _sink;
+            public string FirstError = null;
+
+            public PathCallback(PathSink sink)
+            {
+                _sink = sink;
+            }
+
+            // set before the command runs, so the sink can decode its blocks
+            internal override void SetEncoding(Encoding encoding)
+            {
+                base.SetEncoding(encoding);
+                _sink.SetEncoding(ContentEncoding);
+            }
+
+            public override void OutputMessage(P4Message message)
+            {
+                if (FirstError == null && message.Severity >= P4MessageSeverity.Failed) FirstError = message.Format();
+            }
+
+            internal override bool PollsCancel
+            {
+                get { return false; }
+            }
+        }
+
+        /// <summary>
+        /// The ID of the root node, "//".
+        /// </summary>
+        public const int Root = 0;
+
+        private readonly bool _caseSensitive;
+
+        // node columns
+        private readonly List<int> _parent = new List<int>();
+        private readonly List<int> _segment = new List<int>();
+        private readonly List<int> _firstChild = new List<int>();
+        private readonly List<int> _lastChild = new List<int>();
+        private readonly List<int> _nextSibling = new List<int>();
+        private readonly List<bool> _isFile = new List<bool>();
+        private int _fileCount = 0;
+
+        // (parent, key) -> child, where the key is the segment ID of the first spelling seen of the segment (in any
+        // folder) on a case-insensitive server, and of the segment itself on a case-sensitive one
+        private readonly Dictionary<long, int> _children = new Dictionary<long, int>();
+        private readonly Dictionary<string, int> _segmentIds = new Dictionary<string, int>(StringComparer.Ordinal);
+        private readonly Dictionary<string, int> _keyIds;
+        private readonly List<string> _segments = new List<string>();
+
+        /// <summary>
+        /// Initializes a new instance of the <see cref="P4DepotPathTrie"/> class.
+        /// </summary>
+        /// <param name="caseSensitive">Whether paths differing only in case are different paths.</param>
+        public P4DepotPathTrie(bool caseSensitive)
+        {
+            _caseSensitive = caseSensitive;
+            _keyIds = caseSensitive ? _segmentIds : new Dictionary<string, int>(StringComparer.OrdinalIgnoreCase);
+            _segments.Add(string.Empty);
+            _segmentIds.Add(string.Empty, 0);
+            NewNode(-1, 0, 0);
+        }
+
+        /// <summary>
+        /// Initializes a new instance of the <see cref="P4DepotPathTrie"/> class, matching the server's case handling.
+        /// </summary>
+        /// <param name="connection">A connected connection; see <see cref="P4Connection.IsServerCaseSensitive"/>.</param>
+        public P4DepotPathTrie(P4Connection connection)
+            : this(connection.IsServerCaseSensitive())
+        {
+        }
+
+        #region Public Properties
+        /// <summary>
+        /// Gets whether paths differing only in case are different paths.
+        /// </summary>
+        public bool IsCaseSensitive
+        {
+            get { return _caseSensitive; }
+        }
+
+        /// <summary>
+        /// Gets the number of nodes, folders and files, including the root.
+        /// </summary>
+        public int NodeCount
+        {
+            get { return _parent.Count; }
+        }
+
+        /// <summary>
+        /// Gets the number of files added.
+        /// </summary>
+        public int FileCount
+        {
+            get { return _fileCount; }
+        }
+        #endregion
+
+        #region Public Methods
+        /// <summary>
+        /// Adds a depot file, and any folders above it.
+        /// </summary>
+        /// <param name="depotPath">The depot path, e.g. //depot/main/src/main.c.</param>
+        /// <returns>The file's node ID.  Adding the same path again returns the same ID.</returns>
+        public int Add(string depotPath)
+        {
+            int node = Walk(depotPath, true);
+            if (!_isFile[node])
+            {
+                _isFile[node] = true;
+                _fileCount++;
+            }
+            return node;
+        }
+
+        /// <summary>
+        /// Runs a command and adds the depot path from each record it returns.
+        /// </summary>
+        /// <remarks>
+        /// Only the one field is taken from each record, natively, as the records stream in; no P4Record is made and
+        /// nothing else is kept, so a result set of any size can be indexed.
+        /// </remarks>
+        /// <param name="connection">The connection to run the command on.</param>
+        /// <param name="field">The tagged field holding the path, usually "depotFile".</param>
+        /// <param name="command">The command, e.g. "files" or "fstat".</param>
+        /// <param name="args">The command's arguments.</param>
+        /// <returns>The node ID for each record with the field, in the order the server returned them.</returns>
+        public int[] AddResults(P4Connection connection, string field, string command, params string[] args)
+        {
+            if (connection == null) throw new ArgumentNullException("connection");
+            if (field == null) throw new ArgumentNullException("field");
+
+            PathSink sink = new PathSink(this);
+            PathCallback cb = new PathCallback(sink);
+            connection.RunToSink(sink, field, cb, command, args);
+            if (sink.Error != null) throw sink.Error;
+            if (cb.FirstError != null) throw new InvalidOperationException(command + " failed: " + cb.FirstError);
+            return sink.Nodes.ToArray();
+        }
+
+        /// <summary>
+        /// Finds a folder or file.
+        /// </summary>
+        /// <param name="depotPath">The depot path.  A trailing / or /... is ignored.</param>
+        /// <returns>The node ID, or -1 if the path isn't in the trie.</returns>
+        public int Find(string depotPath)
+        {
+            return Walk(depotPath, false);
+        }
+
+        /// <summary>
+        /// Gets the full depot path of a node.
+        /// </summary>
+        /// <param name="node">The node ID.</param>
+        /// <returns>The depot path; folders don't have a trailing /.</returns>
+        public string GetPath(int node)
+        {
+            CheckNode(node);
+            if (node == Root) return "//";
+
+            // collect the segments leaf to root, then write them out root to leaf
+            List<int> chain = new List<int>();
+            int length = 1;
+            for (int n = node; n != Root; n = _parent[n])
+            {
+                chain.Add(n);
+                length += _segments[_segment[n]].Length + 1;
+            }
+            StringBuilder sb = new StringBuilder(length);
+            sb.Append('/');
+            for (int i = chain.Count - 1; i >= 0; i--)
+            {
+                sb.Append('/');
+                sb.Append(_segments[_segment[chain[i]]]);
+            }
+            return sb.ToString();
+        }
+
+        /// <summary>
+        /// Gets a node's own name, e.g. main.c for //depot/main/src/main.c.
+        /// </summary>
+        /// <param name="node">The node ID.</param>
+        /// <returns>The name; empty for the root.</returns>
+        public string GetName(int node)
+        {
+            CheckNode(node);
+            return _segments[_segment[node]];
+        }
+
+        /// <summary>
+        /// Gets a node's parent folder.
+        /// </summary>
+        /// <param name="node">The node ID.</param>
+        /// <returns>The parent's node ID, or -1 for the root.</returns>
+        public int GetParent(int node)
+        {
+            CheckNode(node);
+            return _parent[node];
+        }
+
+        /// <summary>
+        /// Gets whether a node was added as a file, rather than only being a folder above one.
+        /// </summary>
+        /// <param name="node">The node ID.</param>
+        /// <returns>true if the node is a file.</returns>
+        public bool IsFile(int node)
+        {
+            CheckNode(node);
+            return _isFile[node];
+        }
+
+        /// <summary>
+        /// Gets the immediate children of a folder.
+        /// </summary>
+        /// <param name="node">The folder's node ID.</param>
+        /// <returns>The children's node IDs, in the order they were first added.</returns>
+        public int[] GetChildren(int node)
+        {
+            CheckNode(node);
+            List<int> ret = new List<int>();
+            for (int c = _firstChild[node]; c >= 0; c = _nextSibling[c])
+            {
+                ret.Add(c);
+            }
+            return ret.ToArray();
+        }
+
+        /// <summary>
+        /// Gets every file at or under a path.
+        /// </summary>
+        /// <param name="depotPath">A folder or file, e.g. //depot/main/src/... .</param>
+        /// <returns>The files' node IDs, depth first in the order they were added; empty if the path isn't in the trie.</returns>
+        public int[] GetFilesUnder(string depotPath)
+        {
+            List<int> ret = new List<int>();
+            int start = Find(depotPath);
+            if (start < 0) return ret.ToArray();
+
+            // explicit stack; depot trees can be deeper than is comfortable to recurse
+            Stack<int> pending = new Stack<int>();
+            pending.Push(start);
+            while (pending.Count > 0)
+            {
+                int n = pending.Pop();
+                if (_isFile[n]) ret.Add(n);
+
+                // push in reverse so children come out in order
+                int[] children = GetChildren(n);
+                for (int i = children.Length - 1; i >= 0; i--)
+                {
+                    pending.Push(children[i]);
+                }
+            }
+            return ret.ToArray();
+        }
+
+        /// <summary>
+        /// Releases spare capacity once all paths have been added.
+        /// </summary>
+        public void TrimExcess()
+        {
+            _parent.TrimExcess();
+            _segment.TrimExcess();
+            _firstChild.TrimExcess();
+            _lastChild.TrimExcess();
+            _nextSibling.TrimExcess();
+            _isFile.TrimExcess();
+            _segments.TrimExcess();
+        }
+        #endregion
+
+        #region Private Helper Methods
+        private int NewNode(int parent, int key, int segment)
+        {
+            int node = _parent.Count;
+            _parent.Add(parent);
+            _segment.Add(segment);
+            _firstChild.Add(-1);
+            _lastChild.Add(-1);
+            _nextSibling.Add(-1);
+            _isFile.Add(false);
+
+            if (parent >= 0)
+            {
+                if (_lastChild[parent] < 0) _firstChild[parent] = node;
+                else _nextSibling[_lastChild[parent]] = node;
+                _lastChild[parent] = node;
+                _children.Add(ChildKey(parent, key), node);
+            }
+            return node;
+        }
+
+        private static long ChildKey(int parent, int key)
+        {
+            return ((long)parent << 32) | (uint)key;
+        }
+
+        private int Intern(string name)
+        {
+            int segment;
+            if (!_segmentIds.TryGetValue(name, out segment))
+            {
+                segment = _segments.Count;
+                _segments.Add(name);
+                _segmentIds.Add(name, segment);
+            }
+            return segment;
+        }
+
+        private void CheckNode(int node)
+        {
+            if (node < 0 || node >= _parent.Count) throw new ArgumentOutOfRangeException("node");
+        }
+
+        private int Walk(string depotPath, bool create)
+        {
+            if (depotPath == null) throw new ArgumentNullException("depotPath");
+            if (!depotPath.StartsWith("//")) throw new ArgumentException("Not a depot path: " + depotPath, "depotPath");
+
+            int end = depotPath.Length;
+            if (depotPath.EndsWith("/...")) end -= 4;
+            else if (end > 2 && depotPath[end - 1] == '/') end--;
+
+            int node = Root;
+            int pos = 2;
+            while (pos < end)
+            {
+                int slash = depotPath.IndexOf('/', pos, end - pos);
+                if (slash < 0) slash = end;
+                if (slash == pos) throw new ArgumentException("Empty segment in depot path: " + depotPath, "depotPath");
+
+                string name = depotPath.Substring(pos, slash - pos);
+                int key;
+                if (!_keyIds.TryGetValue(name, out key))
+                {
+                    if (!create) return -1;
+                    key = Intern(name);
+                    if (!_caseSensitive) _keyIds.Add(name, key);
+                }
+
+                // a new node keeps its own spelling, whatever case the key was first seen in
+                int child;
+                if (!_children.TryGetValue(ChildKey(node, key), out child))
+                {
+                    if (!create) return -1;
+                    child = NewNode(node, key, _caseSensitive ? key : Intern(name));
+                }
+                node = child;
+                pos = slash + 1;
+            }
+            return node;
+        }
+        #endregion
+    }
+}
@@ -0,0 +1,265 @@
+/*
+ * P4.Net *
+Copyright (c) 2007-2010 Shawn Hladky
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+and associated documentation files (the "Software"), to deal in the Software without 
+restriction, including without limitation the rights to use, copy, modify, merge, publish, 
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or 
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+ */
+
+
+using System;
+using System.Collections.Generic;
+using System.Globalization;
+
+namespace P4API
+{
+    /// <summary>
+    /// Handler for <see cref="P4Diagnostics.OnDebugOutput"/>.
+    /// </summary>
+    /// <param name="sender">The <see cref="P4Diagnostics"/> instance.</param>
+    /// <param name="args">The captured debug line.</param>
+    public delegate void OnDebugOutputEventHandler(object sender, P4DebugOutputEventArgs args);
+
+    /// <summary>
+    /// Arguments provided for an OnDebugOutput event.
+    /// </summary>
+    public class P4DebugOutputEventArgs : EventArgs
+    {
+        private DateTime _timestamp;
+        private string _text;
+
+        internal P4DebugOutputEventArgs(DateTime timestamp, string text)
+        {
+            _timestamp = timestamp;
+            _text = text;
+        }
+
+        /// <summary>
+        /// Gets the time (UTC) the line was written by the Perforce API.
+        /// </summary>
+        public DateTime Timestamp
+        {
+            get
+            {
+                return _timestamp;
+            }
+        }
+
+        /// <summary>
+        /// Gets the debug line.
+        /// </summary>
+        public string Text
+        {
+            get
+            {
+                return _text;
+            }
+        }
+    }
+
+    /// <summary>
+    /// Controls the Perforce API's debug levels and tunables, and captures its debug output.
+    /// </summary>
+    /// <remarks>
+    /// Debug levels and tunables are global to the process.  They apply to every <see cref="P4Connection"/>, and take effect
+    /// for connections opened after they are set.
+    /// <para>While capture is on, debug output is kept in a bounded native buffer instead of going to stdout.
+    /// After each command (and after connecting) the buffered lines are raised through <see cref="OnDebugOutput"/>,
+    /// on the thread that ran the command.  When the buffer fills, the oldest lines are dropped and counted in
+    /// <see cref="DroppedLines"/>.</para>
+    /// </remarks>
+    /// <example>
+    /// See how long RPC and network calls take:
+    /// <code language="C#">
+    /// P4Diagnostics diag = P4Connection.Diagnostics;
+    /// diag.OnDebugOutput += delegate(object sender, P4DebugOutputEventArgs e) { log.WriteLine("{0:o} {1}", e.Timestamp, e.Text); };
+    /// diag.StartCapture();
+    /// diag.SetDebugLevel("rpc", 3);
+    /// diag.SetDebugLevel("net", 1);
+    /// </code>
+    /// </example>
+    public class P4Diagnostics
+    {
+        /// <summary>
+        /// Default number of lines kept in the capture buffer.
+        /// </summary>
+        public const int DefaultCapacity = 4096;
+
+        // same order as P4DebugType in the Perforce API's debug.h
+        private static readonly string[] _debugAreas = new string[] {
+            "db", "diff", "dm", "dmc", "ftp", "handle", "lbr", "map", "net",
+            "options", "rcs", "records", "rpc", "server", "spec", "track", "zeroconf", "ob" };
+
+        private static P4Diagnostics _instance = new P4Diagnostics();
+        private object _lock = new object();
+
+        private P4Diagnostics()
+        {
+        }
+
+        internal static P4Diagnostics Instance
+        {
+            get
+            {
+                return _instance;
+            }
+        }
+
+        /// <summary>
+        /// Raised for each captured debug line.
+        /// </summary>
+        public event OnDebugOutputEventHandler OnDebugOutput;
+
+        /// <summary>
+        /// Gets the names accepted by <see cref="SetDebugLevel"/>.
+        /// </summary>
+        public static string[] DebugAreas
+        {
+            get
+            {
+                return (string[])_debugAreas.Clone();
+            }
+        }
+
+        /// <summary>
+        /// Sets the debug level for an area of the Perforce API.
+        /// </summary>
+        /// <param name="area">The area, for example "rpc" or "net".  See <see cref="DebugAreas"/>.</param>
+        /// <param name="level">The level (0 turns debugging off, higher is more verbose).</param>
+        public void SetDebugLevel(string area, int level)
+        {
+            GetAreaIndex(area);
+            if (level < 0) throw new ArgumentOutOfRangeException("level");
+            p4dn.DebugLog.SetLevel(string.Format(CultureInfo.InvariantCulture, "{0}={1}", area.ToLowerInvariant(), level));
+        }
+
+        /// <summary>
+        /// Gets the debug level for an area of the Perforce API.
+        /// </summary>
+        /// <param name="area">The area, for example "rpc" or "net".</param>
+        /// <returns>The current level.</returns>
+        public int GetDebugLevel(string area)
+        {
+            return p4dn.DebugLog.GetLevel(GetAreaIndex(area));
+        }
+
+        /// <summary>
+        /// Sets a Perforce API tunable, for example "net.maxwait" or "net.tcpsize".
+        /// </summary>
+        /// <param name="name">The tunable name.</param>
+        /// <param name="value">The value.  Values are clamped by the Perforce API to the tunable's range.</param>
+        public void SetTunable(string name, int value)
+        {
+            if (string.IsNullOrEmpty(name) || name.IndexOf('=') >= 0 || name.IndexOf(',') >= 0)
+            {
+                throw new ArgumentException("Invalid tunable name.", "name");
+            }
+            p4dn.DebugLog.SetTunable(string.Format(CultureInfo.InvariantCulture, "{0}={1}", name, value));
+        }
+
+        /// <summary>
+        /// Gets the debug levels (and tunables) as the Perforce API reports them.
+        /// </summary>
+        /// <param name="showAll">True to include settings that are at their default.</param>
+        /// <returns>The settings, one per line.</returns>
+        public string ShowLevels(bool showAll)
+        {
+            return p4dn.DebugLog.ShowLevels(showAll);
+        }
+
+        /// <summary>
+        /// Starts capturing debug output, keeping up to <see cref="DefaultCapacity"/> lines between commands.
+        /// </summary>
+        public void StartCapture()
+        {
+            StartCapture(DefaultCapacity);
+        }
+
+        /// <summary>
+        /// Starts capturing debug output.
+        /// </summary>
+        /// <param name="capacity">Number of lines kept between commands.</param>
+        public void StartCapture(int capacity)
+        {
+            p4dn.DebugLog.StartCapture(capacity);
+        }
+
+        /// <summary>
+        /// Stops capturing debug output.
+        /// </summary>
+        /// <remarks>
+        /// Once capture has been started, debug output no longer goes to stdout; after StopCapture it is discarded.
+        /// Lines already captured are still delivered by the next <see cref="Flush"/>.
+        /// </remarks>
+        public void StopCapture()
+        {
+            p4dn.DebugLog.StopCapture();
+        }
+
+        /// <summary>
+        /// Gets whether debug output is being captured.
+        /// </summary>
+        public bool IsCapturing
+        {
+            get
+            {
+                return p4dn.DebugLog.Capturing;
+            }
+        }
+
+        /// <summary>
+        /// Gets the number of lines dropped because the capture buffer was full.
+        /// </summary>
+        public long DroppedLines
+        {
+            get
+            {
+                return p4dn.DebugLog.Dropped;
+            }
+        }
+
+        /// <summary>
+        /// Delivers any buffered debug lines to <see cref="OnDebugOutput"/>.
+        /// </summary>
+        /// <remarks>Called by P4Connection after each command; call it yourself to see output from a command that is still running.</remarks>
+        public void Flush()
+        {
+            p4dn.DebugLine[] lines;
+            lock (_lock)
+            {
+                lines = p4dn.DebugLog.Drain();
+            }
+            if (lines.Length == 0) return;
+
+            OnDebugOutputEventHandler handler = OnDebugOutput;
+            if (handler == null) return;
+            foreach (p4dn.DebugLine line in lines)
+            {
+                handler(this, new P4DebugOutputEventArgs(line.Timestamp, line.Text));
+            }
+        }
+
+        private static int GetAreaIndex(string area)
+        {
+            if (area == null) throw new ArgumentNullException("area");
+            int i = Array.IndexOf(_debugAreas, area.ToLowerInvariant());
+            if (i < 0)
+            {
+                throw new ArgumentException(string.Format("Unknown debug area '{0}'.", area), "area");
+            }
+            return i;
+        }
+    }
+}
@@ -0,0 +1,77 @@
+/*
+ * P4.Net *
+Copyright (c) 2007-2010 Shawn Hladky
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+and associated documentation files (the "Software"), to deal in the Software without 
+restriction, including without limitation the rights to use, copy, modify, merge, publish, 
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or 
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+ */
+
+
+using System;
+
+namespace P4API
+{
+    /// <summary>
+    /// Arguments provided for an OnFailover event.
+    /// </summary>
+    public class P4FailoverEventArgs : EventArgs
+    {
+        private string _port;
+        private bool _usedStandby;
+        private TimeSpan _elapsed;
+
+        //don't allow to be created outside this assembly
+        internal P4FailoverEventArgs(string port, bool usedStandby, TimeSpan elapsed)
+        {
+            _port = port;
+            _usedStandby = usedStandby;
+            _elapsed = elapsed;
+        }
+
+        /// <summary>
+        /// The server the connection was re-established to.
+        /// </summary>
+        public string Port
+        {
+            get
+            {
+                return _port;
+            }
+        }
+
+        /// <summary>
+        /// True when a warm standby session was swapped in; false when P4.Net had to reconnect from scratch.
+        /// </summary>
+        /// <seealso cref="P4Connection.WarmStandby"/>
+        public bool UsedStandby
+        {
+            get
+            {
+                return _usedStandby;
+            }
+        }
+
+        /// <summary>
+        /// How long the caller was held up re-establishing the connection.
+        /// </summary>
+        public TimeSpan Elapsed
+        {
+            get
+            {
+                return _elapsed;
+            }
+        }
+    }
+}
@@ -0,0 +1,240 @@
+/*
+ * P4.Net *
+Copyright (c) 2007-2010 Shawn Hladky
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+and associated documentation files (the "Software"), to deal in the Software without 
+restriction, including without limitation the rights to use, copy, modify, merge, publish, 
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or 
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+ */
+
+
+using System;
+
+namespace P4API
+{
+    /// <summary>
+    /// How one server's part of a <see cref="P4Federation"/> query ended.
+    /// </summary>
+    public enum P4FederatedSourceStatus
+    {
+        /// <summary>
+        /// The command completed (it may still have returned errors).
+        /// </summary>
+        Completed = 1,
+
+        /// <summary>
+        /// The command hit <see cref="P4Federation.Timeout"/>; the records received before that are included.
+        /// </summary>
+        TimedOut = 2,
+
+        /// <summary>
+        /// The command threw; see <see cref="P4FederatedSource.Error"/>.
+        /// </summary>
+        Failed = 3,
+
+        /// <summary>
+        /// The server didn't answer in time (or was still busy with an earlier query that gave up on it), so nothing
+        /// from it is included.
+        /// </summary>
+        NotFinished = 4,
+
+        /// <summary>
+        /// The server was running a query for another call to <see cref="P4Federation.Run"/> at the same moment, so
+        /// it wasn't asked and nothing from it is included.
+        /// </summary>
+        Busy = 5
+    }
+
+    /// <summary>
+    /// One server's part of a <see cref="P4FederatedResult"/>.
+    /// </summary>
+    public class P4FederatedSource
+    {
+        private string _name;
+        private P4FederatedSourceStatus _status;
+        private P4RecordSet _recordSet;
+        private Exception _error;
+        private TimeSpan _elapsed;
+
+        //don't allow to be created outside this assembly
+        internal P4FederatedSource(string name, P4FederatedSourceStatus status, P4RecordSet recordSet, Exception error, TimeSpan elapsed)
+        {
+            _name = name;
+            _status = status;
+            _recordSet = recordSet;
+            _error = error;
+            _elapsed = elapsed;
+        }
+
+        /// <summary>
+        /// Gets the server's name in the federation.
+        /// </summary>
+        public string Name
+        {
+            get
+            {
+                return _name;
+            }
+        }
+
+        /// <summary>
+        /// Gets how the server's part ended.
+        /// </summary>
+        public P4FederatedSourceStatus Status
+        {
+            get
+            {
+                return _status;
+            }
+        }
+
+        /// <summary>
+        /// Gets the server's results, or null if it failed or didn't finish.
+        /// </summary>
+        public P4RecordSet RecordSet
+        {
+            get
+            {
+                return _recordSet;
+            }
+        }
+
+        /// <summary>
+        /// Gets the exception the command threw, or null.
+        /// </summary>
+        public Exception Error
+        {
+            get
+            {
+                return _error;
+            }
+        }
+
+        /// <summary>
+        /// Gets how long the server took (or how long it was waited for).
+        /// </summary>
+        public TimeSpan Elapsed
+        {
+            get
+            {
+                return _elapsed;
+            }
+        }
+    }
+
+    /// <summary>
+    /// A record from a <see cref="P4Federation"/> query, tagged with the server it came from.
+    /// </summary>
+    public class P4FederatedRecord
+    {
+        private string _source;
+        private P4Record _record;
+
+        //don't allow to be created outside this assembly
+        internal P4FederatedRecord(string source, P4Record record)
+        {
+            _source = source;
+            _record = record;
+        }
+
+        /// <summary>
+        /// Gets the name of the server the record came from.
+        /// </summary>
+        public string Source
+        {
+            get
+            {
+                return _source;
+            }
+        }
+
+        /// <summary>
+        /// Gets the record.
+        /// </summary>
+        public P4Record Record
+        {
+            get
+            {
+                return _record;
+            }
+        }
+
+        /// <summary>
+        /// Returns the value of of the Field by key.  This is the same as Record.Fields[key].
+        /// </summary>
+        /// <param name="key">The field name.</param>
+        /// <value>The value for field 'key'.</value>
+        public string this[string key]
+        {
+            get
+            {
+                return _record.Fields[key];
+            }
+        }
+    }
+
+    /// <summary>
+    /// The merged results of a <see cref="P4Federation"/> query.
+    /// </summary>
+    public class P4FederatedResult
+    {
+        private P4FederatedRecord[] _records;
+        private P4FederatedSource[] _sources;
+
+        //don't allow to be created outside this assembly
+        internal P4FederatedResult(P4FederatedRecord[] records, P4FederatedSource[] sources)
+        {
+            _records = records;
+            _sources = sources;
+        }
+
+        /// <summary>
+        /// Gets the records from every server that answered, sorted by <see cref="P4Federation.SortField"/> if set,
+        /// otherwise in server order.
+        /// </summary>
+        public P4FederatedRecord[] Records
+        {
+            get
+            {
+                return (P4FederatedRecord[])_records.Clone();
+            }
+        }
+
+        /// <summary>
+        /// Gets each server's part, in the order the servers were added.
+        /// </summary>
+        public P4FederatedSource[] Sources
+        {
+            get
+            {
+                return (P4FederatedSource[])_sources.Clone();
+            }
+        }
+
+        /// <summary>
+        /// Gets whether every server completed, so <see cref="Records"/> is the whole answer.
+        /// </summary>
+        public bool IsComplete
+        {
+            get
+            {
+                foreach (P4FederatedSource s in _sources)
+                {
+                    if (s.Status != P4FederatedSourceStatus.Completed) return false;
+                }
+                return true;
+            }
+        }
+    }
+}
@@ -0,0 +1,353 @@
+/*
+ * P4.Net *
+Copyright (c) 2007-2010 Shawn Hladky
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+and associated documentation files (the "Software"), to deal in the Software without 
+restriction, including without limitation the rights to use, copy, modify, merge, publish, 
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or 
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+ */
+
+
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Threading;
+
+namespace P4API
+{
+    /// <summary>
+    /// Runs the same tagged command against several independent servers at once and merges the records.
+    /// </summary>
+    /// <remarks>
+    /// <para>Each server is a <see cref="P4Connection"/> added with <see cref="Add"/>; the federation doesn't own them.
+    /// A query runs on every server concurrently, each limited by <see cref="Timeout"/>.  Servers that are slow or
+    /// down don't hold up the others: their part is reported in <see cref="P4FederatedResult.Sources"/> and the
+    /// records that did arrive are returned.</para>
+    /// <para>A server still busy with an earlier query that gave up on it is skipped (NotFinished) until it is done.</para>
+    /// <para>Run may be called from several threads.  Each connection runs one query at a time, so a server busy with
+    /// another thread's Run is skipped too, and reported Busy.</para>
+    /// </remarks>
+    public class P4Federation
+    {
+        private sealed class Source
+        {
+            public string Name;
+            public P4Connection Connection;
+            public bool Busy;
+            // the query keeping it busy was given up on
+            public bool Abandoned;
+        }
+
+        private sealed class Call
+        {
+            public Source Source;
+            public P4RecordSet RecordSet;
+            public Exception Error;
+            public TimeSpan Elapsed;
+            public bool Skipped;
+            public bool SkippedAbandoned;
+            public bool Done;
+        }
+
+        private readonly List<Source> _sources = new List<Source>();
+        private TimeSpan _timeout = TimeSpan.FromSeconds(30);
+        private string _sortField = null;
+        private bool _sortDescending = false;
+
+        /// <summary>
+        /// Initializes a new instance of the <see cref="P4Federation"/> class with no servers.
+        /// </summary>
+        public P4Federation()
+        {
+        }
+
+        #region Public Properties
+        /// <summary>
+        /// Gets/Sets how long each server is given to answer.
+        /// </summary>
+        /// <remarks>
+        /// Applied as the connection's <see cref="P4Connection.CommandTimeout"/>, so a slow server returns what it has
+        /// so far.  A server that hasn't even connected a few seconds after that is reported NotFinished.
+        /// </remarks>
+        /// <value>Defaults to 30 seconds.</value>
+        public TimeSpan Timeout
+        {
+            get
+            {
+                return _timeout;
+            }
+            set
+            {
+                if (value <= TimeSpan.Zero) throw new ArgumentOutOfRangeException("value");
+                _timeout = value;
+            }
+        }
+
+        /// <summary>
+        /// Gets/Sets the field merged records are sorted by, e.g. "time" or "change".  Null keeps server order.
+        /// </summary>
+        /// <remarks>Values that are both whole numbers compare as numbers; otherwise as strings.  Records without the
+        /// field sort last.  Records with equal keys keep server order.</remarks>
+        public string SortField
+        {
+            get
+            {
+                return _sortField;
+            }
+            set
+            {
+                _sortField = value;
+            }
+        }
+
+        /// <summary>
+        /// Gets/Sets whether <see cref="SortField"/> sorts newest (largest) first.
+        /// </summary>
+        /// <value>Defaults to false.</value>
+        public bool SortDescending
+        {
+            get
+            {
+                return _sortDescending;
+            }
+            set
+            {
+                _sortDescending = value;
+            }
+        }
+
+        /// <summary>
+        /// Gets the number of servers.
+        /// </summary>
+        public int Count
+        {
+            get
+            {
+                lock (_sources)
+                {
+                    return _sources.Count;
+                }
+            }
+        }
+        #endregion
+
+        #region Public Methods
+        /// <summary>
+        /// Adds a server to the federation.
+        /// </summary>
+        /// <param name="name">Name used to tag the server's records.</param>
+        /// <param name="connection">Connection to the server.  Don't use it elsewhere while a query runs.</param>
+        public void Add(string name, P4Connection connection)
+        {
+            if (name == null) throw new ArgumentNullException("name");
+            if (connection == null) throw new ArgumentNullException("connection");
+
+            Source s = new Source();
+            s.Name = name;
+            s.Connection = connection;
+            lock (_sources)
+            {
+                _sources.Add(s);
+            }
+        }
+
+        /// <summary>
+        /// Runs a tagged command on every server and merges the results.
+        /// </summary>
+        /// <param name="command">The command.</param>
+        /// <param name="args">The arguments to the Perforce command.</param>
+        /// <returns>The merged records and each server's part.</returns>
+        public P4FederatedResult Run(string command, params string[] args)
+        {
+            if (command == null) throw new ArgumentNullException("command");
+            if (args == null) throw new ArgumentNullException("args");
+
+            Source[] sources;
+            lock (_sources)
+            {
+                sources = _sources.ToArray();
+            }
+
+            TimeSpan timeout = _timeout;
+            Call[] calls = new Call[sources.Length];
+            object done = new object();
+            for (int i = 0; i < sources.Length; i++)
+            {
+                calls[i] = new Call();
+                calls[i].Source = sources[i];
+                Call call = calls[i];
+
+                // a connection still running another query is left alone
+                lock (_sources)
+                {
+                    call.Skipped = call.Source.Busy;
+                    call.SkippedAbandoned = call.Source.Busy && call.Source.Abandoned;
+                    if (!call.Skipped)
+                    {
+                        call.Source.Busy = true;
+                        call.Source.Abandoned = false;
+                    }
+                }
+                if (call.Skipped) continue;
+
+                ThreadPool.QueueUserWorkItem(delegate
+                {
+                    Stopwatch sw = Stopwatch.StartNew();
+                    P4Connection c = call.Source.Connection;
+                    try
+                    {
+                        TimeSpan old = c.CommandTimeout;
+                        c.CommandTimeout = timeout;
+                        try
+                        {
+                            call.RecordSet = c.Run(command, args);
+                        }
+                        finally
+                        {
+                            c.CommandTimeout = old;
+                        }
+                    }
+                    catch (Exception e)
+                    {
+                        call.Error = e;
+                    }
+                    finally
+                    {
+                        lock (_sources)
+                        {
+                            call.Source.Busy = false;
+                        }
+                    }
+
+                    lock (done)
+                    {
+                        call.Elapsed = sw.Elapsed;
+                        call.Done = true;
+                        Monitor.PulseAll(done);
+                    }
+                });
+            }
+
+            // the command timeout can't stop a connect that hangs, so don't wait forever for it
+            Stopwatch waited = Stopwatch.StartNew();
+            TimeSpan limit = timeout + TimeSpan.FromSeconds(5);
+            P4FederatedSource[] parts = new P4FederatedSource[calls.Length];
+            lock (done)
+            {
+                while (true)
+                {
+                    bool all = true;
+                    foreach (Call call in calls)
+                    {
+                        if (!call.Done && !call.Skipped) all = false;
+                    }
+                    TimeSpan left = limit - waited.Elapsed;
+                    if (all || left <= TimeSpan.Zero) break;
+                    Monitor.Wait(done, left);
+                }
+
+                for (int i = 0; i < calls.Length; i++)
+                {
+                    parts[i] = ToSource(calls[i], waited.Elapsed);
+                }
+            }
+
+            // whoever finds these still busy should know nobody is waiting for them
+            lock (_sources)
+            {
+                foreach (Call call in calls)
+                {
+                    if (!call.Skipped && !call.Done) call.Source.Abandoned = true;
+                }
+            }
+
+            return new P4FederatedResult(Merge(parts), parts);
+        }
+        #endregion
+
+        #region Private Helper Methods
+        private static P4FederatedSource ToSource(Call call, TimeSpan waited)
+        {
+            if (call.Skipped && !call.SkippedAbandoned)
+            {
+                return new P4FederatedSource(call.Source.Name, P4FederatedSourceStatus.Busy, null, null, TimeSpan.Zero);
+            }
+            if (!call.Done)
+            {
+                return new P4FederatedSource(call.Source.Name, P4FederatedSourceStatus.NotFinished, null, null, waited);
+            }
+            if (call.Error != null)
+            {
+                return new P4FederatedSource(call.Source.Name, P4FederatedSourceStatus.Failed, null, call.Error, call.Elapsed);
+            }
+            P4FederatedSourceStatus status = (call.RecordSet.CommandStatus == P4CommandStatus.TimedOut)
+                ? P4FederatedSourceStatus.TimedOut : P4FederatedSourceStatus.Completed;
+            return new P4FederatedSource(call.Source.Name, status, call.RecordSet, null, call.Elapsed);
+        }
+
+        private P4FederatedRecord[] Merge(P4FederatedSource[] parts)
+        {
+            List<P4FederatedRecord> records = new List<P4FederatedRecord>();
+            foreach (P4FederatedSource part in parts)
+            {
+                if (part.RecordSet == null) continue;
+                foreach (P4Record r in part.RecordSet)
+                {
+                    records.Add(new P4FederatedRecord(part.Name, r));
+                }
+            }
+
+            string field = _sortField;
+            if (field == null) return records.ToArray();
+
+            // List.Sort isn't stable, so break ties on the original position
+            int[] order = new int[records.Count];
+            P4FederatedRecord[] sorted = records.ToArray();
+            for (int i = 0; i < order.Length; i++)
+            {
+                order[i] = i;
+            }
+            bool descending = _sortDescending;
+            Array.Sort(order, delegate(int a, int b)
+            {
+                string x = sorted[a].Record.Fields[field];
+                string y = sorted[b].Record.Fields[field];
+
+                // missing values sort last, whichever the direction
+                int c = (x == null ? 1 : 0) - (y == null ? 1 : 0);
+                if (c == 0 && x != null)
+                {
+                    c = CompareValues(x, y);
+                    if (descending) c = -c;
+                }
+                return (c != 0) ? c : a.CompareTo(b);
+            });
+
+            P4FederatedRecord[] ret = new P4FederatedRecord[order.Length];
+            for (int i = 0; i < order.Length; i++)
+            {
+                ret[i] = sorted[order[i]];
+            }
+            return ret;
+        }
+
+        private static int CompareValues(string a, string b)
+        {
+            long x, y;
+            if (long.TryParse(a, out x) && long.TryParse(b, out y)) return x.CompareTo(y);
+            return string.CompareOrdinal(a, b);
+        }
+        #endregion
+    }
+}
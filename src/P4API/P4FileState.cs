@@ -0,0 +1,126 @@
+/*
+ * P4.Net *
+Copyright (c) 2007-2010 Shawn Hladky
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+and associated documentation files (the "Software"), to deal in the Software without 
+restriction, including without limitation the rights to use, copy, modify, merge, publish, 
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or 
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+ */
+
+
+using System;
+
+namespace P4API
+{
+    /// <summary>
+    /// One file's state in a <see cref="P4WorkspaceState"/>.
+    /// </summary>
+    public class P4FileState
+    {
+        private string _depotFile;
+        private string _clientFile;
+        private int _haveRev;
+        private int _headRev;
+        private string _action;
+        private string _digest;
+
+        //don't allow to be created outside this assembly
+        internal P4FileState(string depotFile, string clientFile, int haveRev, int headRev, string action, string digest)
+        {
+            _depotFile = depotFile;
+            _clientFile = clientFile;
+            _haveRev = haveRev;
+            _headRev = headRev;
+            _action = action;
+            _digest = digest;
+        }
+
+        /// <summary>
+        /// The file's depot path.
+        /// </summary>
+        public string DepotFile
+        {
+            get
+            {
+                return _depotFile;
+            }
+        }
+
+        /// <summary>
+        /// The file's local path.
+        /// </summary>
+        public string ClientFile
+        {
+            get
+            {
+                return _clientFile;
+            }
+        }
+
+        /// <summary>
+        /// The revision synced to the workspace, or 0 if none.
+        /// </summary>
+        public int HaveRev
+        {
+            get
+            {
+                return _haveRev;
+            }
+        }
+
+        /// <summary>
+        /// The head revision in the depot.
+        /// </summary>
+        public int HeadRev
+        {
+            get
+            {
+                return _headRev;
+            }
+        }
+
+        /// <summary>
+        /// The action the file is opened for (add, edit, delete, ...), or null if it isn't open.
+        /// </summary>
+        public string Action
+        {
+            get
+            {
+                return _action;
+            }
+        }
+
+        /// <summary>
+        /// The MD5 digest of the head revision, as hex, or null if the server didn't report one.
+        /// </summary>
+        public string Digest
+        {
+            get
+            {
+                return _digest;
+            }
+        }
+
+        /// <summary>
+        /// Gets whether a newer revision than the one synced is available.
+        /// </summary>
+        public bool IsOutOfDate
+        {
+            get
+            {
+                return _haveRev != 0 && _haveRev < _headRev;
+            }
+        }
+    }
+}
@@ -0,0 +1,256 @@
+/*
+ * P4.Net *
+Copyright (c) 2007-2010 Shawn Hladky
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+and associated documentation files (the "Software"), to deal in the Software without 
+restriction, including without limitation the rights to use, copy, modify, merge, publish, 
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or 
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+ */
+
+
+using System;
+
+namespace P4API
+{
+    /// <summary>
+    /// A log-linear histogram of non-negative values (P4.Net records times in microseconds).
+    /// </summary>
+    /// <remarks>
+    /// Each power of two is split into 16 buckets, so any recorded value is reported to within about 6%.
+    /// The histogram has a fixed size no matter how many values are recorded.
+    /// <para>P4Histogram is not thread safe.  Instances returned from <see cref="P4PerformanceCounters"/> are copies
+    /// and can be read freely.</para>
+    /// </remarks>
+    public class P4Histogram
+    {
+        private const int SubBucketBits = 4;
+        private const int SubBucketCount = 1 << SubBucketBits;
+        private const int BucketCount = (64 - SubBucketBits) * SubBucketCount;
+
+        private long[] _counts = new long[BucketCount];
+        private long _count;
+        private long _sum;
+        private long _min = long.MaxValue;
+        private long _max;
+
+        /// <summary>
+        /// Initializes a new, empty instance of the <see cref="P4Histogram"/> class.
+        /// </summary>
+        public P4Histogram()
+        {
+        }
+
+        /// <summary>
+        /// Records a value.  Negative values are recorded as 0.
+        /// </summary>
+        /// <param name="value">The value.</param>
+        public void Record(long value)
+        {
+            Record(value, 1);
+        }
+
+        /// <summary>
+        /// Records a value several times.
+        /// </summary>
+        /// <param name="value">The value.</param>
+        /// <param name="count">How many times to record it.</param>
+        public void Record(long value, long count)
+        {
+            if (count <= 0) return;
+            if (value < 0) value = 0;
+
+            _counts[GetIndex(value)] += count;
+            _count += count;
+            _sum += value * count;
+            if (value < _min) _min = value;
+            if (value > _max) _max = value;
+        }
+
+        /// <summary>
+        /// Adds all values recorded in another histogram to this one.
+        /// </summary>
+        /// <param name="other">The histogram to add.</param>
+        public void Add(P4Histogram other)
+        {
+            if (other == null || other._count == 0) return;
+            for (int i = 0; i < BucketCount; i++)
+            {
+                _counts[i] += other._counts[i];
+            }
+            _count += other._count;
+            _sum += other._sum;
+            if (other._min < _min) _min = other._min;
+            if (other._max > _max) _max = other._max;
+        }
+
+        /// <summary>
+        /// Removes all recorded values.
+        /// </summary>
+        public void Reset()
+        {
+            Array.Clear(_counts, 0, BucketCount);
+            _count = 0;
+            _sum = 0;
+            _min = long.MaxValue;
+            _max = 0;
+        }
+
+        /// <summary>
+        /// Creates a copy of this histogram.
+        /// </summary>
+        /// <returns>An independent copy.</returns>
+        public P4Histogram Clone()
+        {
+            P4Histogram ret = new P4Histogram();
+            ret.Add(this);
+            return ret;
+        }
+
+        /// <summary>
+        /// Creates a copy corrected for coordinated omission.
+        /// </summary>
+        /// <remarks>
+        /// A client that waits for each command before sending the next one stops sending while the server stalls, so the
+        /// commands it would have sent in the meantime never show up in the histogram.  For every recorded value longer
+        /// than <paramref name="expectedInterval"/> the copy also holds the values those missing commands would have seen
+        /// (value - interval, value - 2 * interval, ... down to the interval).  Values are taken from bucket upper bounds.
+        /// </remarks>
+        /// <param name="expectedInterval">The interval between commands the client meant to keep, in the histogram's units.</param>
+        /// <returns>A new histogram; this one is unchanged.</returns>
+        public P4Histogram CopyCorrectedForCoordinatedOmission(long expectedInterval)
+        {
+            P4Histogram ret = Clone();
+            if (expectedInterval <= 0) return ret;
+
+            for (int i = 0; i < BucketCount; i++)
+            {
+                long count = _counts[i];
+                if (count == 0) continue;
+
+                long value = Math.Min(GetUpperBound(i), _max);
+                for (long missing = value - expectedInterval; missing >= expectedInterval; missing -= expectedInterval)
+                {
+                    ret.Record(missing, count);
+                }
+            }
+            return ret;
+        }
+
+        /// <summary>
+        /// Gets the number of recorded values.
+        /// </summary>
+        public long Count
+        {
+            get
+            {
+                return _count;
+            }
+        }
+
+        /// <summary>
+        /// Gets the sum of all recorded values.
+        /// </summary>
+        public long Sum
+        {
+            get
+            {
+                return _sum;
+            }
+        }
+
+        /// <summary>
+        /// Gets the smallest recorded value (0 when empty).
+        /// </summary>
+        public long Min
+        {
+            get
+            {
+                return _count == 0 ? 0 : _min;
+            }
+        }
+
+        /// <summary>
+        /// Gets the largest recorded value.
+        /// </summary>
+        public long Max
+        {
+            get
+            {
+                return _max;
+            }
+        }
+
+        /// <summary>
+        /// Gets the mean of the recorded values.
+        /// </summary>
+        public double Mean
+        {
+            get
+            {
+                return _count == 0 ? 0 : (double)_sum / _count;
+            }
+        }
+
+        /// <summary>
+        /// Gets the value below which the given percentage of recorded values fall.
+        /// </summary>
+        /// <param name="percentile">Percentile, from 0 to 100.</param>
+        /// <returns>The upper bound of the bucket that holds the percentile (never more than Max).</returns>
+        public long GetPercentile(double percentile)
+        {
+            if (_count == 0) return 0;
+            if (percentile < 0) percentile = 0;
+            if (percentile > 100) percentile = 100;
+
+            long rank = (long)Math.Ceiling(percentile / 100.0 * _count);
+            if (rank < 1) rank = 1;
+
+            long seen = 0;
+            for (int i = 0; i < BucketCount; i++)
+            {
+                seen += _counts[i];
+                if (seen >= rank)
+                {
+                    return Math.Min(GetUpperBound(i), _max);
+                }
+            }
+            return _max;
+        }
+
+        private static int GetIndex(long value)
+        {
+            if (value < SubBucketCount) return (int)value;
+
+            int shift = HighestBit(value) - SubBucketBits;
+            int sub = (int)(value >> shift) & (SubBucketCount - 1);
+            return (shift + 1) * SubBucketCount + sub;
+        }
+
+        private static long GetUpperBound(int index)
+        {
+            if (index < SubBucketCount) return index;
+
+            int shift = index / SubBucketCount - 1;
+            long lower = (long)(SubBucketCount + index % SubBucketCount) << shift;
+            return lower + (1L << shift) - 1;
+        }
+
+        private static int HighestBit(long value)
+        {
+            int bit = 0;
+            while ((value >>= 1) != 0) bit++;
+            return bit;
+        }
+    }
+}
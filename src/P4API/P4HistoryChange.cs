@@ -0,0 +1,142 @@
+/*
+ * P4.Net *
+Copyright (c) 2007-2010 Shawn Hladky
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+and associated documentation files (the "Software"), to deal in the Software without 
+restriction, including without limitation the rights to use, copy, modify, merge, publish, 
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or 
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+ */
+
+
+using System;
+
+namespace P4API
+{
+    /// <summary>
+    /// A submitted change kept in a <see cref="P4ChangeHistory"/>.
+    /// </summary>
+    public class P4HistoryChange
+    {
+        private int _change;
+        private DateTime _time;
+        private string _user;
+        private string _client;
+        private string _description;
+        private string[] _depotFiles;
+        private string[] _actions;
+        private string[] _revisions;
+
+        //don't allow to be created outside this assembly
+        internal P4HistoryChange(int change, DateTime time, string user, string client, string description,
+            string[] depotFiles, string[] actions, string[] revisions)
+        {
+            _change = change;
+            _time = time;
+            _user = user;
+            _client = client;
+            _description = description;
+            _depotFiles = depotFiles;
+            _actions = actions;
+            _revisions = revisions;
+        }
+
+        /// <summary>
+        /// The change number.
+        /// </summary>
+        public int Change
+        {
+            get
+            {
+                return _change;
+            }
+        }
+
+        /// <summary>
+        /// When the change was submitted, in UTC.
+        /// </summary>
+        public DateTime Time
+        {
+            get
+            {
+                return _time;
+            }
+        }
+
+        /// <summary>
+        /// The user who submitted the change.
+        /// </summary>
+        public string User
+        {
+            get
+            {
+                return _user;
+            }
+        }
+
+        /// <summary>
+        /// The client workspace the change was submitted from.
+        /// </summary>
+        public string Client
+        {
+            get
+            {
+                return _client;
+            }
+        }
+
+        /// <summary>
+        /// The full change description.
+        /// </summary>
+        public string Description
+        {
+            get
+            {
+                return _description;
+            }
+        }
+
+        /// <summary>
+        /// The depot paths of the files in the change.
+        /// </summary>
+        public string[] DepotFiles
+        {
+            get
+            {
+                return (string[])_depotFiles.Clone();
+            }
+        }
+
+        /// <summary>
+        /// The action on each file, in the same order as <see cref="DepotFiles"/>.
+        /// </summary>
+        public string[] Actions
+        {
+            get
+            {
+                return (string[])_actions.Clone();
+            }
+        }
+
+        /// <summary>
+        /// The revision of each file, in the same order as <see cref="DepotFiles"/>.
+        /// </summary>
+        public string[] Revisions
+        {
+            get
+            {
+                return (string[])_revisions.Clone();
+            }
+        }
+    }
+}
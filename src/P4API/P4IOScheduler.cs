@@ -0,0 +1,173 @@
+/*
+ * P4.Net *
+Copyright (c) 2007-2010 Shawn Hladky
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+and associated documentation files (the "Software"), to deal in the Software without 
+restriction, including without limitation the rights to use, copy, modify, merge, publish, 
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or 
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+ */
+
+
+#if CLR4
+using System;
+using System.Collections.Concurrent;
+using System.Collections.Generic;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace P4API
+{
+    /// <summary>
+    /// Runs P4.Net's asynchronous commands on a small set of dedicated threads.
+    /// </summary>
+    /// <remarks>
+    /// A Perforce command blocks its thread for the whole conversation with the server.  Running those on the
+    /// thread pool starves everything else that needs pool threads, so the *Async methods of <see cref="P4Connection"/>
+    /// queue their commands here instead.  At most <see cref="MaximumConcurrencyLevel"/> commands run at once;
+    /// the rest wait in the queue without holding a thread.
+    /// </remarks>
+    public sealed class P4IOScheduler : TaskScheduler, IDisposable
+    {
+        private static readonly object _defaultLock = new object();
+        private static P4IOScheduler _default;
+
+        [ThreadStatic]
+        private static P4IOScheduler _current;
+
+        private readonly BlockingCollection<Task> _tasks = new BlockingCollection<Task>();
+        private readonly Thread[] _threads;
+
+        /// <summary>
+        /// Starts a scheduler with its own threads.
+        /// </summary>
+        /// <param name="threads">Number of I/O threads (the most commands that will run at once).</param>
+        public P4IOScheduler(int threads)
+        {
+            if (threads < 1) throw new ArgumentOutOfRangeException("threads");
+
+            _threads = new Thread[threads];
+            for (int i = 0; i < threads; i++)
+            {
+                Thread t = new Thread(Work);
+                t.IsBackground = true;
+                t.Name = "P4.Net I/O " + i;
+                _threads[i] = t;
+                t.Start();
+            }
+        }
+
+        /// <summary>
+        /// Gets/Sets the scheduler used by connections that don't set <see cref="P4Connection.IOScheduler"/>.
+        /// </summary>
+        /// <value>Created on first use with one thread per processor (at least 4).</value>
+        public static P4IOScheduler DefaultScheduler
+        {
+            get
+            {
+                lock (_defaultLock)
+                {
+                    if (_default == null)
+                    {
+                        _default = new P4IOScheduler(Math.Max(4, Environment.ProcessorCount));
+                    }
+                    return _default;
+                }
+            }
+            set
+            {
+                if (value == null) throw new ArgumentNullException("value");
+                lock (_defaultLock)
+                {
+                    _default = value;
+                }
+            }
+        }
+
+        /// <summary>
+        /// Gets the number of I/O threads.
+        /// </summary>
+        public override int MaximumConcurrencyLevel
+        {
+            get
+            {
+                return _threads.Length;
+            }
+        }
+
+        /// <summary>
+        /// Gets the number of commands waiting for a thread.
+        /// </summary>
+        public int QueuedCount
+        {
+            get
+            {
+                return _tasks.Count;
+            }
+        }
+
+        /// <summary>
+        /// Stops accepting work and waits for queued commands to finish.
+        /// </summary>
+        public void Dispose()
+        {
+            if (_tasks.IsAddingCompleted) return;
+            _tasks.CompleteAdding();
+            foreach (Thread t in _threads)
+            {
+                if (t != Thread.CurrentThread) t.Join();
+            }
+        }
+
+        /// <summary>
+        /// Queues a task to one of the I/O threads.
+        /// </summary>
+        /// <param name="task">The task.</param>
+        protected override void QueueTask(Task task)
+        {
+            _tasks.Add(task);
+        }
+
+        /// <summary>
+        /// Runs a task inline, but only when already on one of this scheduler's threads.
+        /// </summary>
+        /// <param name="task">The task.</param>
+        /// <param name="taskWasPreviouslyQueued">Whether the task is still in the queue.</param>
+        /// <returns>True when the task was run.</returns>
+        protected override bool TryExecuteTaskInline(Task task, bool taskWasPreviouslyQueued)
+        {
+            // a pool thread waiting on a command must not end up running it
+            if (_current != this) return false;
+            return TryExecuteTask(task);
+        }
+
+        /// <summary>
+        /// Gets the queued tasks, for the debugger.
+        /// </summary>
+        /// <returns>The tasks not yet started.</returns>
+        protected override IEnumerable<Task> GetScheduledTasks()
+        {
+            return _tasks.ToArray();
+        }
+
+        private void Work()
+        {
+            _current = this;
+            foreach (Task task in _tasks.GetConsumingEnumerable())
+            {
+                TryExecuteTask(task);
+            }
+        }
+    }
+}
+#endif
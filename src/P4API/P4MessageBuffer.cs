@@ -0,0 +1,61 @@
+/*
+ * P4.Net *
+Copyright (c) 2007-2010 Shawn Hladky
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+and associated documentation files (the "Software"), to deal in the Software without 
+restriction, including without limitation the rights to use, copy, modify, merge, publish, 
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or 
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+ */
+
+
+using System;
+
+namespace P4API
+{
+    /// <summary>
+    /// Chunked byte pool that holds marshalled message snapshots for a single command run.
+    /// </summary>
+    /// <remarks>
+    /// Messages reference a slice of a shared chunk rather than owning their own buffer, so a
+    /// command producing many messages only allocates a handful of large arrays.
+    /// </remarks>
+    internal class P4MessageBuffer
+    {
+        private const int ChunkSize = 16 * 1024;
+
+        private byte[] _chunk = null;
+        private int _used = 0;
+
+        /// <summary>
+        /// Reserves length bytes, returning the chunk and offset the caller may write to.
+        /// </summary>
+        internal byte[] Reserve(int length, out int offset)
+        {
+            if (length > ChunkSize / 4)
+            {
+                // big messages get their own array so they don't waste the tail of a chunk
+                offset = 0;
+                return new byte[length];
+            }
+            if (_chunk == null || _used + length > _chunk.Length)
+            {
+                _chunk = new byte[ChunkSize];
+                _used = 0;
+            }
+            offset = _used;
+            _used += length;
+            return _chunk;
+        }
+    }
+}
@@ -0,0 +1,142 @@
+/*
+ * P4.Net *
+Copyright (c) 2007-2010 Shawn Hladky
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+and associated documentation files (the "Software"), to deal in the Software without 
+restriction, including without limitation the rights to use, copy, modify, merge, publish, 
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or 
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+ */
+
+
+using System;
+using System.Collections.Generic;
+
+namespace P4API
+{
+    /// <summary>
+    /// Filters Perforce messages before they are handed to P4.Net.
+    /// </summary>
+    /// <remarks>
+    /// The filter is evaluated in the native layer for every message the server sends.  Messages that
+    /// are filtered out are never formatted or stored; only their count (by severity) is reported on the
+    /// resulting recordset.
+    /// <para>Ids are the unique code of the message, which is <c>P4Message.Identity &amp; 0xffff</c>.
+    /// Subsystems are <c>(P4Message.Identity &gt;&gt; 10) &amp; 0x3f</c>.</para>
+    /// <para>A message in one of the deny lists is always dropped.  A message in one of the allow lists is always kept.
+    /// All other messages are kept when their severity is at least MinimumSeverity.</para>
+    /// </remarks>
+    /// <example>
+    /// Keep only warnings and errors:
+    /// <code language="C#">
+    /// P4MessageFilter filter = new P4MessageFilter(P4MessageSeverity.Warning);
+    /// p4.MessageFilter = filter;
+    /// P4RecordSet r = p4.Run("sync", "//depot/...");
+    /// Console.WriteLine("{0} info messages suppressed", r.GetSuppressedMessageCount(P4MessageSeverity.Info));
+    /// </code>
+    /// </example>
+    public class P4MessageFilter
+    {
+        private P4MessageSeverity _minimumSeverity = P4MessageSeverity.Empty;
+        private List<int> _allowedIds = new List<int>();
+        private List<int> _deniedIds = new List<int>();
+        private List<int> _allowedSubsystems = new List<int>();
+        private List<int> _deniedSubsystems = new List<int>();
+
+        /// <summary>
+        /// Initializes a new instance of the <see cref="P4MessageFilter"/> class that lets every message through.
+        /// </summary>
+        public P4MessageFilter()
+        {
+        }
+
+        /// <summary>
+        /// Initializes a new instance of the <see cref="P4MessageFilter"/> class.
+        /// </summary>
+        /// <param name="minimumSeverity">Messages below this severity are suppressed.</param>
+        public P4MessageFilter(P4MessageSeverity minimumSeverity)
+        {
+            _minimumSeverity = minimumSeverity;
+        }
+
+        /// <summary>
+        /// Gets/Sets the lowest severity that is passed on.
+        /// </summary>
+        public P4MessageSeverity MinimumSeverity
+        {
+            get
+            {
+                return _minimumSeverity;
+            }
+            set
+            {
+                _minimumSeverity = value;
+            }
+        }
+
+        /// <summary>
+        /// Gets the message ids that are always kept.
+        /// </summary>
+        public IList<int> AllowedIds
+        {
+            get
+            {
+                return _allowedIds;
+            }
+        }
+
+        /// <summary>
+        /// Gets the message ids that are always suppressed.
+        /// </summary>
+        public IList<int> DeniedIds
+        {
+            get
+            {
+                return _deniedIds;
+            }
+        }
+
+        /// <summary>
+        /// Gets the subsystems whose messages are always kept.
+        /// </summary>
+        public IList<int> AllowedSubsystems
+        {
+            get
+            {
+                return _allowedSubsystems;
+            }
+        }
+
+        /// <summary>
+        /// Gets the subsystems whose messages are always suppressed.
+        /// </summary>
+        public IList<int> DeniedSubsystems
+        {
+            get
+            {
+                return _deniedSubsystems;
+            }
+        }
+
+        internal p4dn.MessageFilter CreateNativeFilter()
+        {
+            p4dn.MessageFilter filter = new p4dn.MessageFilter();
+            filter.SetMinimumSeverity((int)_minimumSeverity);
+            foreach (int id in _allowedIds) filter.AllowId(id & 0xffff);
+            foreach (int id in _deniedIds) filter.DenyId(id & 0xffff);
+            foreach (int subsystem in _allowedSubsystems) filter.AllowSubsystem(subsystem);
+            foreach (int subsystem in _deniedSubsystems) filter.DenySubsystem(subsystem);
+            return filter;
+        }
+    }
+}
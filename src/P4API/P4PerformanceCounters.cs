@@ -0,0 +1,405 @@
+/*
+ * P4.Net *
+Copyright (c) 2007-2010 Shawn Hladky
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+and associated documentation files (the "Software"), to deal in the Software without 
+restriction, including without limitation the rights to use, copy, modify, merge, publish, 
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or 
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+ */
+
+
+using System;
+using System.Collections.Generic;
+using System.Globalization;
+using System.IO;
+
+namespace P4API
+{
+    /// <summary>
+    /// Aggregated performance counters for one Perforce command name.
+    /// </summary>
+    /// <remarks>Instances returned from <see cref="P4PerformanceCounters"/> are snapshots and do not change.</remarks>
+    public class P4CommandMetrics
+    {
+        private string _command;
+        private long _count;
+        private long _cancelled;
+        private long _timedOut;
+        private long _records;
+        private long _messages;
+        private long _textBytes;
+        private long _binaryBytes;
+        private long _allocatedBytes;
+        private P4Histogram _wallTime = new P4Histogram();
+        private P4Histogram _timeToFirstByte = new P4Histogram();
+        private P4Histogram _managedCallbackTime = new P4Histogram();
+
+        internal P4CommandMetrics(string command)
+        {
+            _command = command;
+        }
+
+        internal void Add(P4CommandStatistics stats)
+        {
+            _count++;
+            if (stats.Status == P4CommandStatus.Cancelled) _cancelled++;
+            if (stats.Status == P4CommandStatus.TimedOut) _timedOut++;
+            _records += stats.Records;
+            _messages += stats.Messages;
+            _textBytes += stats.TextBytes;
+            _binaryBytes += stats.BinaryBytes;
+            _allocatedBytes += stats.AllocatedBytes;
+            _wallTime.Record(ToMicroseconds(stats.WallTime));
+            _timeToFirstByte.Record(ToMicroseconds(stats.TimeToFirstByte));
+            _managedCallbackTime.Record(ToMicroseconds(stats.ManagedCallbackTime));
+        }
+
+        internal P4CommandMetrics Clone()
+        {
+            P4CommandMetrics ret = (P4CommandMetrics)MemberwiseClone();
+            ret._wallTime = _wallTime.Clone();
+            ret._timeToFirstByte = _timeToFirstByte.Clone();
+            ret._managedCallbackTime = _managedCallbackTime.Clone();
+            return ret;
+        }
+
+        private static long ToMicroseconds(TimeSpan t)
+        {
+            return t.Ticks / (TimeSpan.TicksPerMillisecond / 1000);
+        }
+
+        /// <summary>
+        /// Gets the command name.
+        /// </summary>
+        public string Command
+        {
+            get
+            {
+                return _command;
+            }
+        }
+
+        /// <summary>
+        /// Gets the number of times the command was run.
+        /// </summary>
+        public long Count
+        {
+            get
+            {
+                return _count;
+            }
+        }
+
+        /// <summary>
+        /// Gets the number of runs that were cancelled.
+        /// </summary>
+        public long Cancelled
+        {
+            get
+            {
+                return _cancelled;
+            }
+        }
+
+        /// <summary>
+        /// Gets the number of runs that timed out.
+        /// </summary>
+        public long TimedOut
+        {
+            get
+            {
+                return _timedOut;
+            }
+        }
+
+        /// <summary>
+        /// Gets the total number of tagged records returned.
+        /// </summary>
+        public long Records
+        {
+            get
+            {
+                return _records;
+            }
+        }
+
+        /// <summary>
+        /// Gets the total number of messages returned.
+        /// </summary>
+        public long Messages
+        {
+            get
+            {
+                return _messages;
+            }
+        }
+
+        /// <summary>
+        /// Gets the total bytes of text content returned.
+        /// </summary>
+        public long TextBytes
+        {
+            get
+            {
+                return _textBytes;
+            }
+        }
+
+        /// <summary>
+        /// Gets the total bytes of binary content returned.
+        /// </summary>
+        public long BinaryBytes
+        {
+            get
+            {
+                return _binaryBytes;
+            }
+        }
+
+        /// <summary>
+        /// Gets the total approximate managed allocations, in bytes.
+        /// </summary>
+        public long AllocatedBytes
+        {
+            get
+            {
+                return _allocatedBytes;
+            }
+        }
+
+        /// <summary>
+        /// Gets the distribution of wall times, in microseconds.
+        /// </summary>
+        public P4Histogram WallTime
+        {
+            get
+            {
+                return _wallTime;
+            }
+        }
+
+        /// <summary>
+        /// Gets the distribution of times to first byte, in microseconds.
+        /// </summary>
+        public P4Histogram TimeToFirstByte
+        {
+            get
+            {
+                return _timeToFirstByte;
+            }
+        }
+
+        /// <summary>
+        /// Gets the distribution of time spent in managed callbacks, in microseconds.
+        /// </summary>
+        public P4Histogram ManagedCallbackTime
+        {
+            get
+            {
+                return _managedCallbackTime;
+            }
+        }
+    }
+
+    /// <summary>
+    /// Process-wide performance counters, aggregated by command name.
+    /// </summary>
+    /// <remarks>
+    /// Every command run through a <see cref="P4Connection"/> is added here when Enabled is true (the default).
+    /// All members are thread safe.
+    /// </remarks>
+    /// <example>
+    /// Dump the counters for a dashboard:
+    /// <code language="C#">
+    /// using (StreamWriter w = new StreamWriter("p4metrics.json"))
+    /// {
+    ///     P4PerformanceCounters.WriteJson(w);
+    /// }
+    /// </code>
+    /// </example>
+    public static class P4PerformanceCounters
+    {
+        private static object _lock = new object();
+        private static Dictionary<string, P4CommandMetrics> _metrics = new Dictionary<string, P4CommandMetrics>();
+        private static bool _enabled = true;
+        private static DateTime _since = DateTime.UtcNow;
+
+        /// <summary>
+        /// Gets/Sets whether commands are added to the process-wide counters.
+        /// </summary>
+        /// <remarks>Per-command statistics on the recordsets are collected either way.</remarks>
+        public static bool Enabled
+        {
+            get
+            {
+                return _enabled;
+            }
+            set
+            {
+                _enabled = value;
+            }
+        }
+
+        /// <summary>
+        /// Gets the time (UTC) the counters were started or last reset.
+        /// </summary>
+        public static DateTime Since
+        {
+            get
+            {
+                lock (_lock)
+                {
+                    return _since;
+                }
+            }
+        }
+
+        internal static void Record(P4CommandStatistics stats)
+        {
+            if (!_enabled) return;
+
+            lock (_lock)
+            {
+                P4CommandMetrics m;
+                if (!_metrics.TryGetValue(stats.Command, out m))
+                {
+                    m = new P4CommandMetrics(stats.Command);
+                    _metrics.Add(stats.Command, m);
+                }
+                m.Add(stats);
+            }
+        }
+
+        /// <summary>
+        /// Gets a copy of the counters for every command run so far, sorted by command name.
+        /// </summary>
+        /// <returns>Snapshots of the per-command counters.</returns>
+        public static P4CommandMetrics[] GetSnapshot()
+        {
+            List<P4CommandMetrics> ret;
+            lock (_lock)
+            {
+                ret = new List<P4CommandMetrics>(_metrics.Count);
+                foreach (P4CommandMetrics m in _metrics.Values)
+                {
+                    ret.Add(m.Clone());
+                }
+            }
+            ret.Sort(delegate(P4CommandMetrics a, P4CommandMetrics b) { return string.CompareOrdinal(a.Command, b.Command); });
+            return ret.ToArray();
+        }
+
+        /// <summary>
+        /// Gets a copy of the counters for one command.
+        /// </summary>
+        /// <param name="command">The command name.</param>
+        /// <returns>A snapshot of the counters, or null if the command has not been run.</returns>
+        public static P4CommandMetrics GetMetrics(string command)
+        {
+            lock (_lock)
+            {
+                P4CommandMetrics m;
+                if (_metrics.TryGetValue(command, out m))
+                {
+                    return m.Clone();
+                }
+            }
+            return null;
+        }
+
+        /// <summary>
+        /// Clears all counters.
+        /// </summary>
+        public static void Reset()
+        {
+            lock (_lock)
+            {
+                _metrics.Clear();
+                _since = DateTime.UtcNow;
+            }
+        }
+
+        /// <summary>
+        /// Writes a snapshot of the counters as a JSON document.
+        /// </summary>
+        /// <param name="writer">Destination.</param>
+        /// <remarks>Times are in microseconds.  Each command reports count, p50/p90/p99/max of its histograms and the byte/record totals.</remarks>
+        public static void WriteJson(TextWriter writer)
+        {
+            if (writer == null) throw new ArgumentNullException("writer");
+
+            DateTime since = Since;
+            P4CommandMetrics[] snapshot = GetSnapshot();
+            CultureInfo ci = CultureInfo.InvariantCulture;
+
+            writer.Write("{\"since\":\"");
+            writer.Write(since.ToString("o", ci));
+            writer.Write("\",\"taken\":\"");
+            writer.Write(DateTime.UtcNow.ToString("o", ci));
+            writer.Write("\",\"commands\":[");
+            for (int i = 0; i < snapshot.Length; i++)
+            {
+                P4CommandMetrics m = snapshot[i];
+                if (i > 0) writer.Write(',');
+                writer.Write("{\"command\":");
+                WriteJsonString(writer, m.Command);
+                writer.Write(string.Format(ci, ",\"count\":{0},\"cancelled\":{1},\"timedOut\":{2},\"records\":{3},\"messages\":{4},\"textBytes\":{5},\"binaryBytes\":{6},\"allocatedBytes\":{7}",
+                    m.Count, m.Cancelled, m.TimedOut, m.Records, m.Messages, m.TextBytes, m.BinaryBytes, m.AllocatedBytes));
+                writer.Write(",\"wallTime\":");
+                WriteJsonHistogram(writer, m.WallTime);
+                writer.Write(",\"timeToFirstByte\":");
+                WriteJsonHistogram(writer, m.TimeToFirstByte);
+                writer.Write(",\"managedCallbackTime\":");
+                WriteJsonHistogram(writer, m.ManagedCallbackTime);
+                writer.Write('}');
+            }
+            writer.Write("]}");
+            writer.Flush();
+        }
+
+        internal static void WriteJsonHistogram(TextWriter writer, P4Histogram h)
+        {
+            writer.Write(string.Format(CultureInfo.InvariantCulture,
+                "{{\"count\":{0},\"min\":{1},\"mean\":{2:0.#},\"p50\":{3},\"p90\":{4},\"p99\":{5},\"max\":{6}}}",
+                h.Count, h.Min, h.Mean, h.GetPercentile(50), h.GetPercentile(90), h.GetPercentile(99), h.Max));
+        }
+
+        internal static void WriteJsonString(TextWriter writer, string s)
+        {
+            writer.Write('"');
+            foreach (char c in s)
+            {
+                switch (c)
+                {
+                    case '"': writer.Write("\\\""); break;
+                    case '\\': writer.Write("\\\\"); break;
+                    case '\n': writer.Write("\\n"); break;
+                    case '\r': writer.Write("\\r"); break;
+                    case '\t': writer.Write("\\t"); break;
+                    default:
+                        if (c < ' ')
+                        {
+                            writer.Write(string.Format(CultureInfo.InvariantCulture, "\\u{0:x4}", (int)c));
+                        }
+                        else
+                        {
+                            writer.Write(c);
+                        }
+                        break;
+                }
+            }
+            writer.Write('"');
+        }
+    }
+}
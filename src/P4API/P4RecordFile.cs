@@ -0,0 +1,366 @@
+/*
+ * P4.Net *
+Copyright (c) 2007-2010 Shawn Hladky
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+and associated documentation files (the "Software"), to deal in the Software without 
+restriction, including without limitation the rights to use, copy, modify, merge, publish, 
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or 
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+ */
+
+
+using System;
+using System.Collections;
+using System.Collections.Generic;
+using System.IO;
+using System.IO.Compression;
+using System.Text;
+#if CLR4
+using System.IO.MemoryMappedFiles;
+#endif
+
+namespace P4API
+{
+    /// <summary>
+    /// Reads tagged results written by <see cref="P4Connection.RunToFile"/>, one record at a time.
+    /// </summary>
+    /// <remarks>
+    /// <para>Only the footer is read on opening, and only the block holding a requested record is mapped (read through
+    /// a file stream in the .NET 2.0 build) and decoded, so opening even a very large result is cheap and needs little
+    /// address space, even in a 32-bit process.  The file is opened for shared
+    /// reading: any number of readers, in any number of processes, may have it open.  All members are thread
+    /// safe.</para>
+    /// <para>Layout (integers little-endian; a varint is 7 bits a byte, low first, high bit set on all but the last):</para>
+    /// <list>
+    /// <li>Header: "P4RECS", a version byte (1), a codec byte (0 none, 1 deflate).</li>
+    /// <li>Blocks: stored length (int32), raw length (int32), record count (int32), then the stored bytes.
+    /// Each record in a raw block is a varint field count followed by a key ref and a value ref per field.  A ref is
+    /// a varint v: even refers to string table entry v/2, odd is followed by v/2 bytes of the string itself.</li>
+    /// <li>Footer: string count (int32), string table length (int32), then the table, a run of varint length and bytes;
+    /// block count (int32), then the offset (int64) and first record number (int64) of each block; record count
+    /// (int64).</li>
+    /// <li>Trailer: footer offset (int64), code page of the strings (int32), "P4RE".</li>
+    /// </list>
+    /// <para>Keys and short values go in the string table, so repeated values are stored once.</para>
+    /// </remarks>
+    public class P4RecordFile : IEnumerable, IDisposable
+    {
+        internal static readonly byte[] Magic = Encoding.ASCII.GetBytes("P4RECS");
+        internal static readonly byte[] TrailerMagic = Encoding.ASCII.GetBytes("P4RE");
+        private const int TrailerLength = 16;
+
+        private sealed class Block
+        {
+            public int Index;
+            public byte[] Data;
+            public int[] Offsets;
+        }
+
+        private readonly object _lock = new object();
+        private FileStream _file;
+#if CLR4
+        private MemoryMappedFile _map;
+#endif
+        private readonly long _length;
+        private readonly byte _codec;
+        private readonly Encoding _encoding;
+        private readonly string[] _strings;
+        private readonly long[] _blockOffsets;
+        private readonly long[] _blockFirst;
+        private readonly int _count;
+        private Block _last = null;
+
+        /// <summary>
+        /// Opens a record file for reading.
+        /// </summary>
+        /// <param name="path">The file written by <see cref="P4Connection.RunToFile"/>.</param>
+        /// <exception cref="InvalidDataException">The file isn't a complete record file.</exception>
+        public P4RecordFile(string path)
+        {
+            _file = new FileStream(path, FileMode.Open, FileAccess.Read, FileShare.Read);
+            try
+            {
+                _length = _file.Length;
+                if (_length < Magic.Length + 2 + TrailerLength) throw new InvalidDataException("Not a P4RecordFile: " + path);
+#if CLR4
+                _map = MemoryMappedFile.CreateFromFile(_file, null, 0, MemoryMappedFileAccess.Read, null,
+                    HandleInheritability.None, true);
+#endif
+                byte[] header = ReadBytes(0, Magic.Length + 2);
+                byte[] trailer = ReadBytes(_length - TrailerLength, TrailerLength);
+                if (!StartsWith(header, 0, Magic) || !StartsWith(trailer, 12, TrailerMagic))
+                {
+                    throw new InvalidDataException("Not a complete P4RecordFile: " + path);
+                }
+                if (header[Magic.Length] != P4RecordFileWriter.FormatVersion)
+                {
+                    throw new InvalidDataException("Unsupported P4RecordFile version " + header[Magic.Length] + ": " + path);
+                }
+                _codec = header[Magic.Length + 1];
+
+                long footer = BitConverter.ToInt64(trailer, 0);
+                _encoding = Encoding.GetEncoding(BitConverter.ToInt32(trailer, 8));
+
+                BinaryReader r = new BinaryReader(new MemoryStream(ReadBytes(footer, (int)(_length - TrailerLength - footer))));
+                int stringCount = r.ReadInt32();
+                byte[] table = r.ReadBytes(r.ReadInt32());
+                _strings = new string[stringCount];
+                int pos = 0;
+                for (int i = 0; i < stringCount; i++)
+                {
+                    int len = ReadVarint(table, ref pos);
+                    _strings[i] = _encoding.GetString(table, pos, len);
+                    pos += len;
+                }
+
+                int blocks = r.ReadInt32();
+                _blockOffsets = new long[blocks];
+                _blockFirst = new long[blocks];
+                for (int i = 0; i < blocks; i++)
+                {
+                    _blockOffsets[i] = r.ReadInt64();
+                    _blockFirst[i] = r.ReadInt64();
+                }
+
+                long count = r.ReadInt64();
+                if (count > int.MaxValue) throw new InvalidDataException("Too many records: " + path);
+                _count = (int)count;
+            }
+            catch
+            {
+                Dispose();
+                throw;
+            }
+        }
+
+        #region Public Properties
+        /// <summary>
+        /// Gets the number of records in the file.
+        /// </summary>
+        public int Count
+        {
+            get { return _count; }
+        }
+
+        /// <summary>
+        /// Gets whether the blocks are deflate-compressed.
+        /// </summary>
+        public bool IsCompressed
+        {
+            get { return _codec == P4RecordFileWriter.CodecDeflate; }
+        }
+
+        /// <summary>
+        /// Gets the encoding the server's strings were written in.
+        /// </summary>
+        public Encoding Encoding
+        {
+            get { return _encoding; }
+        }
+
+        /// <summary>
+        /// Gets the record at the specified index.
+        /// </summary>
+        /// <param name="index">Index of the record to get.</param>
+        /// <value>A new P4Record, decoded from the file.</value>
+        public P4Record this[int index]
+        {
+            get
+            {
+                if (index < 0 || index >= _count) throw new IndexOutOfRangeException();
+
+                // last block whose first record is at or before index
+                int bi = Array.BinarySearch(_blockFirst, (long)index);
+                if (bi < 0) bi = ~bi - 1;
+
+                Block b = GetBlock(bi);
+                int pos = b.Offsets[index - (int)_blockFirst[bi]];
+                return ReadRecord(b.Data, ref pos);
+            }
+        }
+        #endregion
+
+        #region Public Methods
+        /// <summary>
+        /// Closes the file.
+        /// </summary>
+        public void Dispose()
+        {
+            lock (_lock)
+            {
+#if CLR4
+                if (_map != null) _map.Dispose();
+                _map = null;
+#endif
+                if (_file != null) _file.Dispose();
+                _file = null;
+                _last = null;
+            }
+        }
+
+        /// <summary>
+        /// Returns an enumerator that decodes the records in order.
+        /// </summary>
+        /// <returns>An enumerator of P4Records.</returns>
+        public IEnumerator GetEnumerator()
+        {
+            for (int i = 0; i < _count; i++)
+            {
+                yield return this[i];
+            }
+        }
+        #endregion
+
+        #region Private Helper Methods
+        private Block GetBlock(int index)
+        {
+            lock (_lock)
+            {
+                if (_last != null && _last.Index == index) return _last;
+            }
+
+            long offset = _blockOffsets[index];
+            byte[] head = ReadBytes(offset, 12);
+            int storedLength = BitConverter.ToInt32(head, 0);
+            int rawLength = BitConverter.ToInt32(head, 4);
+            int records = BitConverter.ToInt32(head, 8);
+            byte[] stored = ReadBytes(offset + 12, storedLength);
+
+            byte[] data = stored;
+            if (_codec == P4RecordFileWriter.CodecDeflate)
+            {
+                data = new byte[rawLength];
+                using (DeflateStream z = new DeflateStream(new MemoryStream(stored), CompressionMode.Decompress))
+                {
+                    int read = 0;
+                    while (read < rawLength)
+                    {
+                        int n = z.Read(data, read, rawLength - read);
+                        if (n <= 0) throw new InvalidDataException("Truncated P4RecordFile block.");
+                        read += n;
+                    }
+                }
+            }
+
+            // walk the block once to find where each record starts
+            Block b = new Block();
+            b.Index = index;
+            b.Data = data;
+            b.Offsets = new int[records];
+            int pos = 0;
+            for (int i = 0; i < records; i++)
+            {
+                b.Offsets[i] = pos;
+                int refs = ReadVarint(data, ref pos) * 2;
+                for (int j = 0; j < refs; j++)
+                {
+                    SkipRef(data, ref pos);
+                }
+            }
+
+            lock (_lock)
+            {
+                _last = b;
+            }
+            return b;
+        }
+
+        private P4Record ReadRecord(byte[] data, ref int pos)
+        {
+            int fields = ReadVarint(data, ref pos);
+            Dictionary<string, string> sd = new Dictionary<string, string>(fields);
+            for (int i = 0; i < fields; i++)
+            {
+                string key = ReadString(data, ref pos);
+                sd[key] = ReadString(data, ref pos);
+            }
+            return new P4Record(sd);
+        }
+
+        private string ReadString(byte[] data, ref int pos)
+        {
+            int v = ReadVarint(data, ref pos);
+            if ((v & 1) == 0) return _strings[v >> 1];
+            int len = v >> 1;
+            string s = _encoding.GetString(data, pos, len);
+            pos += len;
+            return s;
+        }
+
+        // Also used by P4DepotPathTrie, which gets blocks straight from p4dn's RecordWriter.
+        internal static int ReadVarint(byte[] data, ref int pos)
+        {
+            int value = 0;
+            int shift = 0;
+            byte b;
+            do
+            {
+                b = data[pos++];
+                value |= (b & 0x7F) << shift;
+                shift += 7;
+            }
+            while ((b & 0x80) != 0);
+            return value;
+        }
+
+        internal static void SkipRef(byte[] data, ref int pos)
+        {
+            int v = ReadVarint(data, ref pos);
+            if ((v & 1) != 0) pos += v >> 1;
+        }
+
+        private static bool StartsWith(byte[] data, int offset, byte[] prefix)
+        {
+            for (int i = 0; i < prefix.Length; i++)
+            {
+                if (data[offset + i] != prefix[i]) return false;
+            }
+            return true;
+        }
+
+#if CLR4
+        // A view just over the bytes asked for (a block, or the footer), not the whole file.
+        private byte[] ReadBytes(long offset, int count)
+        {
+            MemoryMappedFile map = _map;
+            if (map == null) throw new ObjectDisposedException("P4RecordFile");
+            byte[] ret = new byte[count];
+            if (count == 0) return ret;
+            using (MemoryMappedViewAccessor view = map.CreateViewAccessor(offset, count, MemoryMappedFileAccess.Read))
+            {
+                view.ReadArray<byte>(0, ret, 0, count);
+            }
+            return ret;
+        }
+#else
+        private byte[] ReadBytes(long offset, int count)
+        {
+            lock (_lock)
+            {
+                if (_file == null) throw new ObjectDisposedException("P4RecordFile");
+                byte[] ret = new byte[count];
+                _file.Position = offset;
+                int read = 0;
+                while (read < count)
+                {
+                    int n = _file.Read(ret, read, count - read);
+                    if (n <= 0) throw new InvalidDataException("Truncated P4RecordFile.");
+                    read += n;
+                }
+                return ret;
+            }
+        }
+#endif
+        #endregion
+    }
+}
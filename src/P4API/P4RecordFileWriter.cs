@@ -0,0 +1,138 @@
+/*
+ * P4.Net *
+Copyright (c) 2007-2010 Shawn Hladky
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+and associated documentation files (the "Software"), to deal in the Software without 
+restriction, including without limitation the rights to use, copy, modify, merge, publish, 
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or 
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+ */
+
+
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.IO.Compression;
+
+namespace P4API
+{
+    // Writes the blocks p4dn's RecordWriter encodes into a P4RecordFile; see P4RecordFile for the layout.
+    internal sealed class P4RecordFileWriter : p4dn.RecordSink, IDisposable
+    {
+        internal const byte FormatVersion = 1;
+        internal const byte CodecNone = 0;
+        internal const byte CodecDeflate = 1;
+
+        private readonly string _path;
+        private FileStream _file;
+        private BinaryWriter _writer;
+        private readonly bool _compress;
+        private readonly List<long> _blockOffsets = new List<long>();
+        private readonly List<long> _blockFirst = new List<long>();
+        private long _records = 0;
+        private byte[] _strings = new byte[0];
+        private int _stringCount = 0;
+        private Exception _error = null;
+
+        internal P4RecordFileWriter(string path, bool compress)
+        {
+            _compress = compress;
+            _path = path;
+            _file = new FileStream(path, FileMode.Create, FileAccess.Write, FileShare.None, 65536);
+            _writer = new BinaryWriter(_file);
+            _writer.Write(P4RecordFile.Magic);
+            _writer.Write(FormatVersion);
+            _writer.Write(compress ? CodecDeflate : CodecNone);
+        }
+
+        // Called from inside the running command, so errors are kept for Close rather than thrown.
+        public override void WriteBlock(byte[] data, int length, int count)
+        {
+            if (_error != null) return;
+            try
+            {
+                byte[] stored = data;
+                int storedLength = length;
+                if (_compress)
+                {
+                    MemoryStream ms = new MemoryStream(length / 2);
+                    using (DeflateStream z = new DeflateStream(ms, CompressionMode.Compress, true))
+                    {
+                        z.Write(data, 0, length);
+                    }
+                    stored = ms.GetBuffer();
+                    storedLength = (int)ms.Length;
+                }
+
+                _blockOffsets.Add(_file.Position);
+                _blockFirst.Add(_records);
+                _writer.Write(storedLength);
+                _writer.Write(length);
+                _writer.Write(count);
+                _writer.Write(stored, 0, storedLength);
+                _records += count;
+            }
+            catch (Exception e)
+            {
+                _error = e;
+            }
+        }
+
+        public override void WriteStrings(byte[] data, int length, int count)
+        {
+            _strings = new byte[length];
+            Buffer.BlockCopy(data, 0, _strings, 0, length);
+            _stringCount = count;
+        }
+
+        // Writes the footer and closes the file.  Returns the number of records.
+        internal long Close(int codePage)
+        {
+            if (_error != null) throw _error;
+
+            long footer = _file.Position;
+            _writer.Write(_stringCount);
+            _writer.Write(_strings.Length);
+            _writer.Write(_strings);
+            _writer.Write(_blockOffsets.Count);
+            for (int i = 0; i < _blockOffsets.Count; i++)
+            {
+                _writer.Write(_blockOffsets[i]);
+                _writer.Write(_blockFirst[i]);
+            }
+            _writer.Write(_records);
+
+            _writer.Write(footer);
+            _writer.Write(codePage);
+            _writer.Write(P4RecordFile.TrailerMagic);
+            Dispose();
+            return _records;
+        }
+
+        // Closes and deletes a file that didn't get all the command's records.
+        internal void Abandon()
+        {
+            Dispose();
+            File.Delete(_path);
+        }
+
+        public void Dispose()
+        {
+            if (_file == null) return;
+            _writer.Flush();
+            _file.Dispose();
+            _file = null;
+            _writer = null;
+        }
+    }
+}
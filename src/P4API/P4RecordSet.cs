@@ -1,98 +1,215 @@
-/*
- * P4.Net *
-Copyright (c) 2007-2010 Shawn Hladky
-
-Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
-and associated documentation files (the "Software"), to deal in the Software without 
-restriction, including without limitation the rights to use, copy, modify, merge, publish, 
-distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
-Software is furnished to do so, subject to the following conditions:
-
-The above copyright notice and this permission notice shall be included in all copies or 
-substantial portions of the Software.
-
-THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
-BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
-NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
-DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
-OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
- */
-
-
-using System;
-using System.Collections;
-using System.Text;
-
-namespace P4API
-{
-    /// <summary>
-    /// Provides output of a Perforce Command in "tagged" moded.
-    /// </summary>
-    /// <remarks>
-    /// P4Recordset is an enumerable collection of P4Records that supply keyed access to 
-    /// information returned from Perforce.
-    /// </remarks>
-    public class P4RecordSet : P4BaseRecordSet, IEnumerable
-    {
-        internal P4RecordSet() { }
-        private P4Record[] m_results;
-        private P4Record[] _Results
-        {
-            get
-            {
-                if (m_results == null)
-                {
-                    m_results = TaggedOutputs.ToArray();
-                }
-                return m_results;
-            }
-        }
-
-        /// <summary>
-        /// Gets an array of records returned from the Perforce command.
-        /// </summary>
-        /// <value>Array of P4Records.</value>
-        public P4Record[] Records
-        {
-            get
-            {
-                return (P4Record[])_Results.Clone();
-            }
-        }
-
-        /// <summary>
-        /// Gets an array of string messages returned from the Perforce command.
-        /// </summary>
-        /// <value>Array of informational messages returned from a Perforce command.</value>
-        public new string[] Messages
-        {
-            get
-            {
-                return (base.StringOutputs.ToArray());
-            }
-        }
-
-        /// <summary>
-        /// Gets the record at the specified index.
-        /// </summary>
-        /// <param name="Index">Index of the record to get.</param>
-        /// <returns>P4Record</returns>
-        /// <value>Returns the record at 'Index'.</value>
-        public P4Record this[int Index] //Indexer
-        {
-            get
-            {
-                return _Results[Index];
-            }
-        }
-
-        #region IEnumerable Members
-
-        IEnumerator IEnumerable.GetEnumerator()
-        {
-            return _Results.GetEnumerator();
-        }
-
-        #endregion
-    }
-}
+/*
+ * P4.Net *
+Copyright (c) 2007-2010 Shawn Hladky
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+and associated documentation files (the "Software"), to deal in the Software without 
+restriction, including without limitation the rights to use, copy, modify, merge, publish, 
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or 
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+ */
+
+
+using System;
+using System.Collections;
+using System.Collections.Generic;
+using System.Text;
+
+namespace P4API
+{
+    /// <summary>
+    /// Provides output of a Perforce Command in "tagged" moded.
+    /// </summary>
+    /// <remarks>
+    /// P4Recordset is an enumerable collection of P4Records that supply keyed access to 
+    /// information returned from Perforce.
+    /// <para>When <see cref="P4Connection.RecordSetMemoryBudget"/> is set and the records grow past it, they are moved
+    /// to a temp file and read back one at a time by the indexer and the enumerator (see <see cref="IsSpilled"/>).
+    /// Dispose the recordset to remove the file early; otherwise it goes when the recordset is collected.</para>
+    /// </remarks>
+    public class P4RecordSet : P4BaseRecordSet, IEnumerable, IDisposable
+    {
+        internal P4RecordSet() { }
+        private P4Record[] m_results;
+        private long _spillThreshold = 0;
+        private long _recordBytes = 0;
+        private P4RecordSpill _spill = null;
+
+        private P4Record[] _Results
+        {
+            get
+            {
+                if (m_results == null)
+                {
+                    if (_spill != null)
+                    {
+                        // not cached: holding them all is what spilling avoids
+                        P4Record[] ret = new P4Record[_spill.Count];
+                        for (int i = 0; i < ret.Length; i++)
+                        {
+                            ret[i] = _spill.Read(i);
+                        }
+                        return ret;
+                    }
+                    m_results = TaggedOutputs.ToArray();
+                }
+                return m_results;
+            }
+        }
+
+        /// <summary>
+        /// Gets an array of records returned from the Perforce command.
+        /// </summary>
+        /// <remarks>For a spilled recordset this reads every record back into memory; use the indexer or
+        /// foreach instead.</remarks>
+        /// <value>Array of P4Records.</value>
+        public P4Record[] Records
+        {
+            get
+            {
+                return (_spill != null) ? _Results : (P4Record[])_Results.Clone();
+            }
+        }
+
+        /// <summary>
+        /// Gets the number of records returned from the Perforce command.
+        /// </summary>
+        /// <value>The record count.</value>
+        public int Count
+        {
+            get
+            {
+                return (_spill != null) ? _spill.Count : TaggedOutputs.Count;
+            }
+        }
+
+        /// <summary>
+        /// Gets whether the records went over the connection's memory budget and are kept in a temp file.
+        /// </summary>
+        /// <remarks>A spilled recordset returns a new P4Record each time a record is read.</remarks>
+        /// <value>True if the records are on disk.</value>
+        public bool IsSpilled
+        {
+            get
+            {
+                return _spill != null;
+            }
+        }
+
+        internal override bool HasSpilledRecords
+        {
+            get
+            {
+                return _spill != null;
+            }
+        }
+
+        internal long SpillThreshold
+        {
+            get
+            {
+                return _spillThreshold;
+            }
+            set
+            {
+                _spillThreshold = value;
+            }
+        }
+
+        internal override void AddRecord(P4Record r)
+        {
+            if (_spill != null)
+            {
+                _spill.Add(r);
+                return;
+            }
+
+            base.AddRecord(r);
+            if (_spillThreshold <= 0) return;
+
+            _recordBytes += r.EstimateSize();
+            if (_recordBytes > _spillThreshold)
+            {
+                // over budget: move what's been collected so far, and everything after it, to disk
+                _spill = new P4RecordSpill();
+                foreach (P4Record t in TaggedOutputs)
+                {
+                    _spill.Add(t);
+                }
+                TaggedOutputs.Clear();
+                TaggedOutputs.TrimExcess();
+                m_results = null;
+            }
+        }
+
+        /// <summary>
+        /// Removes the temp file of a spilled recordset.  Records can't be read afterwards.
+        /// </summary>
+        public void Dispose()
+        {
+            if (_spill != null) _spill.Dispose();
+        }
+
+        /// <summary>
+        /// Gets an array of string messages returned from the Perforce command.
+        /// </summary>
+        /// <value>Array of informational messages returned from a Perforce command.</value>
+        public new string[] Messages
+        {
+            get
+            {
+                return (base.StringOutputs.ToArray());
+            }
+        }
+
+        /// <summary>
+        /// Gets the record at the specified index.
+        /// </summary>
+        /// <param name="Index">Index of the record to get.</param>
+        /// <returns>P4Record</returns>
+        /// <value>Returns the record at 'Index'.</value>
+        public P4Record this[int Index] //Indexer
+        {
+            get
+            {
+                return (_spill != null) ? _spill.Read(Index) : _Results[Index];
+            }
+        }
+
+        internal override void MakeReadOnly()
+        {
+            foreach (P4Record r in TaggedOutputs)
+            {
+                r.MakeReadOnly();
+            }
+            if (_spill != null) _spill.MakeReadOnly();
+            base.MakeReadOnly();
+        }
+
+        #region IEnumerable Members
+
+        IEnumerator IEnumerable.GetEnumerator()
+        {
+            return (_spill != null) ? ReadSpilled() : _Results.GetEnumerator();
+        }
+
+        private IEnumerator ReadSpilled()
+        {
+            for (int i = 0; i < _spill.Count; i++)
+            {
+                yield return _spill.Read(i);
+            }
+        }
+
+        #endregion
+    }
+}
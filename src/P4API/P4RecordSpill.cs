@@ -0,0 +1,233 @@
+/*
+ * P4.Net *
+Copyright (c) 2007-2010 Shawn Hladky
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+and associated documentation files (the "Software"), to deal in the Software without 
+restriction, including without limitation the rights to use, copy, modify, merge, publish, 
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or 
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+ */
+
+
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Text;
+#if CLR4
+using System.IO.MemoryMappedFiles;
+#endif
+
+namespace P4API
+{
+    // Records of a P4RecordSet that went over its memory budget, kept in a temp file.
+    //
+    // Each record is its raw fields: a count, then for each field a key reference and the value (which may be null,
+    // stored as P4SnapshotCache stores it).  Keys repeat in
+    // every record, so each distinct key is written once and referred to by number after that; the key table and
+    // the offset of each record stay in memory.  The file is opened delete-on-close, so it goes away with the
+    // handle even if the recordset is never disposed.
+    //
+    // Reads go through a bounded view, so a spill of any size fits a 32-bit process.  The mapping runs a chunk
+    // past the records written so far (which grows the file), so reading while records are still being added
+    // only maps again once per chunk.
+    internal sealed class P4RecordSpill : IDisposable
+    {
+#if CLR4
+        private const long MapChunk = 16L * 1024 * 1024;
+        private const long ViewSize = 4L * 1024 * 1024;
+#endif
+
+        private readonly object _lock = new object();
+        private FileStream _file;
+        private BinaryWriter _writer;
+        private long _length = 0;
+#if CLR4
+        private MemoryMappedFile _map = null;
+        private long _mappedLength = 0;
+        private MemoryMappedViewStream _view = null;
+        private long _viewOffset = 0;
+        private long _viewLength = 0;
+#endif
+        private readonly List<long> _offsets = new List<long>();
+        private readonly List<string> _keys = new List<string>();
+        private readonly Dictionary<string, int> _keyIds = new Dictionary<string, int>();
+        private bool _readOnly = false;
+
+        internal P4RecordSpill()
+        {
+            string path = Path.Combine(Path.GetTempPath(), "p4spill-" + Guid.NewGuid().ToString("N") + ".tmp");
+            _file = new FileStream(path, FileMode.CreateNew, FileAccess.ReadWrite, FileShare.None, 65536, FileOptions.DeleteOnClose);
+            _writer = new BinaryWriter(_file, Encoding.UTF8);
+        }
+
+        internal int Count
+        {
+            get
+            {
+                lock (_lock)
+                {
+                    return _offsets.Count;
+                }
+            }
+        }
+
+        internal void MakeReadOnly()
+        {
+            _readOnly = true;
+        }
+
+        internal void Add(P4Record record)
+        {
+            lock (_lock)
+            {
+                CheckOpen();
+                // reads move the position in the .NET 2.0 build, and the mapping makes the file longer than the records
+                _offsets.Add(_file.Seek(_length, SeekOrigin.Begin));
+                Dictionary<string, string> fields = record.RawFields;
+                WriteCount(fields.Count);
+                foreach (KeyValuePair<string, string> f in fields)
+                {
+                    int id;
+                    if (_keyIds.TryGetValue(f.Key, out id))
+                    {
+                        WriteCount(id + 1);
+                    }
+                    else
+                    {
+                        // 0 introduces a new key
+                        WriteCount(0);
+                        _writer.Write(f.Key);
+                        _keyIds.Add(f.Key, _keys.Count);
+                        _keys.Add(f.Key);
+                    }
+                    P4SnapshotCache.WriteNullable(_writer, f.Value);
+                }
+                _length = _file.Position;
+            }
+        }
+
+        internal P4Record Read(int index)
+        {
+            lock (_lock)
+            {
+                CheckOpen();
+                if (index < 0 || index >= _offsets.Count) throw new IndexOutOfRangeException();
+
+                long end = (index + 1 < _offsets.Count) ? _offsets[index + 1] : _length;
+                Stream s = GetReader(_offsets[index], end - _offsets[index]);
+                BinaryReader r = new BinaryReader(s, Encoding.UTF8);
+                int count = ReadCount(r);
+                Dictionary<string, string> fields = new Dictionary<string, string>(count);
+                for (int i = 0; i < count; i++)
+                {
+                    int id = ReadCount(r);
+                    // share the key table's strings rather than a copy per record
+                    string key = (id == 0) ? _keys[_keyIds[r.ReadString()]] : _keys[id - 1];
+                    fields.Add(key, P4SnapshotCache.ReadNullable(r));
+                }
+
+                P4Record ret = new P4Record(fields);
+                if (_readOnly) ret.MakeReadOnly();
+                return ret;
+            }
+        }
+
+        public void Dispose()
+        {
+            lock (_lock)
+            {
+                if (_file == null) return;
+#if CLR4
+                Unmap();
+#endif
+                // closing the last handle deletes the file
+                _file.Dispose();
+                _file = null;
+                _writer = null;
+            }
+        }
+
+        private void CheckOpen()
+        {
+            if (_file == null) throw new ObjectDisposedException("P4RecordSet");
+        }
+
+        // BinaryWriter's 7-bit encoding is protected, so it's repeated here.
+        private void WriteCount(int value)
+        {
+            uint v = (uint)value;
+            while (v >= 0x80)
+            {
+                _writer.Write((byte)(v | 0x80));
+                v >>= 7;
+            }
+            _writer.Write((byte)v);
+        }
+
+        private static int ReadCount(BinaryReader r)
+        {
+            int value = 0;
+            int shift = 0;
+            byte b;
+            do
+            {
+                b = r.ReadByte();
+                value |= (b & 0x7F) << shift;
+                shift += 7;
+            }
+            while ((b & 0x80) != 0);
+            return value;
+        }
+
+#if CLR4
+        // A stream positioned at offset, over at least length bytes.
+        private Stream GetReader(long offset, long length)
+        {
+            _writer.Flush();
+            long end = offset + length;
+            if (end > _mappedLength)
+            {
+                Unmap();
+                _mappedLength = _length + MapChunk;
+                _map = MemoryMappedFile.CreateFromFile(_file, null, _mappedLength, MemoryMappedFileAccess.ReadWrite, null,
+                    HandleInheritability.None, true);
+            }
+            if (_view == null || offset < _viewOffset || end > _viewOffset + _viewLength)
+            {
+                if (_view != null) _view.Dispose();
+                _viewOffset = offset;
+                _viewLength = Math.Min(Math.Max(length, ViewSize), _mappedLength - offset);
+                _view = _map.CreateViewStream(_viewOffset, _viewLength, MemoryMappedFileAccess.Read);
+            }
+            _view.Position = offset - _viewOffset;
+            return _view;
+        }
+
+        private void Unmap()
+        {
+            if (_view != null) _view.Dispose();
+            if (_map != null) _map.Dispose();
+            _view = null;
+            _map = null;
+        }
+#else
+        private Stream GetReader(long offset, long length)
+        {
+            // one stream for both; Add seeks back to the end of the records
+            _writer.Flush();
+            _file.Position = offset;
+            return _file;
+        }
+#endif
+    }
+}
@@ -0,0 +1,466 @@
+/*
+ * P4.Net *
+Copyright (c) 2007-2010 Shawn Hladky
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+and associated documentation files (the "Software"), to deal in the Software without 
+restriction, including without limitation the rights to use, copy, modify, merge, publish, 
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or 
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+ */
+
+
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Threading;
+
+namespace P4API
+{
+    /// <summary>
+    /// Sends read-only commands to read replicas and everything else to the primary (commit) server.
+    /// </summary>
+    /// <remarks>
+    /// <para>A command is a read when it is in <see cref="ReadCommands"/> and every file argument is in depot syntax;
+    /// local and client paths depend on the workspace, so those commands go to the primary.</para>
+    /// <para>Each read goes to the healthy replica with the least load (commands in flight, weighted by its average
+    /// command time) whose lag is within <see cref="MaxLag"/>.  Lag is the difference between the primary's and the
+    /// replica's <see cref="LagCounter"/>, checked every <see cref="LagCheckInterval"/>.</para>
+    /// <para>If the read fails on the replica, it is run again on the primary.  A replica that throws is left out
+    /// for <see cref="RetryUnhealthyAfter"/>; one that returns errors (or warnings, when the primary's
+    /// <see cref="P4Connection.ExceptionLevel"/> throws on warnings) just has that command redone on the primary, which
+    /// also decides what to throw.</para>
+    /// <para>The router doesn't own the connections: connect them (with the same user and client) before handing them
+    /// over, and dispose them afterwards.  The router is thread safe; each connection runs one command at a time.</para>
+    /// </remarks>
+    public class P4ReplicaRouter
+    {
+        private sealed class Replica
+        {
+            public P4Connection Connection;
+            public string Port;
+            public bool Healthy = true;
+            public long RetryAt;
+            public long Lag = -1;
+            public double LatencyTicks;
+            public int InFlight;
+            public long Reads;
+            public long Failures;
+        }
+
+        private readonly object _lock = new object();
+        private readonly P4Connection _primary;
+        private readonly object _primaryLock = new object();
+        private readonly Replica[] _replicas;
+        private string[] _readCommands = new string[] { "annotate", "changes", "describe", "dirs", "filelog", "files",
+            "fstat", "print", "sizes" };
+        private long _maxLag = 100;
+        private string _lagCounter = "change";
+        private TimeSpan _lagCheckInterval = TimeSpan.FromSeconds(30);
+        private TimeSpan _retryUnhealthyAfter = TimeSpan.FromSeconds(30);
+        private long _nextLagCheck = 0;
+        private bool _checkingLag = false;
+        private long _primaryCommands;
+
+        /// <summary>
+        /// Initializes a new instance of the <see cref="P4ReplicaRouter"/> class.
+        /// </summary>
+        /// <param name="primary">Connection to the commit (or edge) server that takes writes.</param>
+        /// <param name="replicas">Connections to read-only replicas of it.</param>
+        public P4ReplicaRouter(P4Connection primary, params P4Connection[] replicas)
+        {
+            if (primary == null) throw new ArgumentNullException("primary");
+            if (replicas == null) throw new ArgumentNullException("replicas");
+
+            _primary = primary;
+            _replicas = new Replica[replicas.Length];
+            for (int i = 0; i < replicas.Length; i++)
+            {
+                if (replicas[i] == null) throw new ArgumentNullException("replicas");
+                _replicas[i] = new Replica();
+                _replicas[i].Connection = replicas[i];
+                _replicas[i].Port = replicas[i].Port;
+            }
+        }
+
+        #region Public Properties
+        /// <summary>
+        /// Gets the connection to the primary server.
+        /// </summary>
+        /// <remarks>Don't run commands on it directly while other threads use the router.</remarks>
+        public P4Connection Primary
+        {
+            get
+            {
+                return _primary;
+            }
+        }
+
+        /// <summary>
+        /// Gets/Sets the commands that replicas may answer.
+        /// </summary>
+        /// <value>Defaults to annotate, changes, describe, dirs, filelog, files, fstat, print and sizes.</value>
+        public string[] ReadCommands
+        {
+            get
+            {
+                return (string[])_readCommands.Clone();
+            }
+            set
+            {
+                _readCommands = (value == null) ? new string[0] : (string[])value.Clone();
+            }
+        }
+
+        /// <summary>
+        /// Gets/Sets how far behind the primary (in <see cref="LagCounter"/> units) a replica may be and still take reads.
+        /// </summary>
+        /// <value>Defaults to 100.</value>
+        public long MaxLag
+        {
+            get
+            {
+                return _maxLag;
+            }
+            set
+            {
+                if (value < 0) throw new ArgumentOutOfRangeException("value");
+                _maxLag = value;
+            }
+        }
+
+        /// <summary>
+        /// Gets/Sets the counter compared between the primary and the replicas to measure lag.
+        /// </summary>
+        /// <value>Defaults to "change".</value>
+        public string LagCounter
+        {
+            get
+            {
+                return _lagCounter;
+            }
+            set
+            {
+                if (value == null) throw new ArgumentNullException("value");
+                _lagCounter = value;
+            }
+        }
+
+        /// <summary>
+        /// Gets/Sets how often lag is checked.
+        /// </summary>
+        /// <value>Defaults to 30 seconds.</value>
+        public TimeSpan LagCheckInterval
+        {
+            get
+            {
+                return _lagCheckInterval;
+            }
+            set
+            {
+                _lagCheckInterval = value;
+            }
+        }
+
+        /// <summary>
+        /// Gets/Sets how long a replica that failed is left out before it is tried again.
+        /// </summary>
+        /// <value>Defaults to 30 seconds.</value>
+        public TimeSpan RetryUnhealthyAfter
+        {
+            get
+            {
+                return _retryUnhealthyAfter;
+            }
+            set
+            {
+                _retryUnhealthyAfter = value;
+            }
+        }
+
+        /// <summary>
+        /// Gets the number of commands run on the primary, including reads that fell back to it.
+        /// </summary>
+        public long PrimaryCommands
+        {
+            get
+            {
+                return Interlocked.Read(ref _primaryCommands);
+            }
+        }
+        #endregion
+
+        #region Public Methods
+        /// <summary>
+        /// Checks whether a command would be sent to a replica.
+        /// </summary>
+        /// <param name="command">The command.</param>
+        /// <param name="args">The arguments to the Perforce command.</param>
+        /// <returns>True for reads that don't depend on the workspace.</returns>
+        public bool IsRead(string command, params string[] args)
+        {
+            if (command == null || args == null) return false;
+            if (Array.IndexOf(_readCommands, command) < 0) return false;
+
+            foreach (string arg in args)
+            {
+                if (arg == null) return false;
+                if (arg.StartsWith("-") || arg.StartsWith("//")) continue;
+
+                // counts, change numbers and statuses ("-m 5", "describe 123", "-s submitted") are fine; paths are not
+                if (arg.IndexOfAny(new char[] { '/', '\\', '.', '@', '#', '*' }) >= 0) return false;
+            }
+            return true;
+        }
+
+        /// <summary>
+        /// Executes a Perforce command in tagged mode on a replica or the primary.
+        /// </summary>
+        /// <param name="command">The command.</param>
+        /// <param name="args">The arguments to the Perforce command.</param>
+        /// <returns>A P4Recordset containing the results of the command.</returns>
+        public P4RecordSet Run(string command, params string[] args)
+        {
+            return Route<P4RecordSet>(command, args, delegate(P4Connection c) { return c.Run(command, args); });
+        }
+
+        /// <summary>
+        /// Executes a Perforce command in non-tagged mode on a replica or the primary.
+        /// </summary>
+        /// <param name="command">The command.</param>
+        /// <param name="args">The arguments to the Perforce command.</param>
+        /// <returns>A P4UnParsedRecordSet.</returns>
+        public P4UnParsedRecordSet RunUnParsed(string command, params string[] args)
+        {
+            return Route<P4UnParsedRecordSet>(command, args, delegate(P4Connection c) { return c.RunUnParsed(command, args); });
+        }
+
+        /// <summary>
+        /// Gets the state of each replica.
+        /// </summary>
+        /// <returns>One status per replica, in the order they were given.</returns>
+        public P4ReplicaStatus[] GetReplicaStatus()
+        {
+            lock (_lock)
+            {
+                P4ReplicaStatus[] ret = new P4ReplicaStatus[_replicas.Length];
+                for (int i = 0; i < _replicas.Length; i++)
+                {
+                    Replica r = _replicas[i];
+                    ret[i] = new P4ReplicaStatus(r.Port, r.Healthy, r.Lag,
+                        TimeSpan.FromSeconds(r.LatencyTicks / Stopwatch.Frequency), r.InFlight, r.Reads, r.Failures);
+                }
+                return ret;
+            }
+        }
+
+        /// <summary>
+        /// Checks every replica's lag now, instead of waiting for <see cref="LagCheckInterval"/>.
+        /// </summary>
+        public void CheckLag()
+        {
+            lock (_lock)
+            {
+                if (_checkingLag) return;
+                _checkingLag = true;
+            }
+
+            try
+            {
+                long primary = ReadCounter(_primary, _primaryLock);
+                if (primary < 0) return;
+                foreach (Replica r in _replicas)
+                {
+                    long value = -1;
+                    try
+                    {
+                        value = ReadCounter(r.Connection, r);
+                    }
+                    catch (P4API.Exceptions.P4APIExceptions)
+                    {
+                    }
+
+                    lock (_lock)
+                    {
+                        if (value < 0)
+                        {
+                            MarkUnhealthy(r);
+                        }
+                        else
+                        {
+                            r.Lag = Math.Max(0, primary - value);
+                        }
+                    }
+                }
+            }
+            finally
+            {
+                lock (_lock)
+                {
+                    _checkingLag = false;
+                    _nextLagCheck = Stopwatch.GetTimestamp() + ToTicks(_lagCheckInterval);
+                }
+            }
+        }
+        #endregion
+
+        #region Private Helper Methods
+        private T Route<T>(string command, string[] args, P4ScheduledCommand<T> work) where T : P4BaseRecordSet
+        {
+            if (IsRead(command, args) && _replicas.Length > 0)
+            {
+                bool due;
+                lock (_lock)
+                {
+                    due = !_checkingLag && Stopwatch.GetTimestamp() >= _nextLagCheck;
+                }
+                if (due)
+                {
+                    try
+                    {
+                        CheckLag();
+                    }
+                    catch (P4API.Exceptions.P4APIExceptions)
+                    {
+                        // the primary couldn't say; keep routing on the last known lag
+                    }
+                }
+
+                Replica replica = PickReplica();
+                if (replica != null)
+                {
+                    T result = RunOnReplica(replica, work);
+                    if (result != null) return result;
+                }
+            }
+
+            Interlocked.Increment(ref _primaryCommands);
+            lock (_primaryLock)
+            {
+                return work(_primary);
+            }
+        }
+
+        private Replica PickReplica()
+        {
+            lock (_lock)
+            {
+                long now = Stopwatch.GetTimestamp();
+                Replica best = null;
+                double bestScore = 0;
+                foreach (Replica r in _replicas)
+                {
+                    if (!r.Healthy && now < r.RetryAt) continue;
+                    if (r.Lag > _maxLag) continue;
+
+                    // an idle replica with no history yet scores 0, so every replica gets tried
+                    double score = (r.InFlight + 1) * r.LatencyTicks;
+                    if (best == null || score < bestScore)
+                    {
+                        best = r;
+                        bestScore = score;
+                    }
+                }
+                if (best != null) best.InFlight++;
+                return best;
+            }
+        }
+
+        // Returns null when the primary should answer instead.
+        private T RunOnReplica<T>(Replica replica, P4ScheduledCommand<T> work) where T : P4BaseRecordSet
+        {
+            T result = null;
+            bool threw = false;
+            long start = 0;
+            try
+            {
+                lock (replica)
+                {
+                    start = Stopwatch.GetTimestamp();
+                    P4ExceptionLevels level = replica.Connection.ExceptionLevel;
+                    replica.Connection.ExceptionLevel = P4ExceptionLevels.NoExceptionOnErrors;
+                    try
+                    {
+                        result = work(replica.Connection);
+                    }
+                    finally
+                    {
+                        replica.Connection.ExceptionLevel = level;
+                    }
+                }
+            }
+            catch (P4API.Exceptions.P4APIExceptions)
+            {
+                threw = true;
+            }
+            finally
+            {
+                // whatever the work threw, the replica isn't busy with it any more
+                lock (_lock)
+                {
+                    replica.InFlight--;
+                }
+            }
+
+            bool useful = result != null && !result.HasErrors() &&
+                !(result.HasWarnings() && _primary.ExceptionLevel == P4ExceptionLevels.ExceptionOnBothErrorsAndWarnings);
+
+            lock (_lock)
+            {
+                if (threw)
+                {
+                    MarkUnhealthy(replica);
+                }
+                else
+                {
+                    replica.Healthy = true;
+                    double elapsed = Stopwatch.GetTimestamp() - start;
+                    replica.LatencyTicks = (replica.LatencyTicks == 0) ? elapsed : replica.LatencyTicks * 0.8 + elapsed * 0.2;
+                }
+                if (useful)
+                {
+                    replica.Reads++;
+                }
+                else
+                {
+                    replica.Failures++;
+                }
+            }
+            return useful ? result : null;
+        }
+
+        // Called with _lock held.
+        private void MarkUnhealthy(Replica r)
+        {
+            r.Healthy = false;
+            r.RetryAt = Stopwatch.GetTimestamp() + ToTicks(_retryUnhealthyAfter);
+        }
+
+        private long ReadCounter(P4Connection connection, object connectionLock)
+        {
+            P4RecordSet r;
+            lock (connectionLock)
+            {
+                r = connection.Run("counter", _lagCounter);
+            }
+            long value;
+            if (r.Records.Length != 1 || !long.TryParse(r.Records[0].Fields["value"], out value)) return -1;
+            return value;
+        }
+
+        private static long ToTicks(TimeSpan span)
+        {
+            return (long)(span.TotalSeconds * Stopwatch.Frequency);
+        }
+        #endregion
+    }
+}
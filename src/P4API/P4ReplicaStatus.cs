@@ -0,0 +1,129 @@
+/*
+ * P4.Net *
+Copyright (c) 2007-2010 Shawn Hladky
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+and associated documentation files (the "Software"), to deal in the Software without 
+restriction, including without limitation the rights to use, copy, modify, merge, publish, 
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or 
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+ */
+
+
+using System;
+
+namespace P4API
+{
+    /// <summary>
+    /// A snapshot of one replica's state in a <see cref="P4ReplicaRouter"/>.
+    /// </summary>
+    public class P4ReplicaStatus
+    {
+        private string _port;
+        private bool _healthy;
+        private long _lag;
+        private TimeSpan _latency;
+        private int _inFlight;
+        private long _reads;
+        private long _failures;
+
+        //don't allow to be created outside this assembly
+        internal P4ReplicaStatus(string port, bool healthy, long lag, TimeSpan latency, int inFlight, long reads, long failures)
+        {
+            _port = port;
+            _healthy = healthy;
+            _lag = lag;
+            _latency = latency;
+            _inFlight = inFlight;
+            _reads = reads;
+            _failures = failures;
+        }
+
+        /// <summary>
+        /// Gets the replica's port.
+        /// </summary>
+        public string Port
+        {
+            get
+            {
+                return _port;
+            }
+        }
+
+        /// <summary>
+        /// Gets whether the replica is taking reads.  A replica that failed is given another chance after
+        /// <see cref="P4ReplicaRouter.RetryUnhealthyAfter"/>.
+        /// </summary>
+        public bool IsHealthy
+        {
+            get
+            {
+                return _healthy;
+            }
+        }
+
+        /// <summary>
+        /// Gets how far the replica's lag counter was behind the primary's at the last check, or -1 if not checked yet.
+        /// </summary>
+        public long Lag
+        {
+            get
+            {
+                return _lag;
+            }
+        }
+
+        /// <summary>
+        /// Gets the moving average of the replica's command times.
+        /// </summary>
+        public TimeSpan AverageLatency
+        {
+            get
+            {
+                return _latency;
+            }
+        }
+
+        /// <summary>
+        /// Gets the number of commands running on (or waiting for) the replica.
+        /// </summary>
+        public int InFlight
+        {
+            get
+            {
+                return _inFlight;
+            }
+        }
+
+        /// <summary>
+        /// Gets the number of reads the replica answered.
+        /// </summary>
+        public long Reads
+        {
+            get
+            {
+                return _reads;
+            }
+        }
+
+        /// <summary>
+        /// Gets the number of reads that failed on the replica and went to the primary instead.
+        /// </summary>
+        public long Failures
+        {
+            get
+            {
+                return _failures;
+            }
+        }
+    }
+}
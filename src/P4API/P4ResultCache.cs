@@ -0,0 +1,500 @@
+/*
+ * P4.Net *
+Copyright (c) 2007-2010 Shawn Hladky
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+and associated documentation files (the "Software"), to deal in the Software without 
+restriction, including without limitation the rights to use, copy, modify, merge, publish, 
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or 
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+ */
+
+
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Threading;
+
+namespace P4API
+{
+    /// <summary>
+    /// Shares the results of hot read-only commands between callers: identical concurrent commands run once, and
+    /// results are kept for a short, per-command time to live.
+    /// </summary>
+    /// <remarks>
+    /// <para>Attach a cache to one or more connections with <see cref="P4Connection.ResultCache"/>.  Only commands
+    /// registered with <see cref="SetTimeToLive(string, TimeSpan)"/> go through it; everything else runs as usual.
+    /// Two commands are identical when the command, arguments, server, user, client, working directory, charset,
+    /// tagged mode, <see cref="P4Connection.ServerTracking"/> and <see cref="P4Connection.InternValues"/> all match.
+    /// Commands run while <see cref="P4Connection.MessageFilter"/> is set don't use the cache.</para>
+    /// <para>While a command is running, identical commands from other threads wait for it and get the same result
+    /// instead of sending their own.  Successful results (no errors, not cancelled) are then cached until their time to
+    /// live runs out, or until the cache needs the memory.</para>
+    /// <para>Results handed out by the cache are shared, so they are read-only: see <see cref="P4BaseRecordSet.IsReadOnly"/>.</para>
+    /// <para>Out of the box, info (5 seconds), fstat, counter &lt;name&gt; and client -o (2 seconds each) are registered.
+    /// Only register commands that don't change anything on the server with those arguments.</para>
+    /// <para>When a connection using the cache runs a command that isn't registered and isn't a known read-only
+    /// query (edit, revert, submit, client -i and so on), the cached results for that server are dropped, so the
+    /// connection doesn't read its own write from before it.</para>
+    /// <para>A command waiting for an identical one gives up when its connection's <see cref="P4Connection.CommandTimeout"/>
+    /// or <see cref="P4Connection.CommandDeadline"/> passes, or its cancellation token is cancelled, and ends TimedOut
+    /// or Cancelled like a command stopped while running.</para>
+    /// <para>All members are thread safe.</para>
+    /// </remarks>
+    public class P4ResultCache
+    {
+        internal delegate T Fetch<T>();
+
+        // Commands that never change what a cached command would return.
+        private static readonly string[] ReadOnlyCommands = new string[] {
+            "annotate", "branches", "changes", "clients", "counters", "depots", "describe", "diff2", "dirs", "filelog",
+            "files", "fixes", "fstat", "groups", "have", "info", "jobs", "labels", "opened", "print", "sizes", "users",
+            "where" };
+
+        private sealed class Policy
+        {
+            public long Ttl;
+            public Predicate<string[]> Cacheable;
+        }
+
+        private sealed class Entry
+        {
+            public string Key;
+            public P4BaseRecordSet Result;
+            public long Expires;
+            public long Size;
+        }
+
+        private sealed class Flight
+        {
+            public P4BaseRecordSet Result;
+            public Exception Error;
+            public bool Done;
+        }
+
+        private readonly object _lock = new object();
+        private readonly long _maxMemory;
+        private readonly Dictionary<string, Policy> _policies = new Dictionary<string, Policy>(StringComparer.OrdinalIgnoreCase);
+        private readonly Dictionary<string, LinkedListNode<Entry>> _entries = new Dictionary<string, LinkedListNode<Entry>>();
+        private readonly LinkedList<Entry> _lru = new LinkedList<Entry>();
+        private readonly Dictionary<string, Flight> _flights = new Dictionary<string, Flight>();
+        private long _generation;
+        private long _memoryUsed;
+        private long _hits;
+        private long _misses;
+        private long _coalesced;
+        private long _evictions;
+
+        /// <summary>
+        /// Initializes a new instance of the <see cref="P4ResultCache"/> class holding up to 64 MB of results.
+        /// </summary>
+        public P4ResultCache()
+            : this(64L * 1024 * 1024)
+        {
+        }
+
+        /// <summary>
+        /// Initializes a new instance of the <see cref="P4ResultCache"/> class.
+        /// </summary>
+        /// <param name="maxMemory">Rough upper bound, in bytes, on the memory used by cached results.</param>
+        public P4ResultCache(long maxMemory)
+        {
+            if (maxMemory <= 0) throw new ArgumentOutOfRangeException("maxMemory");
+            _maxMemory = maxMemory;
+
+            SetTimeToLive("info", TimeSpan.FromSeconds(5));
+            SetTimeToLive("fstat", TimeSpan.FromSeconds(2));
+            SetTimeToLive("counter", TimeSpan.FromSeconds(2), delegate(string[] args)
+            {
+                // "counter name" reads; anything else sets, increments or deletes
+                return args.Length == 1 && !args[0].StartsWith("-");
+            });
+            SetTimeToLive("client", TimeSpan.FromSeconds(2), delegate(string[] args)
+            {
+                return args.Length > 0 && args[0] == "-o";
+            });
+        }
+
+        #region Settings
+        /// <summary>
+        /// Gets the rough upper bound, in bytes, on the memory used by cached results.
+        /// </summary>
+        public long MaxMemory
+        {
+            get
+            {
+                return _maxMemory;
+            }
+        }
+
+        /// <summary>
+        /// Sends a command through the cache, whatever its arguments.
+        /// </summary>
+        /// <param name="command">The command.</param>
+        /// <param name="timeToLive">How long results are kept.  TimeSpan.Zero coalesces concurrent commands without caching.</param>
+        public void SetTimeToLive(string command, TimeSpan timeToLive)
+        {
+            SetTimeToLive(command, timeToLive, null);
+        }
+
+        /// <summary>
+        /// Sends a command through the cache when its arguments pass a test.
+        /// </summary>
+        /// <param name="command">The command.</param>
+        /// <param name="timeToLive">How long results are kept.  TimeSpan.Zero coalesces concurrent commands without caching.</param>
+        /// <param name="cacheable">Returns true for arguments that only read, or null for all arguments.</param>
+        public void SetTimeToLive(string command, TimeSpan timeToLive, Predicate<string[]> cacheable)
+        {
+            if (command == null) throw new ArgumentNullException("command");
+            if (timeToLive < TimeSpan.Zero) throw new ArgumentOutOfRangeException("timeToLive");
+
+            Policy policy = new Policy();
+            policy.Ttl = (long)(timeToLive.TotalSeconds * Stopwatch.Frequency);
+            policy.Cacheable = cacheable;
+            lock (_lock)
+            {
+                _policies[command] = policy;
+            }
+        }
+
+        /// <summary>
+        /// Stops sending a command through the cache, and drops its cached results.
+        /// </summary>
+        /// <param name="command">The command.</param>
+        public void RemoveCommand(string command)
+        {
+            if (command == null) throw new ArgumentNullException("command");
+            lock (_lock)
+            {
+                _policies.Remove(command);
+            }
+            // keys start with the command; see P4Connection.GetCacheKey
+            Invalidate(command);
+        }
+
+        /// <summary>
+        /// Drops all cached results for a command, e.g. after running something that changes them.
+        /// </summary>
+        /// <param name="command">The command.</param>
+        public void Invalidate(string command)
+        {
+            if (command == null) throw new ArgumentNullException("command");
+            string prefix = command + "\0";
+            lock (_lock)
+            {
+                LinkedListNode<Entry> node = _lru.First;
+                while (node != null)
+                {
+                    LinkedListNode<Entry> next = node.Next;
+                    if (node.Value.Key.StartsWith(prefix, StringComparison.OrdinalIgnoreCase)) Remove(node);
+                    node = next;
+                }
+                _generation++;
+            }
+        }
+
+        /// <summary>
+        /// Drops all cached results.
+        /// </summary>
+        public void Clear()
+        {
+            lock (_lock)
+            {
+                _entries.Clear();
+                _lru.Clear();
+                _memoryUsed = 0;
+                _generation++;
+            }
+        }
+        #endregion
+
+        #region Statistics
+        /// <summary>
+        /// Gets the number of commands answered from the cache.
+        /// </summary>
+        public long Hits
+        {
+            get
+            {
+                lock (_lock)
+                {
+                    return _hits;
+                }
+            }
+        }
+
+        /// <summary>
+        /// Gets the number of commands that went to the server.
+        /// </summary>
+        public long Misses
+        {
+            get
+            {
+                lock (_lock)
+                {
+                    return _misses;
+                }
+            }
+        }
+
+        /// <summary>
+        /// Gets the number of commands that waited for an identical command already running, instead of sending their own.
+        /// </summary>
+        public long Coalesced
+        {
+            get
+            {
+                lock (_lock)
+                {
+                    return _coalesced;
+                }
+            }
+        }
+
+        /// <summary>
+        /// Gets the number of results dropped early to stay under <see cref="MaxMemory"/>.
+        /// </summary>
+        public long Evictions
+        {
+            get
+            {
+                lock (_lock)
+                {
+                    return _evictions;
+                }
+            }
+        }
+
+        /// <summary>
+        /// Gets the number of cached results (including expired ones not yet dropped).
+        /// </summary>
+        public int Count
+        {
+            get
+            {
+                lock (_lock)
+                {
+                    return _entries.Count;
+                }
+            }
+        }
+
+        /// <summary>
+        /// Gets the estimated memory, in bytes, used by cached results.
+        /// </summary>
+        public long MemoryUsed
+        {
+            get
+            {
+                lock (_lock)
+                {
+                    return _memoryUsed;
+                }
+            }
+        }
+        #endregion
+
+        #region Internal Methods
+        internal bool IsCacheable(string command, string[] args)
+        {
+            Policy policy;
+            lock (_lock)
+            {
+                if (!_policies.TryGetValue(command, out policy)) return false;
+            }
+            return policy.Cacheable == null || policy.Cacheable(args);
+        }
+
+        // True when a command that just ran may have changed cached results.
+        internal bool Invalidates(string command, string[] args)
+        {
+            return Array.IndexOf(ReadOnlyCommands, command) < 0 && !IsCacheable(command, args);
+        }
+
+        // Drops the results from one server; keys have the port third, see P4Connection.GetCacheKey.
+        internal void InvalidateServer(string port)
+        {
+            string[] sep = new string[] { "\0" };
+            lock (_lock)
+            {
+                LinkedListNode<Entry> node = _lru.First;
+                while (node != null)
+                {
+                    LinkedListNode<Entry> next = node.Next;
+                    string[] parts = node.Value.Key.Split(sep, 4, StringSplitOptions.None);
+                    if (parts.Length < 3 || parts[2] == port) Remove(node);
+                    node = next;
+                }
+
+                // and keep commands already running from caching what they read before the change
+                _generation++;
+            }
+        }
+
+        // Returns a cached result, waits for an identical command in flight, or runs fetch and shares what it returns.
+        // A waiter gives up after timeoutMs (0 for no limit) or once cancelled (if not null) is set, and returns what
+        // gaveUp does instead.
+        internal T Run<T>(string key, string command, int timeoutMs, WaitHandle cancelled, Fetch<T> fetch, Fetch<T> gaveUp)
+            where T : P4BaseRecordSet
+        {
+            Flight flight;
+            bool leader = false;
+            long generation;
+            lock (_lock)
+            {
+                LinkedListNode<Entry> node;
+                if (_entries.TryGetValue(key, out node))
+                {
+                    if (node.Value.Expires > Stopwatch.GetTimestamp())
+                    {
+                        _lru.Remove(node);
+                        _lru.AddFirst(node);
+                        _hits++;
+                        return (T)node.Value.Result;
+                    }
+                    Remove(node);
+                }
+
+                generation = _generation;
+                if (_flights.TryGetValue(key, out flight))
+                {
+                    _coalesced++;
+                    if (Wait(flight, timeoutMs, cancelled))
+                    {
+                        if (flight.Error != null) throw flight.Error;
+                        return (T)flight.Result;
+                    }
+                    flight = null;
+                }
+                else
+                {
+                    flight = new Flight();
+                    _flights.Add(key, flight);
+                    _misses++;
+                    leader = true;
+                }
+            }
+            if (!leader) return gaveUp();
+
+            T result = null;
+            try
+            {
+                result = fetch();
+                result.MakeReadOnly();
+                return result;
+            }
+            catch (Exception e)
+            {
+                flight.Error = e;
+                throw;
+            }
+            finally
+            {
+                if (leader)
+                {
+                    lock (_lock)
+                    {
+                        flight.Result = result;
+                        flight.Done = true;
+                        _flights.Remove(key);
+                        if (result != null && generation == _generation) Add(key, command, result);
+                        Monitor.PulseAll(_lock);
+                    }
+                }
+            }
+        }
+        #endregion
+
+        #region Private Helper Methods
+        // Called with _lock held.  Waits for flight to finish; false if the caller's time ran out or it was cancelled.
+        private bool Wait(Flight flight, int timeoutMs, WaitHandle cancelled)
+        {
+            long end = Stopwatch.GetTimestamp() + timeoutMs * Stopwatch.Frequency / 1000;
+            while (!flight.Done)
+            {
+                int slice = Timeout.Infinite;
+                if (cancelled != null)
+                {
+                    // Monitor.Wait can't also wait on the handle, so look at it every so often
+                    if (cancelled.WaitOne(0, false)) return false;
+                    slice = 50;
+                }
+                if (timeoutMs > 0)
+                {
+                    long left = (end - Stopwatch.GetTimestamp()) * 1000 / Stopwatch.Frequency;
+                    if (left <= 0) return false;
+                    if (slice == Timeout.Infinite || left < slice) slice = (int)Math.Min(left, int.MaxValue);
+                }
+                Monitor.Wait(_lock, slice);
+            }
+            return true;
+        }
+
+        // Called with _lock held.
+        private void Add(string key, string command, P4BaseRecordSet result)
+        {
+            if (result.HasErrors() || result.CommandStatus != P4CommandStatus.Completed) return;
+            if (result.HasSpilledRecords) return;
+
+            Policy policy;
+            if (!_policies.TryGetValue(command, out policy) || policy.Ttl <= 0) return;
+
+            long size = EstimateSize(result);
+            if (size > _maxMemory / 4) return;
+
+            while (_memoryUsed + size > _maxMemory && _lru.Last != null)
+            {
+                Remove(_lru.Last);
+                _evictions++;
+            }
+
+            Entry entry = new Entry();
+            entry.Key = key;
+            entry.Result = result;
+            entry.Expires = Stopwatch.GetTimestamp() + policy.Ttl;
+            entry.Size = size;
+            _entries[key] = _lru.AddFirst(entry);
+            _memoryUsed += size;
+        }
+
+        private void Remove(LinkedListNode<Entry> node)
+        {
+            _lru.Remove(node);
+            _entries.Remove(node.Value.Key);
+            _memoryUsed -= node.Value.Size;
+        }
+
+        // Rough: two bytes a character plus per-object overhead.
+        private static long EstimateSize(P4BaseRecordSet result)
+        {
+            long size = 256 + EstimateSize(result.StringOutputs) + EstimateSize(result.InfoOutputs) +
+                EstimateSize(result.ErrorOutputs) + EstimateSize(result.WarningOutputs) + result.Messages.Count * 128;
+            if (result.BinaryOutput != null) size += result.BinaryOutput.Length;
+            foreach (P4Record r in result.TaggedOutputs)
+            {
+                size += r.EstimateSize();
+            }
+            return size;
+        }
+
+        private static long EstimateSize(List<string> strings)
+        {
+            long size = 0;
+            foreach (string s in strings)
+            {
+                size += 32 + 2 * s.Length;
+            }
+            return size;
+        }
+        #endregion
+    }
+}
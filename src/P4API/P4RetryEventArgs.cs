@@ -0,0 +1,106 @@
+/*
+ * P4.Net *
+Copyright (c) 2007-2010 Shawn Hladky
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+and associated documentation files (the "Software"), to deal in the Software without 
+restriction, including without limitation the rights to use, copy, modify, merge, publish, 
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or 
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+ */
+
+
+using System;
+
+namespace P4API
+{
+    /// <summary>
+    /// Arguments provided for an OnRetry event.
+    /// </summary>
+    public class P4RetryEventArgs : EventArgs
+    {
+        private string _command;
+        private int _attempt;
+        private TimeSpan _delay;
+        private Exception _error;
+        private bool _cancel = false;
+
+        //don't allow to be created outside this assembly
+        internal P4RetryEventArgs(string command, int attempt, TimeSpan delay, Exception error)
+        {
+            _command = command;
+            _attempt = attempt;
+            _delay = delay;
+            _error = error;
+        }
+
+        /// <summary>
+        /// The command being retried.
+        /// </summary>
+        public string Command
+        {
+            get
+            {
+                return _command;
+            }
+        }
+
+        /// <summary>
+        /// The retry about to be made: 1 for the first retry, 2 for the second, and so on.
+        /// </summary>
+        public int Attempt
+        {
+            get
+            {
+                return _attempt;
+            }
+        }
+
+        /// <summary>
+        /// How long P4.Net will wait before retrying.
+        /// </summary>
+        public TimeSpan Delay
+        {
+            get
+            {
+                return _delay;
+            }
+        }
+
+        /// <summary>
+        /// The reconnect error, or null when the connection dropped while the command was running.
+        /// </summary>
+        public Exception Error
+        {
+            get
+            {
+                return _error;
+            }
+        }
+
+        /// <summary>
+        /// Set to true to give up instead of retrying.
+        /// </summary>
+        /// <remarks>The results of the failed attempt (or the reconnect error) are returned to the caller.</remarks>
+        public bool Cancel
+        {
+            get
+            {
+                return _cancel;
+            }
+            set
+            {
+                _cancel = value;
+            }
+        }
+    }
+}
@@ -0,0 +1,646 @@
+/*
+ * P4.Net *
+Copyright (c) 2007-2010 Shawn Hladky
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+and associated documentation files (the "Software"), to deal in the Software without 
+restriction, including without limitation the rights to use, copy, modify, merge, publish, 
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or 
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+ */
+
+
+using System;
+using System.Collections.Generic;
+using System.Globalization;
+
+namespace P4API
+{
+    /// <summary>
+    /// Server-side lock and I/O counters for one database table, from <see cref="P4ServerTracking"/>.
+    /// </summary>
+    public class P4TrackedTable
+    {
+        private string _name;
+        internal long PagesIn, PagesOut, PagesCached;
+        internal long ReadLocksTaken, WriteLocksTaken;
+        internal long RowsGet, RowsPos, RowsScan, RowsPut, RowsDel;
+        internal TimeSpan ReadWait, ReadHeld, WriteWait, WriteHeld;
+        internal TimeSpan MaxReadWait, MaxReadHeld, MaxWriteWait, MaxWriteHeld;
+
+        internal P4TrackedTable(string name)
+        {
+            _name = name;
+        }
+
+        /// <summary>
+        /// Gets the table name, for example "db.rev".
+        /// </summary>
+        public string Name
+        {
+            get
+            {
+                return _name;
+            }
+        }
+
+        /// <summary>
+        /// Gets the number of pages read.
+        /// </summary>
+        public long PagesRead
+        {
+            get
+            {
+                return PagesIn;
+            }
+        }
+
+        /// <summary>
+        /// Gets the number of pages written.
+        /// </summary>
+        public long PagesWritten
+        {
+            get
+            {
+                return PagesOut;
+            }
+        }
+
+        /// <summary>
+        /// Gets the number of pages found in the server's cache.
+        /// </summary>
+        public long PagesFromCache
+        {
+            get
+            {
+                return PagesCached;
+            }
+        }
+
+        /// <summary>
+        /// Gets the number of read locks taken.
+        /// </summary>
+        public long ReadLocks
+        {
+            get
+            {
+                return ReadLocksTaken;
+            }
+        }
+
+        /// <summary>
+        /// Gets the number of write locks taken.
+        /// </summary>
+        public long WriteLocks
+        {
+            get
+            {
+                return WriteLocksTaken;
+            }
+        }
+
+        /// <summary>
+        /// Gets the number of rows fetched, positioned and scanned.
+        /// </summary>
+        public long RowsRead
+        {
+            get
+            {
+                return RowsGet + RowsPos + RowsScan;
+            }
+        }
+
+        /// <summary>
+        /// Gets the number of rows put and deleted.
+        /// </summary>
+        public long RowsWritten
+        {
+            get
+            {
+                return RowsPut + RowsDel;
+            }
+        }
+
+        /// <summary>
+        /// Gets the total time spent waiting for read locks.
+        /// </summary>
+        public TimeSpan ReadLockWait
+        {
+            get
+            {
+                return ReadWait;
+            }
+        }
+
+        /// <summary>
+        /// Gets the total time read locks were held.
+        /// </summary>
+        public TimeSpan ReadLockHeld
+        {
+            get
+            {
+                return ReadHeld;
+            }
+        }
+
+        /// <summary>
+        /// Gets the total time spent waiting for write locks.
+        /// </summary>
+        public TimeSpan WriteLockWait
+        {
+            get
+            {
+                return WriteWait;
+            }
+        }
+
+        /// <summary>
+        /// Gets the total time write locks were held.
+        /// </summary>
+        public TimeSpan WriteLockHeld
+        {
+            get
+            {
+                return WriteHeld;
+            }
+        }
+
+        /// <summary>
+        /// Gets the longest single wait for a read lock.
+        /// </summary>
+        public TimeSpan MaxReadLockWait
+        {
+            get
+            {
+                return MaxReadWait;
+            }
+        }
+
+        /// <summary>
+        /// Gets the longest single wait for a write lock.
+        /// </summary>
+        public TimeSpan MaxWriteLockWait
+        {
+            get
+            {
+                return MaxWriteWait;
+            }
+        }
+    }
+
+    /// <summary>
+    /// Server-side performance tracking for one command.
+    /// </summary>
+    /// <remarks>
+    /// Returned when <see cref="P4Connection.ServerTracking"/> is on.  The server reports its own elapsed time,
+    /// CPU usage, RPC traffic and per-table lock times.  Comparing <see cref="Lapse"/> with
+    /// <see cref="P4CommandStatistics.WallTime"/> shows how much of a slow command was spent on the server.
+    /// <para>Only what the server sent is filled in.  Older servers send less, and fields they leave out read as zero.
+    /// The unparsed lines are always available in <see cref="Lines"/>.</para>
+    /// </remarks>
+    public class P4ServerTracking
+    {
+        private string[] _lines;
+        private TimeSpan _lapse;
+        private TimeSpan _userTime;
+        private TimeSpan _systemTime;
+        private long _ioIn, _ioOut;
+        private long _netIn, _netOut;
+        private long _maxMemoryKB;
+        private long _pageFaults;
+        private long _rpcMessagesIn, _rpcMessagesOut;
+        private long _rpcMBIn, _rpcMBOut;
+        private TimeSpan _rpcSendTime, _rpcReceiveTime;
+        private List<P4TrackedTable> _tables = new List<P4TrackedTable>();
+
+        internal P4ServerTracking(string text)
+        {
+            List<string> lines = new List<string>();
+            P4TrackedTable table = null;
+            foreach (string raw in text.Split('\n'))
+            {
+                if (!raw.StartsWith("--- ")) continue;
+                lines.Add(raw);
+
+                string line = raw.Substring(4);
+                if (line.StartsWith("  "))
+                {
+                    if (table != null) ParseTableLine(table, line.Trim());
+                    continue;
+                }
+
+                string[] t = line.Split(new char[] { ' ' }, StringSplitOptions.RemoveEmptyEntries);
+                if (t.Length == 0) continue;
+
+                if (t[0].StartsWith("db.") || t[0].StartsWith("rdb."))
+                {
+                    table = new P4TrackedTable(t[0]);
+                    _tables.Add(table);
+                    continue;
+                }
+                table = null;
+
+                switch (t[0])
+                {
+                    case "lapse":
+                        if (t.Length > 1) _lapse = ParseTime(t[1]);
+                        break;
+                    case "usage":
+                        ParseUsage(t);
+                        break;
+                    case "rpc":
+                        ParseRpc(t);
+                        break;
+                }
+            }
+            _lines = lines.ToArray();
+        }
+
+        // usage 10+11us 0+0io 0+0net 4104k 0pf
+        private void ParseUsage(string[] t)
+        {
+            for (int i = 1; i < t.Length; i++)
+            {
+                long[] n;
+                if (t[i].EndsWith("us") && (n = ParseLongs(t[i].Substring(0, t[i].Length - 2), '+')).Length == 2)
+                {
+                    _userTime = TimeSpan.FromMilliseconds(n[0]);
+                    _systemTime = TimeSpan.FromMilliseconds(n[1]);
+                }
+                else if (t[i].EndsWith("io") && (n = ParseLongs(t[i].Substring(0, t[i].Length - 2), '+')).Length == 2)
+                {
+                    _ioIn = n[0];
+                    _ioOut = n[1];
+                }
+                else if (t[i].EndsWith("net") && (n = ParseLongs(t[i].Substring(0, t[i].Length - 3), '+')).Length == 2)
+                {
+                    _netIn = n[0];
+                    _netOut = n[1];
+                }
+                else if (t[i].EndsWith("pf"))
+                {
+                    _pageFaults = ParseLong(t[i].Substring(0, t[i].Length - 2));
+                }
+                else if (t[i].EndsWith("k"))
+                {
+                    _maxMemoryKB = ParseLong(t[i].Substring(0, t[i].Length - 1));
+                }
+            }
+        }
+
+        // rpc msgs/size in+out 2+3/0mb+0mb himarks 318788/318788 snd/rcv .000s/.000s
+        private void ParseRpc(string[] t)
+        {
+            for (int i = 1; i < t.Length - 1; i++)
+            {
+                if (t[i] == "in+out")
+                {
+                    string[] parts = t[i + 1].Split('/');
+                    long[] n = ParseLongs(parts[0], '+');
+                    if (n.Length == 2)
+                    {
+                        _rpcMessagesIn = n[0];
+                        _rpcMessagesOut = n[1];
+                    }
+                    if (parts.Length > 1)
+                    {
+                        n = ParseLongs(parts[1].Replace("mb", ""), '+');
+                        if (n.Length == 2)
+                        {
+                            _rpcMBIn = n[0];
+                            _rpcMBOut = n[1];
+                        }
+                    }
+                }
+                else if (t[i] == "snd/rcv")
+                {
+                    string[] parts = t[i + 1].Split('/');
+                    if (parts.Length == 2)
+                    {
+                        _rpcSendTime = ParseTime(parts[0]);
+                        _rpcReceiveTime = ParseTime(parts[1]);
+                    }
+                }
+            }
+        }
+
+        private static void ParseTableLine(P4TrackedTable table, string line)
+        {
+            string[] t = line.Split(new char[] { ' ' }, StringSplitOptions.RemoveEmptyEntries);
+            long[] n;
+            if (t.Length >= 3 && t[0] == "pages")
+            {
+                // pages in+out+cached 3+0+2
+                n = ParseLongs(t[2], '+');
+                if (n.Length == 3)
+                {
+                    table.PagesIn = n[0];
+                    table.PagesOut = n[1];
+                    table.PagesCached = n[2];
+                }
+            }
+            else if (t.Length >= 3 && t[0] == "locks")
+            {
+                // locks read/write 1/0 rows get+pos+scan put+del 1+0+0 0+0
+                n = ParseLongs(t[2], '/');
+                if (n.Length == 2)
+                {
+                    table.ReadLocksTaken = n[0];
+                    table.WriteLocksTaken = n[1];
+                }
+                if (t.Length >= 8 && t[3] == "rows")
+                {
+                    n = ParseLongs(t[6], '+');
+                    if (n.Length == 3)
+                    {
+                        table.RowsGet = n[0];
+                        table.RowsPos = n[1];
+                        table.RowsScan = n[2];
+                    }
+                    n = ParseLongs(t[7], '+');
+                    if (n.Length == 2)
+                    {
+                        table.RowsPut = n[0];
+                        table.RowsDel = n[1];
+                    }
+                }
+            }
+            else if (t.Length >= 5 && (t[0] == "total" || t[0] == "max") && t[1] == "lock")
+            {
+                // total lock wait+held read/write 0ms+0ms/0ms+0ms
+                string[] rw = t[4].Split('/');
+                if (rw.Length != 2) return;
+                string[] r = rw[0].Split('+');
+                string[] w = rw[1].Split('+');
+                if (r.Length != 2 || w.Length != 2) return;
+                if (t[0] == "total")
+                {
+                    table.ReadWait = ParseTime(r[0]);
+                    table.ReadHeld = ParseTime(r[1]);
+                    table.WriteWait = ParseTime(w[0]);
+                    table.WriteHeld = ParseTime(w[1]);
+                }
+                else
+                {
+                    table.MaxReadWait = ParseTime(r[0]);
+                    table.MaxReadHeld = ParseTime(r[1]);
+                    table.MaxWriteWait = ParseTime(w[0]);
+                    table.MaxWriteHeld = ParseTime(w[1]);
+                }
+            }
+        }
+
+        private static long ParseLong(string s)
+        {
+            long ret;
+            return long.TryParse(s, NumberStyles.Integer, CultureInfo.InvariantCulture, out ret) ? ret : 0;
+        }
+
+        private static long[] ParseLongs(string s, char separator)
+        {
+            string[] parts = s.Split(separator);
+            long[] ret = new long[parts.Length];
+            for (int i = 0; i < parts.Length; i++)
+            {
+                if (!long.TryParse(parts[i], NumberStyles.Integer, CultureInfo.InvariantCulture, out ret[i]))
+                {
+                    return new long[0];
+                }
+            }
+            return ret;
+        }
+
+        // ".044s", "12ms"
+        private static TimeSpan ParseTime(string s)
+        {
+            double v;
+            if (s.EndsWith("ms"))
+            {
+                if (double.TryParse(s.Substring(0, s.Length - 2), NumberStyles.Float, CultureInfo.InvariantCulture, out v))
+                {
+                    return TimeSpan.FromMilliseconds(v);
+                }
+            }
+            else if (s.EndsWith("s"))
+            {
+                if (double.TryParse(s.Substring(0, s.Length - 1), NumberStyles.Float, CultureInfo.InvariantCulture, out v))
+                {
+                    return TimeSpan.FromSeconds(v);
+                }
+            }
+            return TimeSpan.Zero;
+        }
+
+        /// <summary>
+        /// Gets the tracking lines as the server sent them.
+        /// </summary>
+        public string[] Lines
+        {
+            get
+            {
+                return _lines;
+            }
+        }
+
+        /// <summary>
+        /// Gets the time the server spent on the command.
+        /// </summary>
+        public TimeSpan Lapse
+        {
+            get
+            {
+                return _lapse;
+            }
+        }
+
+        /// <summary>
+        /// Gets the server's user-mode CPU time.
+        /// </summary>
+        public TimeSpan UserTime
+        {
+            get
+            {
+                return _userTime;
+            }
+        }
+
+        /// <summary>
+        /// Gets the server's kernel-mode CPU time.
+        /// </summary>
+        public TimeSpan SystemTime
+        {
+            get
+            {
+                return _systemTime;
+            }
+        }
+
+        /// <summary>
+        /// Gets the number of disk blocks the server read.
+        /// </summary>
+        public long IoIn
+        {
+            get
+            {
+                return _ioIn;
+            }
+        }
+
+        /// <summary>
+        /// Gets the number of disk blocks the server wrote.
+        /// </summary>
+        public long IoOut
+        {
+            get
+            {
+                return _ioOut;
+            }
+        }
+
+        /// <summary>
+        /// Gets the number of network packets the server received.
+        /// </summary>
+        public long NetIn
+        {
+            get
+            {
+                return _netIn;
+            }
+        }
+
+        /// <summary>
+        /// Gets the number of network packets the server sent.
+        /// </summary>
+        public long NetOut
+        {
+            get
+            {
+                return _netOut;
+            }
+        }
+
+        /// <summary>
+        /// Gets the server process's peak memory use, in kilobytes.
+        /// </summary>
+        public long MaxMemoryKB
+        {
+            get
+            {
+                return _maxMemoryKB;
+            }
+        }
+
+        /// <summary>
+        /// Gets the number of page faults in the server process.
+        /// </summary>
+        public long PageFaults
+        {
+            get
+            {
+                return _pageFaults;
+            }
+        }
+
+        /// <summary>
+        /// Gets the number of RPC messages the server received.
+        /// </summary>
+        public long RpcMessagesIn
+        {
+            get
+            {
+                return _rpcMessagesIn;
+            }
+        }
+
+        /// <summary>
+        /// Gets the number of RPC messages the server sent.
+        /// </summary>
+        public long RpcMessagesOut
+        {
+            get
+            {
+                return _rpcMessagesOut;
+            }
+        }
+
+        /// <summary>
+        /// Gets the RPC volume received by the server, in megabytes.
+        /// </summary>
+        public long RpcMBIn
+        {
+            get
+            {
+                return _rpcMBIn;
+            }
+        }
+
+        /// <summary>
+        /// Gets the RPC volume sent by the server, in megabytes.
+        /// </summary>
+        public long RpcMBOut
+        {
+            get
+            {
+                return _rpcMBOut;
+            }
+        }
+
+        /// <summary>
+        /// Gets the time the server spent blocked sending to the client.
+        /// </summary>
+        public TimeSpan RpcSendTime
+        {
+            get
+            {
+                return _rpcSendTime;
+            }
+        }
+
+        /// <summary>
+        /// Gets the time the server spent waiting on the client.
+        /// </summary>
+        public TimeSpan RpcReceiveTime
+        {
+            get
+            {
+                return _rpcReceiveTime;
+            }
+        }
+
+        /// <summary>
+        /// Gets the per-table counters.
+        /// </summary>
+        public P4TrackedTable[] Tables
+        {
+            get
+            {
+                return _tables.ToArray();
+            }
+        }
+
+        /// <summary>
+        /// Gets the total time spent waiting on database locks, over all tables.
+        /// </summary>
+        public TimeSpan TotalLockWait
+        {
+            get
+            {
+                TimeSpan ret = TimeSpan.Zero;
+                foreach (P4TrackedTable t in _tables)
+                {
+                    ret += t.ReadLockWait + t.WriteLockWait;
+                }
+                return ret;
+            }
+        }
+    }
+}
@@ -0,0 +1,207 @@
+/*
+ * P4.Net *
+Copyright (c) 2007-2010 Shawn Hladky
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+and associated documentation files (the "Software"), to deal in the Software without 
+restriction, including without limitation the rights to use, copy, modify, merge, publish, 
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or 
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+ */
+
+
+using System;
+using p4dn;
+
+namespace P4API
+{
+    /// <summary>
+    /// Records every callback the Perforce API delivers while a command runs to a compact binary session file.
+    /// </summary>
+    /// <remarks>
+    /// Assign to <see cref="P4Connection.SessionRecorder"/>.  Record sets, messages (with their raw error data),
+    /// file content, prompts and timing are all captured, so the session can later be fed back through
+    /// <see cref="P4SessionReplay"/> with no server.  Each command is written (and flushed) as one block when it
+    /// finishes, so one recorder can be shared by several connections.
+    /// <para>Prompt responses, passwords passed to <see cref="P4Connection.Login"/> and files touched by
+    /// resolve or edit are not recorded.  The command arguments are.</para>
+    /// </remarks>
+    public sealed class P4SessionRecorder : IDisposable
+    {
+        private SessionRecorder _recorder;
+
+        /// <summary>
+        /// Creates the session file, overwriting any existing file.
+        /// </summary>
+        /// <param name="path">Path to the session file.</param>
+        public P4SessionRecorder(string path)
+        {
+            if (path == null) throw new ArgumentNullException("path");
+            _recorder = new SessionRecorder(path);
+        }
+
+        /// <summary>
+        /// Gets the path to the session file.
+        /// </summary>
+        public string Path
+        {
+            get
+            {
+                return _recorder.Path;
+            }
+        }
+
+        /// <summary>
+        /// Gets the number of commands recorded so far.
+        /// </summary>
+        public int Commands
+        {
+            get
+            {
+                return _recorder.Runs;
+            }
+        }
+
+        internal SessionRecorder Native
+        {
+            get
+            {
+                return _recorder;
+            }
+        }
+
+        /// <summary>
+        /// Closes the session file.  Commands that finish afterwards throw.
+        /// </summary>
+        public void Dispose()
+        {
+            _recorder.Dispose();
+        }
+    }
+
+    /// <summary>
+    /// Plays a session captured by <see cref="P4SessionRecorder"/> back in place of a Perforce server.
+    /// </summary>
+    /// <remarks>
+    /// Assign to <see cref="P4Connection.SessionReplay"/> before connecting.  The connection never touches the network:
+    /// each command takes the next recorded command from the session, which must be the same command (arguments are
+    /// not compared), and its callbacks are fed through the same native and managed code a live command uses.  Message
+    /// filters, server tracking, statistics, cancellation and command timeouts all behave as they would against the server.
+    /// <para>Commands are handed out in recorded order under a lock, so several connections can share one replay
+    /// (for example to drive a load test).</para>
+    /// </remarks>
+    public sealed class P4SessionReplay : IDisposable
+    {
+        private SessionReplay _replay;
+
+        /// <summary>
+        /// Loads a session file.
+        /// </summary>
+        /// <param name="path">Path to the session file.</param>
+        /// <exception cref="System.IO.InvalidDataException">The file is not a session file.</exception>
+        public P4SessionReplay(string path)
+        {
+            if (path == null) throw new ArgumentNullException("path");
+            _replay = new SessionReplay(path);
+        }
+
+        /// <summary>
+        /// Gets the path to the session file.
+        /// </summary>
+        public string Path
+        {
+            get
+            {
+                return _replay.Path;
+            }
+        }
+
+        /// <summary>
+        /// Gets the number of commands in the session.
+        /// </summary>
+        /// <remarks>A command cut short by a crash while recording is not counted, and can't be replayed.</remarks>
+        public int Commands
+        {
+            get
+            {
+                return _replay.Runs;
+            }
+        }
+
+        /// <summary>
+        /// Gets/Sets whether to reproduce the recorded gaps between callbacks.
+        /// </summary>
+        /// <value>False (the default) replays as fast as the client can consume the output.</value>
+        public bool OriginalTiming
+        {
+            get
+            {
+                return _replay.OriginalTiming;
+            }
+            set
+            {
+                _replay.OriginalTiming = value;
+            }
+        }
+
+        /// <summary>
+        /// Gets/Sets whether to start over from the first command after the last one has been played.
+        /// </summary>
+        /// <value>False (the default) throws <see cref="InvalidOperationException"/> when the session is exhausted.</value>
+        public bool Loop
+        {
+            get
+            {
+                return _replay.Loop;
+            }
+            set
+            {
+                _replay.Loop = value;
+            }
+        }
+
+        /// <summary>
+        /// Gets a recorded command line.
+        /// </summary>
+        /// <param name="index">Index of the command in the session, from 0 to <see cref="Commands"/> - 1.</param>
+        /// <returns>The command name followed by its arguments.</returns>
+        public string[] GetCommand(int index)
+        {
+            if (index < 0 || index >= _replay.Runs) throw new ArgumentOutOfRangeException("index");
+            return _replay.GetCommand(index);
+        }
+
+        /// <summary>
+        /// Starts the replay over from the first command.
+        /// </summary>
+        public void Rewind()
+        {
+            _replay.Rewind();
+        }
+
+        internal SessionReplay Native
+        {
+            get
+            {
+                return _replay;
+            }
+        }
+
+        /// <summary>
+        /// Releases the loaded session.
+        /// </summary>
+        public void Dispose()
+        {
+            _replay.Dispose();
+        }
+    }
+}
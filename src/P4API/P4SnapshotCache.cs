@@ -0,0 +1,621 @@
+/*
+ * P4.Net *
+Copyright (c) 2007-2010 Shawn Hladky
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+and associated documentation files (the "Software"), to deal in the Software without 
+restriction, including without limitation the rights to use, copy, modify, merge, publish, 
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or 
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+ */
+
+
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.IO.Compression;
+using System.Security.Cryptography;
+using System.Text;
+using System.Threading;
+
+namespace P4API
+{
+    /// <summary>
+    /// Persistent cache for queries pinned to submitted history, which can never change.
+    /// </summary>
+    /// <remarks>
+    /// <para>Attach it with <see cref="P4Connection.SnapshotCache"/>.  A hit is read from disk without connecting to
+    /// the server.  Only annotate, dirs, files, print (without -o) and sizes are admitted, when every file argument is
+    /// in depot syntax and pinned with @change or #revision (or a range of them), and every pinned change is already
+    /// submitted.</para>
+    /// <para>filelog and describe are not admitted even when pinned: filelog gains "into" records when the file is
+    /// later integrated elsewhere, and describe gains jobs when one is fixed by the change.</para>
+    /// <para>Results with errors or warnings, or that were cancelled, are not stored, and the cache isn't used at all
+    /// while <see cref="P4Connection.MessageFilter"/> is set.  Results are keyed by server, user, charset, API level,
+    /// tagged mode, command and arguments.</para>
+    /// <para>Each result is a small compressed file in <see cref="Directory"/>.  Several processes can share the
+    /// directory: files are written under a temporary name and renamed into place, and the least recently used are
+    /// deleted once the directory grows past <see cref="MaxSize"/>.</para>
+    /// <para>Obliterating files or editing a submitted change's description does change history; call
+    /// <see cref="Clear"/> afterwards.</para>
+    /// </remarks>
+    public class P4SnapshotCache
+    {
+        private const byte FormatVersion = 1;
+        private const string Extension = ".p4snap";
+        private static readonly byte[] Magic = Encoding.ASCII.GetBytes("P4SNAP");
+        private static readonly string[] FileCommands = new string[] { "annotate", "dirs", "files", "print", "sizes" };
+
+        private readonly string _directory;
+        private readonly long _maxSize;
+        private readonly object _lock = new object();
+        private readonly Dictionary<string, long> _lastSubmitted = new Dictionary<string, long>();
+        private readonly Dictionary<string, List<string>> _depots = new Dictionary<string, List<string>>();
+        private long _size;
+        private long _hits;
+        private long _misses;
+        private long _stores;
+
+        /// <summary>
+        /// Initializes a new instance of the <see cref="P4SnapshotCache"/> class, holding up to 256 MB.
+        /// </summary>
+        /// <param name="directory">Directory for the cache files.  Created if it doesn't exist.</param>
+        public P4SnapshotCache(string directory)
+            : this(directory, 256L * 1024 * 1024)
+        {
+        }
+
+        /// <summary>
+        /// Initializes a new instance of the <see cref="P4SnapshotCache"/> class.
+        /// </summary>
+        /// <param name="directory">Directory for the cache files.  Created if it doesn't exist.</param>
+        /// <param name="maxSize">Size, in bytes, past which the least recently used files are deleted.</param>
+        public P4SnapshotCache(string directory, long maxSize)
+        {
+            if (directory == null) throw new ArgumentNullException("directory");
+            if (maxSize <= 0) throw new ArgumentOutOfRangeException("maxSize");
+
+            _directory = Path.GetFullPath(directory);
+            _maxSize = maxSize;
+            System.IO.Directory.CreateDirectory(_directory);
+
+            foreach (FileInfo f in new DirectoryInfo(_directory).GetFiles("*" + Extension))
+            {
+                _size += f.Length;
+            }
+            // leftovers from writers that died before renaming
+            foreach (FileInfo f in new DirectoryInfo(_directory).GetFiles("*.tmp"))
+            {
+                if (f.LastWriteTimeUtc < DateTime.UtcNow.AddHours(-1)) TryDelete(f.FullName);
+            }
+        }
+
+        #region Public Properties
+        /// <summary>
+        /// Gets the directory holding the cache files.
+        /// </summary>
+        public string Directory
+        {
+            get
+            {
+                return _directory;
+            }
+        }
+
+        /// <summary>
+        /// Gets the size, in bytes, past which the least recently used files are deleted.
+        /// </summary>
+        public long MaxSize
+        {
+            get
+            {
+                return _maxSize;
+            }
+        }
+
+        /// <summary>
+        /// Gets the number of queries answered from disk.
+        /// </summary>
+        public long Hits
+        {
+            get
+            {
+                return Interlocked.Read(ref _hits);
+            }
+        }
+
+        /// <summary>
+        /// Gets the number of admissible queries that had to go to the server.
+        /// </summary>
+        public long Misses
+        {
+            get
+            {
+                return Interlocked.Read(ref _misses);
+            }
+        }
+
+        /// <summary>
+        /// Gets the number of results written to disk by this instance.
+        /// </summary>
+        public long Stores
+        {
+            get
+            {
+                return Interlocked.Read(ref _stores);
+            }
+        }
+        #endregion
+
+        #region Public Methods
+        /// <summary>
+        /// Deletes every cached result (including those written by other processes).
+        /// </summary>
+        public void Clear()
+        {
+            lock (_lock)
+            {
+                foreach (FileInfo f in new DirectoryInfo(_directory).GetFiles("*" + Extension))
+                {
+                    TryDelete(f.FullName);
+                }
+                _size = 0;
+                _lastSubmitted.Clear();
+                _depots.Clear();
+            }
+        }
+        #endregion
+
+        #region Internal Methods
+        // True when the arguments pin the query to history.  change is the highest @change that must already be
+        // submitted.
+        internal static bool IsPinned(string command, string[] args, out long change)
+        {
+            change = 0;
+            if (Array.IndexOf(FileCommands, command) < 0) return false;
+
+            bool anySpec = false;
+            foreach (string arg in args)
+            {
+                if (arg.StartsWith("-"))
+                {
+                    // print -o writes a local file, which a hit wouldn't
+                    if (command == "print" && arg.StartsWith("-o")) return false;
+                    continue;
+                }
+                long pinned;
+                if (!TryGetPinnedChange(arg, out pinned)) return false;
+                change = Math.Max(change, pinned);
+                anySpec = true;
+            }
+            return anySpec;
+        }
+
+        internal T Load<T>(string key) where T : P4BaseRecordSet
+        {
+            string path = GetPath(key);
+            if (!File.Exists(path))
+            {
+                Interlocked.Increment(ref _misses);
+                return null;
+            }
+
+            P4BaseRecordSet result = null;
+            try
+            {
+                result = Read(path, key);
+            }
+            catch (IOException)
+            {
+                // deleted or still being replaced; treat as a miss
+            }
+            catch (InvalidDataException)
+            {
+                TryDelete(path);
+            }
+            catch (EndOfStreamException)
+            {
+                TryDelete(path);
+            }
+
+            T typed = result as T;
+            if (typed == null)
+            {
+                Interlocked.Increment(ref _misses);
+                return null;
+            }
+
+            // the write time is the LRU clock
+            try
+            {
+                File.SetLastWriteTimeUtc(path, DateTime.UtcNow);
+            }
+            catch (IOException) { }
+            catch (UnauthorizedAccessException) { }
+
+            Interlocked.Increment(ref _hits);
+            return typed;
+        }
+
+        // Writes the result if it really is history.  May run "changes -m1 -s submitted" on the connection.
+        internal void Store(P4Connection connection, string key, string command, string[] args, P4BaseRecordSet result)
+        {
+            if (result == null || result.HasErrors() || result.HasWarnings()) return;
+            if (result.CommandStatus != P4CommandStatus.Completed) return;
+            if (result.HasSpilledRecords) return;
+
+            long change;
+            if (!IsPinned(command, args, out change)) return;
+
+            // //name/... is client syntax unless name is a depot, and a client's view can change
+            foreach (string arg in args)
+            {
+                if (arg.StartsWith("-")) continue;
+                if (!IsDepot(connection, GetDepotName(arg))) return;
+            }
+            if (change > 0 && !IsSubmitted(connection, change)) return;
+
+            string path = GetPath(key);
+            string temp = path + "." + Guid.NewGuid().ToString("N") + ".tmp";
+            long length;
+            try
+            {
+                using (FileStream fs = new FileStream(temp, FileMode.CreateNew, FileAccess.Write, FileShare.None))
+                {
+                    Write(fs, key, result);
+                    length = fs.Length;
+                }
+                File.Move(temp, path);
+            }
+            catch (IOException)
+            {
+                // another process stored it first, or the disk is full; either way, nothing lost
+                TryDelete(temp);
+                return;
+            }
+            catch (UnauthorizedAccessException)
+            {
+                TryDelete(temp);
+                return;
+            }
+
+            Interlocked.Increment(ref _stores);
+            bool trim;
+            lock (_lock)
+            {
+                _size += length;
+                trim = _size > _maxSize;
+            }
+            if (trim) Trim();
+        }
+        #endregion
+
+        #region Private Helper Methods
+        // Any change up to the last submitted one is history: later submits are renumbered past it.
+        private bool IsSubmitted(P4Connection connection, long change)
+        {
+            string port = connection.Port ?? string.Empty;
+            lock (_lock)
+            {
+                long known;
+                if (_lastSubmitted.TryGetValue(port, out known) && change <= known) return true;
+            }
+
+            long last = 0;
+            try
+            {
+                P4RecordSet r = connection.RunInternal("changes", "-m1", "-s", "submitted");
+                if (r.Records.Length != 1 || !long.TryParse(r.Records[0].Fields["change"], out last)) return false;
+            }
+            catch (P4API.Exceptions.P4APIExceptions)
+            {
+                return false;
+            }
+
+            lock (_lock)
+            {
+                _lastSubmitted[port] = last;
+            }
+            return change <= last;
+        }
+
+        private bool IsDepot(P4Connection connection, string name)
+        {
+            if (name == null) return false;
+
+            string port = connection.Port ?? string.Empty;
+            List<string> depots;
+            lock (_lock)
+            {
+                if (_depots.TryGetValue(port, out depots)) return depots.Contains(name);
+            }
+
+            depots = new List<string>();
+            try
+            {
+                P4RecordSet r = connection.RunInternal("depots");
+                if (r.HasErrors()) return false;
+                foreach (P4Record d in r)
+                {
+                    if (d.Fields["name"] != null) depots.Add(d.Fields["name"]);
+                }
+            }
+            catch (P4API.Exceptions.P4APIExceptions)
+            {
+                return false;
+            }
+
+            // a depot added later just isn't cached until the next Clear
+            lock (_lock)
+            {
+                _depots[port] = depots;
+            }
+            return depots.Contains(name);
+        }
+
+        private void Trim()
+        {
+            lock (_lock)
+            {
+                List<FileInfo> files = new List<FileInfo>(new DirectoryInfo(_directory).GetFiles("*" + Extension));
+                files.Sort(delegate(FileInfo a, FileInfo b) { return a.LastWriteTimeUtc.CompareTo(b.LastWriteTimeUtc); });
+
+                // other processes write here too, so recount rather than trust _size
+                long size = 0;
+                foreach (FileInfo f in files)
+                {
+                    size += f.Length;
+                }
+
+                long target = _maxSize - _maxSize / 10;
+                for (int i = 0; i < files.Count && size > target; i++)
+                {
+                    if (TryDelete(files[i].FullName)) size -= files[i].Length;
+                }
+                _size = size;
+            }
+        }
+
+        private string GetPath(string key)
+        {
+            byte[] hash;
+            using (SHA1 sha = SHA1.Create())
+            {
+                hash = sha.ComputeHash(Encoding.UTF8.GetBytes(key));
+            }
+            StringBuilder name = new StringBuilder(hash.Length * 2 + Extension.Length);
+            foreach (byte b in hash)
+            {
+                name.Append(b.ToString("x2"));
+            }
+            name.Append(Extension);
+            return Path.Combine(_directory, name.ToString());
+        }
+
+        private static void Write(Stream stream, string key, P4BaseRecordSet result)
+        {
+            stream.Write(Magic, 0, Magic.Length);
+            stream.WriteByte(FormatVersion);
+
+            using (DeflateStream z = new DeflateStream(stream, CompressionMode.Compress, true))
+            {
+                BinaryWriter w = new BinaryWriter(z, Encoding.UTF8);
+                w.Write(key);
+                w.Write((byte)(result is P4RecordSet ? 0 : 1));
+                WriteStrings(w, result.StringOutputs);
+                WriteStrings(w, result.InfoOutputs);
+
+                w.Write(result.TaggedOutputs.Count);
+                foreach (P4Record r in result.TaggedOutputs)
+                {
+                    Dictionary<string, string> fields = r.RawFields;
+                    w.Write(fields.Count);
+                    foreach (KeyValuePair<string, string> f in fields)
+                    {
+                        w.Write(f.Key);
+                        WriteNullable(w, f.Value);
+                    }
+                }
+
+                w.Write(result.Messages.Count);
+                foreach (P4Message m in result.Messages)
+                {
+                    string[] vars = m.Variables;
+                    w.Write(m.Identity);
+                    WriteNullable(w, m.Format());
+                    w.Write(vars.Length);
+                    foreach (string v in vars)
+                    {
+                        w.Write(v);
+                        WriteNullable(w, m.GetValue(v));
+                    }
+                }
+
+                w.Write(result.BinaryOutput != null);
+                if (result.BinaryOutput != null)
+                {
+                    w.Write(result.BinaryOutput.Length);
+                    w.Write(result.BinaryOutput);
+                }
+                WriteNullable(w, result._SpecDef);
+                w.Flush();
+            }
+        }
+
+        private static P4BaseRecordSet Read(string path, string key)
+        {
+            using (FileStream fs = new FileStream(path, FileMode.Open, FileAccess.Read, FileShare.Read | FileShare.Delete))
+            {
+                byte[] header = new byte[Magic.Length + 1];
+                if (fs.Read(header, 0, header.Length) != header.Length) return null;
+                for (int i = 0; i < Magic.Length; i++)
+                {
+                    if (header[i] != Magic[i]) throw new InvalidDataException();
+                }
+                if (header[Magic.Length] != FormatVersion) throw new InvalidDataException();
+
+                using (DeflateStream z = new DeflateStream(fs, CompressionMode.Decompress, true))
+                {
+                    BinaryReader r = new BinaryReader(z, Encoding.UTF8);
+
+                    // different key, same hash: leave the other entry alone
+                    if (r.ReadString() != key) return null;
+
+                    P4BaseRecordSet result = (r.ReadByte() == 0) ? (P4BaseRecordSet)new P4RecordSet() : new P4UnParsedRecordSet();
+                    ReadStrings(r, result.StringOutputs);
+                    ReadStrings(r, result.InfoOutputs);
+
+                    int records = r.ReadInt32();
+                    for (int i = 0; i < records; i++)
+                    {
+                        int count = r.ReadInt32();
+                        Dictionary<string, string> fields = new Dictionary<string, string>(count);
+                        for (int j = 0; j < count; j++)
+                        {
+                            string name = r.ReadString();
+                            fields[name] = ReadNullable(r);
+                        }
+                        result.TaggedOutputs.Add(new P4Record(fields));
+                    }
+
+                    int messages = r.ReadInt32();
+                    for (int i = 0; i < messages; i++)
+                    {
+                        int id = r.ReadInt32();
+                        string format = ReadNullable(r);
+                        int count = r.ReadInt32();
+                        SortedDictionary<string, string> vars = new SortedDictionary<string, string>();
+                        for (int j = 0; j < count; j++)
+                        {
+                            string name = r.ReadString();
+                            vars[name] = ReadNullable(r);
+                        }
+                        result.Messages.Add(new P4Message(id, format, vars));
+                    }
+
+                    if (r.ReadBoolean())
+                    {
+                        result.BinaryOutput = r.ReadBytes(r.ReadInt32());
+                    }
+                    result._SpecDef = ReadNullable(r);
+                    return result;
+                }
+            }
+        }
+
+        private static void WriteStrings(BinaryWriter w, List<string> strings)
+        {
+            w.Write(strings.Count);
+            foreach (string s in strings)
+            {
+                WriteNullable(w, s);
+            }
+        }
+
+        private static void ReadStrings(BinaryReader r, List<string> strings)
+        {
+            int count = r.ReadInt32();
+            for (int i = 0; i < count; i++)
+            {
+                strings.Add(ReadNullable(r));
+            }
+        }
+
+        // a bool for "not null", then the string; P4RecordSpill stores values the same way
+        internal static void WriteNullable(BinaryWriter w, string s)
+        {
+            w.Write(s != null);
+            if (s != null) w.Write(s);
+        }
+
+        internal static string ReadNullable(BinaryReader r)
+        {
+            return r.ReadBoolean() ? r.ReadString() : null;
+        }
+
+        // "depot" for "//depot/path@123"; null when there's no first segment.
+        internal static string GetDepotName(string spec)
+        {
+            if (!spec.StartsWith("//")) return null;
+            int end = spec.IndexOfAny(new char[] { '/', '@', '#' }, 2);
+            if (end <= 2 || spec[end] != '/') return null;
+            return spec.Substring(2, end - 2);
+        }
+
+        // "//depot/path@123", "//depot/path#7" and ranges of them, such as "//depot/...@100,@200".
+        private static bool TryGetPinnedChange(string spec, out long change)
+        {
+            change = 0;
+            if (GetDepotName(spec) == null) return false;
+
+            int rev = spec.IndexOfAny(new char[] { '@', '#' });
+            if (rev < 0) return false;
+
+            // a new file can match a wildcard at its own #N later; @N can't gain files once N is submitted
+            string path = spec.Substring(0, rev);
+            bool wildcard = path.Contains("...") || path.Contains("*") || path.Contains("%%");
+
+            foreach (string end in spec.Substring(rev).Split(','))
+            {
+                long n;
+                if (end.StartsWith("#"))
+                {
+                    if (wildcard) return false;
+
+                    // a revision that doesn't exist yet comes back as a warning, which isn't stored
+                    if (!TryParseNumber(end.Substring(1), out n)) return false;
+                }
+                else if (end.StartsWith("@") && !end.StartsWith("@="))
+                {
+                    // @=change also matches pending and shelved files
+                    if (!TryParseNumber(end.Substring(1), out n)) return false;
+                    change = Math.Max(change, n);
+                }
+                else
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        private static bool TryParseNumber(string s, out long n)
+        {
+            n = 0;
+            if (s.Length == 0 || s.Length > 18) return false;
+            foreach (char c in s)
+            {
+                if (c < '0' || c > '9') return false;
+                n = n * 10 + (c - '0');
+            }
+            return true;
+        }
+
+        private static bool TryDelete(string path)
+        {
+            try
+            {
+                File.Delete(path);
+                return true;
+            }
+            catch (IOException)
+            {
+                return false;
+            }
+            catch (UnauthorizedAccessException)
+            {
+                return false;
+            }
+        }
+        #endregion
+    }
+}
@@ -0,0 +1,192 @@
+/*
+ * P4.Net *
+Copyright (c) 2007-2010 Shawn Hladky
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+and associated documentation files (the "Software"), to deal in the Software without 
+restriction, including without limitation the rights to use, copy, modify, merge, publish, 
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or 
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+ */
+
+
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Globalization;
+using System.IO;
+using System.Text;
+
+namespace P4API
+{
+    /// <summary>
+    /// Opt-in timeline tracing of Perforce commands.
+    /// </summary>
+    /// <remarks>
+    /// While tracing is on, P4.Net records a span for every Init, Run and Final call, every callback from the Perforce API,
+    /// every call into managed callback code, and every connect or reconnect.
+    /// <para>Each thread writes to its own ring buffer without taking locks.  When a buffer fills, the oldest events are
+    /// overwritten.  Only the buffers of the last few threads that have exited are kept.</para>
+    /// <para>The trace is written in the Chrome trace-event JSON format.  It can be opened offline in chrome://tracing or
+    /// https://ui.perfetto.dev.  Gaps between callback spans inside a Run span show time spent waiting on the server.</para>
+    /// </remarks>
+    /// <example>
+    /// <code language="C#">
+    /// P4Trace.Start();
+    /// P4RecordSet r = p4.Run("fstat", "//depot/...");
+    /// P4Trace.Stop();
+    /// P4Trace.WriteChromeTrace("fstat.trace.json");
+    /// </code>
+    /// </example>
+    public static class P4Trace
+    {
+        /// <summary>
+        /// Default number of events kept per thread.
+        /// </summary>
+        public const int DefaultEventsPerThread = 65536;
+
+        /// <summary>
+        /// Gets whether tracing is on.
+        /// </summary>
+        public static bool Enabled
+        {
+            get
+            {
+                return p4dn.Tracer.Enabled;
+            }
+        }
+
+        /// <summary>
+        /// Starts tracing, keeping the last <see cref="DefaultEventsPerThread"/> events on each thread.
+        /// </summary>
+        public static void Start()
+        {
+            Start(DefaultEventsPerThread);
+        }
+
+        /// <summary>
+        /// Starts tracing.
+        /// </summary>
+        /// <param name="eventsPerThread">Number of events kept per thread.</param>
+        /// <remarks>Changing the buffer size discards events that were already recorded.</remarks>
+        public static void Start(int eventsPerThread)
+        {
+            p4dn.Tracer.Start(eventsPerThread);
+        }
+
+        /// <summary>
+        /// Stops tracing.  Events already recorded are kept until <see cref="Clear"/> is called.
+        /// </summary>
+        public static void Stop()
+        {
+            p4dn.Tracer.Stop();
+        }
+
+        /// <summary>
+        /// Discards all recorded events.
+        /// </summary>
+        public static void Clear()
+        {
+            p4dn.Tracer.Clear();
+        }
+
+        /// <summary>
+        /// Writes the recorded events to a file in Chrome trace-event format.
+        /// </summary>
+        /// <param name="path">The file to create.</param>
+        public static void WriteChromeTrace(string path)
+        {
+            using (StreamWriter w = new StreamWriter(path, false, new UTF8Encoding(false)))
+            {
+                WriteChromeTrace(w);
+            }
+        }
+
+        /// <summary>
+        /// Writes the recorded events in Chrome trace-event format.
+        /// </summary>
+        /// <param name="writer">Destination.</param>
+        /// <remarks>Tracing does not need to be stopped; events recorded while writing may or may not be included.</remarks>
+        public static void WriteChromeTrace(TextWriter writer)
+        {
+            if (writer == null) throw new ArgumentNullException("writer");
+
+            CultureInfo ci = CultureInfo.InvariantCulture;
+            int pid = Process.GetCurrentProcess().Id;
+            double usPerTick = 1000000.0 / Stopwatch.Frequency;
+            bool first = true;
+
+            writer.Write("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+            foreach (p4dn.TraceBuffer buffer in p4dn.Tracer.GetBuffers())
+            {
+                // name the thread's track
+                string threadName = buffer.ThreadName;
+                if (threadName == null) threadName = "thread " + buffer.ThreadId.ToString(ci);
+                WriteSeparator(writer, ref first);
+                writer.Write(string.Format(ci, "{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":{0},\"tid\":{1},\"args\":{{\"name\":", pid, buffer.ThreadId));
+                P4PerformanceCounters.WriteJsonString(writer, threadName);
+                writer.Write("}}");
+
+                foreach (p4dn.TraceEvent e in buffer.Snapshot())
+                {
+                    WriteSeparator(writer, ref first);
+                    writer.Write("{\"name\":");
+                    P4PerformanceCounters.WriteJsonString(writer, e.Point.ToString());
+                    writer.Write(string.Format(ci, ",\"cat\":\"{0}\",\"pid\":{1},\"tid\":{2},\"ts\":{3:0.###}",
+                        GetCategory(e.Point), pid, buffer.ThreadId, e.Start * usPerTick));
+                    if (e.Duration >= 0)
+                    {
+                        writer.Write(string.Format(ci, ",\"ph\":\"X\",\"dur\":{0:0.###}", e.Duration * usPerTick));
+                    }
+                    else
+                    {
+                        writer.Write(",\"ph\":\"i\",\"s\":\"t\"");
+                    }
+                    if (e.Detail != null)
+                    {
+                        writer.Write(",\"args\":{\"detail\":");
+                        P4PerformanceCounters.WriteJsonString(writer, e.Detail);
+                        writer.Write('}');
+                    }
+                    writer.Write('}');
+                }
+            }
+            writer.Write("]}");
+            writer.Flush();
+        }
+
+        private static void WriteSeparator(TextWriter writer, ref bool first)
+        {
+            if (!first) writer.Write(',');
+            first = false;
+        }
+
+        private static string GetCategory(p4dn.TracePoint point)
+        {
+            switch (point)
+            {
+                case p4dn.TracePoint.Init:
+                case p4dn.TracePoint.Run:
+                case p4dn.TracePoint.Final:
+                    return "clientapi";
+                case p4dn.TracePoint.Connect:
+                case p4dn.TracePoint.Reconnect:
+                case p4dn.TracePoint.Disconnect:
+                    return "connection";
+                case p4dn.TracePoint.Managed:
+                    return "managed";
+                default:
+                    return "callback";
+            }
+        }
+    }
+}
@@ -0,0 +1,443 @@
+/*
+ * P4.Net *
+Copyright (c) 2007-2010 Shawn Hladky
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+and associated documentation files (the "Software"), to deal in the Software without 
+restriction, including without limitation the rights to use, copy, modify, merge, publish, 
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or 
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+ */
+
+
+using System;
+using System.Collections.Generic;
+using System.Globalization;
+
+namespace P4API
+{
+    /// <summary>
+    /// Local copy of a workspace's file states (have and head revision, open action, digest), refreshed incrementally.
+    /// </summary>
+    /// <remarks>
+    /// <para><see cref="Load"/> fills the cache with one streaming fstat of the whole workspace.  After that,
+    /// <see cref="Refresh"/> only asks for what can have changed: files with revisions submitted since the last change
+    /// seen, the workspace's opened files, and any paths passed to <see cref="Invalidate"/>.  Lookups never go to the
+    /// server.</para>
+    /// <para>Syncing doesn't show up in either of those, so call <see cref="Invalidate"/> for the paths your tool
+    /// syncs (or reverts, or resolves), or Load again.</para>
+    /// <para>States are kept in parallel arrays sorted by depot path (ignoring case on a case-insensitive server, as
+    /// the server does), with a second ordering by local path built on first use.  All members are thread safe; the connection is used only by Load and Refresh.</para>
+    /// </remarks>
+    public class P4WorkspaceState
+    {
+        private sealed class StatCallback : P4Callback
+        {
+            private readonly P4WorkspaceState _owner;
+            private readonly bool _opened;
+            public string FirstError = null;
+
+            public StatCallback(P4WorkspaceState owner, bool opened)
+            {
+                _owner = owner;
+                _opened = opened;
+            }
+
+            public override void OutputRecord(P4Record record)
+            {
+                _owner.Upsert(record, _opened);
+            }
+
+            public override void OutputMessage(P4Message message)
+            {
+                // "no such file(s)" and friends are warnings; only real failures count
+                if (FirstError == null && message.Severity >= P4MessageSeverity.Failed) FirstError = message.Format();
+            }
+
+            internal override bool PollsCancel
+            {
+                get { return false; }
+            }
+        }
+
+        private readonly object _lock = new object();
+        private readonly P4Connection _connection;
+        private string _clientRoot;
+        private int _lastChange = -1;
+        private StringComparer _depotComparer = StringComparer.Ordinal;
+        private StringComparison _depotComparison = StringComparison.Ordinal;
+
+        // parallel, sorted by depot path
+        private List<string> _depot = new List<string>();
+        private List<string> _local = new List<string>();
+        private List<int> _have = new List<int>();
+        private List<int> _head = new List<int>();
+        private List<byte> _action = new List<byte>();
+        private List<byte[]> _digest = new List<byte[]>();
+
+        // opened actions are few; entry 0 is "not opened"
+        private readonly List<string> _actions = new List<string>(new string[] { null });
+        private int[] _byLocal = null;
+        private readonly List<string> _invalidated = new List<string>();
+
+        /// <summary>
+        /// Initializes a new instance of the <see cref="P4WorkspaceState"/> class for the connection's client workspace.
+        /// </summary>
+        /// <param name="connection">Connection with Client set.  Load and Refresh use it; nothing else does.</param>
+        public P4WorkspaceState(P4Connection connection)
+        {
+            if (connection == null) throw new ArgumentNullException("connection");
+            _connection = connection;
+        }
+
+        #region Public Properties
+        /// <summary>
+        /// Gets the number of files in the cache.
+        /// </summary>
+        public int Count
+        {
+            get
+            {
+                lock (_lock)
+                {
+                    return _depot.Count;
+                }
+            }
+        }
+
+        /// <summary>
+        /// Gets the last submitted change the cache has caught up with, or -1 before Load.
+        /// </summary>
+        public int LastChange
+        {
+            get
+            {
+                lock (_lock)
+                {
+                    return _lastChange;
+                }
+            }
+        }
+        #endregion
+
+        #region Public Methods
+        /// <summary>
+        /// Throws away the cache and reloads the whole workspace with one streaming fstat.
+        /// </summary>
+        public void Load()
+        {
+            lock (_lock)
+            {
+                _clientRoot = "//" + _connection.Client + "/...";
+
+                // read the change first, so a submit during the fstat is picked up again by Refresh
+                int last = GetLastChange();
+
+                // sort the way the server streams fstat, or every insert lands mid-list
+                bool caseSensitive = _connection.IsServerCaseSensitive();
+                _depotComparer = caseSensitive ? StringComparer.Ordinal : StringComparer.OrdinalIgnoreCase;
+                _depotComparison = caseSensitive ? StringComparison.Ordinal : StringComparison.OrdinalIgnoreCase;
+
+                _depot = new List<string>();
+                _local = new List<string>();
+                _have = new List<int>();
+                _head = new List<int>();
+                _action = new List<byte>();
+                _digest = new List<byte[]>();
+                _byLocal = null;
+                _invalidated.Clear();
+
+                Stat(false, "-Ol", _clientRoot);
+                _lastChange = last;
+            }
+        }
+
+        /// <summary>
+        /// Brings the cache up to date with new submits, the opened files, and invalidated paths.
+        /// </summary>
+        public void Refresh()
+        {
+            lock (_lock)
+            {
+                if (_lastChange < 0)
+                {
+                    Load();
+                    return;
+                }
+
+                int last = GetLastChange();
+                if (last > _lastChange)
+                {
+                    Stat(false, "-Ol", string.Format(CultureInfo.InvariantCulture, "{0}@{1},@{2}", _clientRoot, _lastChange + 1, last));
+                }
+
+                foreach (string path in _invalidated)
+                {
+                    Stat(false, "-Ol", path);
+                }
+                _invalidated.Clear();
+
+                // opened is the whole truth about actions
+                for (int i = 0; i < _action.Count; i++)
+                {
+                    _action[i] = 0;
+                }
+                Stat(true, "-Ro", "-Ol", _clientRoot);
+
+                _lastChange = last;
+            }
+        }
+
+        /// <summary>
+        /// Marks paths to be read again by the next Refresh, e.g. after syncing them.
+        /// </summary>
+        /// <param name="paths">Depot, client or local paths (wildcards allowed).</param>
+        public void Invalidate(params string[] paths)
+        {
+            if (paths == null) throw new ArgumentNullException("paths");
+            lock (_lock)
+            {
+                foreach (string p in paths)
+                {
+                    if (p == null) throw new ArgumentNullException("paths");
+                    if (!_invalidated.Contains(p)) _invalidated.Add(p);
+                }
+            }
+        }
+
+        /// <summary>
+        /// Gets a file's state by depot path.
+        /// </summary>
+        /// <param name="depotFile">The depot path.</param>
+        /// <returns>The state, or null if the file isn't in the workspace.</returns>
+        public P4FileState GetByDepotPath(string depotFile)
+        {
+            lock (_lock)
+            {
+                int i = _depot.BinarySearch(depotFile, _depotComparer);
+                return (i < 0) ? null : Get(i);
+            }
+        }
+
+        /// <summary>
+        /// Gets a file's state by local path.
+        /// </summary>
+        /// <param name="localFile">The local path.</param>
+        /// <returns>The state, or null if the file isn't in the workspace.</returns>
+        public P4FileState GetByLocalPath(string localFile)
+        {
+            lock (_lock)
+            {
+                int[] order = GetLocalOrder();
+                int n = LowerBound(order.Length, delegate(int k) { return CompareLocal(_local[order[k]], localFile); });
+                if (n < order.Length && CompareLocal(_local[order[n]], localFile) == 0) return Get(order[n]);
+                return null;
+            }
+        }
+
+        /// <summary>
+        /// Gets the states of all files under a depot folder.
+        /// </summary>
+        /// <param name="depotFolder">The folder, e.g. //depot/main/src/ (a trailing ... is ignored).</param>
+        /// <returns>The states, sorted by depot path.</returns>
+        public P4FileState[] GetUnderDepotPath(string depotFolder)
+        {
+            string prefix = TrimWildcard(depotFolder);
+            lock (_lock)
+            {
+                List<P4FileState> ret = new List<P4FileState>();
+                int n = LowerBound(_depot.Count, delegate(int k) { return _depotComparer.Compare(_depot[k], prefix); });
+                for (; n < _depot.Count && _depot[n].StartsWith(prefix, _depotComparison); n++)
+                {
+                    ret.Add(Get(n));
+                }
+                return ret.ToArray();
+            }
+        }
+
+        /// <summary>
+        /// Gets the states of all files under a local folder.
+        /// </summary>
+        /// <param name="localFolder">The folder, e.g. C:\ws\main\src\.</param>
+        /// <returns>The states, sorted by local path.</returns>
+        public P4FileState[] GetUnderLocalPath(string localFolder)
+        {
+            lock (_lock)
+            {
+                int[] order = GetLocalOrder();
+                List<P4FileState> ret = new List<P4FileState>();
+                int n = LowerBound(order.Length, delegate(int k) { return CompareLocal(_local[order[k]], localFolder); });
+                for (; n < order.Length && _local[order[n]].StartsWith(localFolder, StringComparison.OrdinalIgnoreCase); n++)
+                {
+                    ret.Add(Get(order[n]));
+                }
+                return ret.ToArray();
+            }
+        }
+
+        /// <summary>
+        /// Gets the states of the opened files.
+        /// </summary>
+        /// <returns>The states, sorted by depot path.</returns>
+        public P4FileState[] GetOpened()
+        {
+            lock (_lock)
+            {
+                List<P4FileState> ret = new List<P4FileState>();
+                for (int i = 0; i < _action.Count; i++)
+                {
+                    if (_action[i] != 0) ret.Add(Get(i));
+                }
+                return ret.ToArray();
+            }
+        }
+        #endregion
+
+        #region Private Helper Methods
+        private delegate int Probe(int index);
+
+        // First index whose probe is >= 0.
+        private static int LowerBound(int count, Probe compare)
+        {
+            int lo = 0, hi = count;
+            while (lo < hi)
+            {
+                int mid = lo + (hi - lo) / 2;
+                if (compare(mid) < 0) lo = mid + 1; else hi = mid;
+            }
+            return lo;
+        }
+
+        private static int CompareLocal(string a, string b)
+        {
+            // local paths are case-insensitive on Windows, where P4.Net runs
+            return string.Compare(a, b, StringComparison.OrdinalIgnoreCase);
+        }
+
+        private int[] GetLocalOrder()
+        {
+            if (_byLocal == null)
+            {
+                int[] order = new int[_local.Count];
+                for (int i = 0; i < order.Length; i++)
+                {
+                    order[i] = i;
+                }
+                List<string> local = _local;
+                Array.Sort(order, delegate(int a, int b) { return CompareLocal(local[a], local[b]); });
+                _byLocal = order;
+            }
+            return _byLocal;
+        }
+
+        private int GetLastChange()
+        {
+            P4RecordSet r = _connection.Run("changes", "-m1", "-s", "submitted");
+            return (r.Records.Length == 0) ? 0 : int.Parse(r.Records[0].Fields["change"], CultureInfo.InvariantCulture);
+        }
+
+        private void Stat(bool opened, params string[] args)
+        {
+            StatCallback cb = new StatCallback(this, opened);
+            _connection.RunCallback(cb, "fstat", args);
+            if (cb.FirstError != null) throw new InvalidOperationException("fstat failed: " + cb.FirstError);
+        }
+
+        // Called with _lock held, from the fstat callback.
+        private void Upsert(P4Record r, bool opened)
+        {
+            string depotFile = r.Fields["depotFile"];
+            if (depotFile == null) return;
+
+            int i = _depot.BinarySearch(depotFile, _depotComparer);
+            if (i < 0)
+            {
+                // a fresh Load streams in depot order, so this is nearly always an append
+                i = ~i;
+                _depot.Insert(i, depotFile);
+                _local.Insert(i, r.Fields["clientFile"] ?? string.Empty);
+                _have.Insert(i, 0);
+                _head.Insert(i, 0);
+                _action.Insert(i, 0);
+                _digest.Insert(i, null);
+                _byLocal = null;
+            }
+            else if (r.Fields["clientFile"] != null && r.Fields["clientFile"] != _local[i])
+            {
+                _local[i] = r.Fields["clientFile"];
+                _byLocal = null;
+            }
+
+            _have[i] = ParseRev(r.Fields["haveRev"]);
+            _head[i] = ParseRev(r.Fields["headRev"]);
+            _digest[i] = ParseDigest(r.Fields["digest"]);
+
+            string action = r.Fields["action"];
+            if (action != null || opened)
+            {
+                _action[i] = GetActionCode(action);
+            }
+        }
+
+        private byte GetActionCode(string action)
+        {
+            int code = _actions.IndexOf(action);
+            if (code < 0)
+            {
+                if (_actions.Count > byte.MaxValue) throw new InvalidOperationException("Too many distinct actions.");
+                _actions.Add(action);
+                code = _actions.Count - 1;
+            }
+            return (byte)code;
+        }
+
+        private P4FileState Get(int i)
+        {
+            byte[] d = _digest[i];
+            string digest = null;
+            if (d != null)
+            {
+                System.Text.StringBuilder sb = new System.Text.StringBuilder(d.Length * 2);
+                foreach (byte b in d)
+                {
+                    sb.Append(b.ToString("X2"));
+                }
+                digest = sb.ToString();
+            }
+            return new P4FileState(_depot[i], _local[i], _have[i], _head[i], _actions[_action[i]], digest);
+        }
+
+        private static int ParseRev(string rev)
+        {
+            int n;
+            return (rev != null && int.TryParse(rev, NumberStyles.None, CultureInfo.InvariantCulture, out n)) ? n : 0;
+        }
+
+        // 32 hex digits -> 16 bytes; anything else isn't kept
+        private static byte[] ParseDigest(string hex)
+        {
+            if (hex == null || hex.Length != 32) return null;
+            byte[] ret = new byte[16];
+            for (int i = 0; i < 16; i++)
+            {
+                if (!byte.TryParse(hex.Substring(i * 2, 2), NumberStyles.HexNumber, CultureInfo.InvariantCulture, out ret[i])) return null;
+            }
+            return ret;
+        }
+
+        private static string TrimWildcard(string path)
+        {
+            return path.EndsWith("...") ? path.Substring(0, path.Length - 3) : path;
+        }
+        #endregion
+    }
+}
@@ -1,64 +1,64 @@
-/*
- * P4.Net *
-Copyright (c) 2007-2010 Shawn Hladky
-
-Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
-and associated documentation files (the "Software"), to deal in the Software without 
-restriction, including without limitation the rights to use, copy, modify, merge, publish, 
-distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
-Software is furnished to do so, subject to the following conditions:
-
-The above copyright notice and this permission notice shall be included in all copies or 
-substantial portions of the Software.
-
-THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
-BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
-NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
-DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
-OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
- */
-
-
-using System;
-using System.IO;
-using System.Text;
-
-namespace P4API
-{
-
-    internal class PrintStreamHelper
-    {
-        private Encoding _printEncoding;
-        private P4Connection _p4;
-        private Stream _printStream;
-        private int _filesPrinted = 0;
-
-        public PrintStreamHelper(P4Connection p4)
-        {
-            _p4 = p4;
-        }
-        public int PrintStream(Stream stream, string filePath, Encoding encoding)
-        {
-            _printStream = stream;
-            _printEncoding = encoding;
-            OnPrintStreamEventHandler eh = new OnPrintStreamEventHandler(PrintStreamOnPrint);
-            _p4.OnPrintStream += eh;
-            _p4.PrintStreamEvents(filePath);
-            _p4.OnPrintStream -= eh;
-            _printStream = null;
-            _printEncoding = null;
-            return _filesPrinted;
-        }
-        private void PrintStreamOnPrint(P4PrintStreamEventArgs e, out Stream s)
-        {
-            _filesPrinted++;
-            if (_printEncoding != null)
-            {
-                e.TextEncoding = _printEncoding;
-                e.UnicodeEncoding = _printEncoding;
-            }
-            s = _printStream;
-        }
-    }
-
-}
+/*
+ * P4.Net *
+Copyright (c) 2007-2010 Shawn Hladky
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+and associated documentation files (the "Software"), to deal in the Software without 
+restriction, including without limitation the rights to use, copy, modify, merge, publish, 
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or 
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+ */
+
+
+using System;
+using System.IO;
+using System.Text;
+
+namespace P4API
+{
+
+    internal class PrintStreamHelper
+    {
+        private Encoding _printEncoding;
+        private P4Connection _p4;
+        private Stream _printStream;
+        private int _filesPrinted = 0;
+
+        public PrintStreamHelper(P4Connection p4)
+        {
+            _p4 = p4;
+        }
+        public int PrintStream(Stream stream, string filePath, Encoding encoding)
+        {
+            _printStream = stream;
+            _printEncoding = encoding;
+            OnPrintStreamEventHandler eh = new OnPrintStreamEventHandler(PrintStreamOnPrint);
+            _p4.OnPrintStream += eh;
+            _p4.PrintStreamEvents(filePath);
+            _p4.OnPrintStream -= eh;
+            _printStream = null;
+            _printEncoding = null;
+            return _filesPrinted;
+        }
+        private void PrintStreamOnPrint(P4PrintStreamEventArgs e, out Stream s)
+        {
+            _filesPrinted++;
+            if (_printEncoding != null)
+            {
+                e.TextEncoding = _printEncoding;
+                e.UnicodeEncoding = _printEncoding;
+            }
+            s = _printStream;
+        }
+    }
+
+}
@@ -0,0 +1,145 @@
+/*
+ * P4.Net *
+Copyright (c) 2007-2010 Shawn Hladky
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+and associated documentation files (the "Software"), to deal in the Software without 
+restriction, including without limitation the rights to use, copy, modify, merge, publish, 
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or 
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+ */
+
+
+#include "StdAfx.h"
+#include "BridgeBenchmark_m.h"
+#include "ClientUserDelegate.h"
+#include "strtable.h"
+
+p4dn::BridgeBenchmark::BridgeBenchmark( p4dn::ClientUser^ ui, System::Text::Encoding^ encoding )
+{
+	_encoding = encoding;
+	_cud = new ClientUserDelegate( ui, encoding );
+	_record = new StrBufDict();
+	_message = new ::Error();
+	_messageFormat = new StrBuf();
+	_info = new StrBuf();
+	_content = new StrBuf();
+	_recordBytes = 0;
+}
+
+p4dn::BridgeBenchmark::~BridgeBenchmark()
+{
+	this->!BridgeBenchmark();
+}
+
+p4dn::BridgeBenchmark::!BridgeBenchmark()
+{
+	if ( _cud != NULL ) delete _cud;
+	if ( _record != NULL ) delete _record;
+	if ( _message != NULL ) delete _message;
+	if ( _messageFormat != NULL ) delete _messageFormat;
+	if ( _info != NULL ) delete _info;
+	if ( _content != NULL ) delete _content;
+	_cud = NULL;
+	_record = NULL;
+	_message = NULL;
+	_messageFormat = NULL;
+	_info = NULL;
+	_content = NULL;
+}
+
+void p4dn::BridgeBenchmark::SetRecord( array<System::String^>^ keys, array<System::String^>^ values )
+{
+	_record->Clear();
+	_recordBytes = 0;
+	for ( int i = 0; i < keys->Length; i++ )
+	{
+		StrBuf k, v;
+		P4String::StringToStrBuf( &k, keys[i], _encoding );
+		P4String::StringToStrBuf( &v, values[i], _encoding );
+		_record->SetVar( k, v );
+		_recordBytes += k.Length() + v.Length();
+	}
+}
+
+void p4dn::BridgeBenchmark::OutputStatLoop( int iterations )
+{
+	for ( int i = 0; i < iterations; i++ ) _cud->OutputStat( _record );
+}
+
+void p4dn::BridgeBenchmark::SetMessage( int severity, System::String^ format, array<System::String^>^ values )
+{
+	// the ErrorId only points at the format, so it lives in _messageFormat
+	P4String::StringToStrBuf( _messageFormat, format, _encoding );
+	ErrorId id;
+	id.code = ErrorOf( ES_CLIENT, 1, severity, EV_NONE, values->Length );
+	id.fmt = _messageFormat->Text();
+
+	_message->Clear();
+	_message->Set( id );
+	for ( int i = 0; i < values->Length; i++ )
+	{
+		StrBuf v;
+		P4String::StringToStrBuf( &v, values[i], _encoding );
+		*_message << v;
+	}
+}
+
+void p4dn::BridgeBenchmark::MessageLoop( int iterations )
+{
+	for ( int i = 0; i < iterations; i++ ) _cud->Message( _message );
+}
+
+void p4dn::BridgeBenchmark::SetInfo( System::String^ line )
+{
+	P4String::StringToStrBuf( _info, line, _encoding );
+}
+
+void p4dn::BridgeBenchmark::OutputInfoLoop( int iterations )
+{
+	for ( int i = 0; i < iterations; i++ ) _cud->OutputInfo( '0', _info->Text() );
+}
+
+void p4dn::BridgeBenchmark::SetContent( array<System::Byte>^ chunk )
+{
+	_content->Clear();
+	if ( chunk->Length == 0 ) return;
+	pin_ptr<System::Byte> p = &chunk[0];
+	_content->Set( (const char *)p, chunk->Length );
+}
+
+void p4dn::BridgeBenchmark::OutputTextLoop( int iterations )
+{
+	for ( int i = 0; i < iterations; i++ ) _cud->OutputText( _content->Text(), _content->Length() );
+}
+
+void p4dn::BridgeBenchmark::OutputBinaryLoop( int iterations )
+{
+	for ( int i = 0; i < iterations; i++ ) _cud->OutputBinary( _content->Text(), _content->Length() );
+}
+
+void p4dn::BridgeBenchmark::EncodeLoop( System::String^ s, System::Text::Encoding^ encoding, int iterations )
+{
+	StrBuf b;
+	for ( int i = 0; i < iterations; i++ ) P4String::StringToStrBuf( &b, s, encoding );
+}
+
+void p4dn::BridgeBenchmark::DecodeLoop( array<System::Byte>^ bytes, System::Text::Encoding^ encoding, int iterations )
+{
+	StrBuf b;
+	if ( bytes->Length > 0 )
+	{
+		pin_ptr<System::Byte> p = &bytes[0];
+		b.Set( (const char *)p, bytes->Length );
+	}
+	for ( int i = 0; i < iterations; i++ ) P4String::StrPtrToString( &b, encoding );
+}
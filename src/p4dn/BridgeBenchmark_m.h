@@ -0,0 +1,77 @@
+/*
+ * P4.Net *
+Copyright (c) 2007-2010 Shawn Hladky
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+and associated documentation files (the "Software"), to deal in the Software without 
+restriction, including without limitation the rights to use, copy, modify, merge, publish, 
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or 
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+ */
+
+
+#pragma once
+
+#include "StdAfx.h"
+#include "ClientUser_m.h"
+#include <vcclr.h>
+
+class ClientUserDelegate;
+class StrBufDict;
+
+namespace p4dn {
+
+	//================================================================
+	// Drives a ClientUserDelegate with synthetic server output so the
+	// cost of the bridge can be measured without a server.  Each SetXxx
+	// builds the native input once; each XxxLoop replays it.
+	//
+	public ref class BridgeBenchmark
+	{
+	public:
+		BridgeBenchmark( p4dn::ClientUser^ ui, System::Text::Encoding^ encoding );
+		~BridgeBenchmark();
+		!BridgeBenchmark();
+
+		// tagged record, as the p4api would pass to OutputStat
+		void SetRecord( array<System::String^>^ keys, array<System::String^>^ values );
+		void OutputStatLoop( int iterations );
+
+		// message with %name% variables in the format
+		void SetMessage( int severity, System::String^ format, array<System::String^>^ values );
+		void MessageLoop( int iterations );
+
+		void SetInfo( System::String^ line );
+		void OutputInfoLoop( int iterations );
+
+		void SetContent( array<System::Byte>^ chunk );
+		void OutputTextLoop( int iterations );
+		void OutputBinaryLoop( int iterations );
+
+		// size of the current record as the p4api holds it (keys + values)
+		property int RecordBytes { int get() { return _recordBytes; } }
+
+		// P4String conversions in isolation
+		static void EncodeLoop( System::String^ s, System::Text::Encoding^ encoding, int iterations );
+		static void DecodeLoop( array<System::Byte>^ bytes, System::Text::Encoding^ encoding, int iterations );
+
+	private:
+		ClientUserDelegate*	_cud;
+		StrBufDict*			_record;
+		::Error*			_message;
+		StrBuf*				_messageFormat;
+		StrBuf*				_info;
+		StrBuf*				_content;
+		System::Text::Encoding^ _encoding;
+		int					_recordBytes;
+	};
+}
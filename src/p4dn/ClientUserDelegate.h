@@ -1,59 +1,102 @@
-/*
- * P4.Net *
-Copyright (c) 2007-2010 Shawn Hladky
-
-Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
-and associated documentation files (the "Software"), to deal in the Software without 
-restriction, including without limitation the rights to use, copy, modify, merge, publish, 
-distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
-Software is furnished to do so, subject to the following conditions:
-
-The above copyright notice and this permission notice shall be included in all copies or 
-substantial portions of the Software.
-
-THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
-BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
-NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
-DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
-OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
- */
-
-
-#pragma once
-#include "StdAfx.h"
-#include "Error_m.h"
-#include "ClientUser_m.h"
-#include <vcclr.h>
-
-//================================================================
-// wrapper for callbacks into into the ClienUser class
-//
-//
-// Implements callbacks to interface the clientapi with the .NET interface
-//================================================================
-class ClientUserDelegate : public ::ClientUser 
-{
-	private:
-		gcroot<p4dn::ClientUser^> mcu;
-		gcroot<System::Text::Encoding^> _encoding;
-	public:            
-		ClientUserDelegate( gcroot<p4dn::ClientUser^> ManagedClientUser, gcroot<System::Text::Encoding^> encoding );
-		~ClientUserDelegate();
-		void InputData( StrBuf *strbuf, ::Error *e );
-		void HandleError( ::Error *err );
-		void Message( ::Error *err );
-		void OutputError( const_char *errBuf );
-		void OutputInfo( char level, const_char *data );
-		void OutputBinary( const_char *data, int length );
-		void OutputText( const_char *data, int length );
-		void OutputStat( StrDict *varList );
-		void Prompt( const StrPtr &msg, StrBuf &rsp, int noEcho, ::Error *e );
-		void ErrorPause( char *errBuf, ::Error *e );
-		void Edit( FileSys *f1, ::Error *e );
-		void Diff( FileSys *f1, FileSys *f2, int doPage, char *diffFlags, ::Error *e );
-		void Merge( FileSys *base, FileSys *leg1, FileSys *leg2, FileSys *result, ::Error *e );
-		void Help( const_char *const *help );
-		FileSys *File( FileSysType type );
-		void Finished();
-		int	Resolve( ClientMerge *m, Error *e );
-};
+/*
+ * P4.Net *
+Copyright (c) 2007-2010 Shawn Hladky
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+and associated documentation files (the "Software"), to deal in the Software without 
+restriction, including without limitation the rights to use, copy, modify, merge, publish, 
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or 
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+ */
+
+
+#pragma once
+#include "StdAfx.h"
+#include "Error_m.h"
+#include "ClientUser_m.h"
+#include "MessageFilter_m.h"
+#include "RunCounters_m.h"
+#include "Tracer_m.h"
+#include "Session_m.h"
+#include "ValuePool_m.h"
+#include "RecordWriter_m.h"
+#include "JsonWriter_m.h"
+#include <vcclr.h>
+
+//================================================================
+// wrapper for callbacks into into the ClienUser class
+//
+//
+// Implements callbacks to interface the clientapi with the .NET interface
+//================================================================
+class ClientUserDelegate : public ::ClientUser 
+{
+	private:
+		gcroot<p4dn::ClientUser^> mcu;
+		gcroot<System::Text::Encoding^> _encoding;
+
+		// one wrapper is re-pointed at each callback's ::Error instead of allocating a new one
+		gcroot<p4dn::Error^> _error;
+		p4dn::Error^ WrapError( ::Error *err );
+		void ReleaseError();
+
+		// per-run copy of the connection's message filter, NULL when everything is delivered
+		p4dn::MessageFilterState* _filter;
+
+		// per-run performance counters, see RunCounters_m.h
+		p4dn::RunCountersState _counters;
+
+		// the "--- lapse" block from a command run with the track variable set
+		bool _tracking;
+		StrBuf _trackLines;
+		bool TakeTrackLine( const char *line );
+
+		// every callback is copied here first when the run is being recorded
+		p4dn::SessionTape* _tape;
+
+		// shares repeated keys and values between records, NULL when off
+		p4dn::ValuePool* _pool;
+
+		// tagged records are encoded here instead of being passed on, NULL when off
+		p4dn::RecordWriter* _writer;
+
+		// tagged records (and maybe messages) written as JSON lines, NULL when off
+		p4dn::JsonWriter* _json;
+	public:            
+		ClientUserDelegate( gcroot<p4dn::ClientUser^> ManagedClientUser, gcroot<System::Text::Encoding^> encoding );
+		~ClientUserDelegate();
+		void SetMessageFilter( const p4dn::MessageFilterState *filter );
+		p4dn::RunCountersState& Counters() { return _counters; }
+		void SetTracking( bool tracking ) { _tracking = tracking; }
+		const StrBuf& TrackLines() const { return _trackLines; }
+		void SetTape( p4dn::SessionTape *tape ) { _tape = tape; }
+		void SetValuePool( p4dn::ValuePool *pool ) { _pool = pool; }
+		void SetRecordWriter( p4dn::RecordWriter *writer ) { _writer = writer; }
+		void SetJsonWriter( p4dn::JsonWriter *json ) { _json = json; }
+		void InputData( StrBuf *strbuf, ::Error *e );
+		void HandleError( ::Error *err );
+		void Message( ::Error *err );
+		void OutputError( const_char *errBuf );
+		void OutputInfo( char level, const_char *data );
+		void OutputBinary( const_char *data, int length );
+		void OutputText( const_char *data, int length );
+		void OutputStat( StrDict *varList );
+		void Prompt( const StrPtr &msg, StrBuf &rsp, int noEcho, ::Error *e );
+		void ErrorPause( char *errBuf, ::Error *e );
+		void Edit( FileSys *f1, ::Error *e );
+		void Diff( FileSys *f1, FileSys *f2, int doPage, char *diffFlags, ::Error *e );
+		void Merge( FileSys *base, FileSys *leg1, FileSys *leg2, FileSys *result, ::Error *e );
+		void Help( const_char *const *help );
+		FileSys *File( FileSysType type );
+		void Finished();
+		int	Resolve( ClientMerge *m, Error *e );
+};
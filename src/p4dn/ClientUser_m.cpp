@@ -1,130 +1,130 @@
-/*
- * P4.Net *
-Copyright (c) 2007-2010 Shawn Hladky
-
-Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
-and associated documentation files (the "Software"), to deal in the Software without 
-restriction, including without limitation the rights to use, copy, modify, merge, publish, 
-distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
-Software is furnished to do so, subject to the following conditions:
-
-The above copyright notice and this permission notice shall be included in all copies or 
-substantial portions of the Software.
-
-THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
-BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
-NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
-DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
-OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
- */
-
-//
-// Copyright 2010 Jacob Gladish. All rights reserved.
-// 
-// Redistribution and use in source and binary forms, with or without modification, are
-// permitted provided that the following conditions are met:
-// 
-//    1. Redistributions of source code must retain the above copyright notice, this list of
-//       conditions and the following disclaimer.
-// 
-//    2. Redistributions in binary form must reproduce the above copyright notice, this list
-//       of conditions and the following disclaimer in the documentation and/or other materials
-//       provided with the distribution.
-// 
-// THIS SOFTWARE IS PROVIDED BY Jacob Gladish ``AS IS'' AND ANY EXPRESS OR IMPLIED
-// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
-// FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> OR
-// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
-// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
-// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
-// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
-// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
-// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
-// 
-// The views and conclusions contained in the software and documentation are those of the
-// authors and should not be interpreted as representing official policies, either expressed
-// or implied, of <copyright holder>.
-// 
-
-#include "StdAfx.h"
-#include "clientuser_m.h"
-
-using namespace System::Runtime::InteropServices;
-
-
-p4dn::ClientUser::ClientUser()
-{        
-}
-
-
-void p4dn::ClientUser::InputData( String^% s, p4dn::Error^ err )
-{     
-}
- 
-void p4dn::ClientUser::InputForm(Hashtable^% varList, String^% specdef, p4dn::Error^ err)
-{     
-}
-
-void p4dn::ClientUser::HandleError( p4dn::Error^ err )
-{
-}
-
-
-void p4dn::ClientUser::Message( p4dn::Error^ err )
-{                
-}
-
-void p4dn::ClientUser::OutputError( String^ s )
-{        
-}
-
-void p4dn::ClientUser::SetSpecDef(String^ SpecDef)
-{        
-}
-   
-void p4dn::ClientUser::OutputInfo( Char level, String^ s )
-{     
-}
-
-
-void p4dn::ClientUser::OutputContent(array<System::Byte>^ b , bool IsText)
-{
-}
-
-void p4dn::ClientUser::OutputStat( System::Collections::Generic::Dictionary<System::String^, System::String^>^  varList )
-{ 
-}
-
-
-void p4dn::ClientUser::Prompt( const String^ msg, 
-                               String^% rsp, 
-                               bool noEcho, 
-                               p4dn::Error^ err )
-{
-}
-
-void p4dn::ClientUser::ErrorPause(  System::String^ errBuf, p4dn::Error^ err )
-{    
-}
-
-void p4dn::ClientUser::Edit( System::IO::FileInfo^ info, p4dn::Error^ err )
-{       
-}
-
-void p4dn::ClientUser::Merge( System::IO::FileInfo^ base, 
-                              System::IO::FileInfo^ leg1, 
-                              System::IO::FileInfo^ leg2, 
-                              System::IO::FileInfo^ result, 
-                              p4dn::Error^ err )
-{
-}
-
-p4dn::P4MergeStatus p4dn::ClientUser::Resolve(P4MergeData^ mergeData)
-{
-	return P4MergeStatus::CMS_QUIT;
-}
-
-void p4dn::ClientUser::Help( System::String^ help )
-{
-    
-}
+/*
+ * P4.Net *
+Copyright (c) 2007-2010 Shawn Hladky
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+and associated documentation files (the "Software"), to deal in the Software without 
+restriction, including without limitation the rights to use, copy, modify, merge, publish, 
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or 
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+ */
+
+//
+// Copyright 2010 Jacob Gladish. All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+//    1. Redistributions of source code must retain the above copyright notice, this list of
+//       conditions and the following disclaimer.
+// 
+//    2. Redistributions in binary form must reproduce the above copyright notice, this list
+//       of conditions and the following disclaimer in the documentation and/or other materials
+//       provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY Jacob Gladish ``AS IS'' AND ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+// FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// 
+// The views and conclusions contained in the software and documentation are those of the
+// authors and should not be interpreted as representing official policies, either expressed
+// or implied, of <copyright holder>.
+// 
+
+#include "StdAfx.h"
+#include "clientuser_m.h"
+
+using namespace System::Runtime::InteropServices;
+
+
+p4dn::ClientUser::ClientUser()
+{        
+}
+
+
+void p4dn::ClientUser::InputData( String^% s, p4dn::Error^ err )
+{     
+}
+ 
+void p4dn::ClientUser::InputForm(Hashtable^% varList, String^% specdef, p4dn::Error^ err)
+{     
+}
+
+void p4dn::ClientUser::HandleError( p4dn::Error^ err )
+{
+}
+
+
+void p4dn::ClientUser::Message( p4dn::Error^ err )
+{                
+}
+
+void p4dn::ClientUser::OutputError( String^ s )
+{        
+}
+
+void p4dn::ClientUser::SetSpecDef(String^ SpecDef)
+{        
+}
+   
+void p4dn::ClientUser::OutputInfo( Char level, String^ s )
+{     
+}
+
+
+void p4dn::ClientUser::OutputContent(array<System::Byte>^ b , bool IsText)
+{
+}
+
+void p4dn::ClientUser::OutputStat( System::Collections::Generic::Dictionary<System::String^, System::String^>^  varList )
+{ 
+}
+
+
+void p4dn::ClientUser::Prompt( const String^ msg, 
+                               String^% rsp, 
+                               bool noEcho, 
+                               p4dn::Error^ err )
+{
+}
+
+void p4dn::ClientUser::ErrorPause(  System::String^ errBuf, p4dn::Error^ err )
+{    
+}
+
+void p4dn::ClientUser::Edit( System::IO::FileInfo^ info, p4dn::Error^ err )
+{       
+}
+
+void p4dn::ClientUser::Merge( System::IO::FileInfo^ base, 
+                              System::IO::FileInfo^ leg1, 
+                              System::IO::FileInfo^ leg2, 
+                              System::IO::FileInfo^ result, 
+                              p4dn::Error^ err )
+{
+}
+
+p4dn::P4MergeStatus p4dn::ClientUser::Resolve(P4MergeData^ mergeData)
+{
+	return P4MergeStatus::CMS_QUIT;
+}
+
+void p4dn::ClientUser::Help( System::String^ help )
+{
+    
+}
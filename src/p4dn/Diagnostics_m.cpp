@@ -0,0 +1,241 @@
+/*
+ * P4.Net *
+Copyright (c) 2007-2010 Shawn Hladky
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+and associated documentation files (the "Software"), to deal in the Software without 
+restriction, including without limitation the rights to use, copy, modify, merge, publish, 
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or 
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+ */
+
+
+#include "StdAfx.h"
+#include "Diagnostics_m.h"
+
+using namespace System::Threading;
+
+p4dn::DebugCapture::DebugCapture( int capacity )
+{
+	_lines = new Line[ capacity ];
+	_capacity = capacity;
+	_first = 0;
+	_count = 0;
+	_dropped = 0;
+	_enabled = true;
+	_owner = 0;
+	_lock = gcnew System::Object();
+}
+
+p4dn::DebugCapture::~DebugCapture()
+{
+	delete [] _lines;
+	delete _lock;
+}
+
+::StrBuf *p4dn::DebugCapture::Buffer()
+{
+	// P4Debug::printf asks for the one process-wide buffer, formats into it
+	// and then calls Output; keep other threads out of it until then
+	int me = Thread::CurrentThread->ManagedThreadId;
+	if ( _owner != me )
+	{
+		Monitor::Enter( _lock );
+		_owner = me;
+	}
+	return P4DebugConfig::Buffer();
+}
+
+void p4dn::DebugCapture::Output()
+{
+	// normally Buffer took the lock already
+	if ( _owner != Thread::CurrentThread->ManagedThreadId )
+		Monitor::Enter( _lock );
+
+	try
+	{
+		if ( buf && _enabled )
+		{
+			const char *p = buf->Text();
+			const char *end = p + buf->Length();
+			while ( p < end )
+			{
+				const char *nl = p;
+				while ( nl < end && *nl != '\n' ) nl++;
+				int len = (int)( nl - p );
+				if ( len > 0 && p[len - 1] == '\r' ) len--;
+				if ( len > 0 ) Add( p, len );
+				p = nl + 1;
+			}
+		}
+		if ( buf ) buf->Clear();
+	}
+	finally
+	{
+		_owner = 0;
+		Monitor::Exit( _lock );
+	}
+}
+
+void p4dn::DebugCapture::Add( const char *text, int length )
+{
+	__int64 now = System::DateTime::UtcNow.Ticks;
+
+	Monitor::Enter( _lock );
+	try
+	{
+		int slot;
+		if ( _count == _capacity )
+		{
+			slot = _first;
+			_first = ( _first + 1 ) % _capacity;
+			_dropped++;
+		}
+		else
+		{
+			slot = ( _first + _count ) % _capacity;
+			_count++;
+		}
+		_lines[slot].timestamp = now;
+		_lines[slot].text.Set( text, length );
+	}
+	finally
+	{
+		Monitor::Exit( _lock );
+	}
+}
+
+void p4dn::DebugCapture::Resize( int capacity )
+{
+	Monitor::Enter( _lock );
+	try
+	{
+		Line *lines = new Line[ capacity ];
+		int keep = _count < capacity ? _count : capacity;
+		int skip = _count - keep;
+		for ( int i = 0; i < keep; i++ )
+		{
+			Line &l = _lines[ ( _first + skip + i ) % _capacity ];
+			lines[i].timestamp = l.timestamp;
+			lines[i].text.Set( l.text );
+		}
+		delete [] _lines;
+		_lines = lines;
+		_dropped += skip;
+		_capacity = capacity;
+		_first = 0;
+		_count = keep;
+	}
+	finally
+	{
+		Monitor::Exit( _lock );
+	}
+}
+
+void p4dn::DebugCapture::Take( int i, __int64 &timestamp, StrBuf *&text )
+{
+	Line &l = _lines[ ( _first + i ) % _capacity ];
+	timestamp = l.timestamp;
+	text = &l.text;
+}
+
+void p4dn::DebugCapture::Clear()
+{
+	_first = 0;
+	_count = 0;
+}
+
+void p4dn::DebugLog::SetLevel( System::String^ setting )
+{
+	StrBuf s;
+	P4String::StringToStrBuf( &s, setting, System::Text::Encoding::ASCII );
+	p4debug.SetLevel( s.Text() );
+}
+
+int p4dn::DebugLog::GetLevel( int debugType )
+{
+	if ( debugType < 0 || debugType >= DT_LAST ) throw gcnew System::ArgumentOutOfRangeException( "debugType" );
+	return p4debug.GetLevel( (P4DebugType)debugType );
+}
+
+void p4dn::DebugLog::SetTunable( System::String^ setting )
+{
+	StrBuf s;
+	P4String::StringToStrBuf( &s, setting, System::Text::Encoding::ASCII );
+	p4tunable.Set( s.Text() );
+}
+
+System::String^ p4dn::DebugLog::ShowLevels( bool showAll )
+{
+	StrBuf s;
+	p4debug.ShowLevels( showAll ? 1 : 0, s );
+	return P4String::StrPtrToString( &s, System::Text::Encoding::ASCII );
+}
+
+void p4dn::DebugLog::StartCapture( int capacity )
+{
+	if ( capacity <= 0 ) throw gcnew System::ArgumentOutOfRangeException( "capacity" );
+
+	if ( _capture == NULL )
+	{
+		_capture = new DebugCapture( capacity );
+		_capture->Install();
+	}
+	else if ( _capture->Capacity() != capacity )
+	{
+		_capture->Resize( capacity );
+	}
+	_capture->SetEnabled( true );
+}
+
+void p4dn::DebugLog::StopCapture()
+{
+	// p4debug keeps a pointer to the installed config, so it is never
+	// deleted; it just discards output from here on
+	if ( _capture != NULL ) _capture->SetEnabled( false );
+}
+
+bool p4dn::DebugLog::Capturing::get()
+{
+	return _capture != NULL && _capture->IsEnabled();
+}
+
+System::Int64 p4dn::DebugLog::Dropped::get()
+{
+	return _capture == NULL ? 0 : _capture->Dropped();
+}
+
+array<p4dn::DebugLine>^ p4dn::DebugLog::Drain()
+{
+	if ( _capture == NULL ) return gcnew array<DebugLine>( 0 );
+
+	Monitor::Enter( _capture->Lock() );
+	try
+	{
+		int count = _capture->Count();
+		array<DebugLine>^ ret = gcnew array<DebugLine>( count );
+		for ( int i = 0; i < count; i++ )
+		{
+			__int64 ticks;
+			StrBuf *text;
+			_capture->Take( i, ticks, text );
+			ret[i].Timestamp = System::DateTime( ticks, System::DateTimeKind::Utc );
+			ret[i].Text = P4String::StrPtrToString( text, System::Text::Encoding::Default );
+		}
+		_capture->Clear();
+		return ret;
+	}
+	finally
+	{
+		Monitor::Exit( _capture->Lock() );
+	}
+}
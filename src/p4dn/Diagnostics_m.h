@@ -0,0 +1,112 @@
+/*
+ * P4.Net *
+Copyright (c) 2007-2010 Shawn Hladky
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+and associated documentation files (the "Software"), to deal in the Software without 
+restriction, including without limitation the rights to use, copy, modify, merge, publish, 
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or 
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+ */
+
+
+#pragma once
+
+#include "StdAfx.h"
+#include "debug.h"
+#include <vcclr.h>
+
+namespace p4dn {
+
+	//================================================================
+	// P4DebugConfig that keeps p4debug output in a bounded ring of
+	// lines instead of writing it to stdout.  When the ring is full the
+	// oldest lines are dropped (and counted).
+	//
+	class DebugCapture : public ::P4DebugConfig
+	{
+	public:
+		DebugCapture( int capacity );
+		virtual ~DebugCapture();
+
+		virtual ::StrBuf *Buffer();
+		virtual void Output();
+
+		void	SetEnabled( bool enabled ) { _enabled = enabled; }
+		bool	IsEnabled() const { return _enabled; }
+		int		Capacity() const { return _capacity; }
+		void	Resize( int capacity );
+
+		// held while reading the buffered lines
+		System::Object^ Lock() { return _lock; }
+
+		// copies out and removes the buffered lines, see DebugLog::Drain
+		int		Count() const { return _count; }
+		void	Take( int i, __int64 &timestamp, StrBuf *&text );
+		void	Clear();
+		__int64	Dropped() const { return _dropped; }
+
+	private:
+		void	Add( const char *text, int length );
+
+		struct Line
+		{
+			__int64	timestamp;		// DateTime ticks, UTC
+			StrBuf	text;
+		};
+
+		Line*	_lines;
+		int		_capacity;
+		int		_first;
+		int		_count;
+		__int64	_dropped;
+		bool	_enabled;
+
+		// p4debug may be written from any thread running a command; the
+		// thread formatting into the shared buffer holds _lock until Output
+		gcroot<System::Object^> _lock;
+		volatile int _owner;	// ManagedThreadId holding _lock for printf, or 0
+	};
+
+	public value struct DebugLine
+	{
+		// UTC time the line was written
+		System::DateTime	Timestamp;
+		System::String^		Text;
+	};
+
+	//================================================================
+	// Process-wide access to p4debug/p4tunable and the capture buffer.
+	//
+	public ref class DebugLog abstract sealed
+	{
+	public:
+		// "rpc=3", "net=1,rpc=5", ...
+		static void SetLevel( System::String^ setting );
+		static int GetLevel( int debugType );
+
+		// "net.maxwait=10", ...
+		static void SetTunable( System::String^ setting );
+
+		static System::String^ ShowLevels( bool showAll );
+
+		static void StartCapture( int capacity );
+		static void StopCapture();
+		static property bool Capturing { bool get(); }
+		static property System::Int64 Dropped { System::Int64 get(); }
+
+		static array<DebugLine>^ Drain();
+
+	private:
+		static DebugCapture* _capture = NULL;
+	};
+}
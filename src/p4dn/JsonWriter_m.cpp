@@ -0,0 +1,481 @@
+/*
+ * P4.Net *
+Copyright (c) 2007-2010 Shawn Hladky
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+and associated documentation files (the "Software"), to deal in the Software without 
+restriction, including without limitation the rights to use, copy, modify, merge, publish, 
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or 
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+ */
+
+
+#include "StdAfx.h"
+#include "JsonWriter_m.h"
+#include "ByteHash.h"
+#include <emmintrin.h>
+#include <intrin.h>
+
+using namespace System::Runtime::InteropServices;
+
+p4dn::JsonWriter::JsonWriter( System::IO::Stream^ stream, System::Text::Encoding^ encoding, bool messages,
+							  CommandCancellation *cancellation )
+{
+	_stream = stream;
+	_error = nullptr;
+	_encoding = encoding;
+	_cancellation = cancellation;
+	_messages = messages;
+	_utf8 = ( encoding->CodePage == 65001 );
+	_transcode = !_utf8 && !encoding->IsSingleByte;
+	_fields = NULL;
+	_fieldCapacity = 0;
+	_groups = NULL;
+	_groupCapacity = 0;
+	_slots = NULL;
+	_slotCapacity = 0;
+
+	// UTF-8 for each high byte of a single-byte encoding (unused otherwise)
+	array<System::Byte>^ one = gcnew array<System::Byte>( 1 );
+	for (int b = 0x80; b < 0x100; b++)
+	{
+		unsigned c = b;
+		if ( !_utf8 && encoding->IsSingleByte )
+		{
+			one[0] = (System::Byte)b;
+			c = encoding->GetChars( one )[0];
+		}
+		char *u = _high[b - 0x80];
+		if ( c < 0x20 || c == '"' || c == '\\' )
+		{
+			// nothing sensible maps here; keep the string valid
+			u[0] = '?';
+			u[1] = 0;
+		}
+		else if ( c < 0x80 )
+		{
+			u[0] = (char)c;
+			u[1] = 0;
+		}
+		else if ( c < 0x800 )
+		{
+			u[0] = (char)( 0xC0 | (c >> 6) );
+			u[1] = (char)( 0x80 | (c & 0x3F) );
+			u[2] = 0;
+		}
+		else
+		{
+			u[0] = (char)( 0xE0 | (c >> 12) );
+			u[1] = (char)( 0x80 | ((c >> 6) & 0x3F) );
+			u[2] = (char)( 0x80 | (c & 0x3F) );
+		}
+		u[3] = 0;
+	}
+}
+
+p4dn::JsonWriter::~JsonWriter()
+{
+	if (_fields != NULL) delete [] _fields;
+	if (_groups != NULL) delete [] _groups;
+	if (_slots != NULL) delete [] _slots;
+	_stream = nullptr;
+	_error = nullptr;
+	_encoding = nullptr;
+}
+
+System::Exception^ p4dn::JsonWriter::Finish()
+{
+	Flush();
+	return _error;
+}
+
+void p4dn::JsonWriter::Flush()
+{
+	int length = _out.Length();
+	if ( length == 0 ) return;
+	if ( (System::Exception^)_error == nullptr )
+	{
+		// called from inside the p4api, so nothing may be thrown from here
+		try
+		{
+			array<System::Byte>^ data = gcnew array<System::Byte>( length );
+			Marshal::Copy( System::IntPtr( (void*)_out.Text() ), data, 0, length );
+			_stream->Write( data, 0, length );
+		}
+		catch ( System::Exception^ e )
+		{
+			// nothing more will be written, so stop pulling the result from the server
+			_error = e;
+			if ( _cancellation != NULL ) _cancellation->Cancel();
+		}
+	}
+	_out.Clear();
+}
+
+void p4dn::JsonWriter::AddMessage( ::Error *err )
+{
+	StrBuf msg;
+	err->Fmt( &msg, EF_PLAIN );
+	ErrorId *id = err->GetId(0);
+
+	StrBuf line;
+	line << "{\"severity\":" << err->GetSeverity() << ",\"id\":" << ( id ? id->UniqueCode() : 0 ) << ",\"message\":";
+	_out.Append( &line );
+
+	// Fmt ends multi-line messages with a newline; JSON lines can't have one unescaped, and the last isn't wanted
+	int length = msg.Length();
+	while ( length > 0 && ( msg.Text()[length - 1] == '\n' || msg.Text()[length - 1] == '\r' ) ) length--;
+	WriteString( msg.Text(), length );
+	_out.Append( "}\n", 2 );
+
+	if ( _out.Length() >= BufferSize ) Flush();
+}
+
+// A multi-byte encoding can't be mapped a byte at a time, so the string is
+// decoded whole and its UTF-8 escaped instead.  Managed, unlike its caller.
+void p4dn::JsonWriter::WriteTranscoded( const char *p, int length )
+{
+	System::String^ s = gcnew System::String( p, 0, length, (System::Text::Encoding^)_encoding );
+	array<System::Byte>^ utf8 = System::Text::Encoding::UTF8->GetBytes( s );
+	_transcoded.Clear();
+	if ( utf8->Length > 0 )
+	{
+		pin_ptr<System::Byte> b = &utf8[0];
+		_transcoded.Append( (const char *)b, utf8->Length );
+	}
+	WriteEscaped( _transcoded.Text(), _transcoded.Length(), false );
+}
+
+// Everything below runs for every field of every record, so it is compiled
+// native; Add only calls back into managed code to flush a full buffer.
+#pragma managed(push, off)
+
+namespace {
+
+	// Index of the first byte of p[0..n) that can't be copied into a JSON string as it is:
+	// a quote, a backslash, a control character, or (when high is set) a byte over 0x7F.
+	int ScanPlain( const unsigned char *p, int n, bool high )
+	{
+		const __m128i quote = _mm_set1_epi8( '"' );
+		const __m128i backslash = _mm_set1_epi8( '\\' );
+		const __m128i control = _mm_set1_epi8( 0x1F );
+		const __m128i zero = _mm_setzero_si128();
+
+		int i = 0;
+		for ( ; i + 16 <= n; i += 16 )
+		{
+			__m128i v = _mm_loadu_si128( (const __m128i*)(p + i) );
+			__m128i m = _mm_or_si128( _mm_cmpeq_epi8( v, quote ), _mm_cmpeq_epi8( v, backslash ) );
+
+			// unsigned v <= 0x1F is the same as v - 0x1F saturating to 0
+			m = _mm_or_si128( m, _mm_cmpeq_epi8( _mm_subs_epu8( v, control ), zero ) );
+			int mask = _mm_movemask_epi8( m );
+			if ( high ) mask |= _mm_movemask_epi8( v );
+			if ( mask != 0 )
+			{
+				unsigned long bit;
+				_BitScanForward( &bit, (unsigned long)mask );
+				return i + (int)bit;
+			}
+		}
+		for ( ; i < n; i++ )
+		{
+			unsigned char c = p[i];
+			if ( c == '"' || c == '\\' || c < 0x20 || ( high && c > 0x7F ) ) return i;
+		}
+		return n;
+	}
+
+	bool IsDigit( char c )
+	{
+		return c >= '0' && c <= '9';
+	}
+}
+
+p4dn::JsonWriter::KeyMap::KeyMap()
+{
+	_slots = NULL;
+	_size = 0;
+	_generation = 0;
+}
+
+p4dn::JsonWriter::KeyMap::~KeyMap()
+{
+	if (_slots != NULL) delete [] _slots;
+}
+
+void p4dn::JsonWriter::KeyMap::Reset( int count )
+{
+	if ( count * 2 > _size )
+	{
+		int size = 64;
+		while ( size < count * 2 ) size *= 2;
+		if (_slots != NULL) delete [] _slots;
+		_slots = new Slot[size];
+		memset( _slots, 0, sizeof(Slot) * size );
+		_size = size;
+		_generation = 0;
+	}
+
+	// a slot is only in use when its generation matches
+	if ( ++_generation == 0 )
+	{
+		memset( _slots, 0, sizeof(Slot) * _size );
+		_generation = 1;
+	}
+}
+
+int p4dn::JsonWriter::KeyMap::Find( const char *p, int length ) const
+{
+	unsigned hash = HashBytes( p, length );
+	int mask = _size - 1;
+	for (int i = hash & mask; _slots[i].generation == _generation; i = (i + 1) & mask)
+	{
+		const Slot &s = _slots[i];
+		if ( s.hash == hash && s.length == length && memcmp( s.p, p, length ) == 0 ) return s.value;
+	}
+	return -1;
+}
+
+void p4dn::JsonWriter::KeyMap::Insert( const char *p, int length, int value )
+{
+	unsigned hash = HashBytes( p, length );
+	int mask = _size - 1;
+	int i = hash & mask;
+	while ( _slots[i].generation == _generation ) i = (i + 1) & mask;
+	Slot &s = _slots[i];
+	s.generation = _generation;
+	s.hash = hash;
+	s.p = p;
+	s.length = length;
+	s.value = value;
+}
+
+void p4dn::JsonWriter::Add( StrDict *dict )
+{
+	::StrRef var, val;
+
+	// collect the fields; the StrRefs point into the dictionary, which outlives this call
+	int n = 0;
+	for (int i = 0; dict->GetVar(i, var, val) != 0; i++)
+	{
+		// same fields ClientUserDelegate::OutputStat leaves out
+		if ( var == "specdef" || var == "func" || var == "specFormatted" ) continue;
+		if ( n == _fieldCapacity )
+		{
+			int capacity = ( n == 0 ) ? 64 : n * 2;
+			Field *fields = new Field[capacity];
+			if ( n > 0 ) memcpy( fields, _fields, sizeof(Field) * n );
+			if (_fields != NULL) delete [] _fields;
+			_fields = fields;
+			_fieldCapacity = capacity;
+		}
+		Field &f = _fields[n++];
+		f.key = var.Text();
+		f.keyLength = var.Length();
+		f.value = val.Text();
+		f.valueLength = val.Length();
+		f.group = -1;
+	}
+
+	_keys.Reset( n );
+	for (int i = 0; i < n; i++)
+	{
+		_keys.Insert( _fields[i].key, _fields[i].keyLength, i );
+	}
+
+	// arrays: as P4Record, a key ending in digits whose base also appears with index 0
+	if ( n > _groupCapacity )
+	{
+		if (_groups != NULL) delete [] _groups;
+		_groups = new Group[n];
+		_groupCapacity = n;
+	}
+	_bases.Reset( n );
+	int groups = 0;
+	for (int i = 0; i < n; i++)
+	{
+		Field &f = _fields[i];
+		int b = f.keyLength;
+		while ( b > 0 && IsDigit( f.key[b - 1] ) ) b--;
+		f.baseLength = b;
+		f.index = -1;
+
+		// more than 9 digits, or an index far past the record's size, isn't an array element
+		if ( b == f.keyLength || b == 0 || f.keyLength - b > 9 ) continue;
+		int index = 0;
+		for (int j = b; j < f.keyLength; j++) index = index * 10 + ( f.key[j] - '0' );
+		if ( index > n * 2 + 16 ) continue;
+		f.index = index;
+
+		bool array = ( b == 8 && memcmp( f.key, "fileSize", 8 ) == 0 );
+		if ( !array )
+		{
+			_scratch.Clear();
+			_scratch.Append( f.key, b );
+			_scratch.Extend( '0' );
+			array = _keys.Find( _scratch.Text(), _scratch.Length() ) >= 0;
+		}
+		if ( !array ) continue;
+
+		int g = _bases.Find( f.key, b );
+		if ( g < 0 )
+		{
+			g = groups++;
+			_groups[g].first = i;
+			_groups[g].maxIndex = -1;
+			_groups[g].collides = false;
+			_groups[g].written = false;
+			_bases.Insert( f.key, b, g );
+		}
+		f.group = g;
+		if ( index > _groups[g].maxIndex ) _groups[g].maxIndex = index;
+	}
+
+	// element slots, -1 where an index is missing
+	int slots = 0;
+	for (int g = 0; g < groups; g++)
+	{
+		_groups[g].slots = slots;
+		slots += _groups[g].maxIndex + 1;
+	}
+	if ( slots > _slotCapacity )
+	{
+		if (_slots != NULL) delete [] _slots;
+		_slots = new int[slots];
+		_slotCapacity = slots;
+	}
+	for (int s = 0; s < slots; s++) _slots[s] = -1;
+	for (int i = 0; i < n; i++)
+	{
+		const Field &f = _fields[i];
+		if ( f.group >= 0 )
+		{
+			_slots[_groups[f.group].slots + f.index] = i;
+		}
+		else if ( groups > 0 )
+		{
+			int g = _bases.Find( f.key, f.keyLength );
+			if ( g >= 0 ) _groups[g].collides = true;
+		}
+	}
+
+	_out.Extend( '{' );
+	bool first = true;
+	for (int i = 0; i < n; i++)
+	{
+		const Field &f = _fields[i];
+		if ( f.group >= 0 && _groups[f.group].written ) continue;
+		if ( !first ) _out.Extend( ',' );
+		first = false;
+
+		if ( f.group >= 0 )
+		{
+			WriteGroup( f.group );
+		}
+		else
+		{
+			WriteString( f.key, f.keyLength );
+			_out.Extend( ':' );
+			WriteString( f.value, f.valueLength );
+		}
+	}
+	_out.Append( "}\n", 2 );
+
+	if ( _out.Length() >= BufferSize ) Flush();
+}
+
+void p4dn::JsonWriter::WriteGroup( int g )
+{
+	Group &group = _groups[g];
+	group.written = true;
+
+	const Field &f = _fields[group.first];
+	if ( group.collides )
+	{
+		_scratch.Clear();
+		_scratch.Append( f.key, f.baseLength );
+		_scratch.Append( "[]", 2 );
+		WriteString( _scratch.Text(), _scratch.Length() );
+	}
+	else
+	{
+		WriteString( f.key, f.baseLength );
+	}
+	_out.Append( ":[", 2 );
+
+	for (int i = 0; i <= group.maxIndex; i++)
+	{
+		if ( i > 0 ) _out.Extend( ',' );
+		int field = _slots[group.slots + i];
+		if ( field >= 0 ) WriteString( _fields[field].value, _fields[field].valueLength );
+		else _out.Append( "\"\"", 2 );
+	}
+	_out.Extend( ']' );
+}
+
+void p4dn::JsonWriter::WriteString( const char *p, int length )
+{
+	if ( _transcode )
+	{
+		// every multi-byte character starts with a high byte; ASCII-only strings take the fast path
+		for (int i = 0; i < length; i++)
+		{
+			if ( (unsigned char)p[i] > 0x7F )
+			{
+				WriteTranscoded( p, length );
+				return;
+			}
+		}
+	}
+	WriteEscaped( p, length, !_utf8 );
+}
+
+void p4dn::JsonWriter::WriteEscaped( const char *p, int length, bool mapHigh )
+{
+	static const char hex[] = "0123456789abcdef";
+	const unsigned char *u = (const unsigned char *)p;
+
+	_out.Extend( '"' );
+	int i = 0;
+	while ( i < length )
+	{
+		int plain = ScanPlain( u + i, length - i, mapHigh );
+		if ( plain > 0 ) _out.Append( p + i, plain );
+		i += plain;
+		if ( i >= length ) break;
+
+		unsigned char c = u[i++];
+		switch ( c )
+		{
+		case '"':	_out.Append( "\\\"", 2 ); break;
+		case '\\':	_out.Append( "\\\\", 2 ); break;
+		case '\n':	_out.Append( "\\n", 2 ); break;
+		case '\r':	_out.Append( "\\r", 2 ); break;
+		case '\t':	_out.Append( "\\t", 2 ); break;
+		default:
+			if ( c > 0x7F )
+			{
+				_out.Append( _high[c - 0x80] );
+			}
+			else
+			{
+				char esc[6] = { '\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF] };
+				_out.Append( esc, 6 );
+			}
+			break;
+		}
+	}
+	_out.Extend( '"' );
+}
+
+#pragma managed(pop)
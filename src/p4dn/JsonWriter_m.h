@@ -0,0 +1,145 @@
+/*
+ * P4.Net *
+Copyright (c) 2007-2010 Shawn Hladky
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+and associated documentation files (the "Software"), to deal in the Software without 
+restriction, including without limitation the rights to use, copy, modify, merge, publish, 
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or 
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+ */
+
+
+#pragma once
+
+#include "StdAfx.h"
+#include "KeepAlive_m.h"
+#include <vcclr.h>
+
+namespace p4dn {
+
+	//================================================================
+	// Writes the tagged records of one Run, and optionally its
+	// messages, to a stream as newline-delimited JSON, straight from
+	// the StrDict.  No managed strings are made; the stream only sees
+	// whole buffers.
+	//
+	// Fields are grouped the way P4Record does it: a key ending in
+	// digits is an array element when the record also has the same
+	// base with index 0 (fileSize always is), and missing indexes are
+	// written as "".  When a plain field has the same name as an
+	// array, the array is written as "name[]".
+	//
+	// Strings are written as UTF-8.  When the connection's encoding is
+	// single-byte, high bytes are mapped through a table; when it is
+	// multi-byte (cp932, cp936, euc-jp ...), a string with any high
+	// byte is decoded through the Encoding first, since its trail
+	// bytes can look like quotes or backslashes.
+	//
+	// Once the stream throws, nothing more is written and the run is
+	// cancelled through its CommandCancellation, so the rest of the
+	// result isn't pulled from the server for nothing.
+	//
+	class JsonWriter
+	{
+	public:
+		enum { BufferSize = 64 * 1024 };
+
+		JsonWriter( System::IO::Stream^ stream, System::Text::Encoding^ encoding, bool messages,
+					CommandCancellation *cancellation );
+		~JsonWriter();
+
+		bool	WantsMessages() const { return _messages; }
+		void	Add( StrDict *dict );
+		void	AddMessage( ::Error *err );
+
+		// writes what's buffered; returns the first error the stream threw, nullptr if none
+		System::Exception^	Finish();
+
+	private:
+		struct Field
+		{
+			const char	*key;
+			int			keyLength;
+			const char	*value;
+			int			valueLength;
+			int			baseLength;		// key without trailing digits
+			int			index;			// the trailing digits, -1 if none
+			int			group;			// array this is an element of, -1 for a plain field
+		};
+
+		struct Group
+		{
+			int		first;				// field where the base first appears
+			int		maxIndex;
+			int		slots;				// start of this group's elements in _slots
+			bool	collides;			// a plain field has the same name
+			bool	written;
+		};
+
+		// string -> int map over one record's keys, cleared by bumping the generation
+		class KeyMap
+		{
+		public:
+			KeyMap();
+			~KeyMap();
+			void	Reset( int count );
+			int		Find( const char *p, int length ) const;
+			void	Insert( const char *p, int length, int value );
+
+		private:
+			struct Slot
+			{
+				unsigned	generation;
+				unsigned	hash;
+				const char	*p;
+				int			length;
+				int			value;
+			};
+
+			Slot		*_slots;
+			int			_size;
+			unsigned	_generation;
+		};
+
+		void	WriteString( const char *p, int length );
+		void	WriteEscaped( const char *p, int length, bool mapHigh );
+		void	WriteTranscoded( const char *p, int length );
+		void	WriteGroup( int g );
+		void	Flush();
+
+		gcroot<System::IO::Stream^>		_stream;
+		gcroot<System::Exception^>		_error;
+		gcroot<System::Text::Encoding^>	_encoding;
+		CommandCancellation	*_cancellation;
+		bool		_messages;
+		bool		_utf8;
+		bool		_transcode;			// multi-byte, not UTF-8
+		char		_high[128][4];		// UTF-8 for bytes 0x80-0xFF of a single-byte encoding
+		StrBuf		_out;
+		StrBuf		_transcoded;
+
+		Field		*_fields;
+		int			_fieldCapacity;
+		Group		*_groups;
+		int			_groupCapacity;
+		int			*_slots;
+		int			_slotCapacity;
+		KeyMap		_keys;
+		KeyMap		_bases;
+		StrBuf		_scratch;
+
+		JsonWriter( const JsonWriter & );
+		void operator =( const JsonWriter & );
+	};
+
+} // end namespace
@@ -0,0 +1,87 @@
+/*
+ * P4.Net *
+Copyright (c) 2007-2010 Shawn Hladky
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+and associated documentation files (the "Software"), to deal in the Software without 
+restriction, including without limitation the rights to use, copy, modify, merge, publish, 
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or 
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+ */
+
+
+#include "StdAfx.h"
+#include "ClientApi_m.h"
+
+// Everything the p4api polls while waiting on the server is kept native.
+#pragma managed(push, off)
+
+p4dn::CommandCancellation::CommandCancellation()
+{
+	_cancelled = 0;
+	_status = Completed;
+	_hasDeadline = 0;
+	_deadline = 0;
+}
+
+void p4dn::CommandCancellation::Begin( int timeoutMs )
+{
+	_cancelled = 0;
+	_status = Running;
+	_hasDeadline = timeoutMs > 0;
+	_deadline = _hasDeadline ? clock() + (clock_t)( (double)timeoutMs * CLOCKS_PER_SEC / 1000 ) : 0;
+}
+
+void p4dn::CommandCancellation::End()
+{
+	if ( _status == Running ) _status = Completed;
+	_cancelled = 0;
+	_hasDeadline = 0;
+}
+
+void p4dn::CommandCancellation::Cancel()
+{
+	_cancelled = 1;
+}
+
+int p4dn::CommandCancellation::Poll()
+{
+	if ( _cancelled )
+	{
+		_status = Cancelled;
+		return 0;
+	}
+	if ( _hasDeadline && (long)( clock() - _deadline ) >= 0 )
+	{
+		_status = TimedOut;
+		return 0;
+	}
+	return 1;
+}
+
+int p4dn::KeepAliveDelegate::IsAlive()
+{
+	if ( !_cancellation.Poll() ) return 0;
+
+	// only cross into managed code when someone actually asked to be polled
+	if ( !_hasManagedKeepAlive ) return 1;
+	return IsAliveManaged();
+}
+
+#pragma managed(pop)
+
+int p4dn::KeepAliveDelegate::IsAliveManaged()
+{
+	bool b = _KeepAlive->IsAlive();
+	if ( !b ) _cancellation.Cancel();
+	return ( b ? 1 : 0 );
+}
@@ -0,0 +1,165 @@
+/*
+ * P4.Net *
+Copyright (c) 2007-2010 Shawn Hladky
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+and associated documentation files (the "Software"), to deal in the Software without 
+restriction, including without limitation the rights to use, copy, modify, merge, publish, 
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or 
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+ */
+
+
+#include "StdAfx.h"
+#include "MessageFilter_m.h"
+
+using namespace p4dn;
+
+MessageFilterState::MessageFilterState()
+{
+	_minSeverity = E_EMPTY;
+	_allowIds.items = NULL; _allowIds.count = _allowIds.size = 0;
+	_denyIds.items = NULL; _denyIds.count = _denyIds.size = 0;
+	_allowSubsystems.items = NULL; _allowSubsystems.count = _allowSubsystems.size = 0;
+	_denySubsystems.items = NULL; _denySubsystems.count = _denySubsystems.size = 0;
+	ResetCounters();
+}
+
+MessageFilterState::MessageFilterState( const MessageFilterState &other )
+{
+	_minSeverity = other._minSeverity;
+	Copy( _allowIds, other._allowIds );
+	Copy( _denyIds, other._denyIds );
+	Copy( _allowSubsystems, other._allowSubsystems );
+	Copy( _denySubsystems, other._denySubsystems );
+	ResetCounters();
+}
+
+MessageFilterState::~MessageFilterState()
+{
+	delete [] _allowIds.items;
+	delete [] _denyIds.items;
+	delete [] _allowSubsystems.items;
+	delete [] _denySubsystems.items;
+}
+
+void MessageFilterState::Add( IntList &list, int value )
+{
+	if ( Contains( list, value ) ) return;
+	if ( list.count == list.size )
+	{
+		int size = list.size ? list.size * 2 : 8;
+		int *items = new int[size];
+		for ( int i = 0; i < list.count; i++ ) items[i] = list.items[i];
+		delete [] list.items;
+		list.items = items;
+		list.size = size;
+	}
+	list.items[list.count++] = value;
+}
+
+bool MessageFilterState::Contains( const IntList &list, int value )
+{
+	// lists are a handful of entries, a linear scan beats anything fancier
+	for ( int i = 0; i < list.count; i++ )
+	{
+		if ( list.items[i] == value ) return true;
+	}
+	return false;
+}
+
+void MessageFilterState::Copy( IntList &to, const IntList &from )
+{
+	to.count = to.size = from.count;
+	to.items = from.count ? new int[from.count] : NULL;
+	for ( int i = 0; i < from.count; i++ ) to.items[i] = from.items[i];
+}
+
+bool MessageFilterState::Accept( ::Error *err )
+{
+	ErrorId *id = err->GetId(0);
+	if ( !id ) return true;
+
+	int unique = id->UniqueCode();
+	int subsystem = id->Subsystem();
+	int severity = id->Severity();
+
+	bool accept;
+	if ( Contains( _denyIds, unique ) || Contains( _denySubsystems, subsystem ) )
+	{
+		accept = false;
+	}
+	else if ( Contains( _allowIds, unique ) || Contains( _allowSubsystems, subsystem ) )
+	{
+		accept = true;
+	}
+	else
+	{
+		accept = severity >= _minSeverity;
+	}
+
+	if ( !accept ) _suppressed[severity & 0x7]++;
+	return accept;
+}
+
+void MessageFilterState::ResetCounters()
+{
+	for ( int i = 0; i < 8; i++ ) _suppressed[i] = 0;
+}
+
+int MessageFilterState::SuppressedTotal() const
+{
+	int total = 0;
+	for ( int i = 0; i < 8; i++ ) total += _suppressed[i];
+	return total;
+}
+
+p4dn::MessageFilter::MessageFilter()
+{
+	_state = new MessageFilterState();
+}
+
+p4dn::MessageFilter::~MessageFilter()
+{
+	this->!MessageFilter();
+}
+
+p4dn::MessageFilter::!MessageFilter()
+{
+	if ( _state != NULL ) delete _state;
+	_state = NULL;
+}
+
+void p4dn::MessageFilter::SetMinimumSeverity( int severity )
+{
+	_state->SetMinimumSeverity( severity );
+}
+
+void p4dn::MessageFilter::AllowId( int uniqueCode )
+{
+	_state->AllowId( uniqueCode );
+}
+
+void p4dn::MessageFilter::DenyId( int uniqueCode )
+{
+	_state->DenyId( uniqueCode );
+}
+
+void p4dn::MessageFilter::AllowSubsystem( int subsystem )
+{
+	_state->AllowSubsystem( subsystem );
+}
+
+void p4dn::MessageFilter::DenySubsystem( int subsystem )
+{
+	_state->DenySubsystem( subsystem );
+}
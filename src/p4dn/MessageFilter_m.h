@@ -0,0 +1,106 @@
+/*
+ * P4.Net *
+Copyright (c) 2007-2010 Shawn Hladky
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+and associated documentation files (the "Software"), to deal in the Software without 
+restriction, including without limitation the rights to use, copy, modify, merge, publish, 
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or 
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+ */
+
+
+#pragma once
+
+#include "StdAfx.h"
+#include <vcclr.h>
+
+namespace p4dn {
+
+	//================================================================
+	// Native half of the message filter.  ClientUserDelegate evaluates
+	// it for every Message/HandleError callback, so it must not touch
+	// any managed state.  Suppressed messages are only counted.
+	//
+	class MessageFilterState
+	{
+	public:
+		MessageFilterState();
+		MessageFilterState( const MessageFilterState &other );
+		~MessageFilterState();
+
+		void	SetMinimumSeverity( int severity ) { _minSeverity = severity; }
+		void	AllowId( int uniqueCode )		{ Add( _allowIds, uniqueCode ); }
+		void	DenyId( int uniqueCode )		{ Add( _denyIds, uniqueCode ); }
+		void	AllowSubsystem( int subsystem )	{ Add( _allowSubsystems, subsystem ); }
+		void	DenySubsystem( int subsystem )	{ Add( _denySubsystems, subsystem ); }
+
+		// returns true if the message should be passed on to managed code
+		bool	Accept( ::Error *err );
+
+		void	ResetCounters();
+		int		Suppressed( int severity ) const { return _suppressed[severity & 0x7]; }
+		int		SuppressedTotal() const;
+
+	private:
+		struct IntList
+		{
+			int *items;
+			int count;
+			int size;
+		};
+
+		static void	Add( IntList &list, int value );
+		static bool	Contains( const IntList &list, int value );
+		static void	Copy( IntList &to, const IntList &from );
+
+		int		_minSeverity;
+		IntList	_allowIds;
+		IntList	_denyIds;
+		IntList	_allowSubsystems;
+		IntList	_denySubsystems;
+		int		_suppressed[8];
+
+		void operator =( const MessageFilterState & );
+	};
+
+	/// <summary>
+	/// Filter applied to server messages before they are handed to managed code.
+	/// </summary>
+	/// <remarks>
+	/// Ids are compared against ErrorId::UniqueCode (subsystem and sub code).
+	/// Deny lists always win; allow lists let a message through regardless of severity.
+	/// </remarks>
+	public ref class MessageFilter
+	{
+	public:
+		MessageFilter();
+		~MessageFilter();
+		!MessageFilter();
+
+		void	SetMinimumSeverity( int severity );
+		void	AllowId( int uniqueCode );
+		void	DenyId( int uniqueCode );
+		void	AllowSubsystem( int subsystem );
+		void	DenySubsystem( int subsystem );
+
+	internal:
+		property MessageFilterState* State
+		{
+			MessageFilterState* get() { return _state; }
+		}
+
+	private:
+		MessageFilterState* _state;
+	};
+
+} // end namespace
@@ -0,0 +1,140 @@
+/*
+ * P4.Net *
+Copyright (c) 2007-2010 Shawn Hladky
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+and associated documentation files (the "Software"), to deal in the Software without 
+restriction, including without limitation the rights to use, copy, modify, merge, publish, 
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or 
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+ */
+
+
+#include "StdAfx.h"
+#include "RecordWriter_m.h"
+#include "ByteHash.h"
+
+using namespace System::Runtime::InteropServices;
+
+p4dn::RecordWriter::RecordWriter( RecordSink^ sink )
+{
+	_sink = sink;
+	_blockRecords = 0;
+	_count = 0;
+
+	// twice MaxStrings, so the table is never more than half full
+	_size = MaxStrings * 2;
+	_table = new Entry[_size];
+	for (int i = 0; i < _size; i++) _table[i].offset = -1;
+}
+
+p4dn::RecordWriter::~RecordWriter()
+{
+	delete [] _table;
+	_sink = nullptr;
+}
+
+void p4dn::RecordWriter::Add( StrDict *dict )
+{
+	::StrRef var, val;
+	int fields = 0;
+	_fields.Clear();
+	if ( _field.Length() )
+	{
+		StrPtr *v = dict->GetVar( _field );
+		if ( !v ) return;
+		WriteRef( _fields, _field, true );
+		WriteRef( _fields, *v, false );
+		fields = 1;
+	}
+	else for (int i = 0; dict->GetVar(i, var, val) != 0; i++)
+	{
+		// same fields ClientUserDelegate::OutputStat leaves out
+		if ( var == "specdef" || var == "func" || var == "specFormatted" ) continue;
+		WriteRef( _fields, var, true );
+		WriteRef( _fields, val, val.Length() <= MaxTableValue );
+		fields++;
+	}
+	WriteVarint( _block, fields );
+	_block.Append( _fields.Text(), _fields.Length() );
+	_blockRecords++;
+
+	if ( _block.Length() >= BlockSize ) Flush();
+}
+
+void p4dn::RecordWriter::Finish()
+{
+	if ( _blockRecords > 0 ) Flush();
+
+	int length = _strings.Length();
+	array<System::Byte>^ data = gcnew array<System::Byte>( length );
+	if ( length > 0 ) Marshal::Copy( System::IntPtr( (void*)_strings.Text() ), data, 0, length );
+	_sink->WriteStrings( data, length, _count );
+}
+
+void p4dn::RecordWriter::WriteRef( StrBuf &to, const StrPtr &s, bool table )
+{
+	const char *p = s.Text();
+	int length = s.Length();
+
+	if ( table )
+	{
+		unsigned hash = HashBytes( p, length );
+		int mask = _size - 1;
+		int i = hash & mask;
+		for ( ; _table[i].offset >= 0; i = (i + 1) & mask)
+		{
+			Entry &e = _table[i];
+			if ( e.hash == hash && e.length == length && memcmp( _strings.Text() + e.offset, p, length ) == 0 )
+			{
+				WriteVarint( to, (unsigned)e.id << 1 );
+				return;
+			}
+		}
+
+		if ( _count < MaxStrings )
+		{
+			WriteVarint( _strings, length );
+			_table[i].hash = hash;
+			_table[i].length = length;
+			_table[i].offset = _strings.Length();
+			_table[i].id = _count;
+			_strings.Append( p, length );
+			WriteVarint( to, (unsigned)_count << 1 );
+			_count++;
+			return;
+		}
+	}
+
+	WriteVarint( to, ((unsigned)length << 1) | 1 );
+	to.Append( p, length );
+}
+
+void p4dn::RecordWriter::Flush()
+{
+	int length = _block.Length();
+	array<System::Byte>^ data = gcnew array<System::Byte>( length );
+	Marshal::Copy( System::IntPtr( (void*)_block.Text() ), data, 0, length );
+	_sink->WriteBlock( data, length, _blockRecords );
+	_block.Clear();
+	_blockRecords = 0;
+}
+
+void p4dn::RecordWriter::WriteVarint( StrBuf &to, unsigned value )
+{
+	while ( value >= 0x80 )
+	{
+		to.Extend( (char)(value | 0x80) );
+		value >>= 7;
+	}
+	to.Extend( (char)value );
+}
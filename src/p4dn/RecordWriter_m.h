@@ -0,0 +1,101 @@
+/*
+ * P4.Net *
+Copyright (c) 2007-2010 Shawn Hladky
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+and associated documentation files (the "Software"), to deal in the Software without 
+restriction, including without limitation the rights to use, copy, modify, merge, publish, 
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or 
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+ */
+
+
+#pragma once
+
+#include "StdAfx.h"
+#include <vcclr.h>
+
+namespace p4dn {
+
+	/// <summary>
+	/// Receives tagged records encoded by RecordWriter, a block at a time.
+	/// </summary>
+	/// <remarks>
+	/// WriteBlock is called from inside a running command, so it must not throw.
+	/// </remarks>
+	public ref class RecordSink abstract
+	{
+	public:
+		// data[0..length) holds count records
+		virtual void WriteBlock( array<System::Byte>^ data, int length, int count ) = 0;
+
+		// called once after the last block, with the string table the records refer to
+		virtual void WriteStrings( array<System::Byte>^ data, int length, int count ) = 0;
+	};
+
+	//================================================================
+	// Encodes the tagged records of one Run without converting them to
+	// managed strings.  Each record is:
+	//
+	//	varint	field count
+	//	ref		key, ref value	(per field)
+	//
+	// where a ref is a varint v: v even is string table entry v/2, v odd
+	// is v/2 bytes following inline.  Keys, and values up to MaxTableValue
+	// bytes, go in the table until it holds MaxStrings entries.  The table
+	// is a run of (varint length, bytes) in entry order.  Strings are the
+	// server's bytes, in the connection's encoding.
+	//
+	// With SetField, only records that have that field are written, each
+	// with just that field and the value always inline, so a sink can read
+	// the values out of each block as it arrives.
+	//
+	class RecordWriter
+	{
+	public:
+		enum { BlockSize = 64 * 1024, MaxStrings = 65536, MaxTableValue = 32 };
+
+		RecordWriter( RecordSink^ sink );
+		~RecordWriter();
+
+		void	SetField( const StrPtr &field ) { _field.Set( field ); }
+		void	Add( StrDict *dict );
+		void	Finish();
+
+	private:
+		struct Entry
+		{
+			unsigned	hash;
+			int			length;
+			int			offset;		// of the bytes in _strings, -1 for an empty slot
+			int			id;			// position in the string table
+		};
+
+		void	WriteRef( StrBuf &to, const StrPtr &s, bool table );
+		void	Flush();
+		static void	WriteVarint( StrBuf &to, unsigned value );
+
+		gcroot<RecordSink^>	_sink;
+		StrBuf		_field;
+		StrBuf		_block;
+		StrBuf		_fields;
+		int			_blockRecords;
+		StrBuf		_strings;
+		int			_count;
+		Entry		*_table;
+		int			_size;
+
+		RecordWriter( const RecordWriter & );
+		void operator =( const RecordWriter & );
+	};
+
+} // end namespace
@@ -0,0 +1,52 @@
+/*
+ * P4.Net *
+Copyright (c) 2007-2010 Shawn Hladky
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+and associated documentation files (the "Software"), to deal in the Software without 
+restriction, including without limitation the rights to use, copy, modify, merge, publish, 
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or 
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+ */
+
+
+#include "StdAfx.h"
+#include "RunCounters_m.h"
+
+void p4dn::RunCountersState::Reset()
+{
+	start = firstByte = end = 0;
+	callbackTicks = managedTicks = 0;
+	textBytes = binaryBytes = 0;
+	records = messages = infoLines = managedTransitions = 0;
+	poolLookups = poolHits = poolEntries = 0;
+	poolBytesSaved = 0;
+}
+
+p4dn::RunCounters::RunCounters( const RunCountersState &state )
+{
+	_start = state.start;
+	_firstByte = state.firstByte;
+	_end = state.end;
+	_callbackTicks = state.callbackTicks;
+	_managedTicks = state.managedTicks;
+	_textBytes = state.textBytes;
+	_binaryBytes = state.binaryBytes;
+	_records = state.records;
+	_messages = state.messages;
+	_infoLines = state.infoLines;
+	_managedTransitions = state.managedTransitions;
+	_poolLookups = state.poolLookups;
+	_poolHits = state.poolHits;
+	_poolEntries = state.poolEntries;
+	_poolBytesSaved = state.poolBytesSaved;
+}
@@ -0,0 +1,87 @@
+/*
+ * P4.Net *
+Copyright (c) 2007-2010 Shawn Hladky
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+and associated documentation files (the "Software"), to deal in the Software without 
+restriction, including without limitation the rights to use, copy, modify, merge, publish, 
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or 
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+ */
+
+
+#pragma once
+
+#include "StdAfx.h"
+
+namespace p4dn {
+
+	//================================================================
+	// Counters collected by ClientUserDelegate during one Run.  Times
+	// are System::Diagnostics::Stopwatch timestamps/ticks.
+	//
+	struct RunCountersState
+	{
+		__int64	start;
+		__int64	firstByte;
+		__int64	end;
+		__int64	callbackTicks;		// inside ClientUserDelegate (native marshalling + managed)
+		__int64	managedTicks;		// inside the managed ClientUser
+		__int64	textBytes;
+		__int64	binaryBytes;
+		int		records;
+		int		messages;
+		int		infoLines;
+		int		managedTransitions;
+		int		poolLookups;		// see ValuePool_m.h
+		int		poolHits;
+		int		poolEntries;
+		__int64	poolBytesSaved;
+
+		void	Reset();
+	};
+
+	//================================================================
+	// Read-only copy of the counters for the last Run.
+	//
+	public ref class RunCounters
+	{
+	public:
+		property System::Int64 StartTimestamp		{ System::Int64 get() { return _start; } }
+		property System::Int64 FirstByteTimestamp	{ System::Int64 get() { return _firstByte; } }
+		property System::Int64 EndTimestamp			{ System::Int64 get() { return _end; } }
+		property System::Int64 CallbackTicks		{ System::Int64 get() { return _callbackTicks; } }
+		property System::Int64 ManagedTicks			{ System::Int64 get() { return _managedTicks; } }
+		property System::Int64 TextBytes			{ System::Int64 get() { return _textBytes; } }
+		property System::Int64 BinaryBytes			{ System::Int64 get() { return _binaryBytes; } }
+		property int Records						{ int get() { return _records; } }
+		property int Messages						{ int get() { return _messages; } }
+		property int InfoLines						{ int get() { return _infoLines; } }
+		property int ManagedTransitions				{ int get() { return _managedTransitions; } }
+		property int PoolLookups					{ int get() { return _poolLookups; } }
+		property int PoolHits						{ int get() { return _poolHits; } }
+		property int PoolEntries					{ int get() { return _poolEntries; } }
+		property System::Int64 PoolBytesSaved		{ System::Int64 get() { return _poolBytesSaved; } }
+
+	internal:
+		RunCounters( const RunCountersState &state );
+
+	private:
+		// a ref class can't hold the native struct, so the fields are copied
+		System::Int64	_start, _firstByte, _end;
+		System::Int64	_callbackTicks, _managedTicks;
+		System::Int64	_textBytes, _binaryBytes;
+		int				_records, _messages, _infoLines, _managedTransitions;
+		int				_poolLookups, _poolHits, _poolEntries;
+		System::Int64	_poolBytesSaved;
+	};
+}
@@ -0,0 +1,544 @@
+/*
+ * P4.Net *
+Copyright (c) 2007-2010 Shawn Hladky
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+and associated documentation files (the "Software"), to deal in the Software without 
+restriction, including without limitation the rights to use, copy, modify, merge, publish, 
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or 
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+ */
+
+
+#include "StdAfx.h"
+#include "Session_m.h"
+#include "ClientUserDelegate.h"
+#include "strtable.h"
+
+using System::Diagnostics::Stopwatch;
+
+static const char SessionMagic[] = "P4DNSESS";
+
+// Encoding and decoding never touch managed objects.
+#pragma managed(push, off)
+
+p4dn::SessionTape::SessionTape()
+{
+	_start = 0;
+	_frequency = 1;
+	_recording = false;
+}
+
+void p4dn::SessionTape::BeginRun( __int64 start, __int64 frequency, int codePage, const StrPtr &func, int argc, const StrPtr *argv )
+{
+	_buf.Clear();
+	_start = start;
+	_frequency = frequency > 0 ? frequency : 1;
+	_recording = true;
+
+	Put( start, SE_BEGIN );
+	PutVarint( (unsigned __int64)codePage );
+	PutString( func );
+	PutVarint( argc );
+	for ( int i = 0; i < argc; i++ ) PutString( argv[i] );
+}
+
+void p4dn::SessionTape::EndRun( __int64 now )
+{
+	if ( !_recording ) return;
+	Put( now, SE_END );
+	_recording = false;
+}
+
+void p4dn::SessionTape::Stat( __int64 now, StrDict *varList )
+{
+	StrRef var, val;
+	int count = 0;
+	while ( varList->GetVar( count, var, val ) ) count++;
+
+	Put( now, SE_STAT );
+	PutVarint( count );
+	for ( int i = 0; i < count; i++ )
+	{
+		varList->GetVar( i, var, val );
+		PutString( var );
+		PutString( val );
+	}
+}
+
+void p4dn::SessionTape::Message( __int64 now, SessionEvent kind, const ::Error *err )
+{
+	_scratch.Clear();
+	err->Marshall2( _scratch );
+	Put( now, kind );
+	PutString( _scratch );
+}
+
+void p4dn::SessionTape::Text( __int64 now, SessionEvent kind, const char *data, int length )
+{
+	Put( now, kind );
+	PutString( data, length );
+}
+
+void p4dn::SessionTape::Info( __int64 now, char level, const char *data )
+{
+	Put( now, SE_OUTPUTINFO );
+	_buf.Extend( level );
+	PutString( data, (int)strlen( data ) );
+}
+
+void p4dn::SessionTape::Prompt( __int64 now, const StrPtr &msg, int noEcho )
+{
+	Put( now, SE_PROMPT );
+	PutString( msg );
+	PutVarint( noEcho ? 1 : 0 );
+}
+
+void p4dn::SessionTape::ErrorPause( __int64 now, const char *text, const ::Error *err )
+{
+	_scratch.Clear();
+	err->Marshall2( _scratch );
+	Put( now, SE_ERRORPAUSE );
+	PutString( text, (int)strlen( text ) );
+	PutString( _scratch );
+}
+
+void p4dn::SessionTape::Event( __int64 now, SessionEvent kind )
+{
+	Put( now, kind );
+}
+
+void p4dn::SessionTape::Put( __int64 now, SessionEvent kind )
+{
+	__int64 ticks = now > _start ? now - _start : 0;
+	_buf.Extend( (char)kind );
+	PutVarint( (unsigned __int64)( ticks / _frequency * 1000000 + ticks % _frequency * 1000000 / _frequency ) );
+}
+
+void p4dn::SessionTape::PutVarint( unsigned __int64 v )
+{
+	char b[10];
+	int n = 0;
+	do
+	{
+		char c = (char)( v & 0x7f );
+		v >>= 7;
+		if ( v ) c |= 0x80;
+		b[n++] = c;
+	} while ( v );
+	_buf.Extend( b, n );
+}
+
+void p4dn::SessionTape::PutString( const char *data, int length )
+{
+	PutVarint( length );
+	if ( length > 0 ) _buf.Extend( data, length );
+}
+
+p4dn::SessionReader::SessionReader( const char *data, int length, int offset )
+{
+	_data = data;
+	_p = data + offset;
+	_end = data + length;
+	_bad = offset < 0 || offset > length;
+}
+
+int p4dn::SessionReader::GetByte()
+{
+	if ( _p >= _end )
+	{
+		_bad = true;
+		return 0;
+	}
+	return (unsigned char)*_p++;
+}
+
+unsigned __int64 p4dn::SessionReader::GetVarint()
+{
+	unsigned __int64 v = 0;
+	for ( int shift = 0; shift < 64; shift += 7 )
+	{
+		int c = GetByte();
+		v |= (unsigned __int64)( c & 0x7f ) << shift;
+		if ( !( c & 0x80 ) ) return v;
+	}
+	_bad = true;
+	return 0;
+}
+
+void p4dn::SessionReader::GetString( StrRef &s )
+{
+	unsigned __int64 length = GetVarint();
+	if ( _bad || length > (unsigned __int64)( _end - _p ) )
+	{
+		_bad = true;
+		s.Set( (char *)"", 0 );
+		return;
+	}
+	s.Set( (char *)_p, (int)length );
+	_p += (int)length;
+}
+
+void p4dn::SessionReader::Skip( int kind )
+{
+	StrRef s;
+	GetVarint();
+	switch ( kind )
+	{
+	case SE_BEGIN:
+		{
+			GetVarint();
+			GetString( s );
+			int argc = (int)GetVarint();
+			for ( int i = 0; i < argc && !_bad; i++ ) GetString( s );
+		}
+		break;
+	case SE_STAT:
+		{
+			int count = (int)GetVarint();
+			for ( int i = 0; i < count * 2 && !_bad; i++ ) GetString( s );
+		}
+		break;
+	case SE_OUTPUTINFO:
+		GetByte();
+		GetString( s );
+		break;
+	case SE_PROMPT:
+		GetString( s );
+		GetVarint();
+		break;
+	case SE_ERRORPAUSE:
+		GetString( s );
+		GetString( s );
+		break;
+	case SE_MESSAGE:
+	case SE_HANDLEERROR:
+	case SE_OUTPUTERROR:
+	case SE_OUTPUTTEXT:
+	case SE_OUTPUTBINARY:
+	case SE_HELP:
+		GetString( s );
+		break;
+	case SE_END:
+	case SE_INPUTDATA:
+	case SE_FINISHED:
+		break;
+	default:
+		_bad = true;
+	}
+}
+
+#pragma managed(pop)
+
+p4dn::SessionRecorder::SessionRecorder( System::String^ path )
+{
+	_path = path;
+	_runs = 0;
+	_stream = gcnew System::IO::FileStream( path, System::IO::FileMode::Create, System::IO::FileAccess::Write, System::IO::FileShare::Read );
+
+	array<System::Byte>^ header = gcnew array<System::Byte>( sizeof(SessionMagic) );
+	for ( int i = 0; i < (int)sizeof(SessionMagic) - 1; i++ ) header[i] = SessionMagic[i];
+	header[sizeof(SessionMagic) - 1] = (System::Byte)SessionVersion;
+	_stream->Write( header, 0, header->Length );
+	_stream->Flush();
+}
+
+p4dn::SessionRecorder::~SessionRecorder()
+{
+	Close();
+}
+
+void p4dn::SessionRecorder::Close()
+{
+	System::Threading::Monitor::Enter( this );
+	try
+	{
+		if ( _stream != nullptr ) _stream->Close();
+		_stream = nullptr;
+	}
+	finally
+	{
+		System::Threading::Monitor::Exit( this );
+	}
+}
+
+void p4dn::SessionRecorder::Append( const SessionTape &tape )
+{
+	const StrBuf &data = tape.Data();
+	array<System::Byte>^ bytes = gcnew array<System::Byte>( data.Length() );
+	if ( data.Length() > 0 )
+	{
+		System::Runtime::InteropServices::Marshal::Copy( System::IntPtr( data.Text() ), bytes, 0, data.Length() );
+	}
+
+	System::Threading::Monitor::Enter( this );
+	try
+	{
+		if ( _stream == nullptr ) throw gcnew System::ObjectDisposedException( _path );
+
+		// one write per run, flushed so a crash only loses the run in progress
+		_stream->Write( bytes, 0, bytes->Length );
+		_stream->Flush();
+		_runs++;
+	}
+	finally
+	{
+		System::Threading::Monitor::Exit( this );
+	}
+}
+
+p4dn::SessionReplay::SessionReplay( System::String^ path )
+{
+	_path = path;
+	_runOffsets = gcnew System::Collections::Generic::List<int>();
+	_next = 0;
+	_codePage = 0;
+	_originalTiming = false;
+	_loop = false;
+
+	array<System::Byte>^ bytes = System::IO::File::ReadAllBytes( path );
+	int magic = (int)sizeof(SessionMagic) - 1;
+	bool ok = bytes->Length > magic;
+	for ( int i = 0; ok && i < magic; i++ ) ok = ( bytes[i] == SessionMagic[i] );
+	if ( !ok ) throw gcnew System::IO::InvalidDataException( path + " is not a session file" );
+	if ( bytes[magic] != SessionVersion )
+	{
+		throw gcnew System::IO::InvalidDataException( System::String::Format(
+			"{0} is session version {1}, expected {2}", path, bytes[magic], SessionVersion ) );
+	}
+
+	_data = new StrBuf();
+	{
+		pin_ptr<System::Byte> p = &bytes[0];
+		_data->Set( (const char *)p, bytes->Length );
+	}
+
+	// index the runs, dropping a trailing run cut off by a crash
+	SessionReader r( _data->Text(), _data->Length(), magic + 1 );
+	int runStart = -1;
+	while ( !r.AtEnd() && !r.Bad() )
+	{
+		int offset = r.Offset();
+		int kind = r.GetByte();
+		if ( kind == SE_BEGIN )
+		{
+			runStart = offset;
+			if ( _runOffsets->Count == 0 )
+			{
+				SessionReader begin( _data->Text(), _data->Length(), offset + 1 );
+				begin.GetVarint();
+				_codePage = (int)begin.GetVarint();
+			}
+		}
+		r.Skip( kind );
+		if ( kind == SE_END && !r.Bad() && runStart >= 0 )
+		{
+			_runOffsets->Add( runStart );
+			runStart = -1;
+		}
+	}
+}
+
+p4dn::SessionReplay::~SessionReplay()
+{
+	this->!SessionReplay();
+}
+
+p4dn::SessionReplay::!SessionReplay()
+{
+	if ( _data != NULL ) delete _data;
+	_data = NULL;
+}
+
+void p4dn::SessionReplay::Rewind()
+{
+	System::Threading::Monitor::Enter( this );
+	_next = 0;
+	System::Threading::Monitor::Exit( this );
+}
+
+array<System::String^>^ p4dn::SessionReplay::GetCommand( int run )
+{
+	if ( _data == NULL ) throw gcnew System::ObjectDisposedException( _path );
+	System::Text::Encoding^ encoding = ( _codePage == 65001 || _codePage == 0 )
+		? gcnew System::Text::UTF8Encoding() : System::Text::Encoding::GetEncoding( _codePage );
+
+	SessionReader r( _data->Text(), _data->Length(), _runOffsets[run] + 1 );
+	StrRef s;
+	r.GetVarint();
+	r.GetVarint();
+	r.GetString( s );
+	System::String^ func = P4String::StrPtrToString( &s, encoding );
+	int argc = (int)r.GetVarint();
+
+	array<System::String^>^ command = gcnew array<System::String^>( argc + 1 );
+	command[0] = func;
+	for ( int i = 0; i < argc; i++ )
+	{
+		r.GetString( s );
+		command[i + 1] = P4String::StrPtrToString( &s, encoding );
+	}
+	return command;
+}
+
+int p4dn::SessionReplay::NextRun()
+{
+	System::Threading::Monitor::Enter( this );
+	try
+	{
+		if ( _data == NULL ) throw gcnew System::ObjectDisposedException( _path );
+		if ( _next >= _runOffsets->Count && _loop ) _next = 0;
+		if ( _next >= _runOffsets->Count )
+		{
+			throw gcnew System::InvalidOperationException( System::String::Format(
+				"All {0} runs in {1} have been replayed", _runOffsets->Count, _path ) );
+		}
+		return _runOffsets[_next++];
+	}
+	finally
+	{
+		System::Threading::Monitor::Exit( this );
+	}
+}
+
+void p4dn::SessionReplay::Wait( Stopwatch^ clock, unsigned __int64 micros )
+{
+	__int64 due = (__int64)( micros / 1000 );
+	__int64 left = due - clock->ElapsedMilliseconds;
+	if ( left > 1 ) System::Threading::Thread::Sleep( (int)( left - 1 ) );
+	while ( (unsigned __int64)clock->Elapsed.Ticks / 10 < micros ) System::Threading::Thread::SpinWait( 20 );
+}
+
+void p4dn::SessionReplay::Play( System::String^ func, System::Text::Encoding^ encoding, ClientUserDelegate *cud, CommandCancellation *cancellation )
+{
+	int offset = NextRun();
+	SessionReader r( _data->Text(), _data->Length(), offset + 1 );
+	StrRef s, var, val;
+	StrBuf text;
+
+	r.GetVarint();
+	r.GetVarint();
+	r.GetString( s );
+	System::String^ recorded = P4String::StrPtrToString( &s, encoding );
+	if ( recorded != func )
+	{
+		throw gcnew System::InvalidOperationException( System::String::Format(
+			"Session replay expected '{0}' but the command was '{1}'", recorded, func ) );
+	}
+	int argc = (int)r.GetVarint();
+	for ( int i = 0; i < argc; i++ ) r.GetString( s );
+
+	Stopwatch^ clock = Stopwatch::StartNew();
+	bool finished = false;
+	while ( !r.Bad() )
+	{
+		int kind = r.GetByte();
+		unsigned __int64 micros = r.GetVarint();
+		if ( kind == SE_END || r.Bad() ) break;
+
+		if ( cancellation != NULL && !cancellation->Poll() ) break;
+		if ( _originalTiming ) Wait( clock, micros );
+
+		switch ( kind )
+		{
+		case SE_STAT:
+			{
+				StrBufDict dict;
+				int count = (int)r.GetVarint();
+				for ( int i = 0; i < count && !r.Bad(); i++ )
+				{
+					r.GetString( var );
+					r.GetString( val );
+					dict.SetVar( var, val );
+				}
+				cud->OutputStat( &dict );
+			}
+			break;
+		case SE_MESSAGE:
+		case SE_HANDLEERROR:
+			{
+				::Error e;
+				r.GetString( s );
+				e.UnMarshall2( s );
+				if ( kind == SE_MESSAGE ) cud->Message( &e );
+				else cud->HandleError( &e );
+			}
+			break;
+		case SE_OUTPUTERROR:
+			r.GetString( s );
+			text.Set( s );
+			cud->OutputError( text.Text() );
+			break;
+		case SE_OUTPUTINFO:
+			{
+				char level = (char)r.GetByte();
+				r.GetString( s );
+				text.Set( s );
+				cud->OutputInfo( level, text.Text() );
+			}
+			break;
+		case SE_OUTPUTTEXT:
+			r.GetString( s );
+			cud->OutputText( s.Text(), s.Length() );
+			break;
+		case SE_OUTPUTBINARY:
+			r.GetString( s );
+			cud->OutputBinary( s.Text(), s.Length() );
+			break;
+		case SE_PROMPT:
+			{
+				::Error e;
+				StrBuf rsp;
+				r.GetString( s );
+				text.Set( s );
+				int noEcho = (int)r.GetVarint();
+				cud->Prompt( text, rsp, noEcho, &e );
+			}
+			break;
+		case SE_INPUTDATA:
+			{
+				::Error e;
+				StrBuf data;
+				cud->InputData( &data, &e );
+			}
+			break;
+		case SE_ERRORPAUSE:
+			{
+				::Error e;
+				r.GetString( s );
+				text.Set( s );
+				r.GetString( s );
+				e.UnMarshall2( s );
+				cud->ErrorPause( text.Text(), &e );
+			}
+			break;
+		case SE_HELP:
+			{
+				r.GetString( s );
+				text.Set( s );
+				const char *help[2] = { text.Text(), NULL };
+				cud->Help( help );
+			}
+			break;
+		case SE_FINISHED:
+			finished = true;
+			cud->Finished();
+			break;
+		default:
+			// can't happen, unknown kinds stop the file from being indexed
+			break;
+		}
+	}
+
+	// a cancelled replay still ends the way a cancelled run does
+	if ( !finished ) cud->Finished();
+}
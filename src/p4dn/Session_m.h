@@ -0,0 +1,211 @@
+/*
+ * P4.Net *
+Copyright (c) 2007-2010 Shawn Hladky
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+and associated documentation files (the "Software"), to deal in the Software without 
+restriction, including without limitation the rights to use, copy, modify, merge, publish, 
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or 
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+ */
+
+
+#pragma once
+
+#include "StdAfx.h"
+#include "KeepAlive_m.h"
+#include <vcclr.h>
+
+class ClientUserDelegate;
+
+namespace p4dn {
+
+	//================================================================
+	// Session files hold the callbacks the p4api delivered during one or
+	// more runs, so they can be fed back through ClientUserDelegate later
+	// without a server.
+	//
+	//   file   := "P4DNSESS" version run*
+	//   run    := SE_BEGIN event* SE_END
+	//   event  := kind(byte) time payload
+	//
+	// Integers are unsigned LEB128 varints and strings are a length followed
+	// by the bytes exactly as the p4api sent them.  time is microseconds
+	// since the start of the run.  Messages are stored in the
+	// Error::Marshall2 format.
+	//
+	enum SessionEvent
+	{
+		SE_BEGIN = 1,		// codePage func argc arg*
+		SE_END,				//
+		SE_STAT,			// count (var val)*
+		SE_MESSAGE,			// error
+		SE_HANDLEERROR,		// error
+		SE_OUTPUTERROR,		// text
+		SE_OUTPUTINFO,		// level text
+		SE_OUTPUTTEXT,		// data
+		SE_OUTPUTBINARY,	// data
+		SE_PROMPT,			// msg noEcho
+		SE_INPUTDATA,		//
+		SE_ERRORPAUSE,		// text error
+		SE_HELP,			// text
+		SE_FINISHED			//
+	};
+
+	const int SessionVersion = 1;
+
+	//================================================================
+	// Encodes one run.  Everything is buffered in memory and handed to a
+	// SessionRecorder when the run ends, so a recorder can be shared by
+	// connections on different threads.  Timestamps are Stopwatch ticks.
+	//
+	class SessionTape
+	{
+	public:
+		SessionTape();
+
+		void	BeginRun( __int64 start, __int64 frequency, int codePage, const StrPtr &func, int argc, const StrPtr *argv );
+		void	EndRun( __int64 now );
+		bool	IsRecording() const { return _recording; }
+		const StrBuf& Data() const { return _buf; }
+
+		void	Stat( __int64 now, StrDict *varList );
+		void	Message( __int64 now, SessionEvent kind, const ::Error *err );
+		void	Text( __int64 now, SessionEvent kind, const char *data, int length );
+		void	Info( __int64 now, char level, const char *data );
+		void	Prompt( __int64 now, const StrPtr &msg, int noEcho );
+		void	ErrorPause( __int64 now, const char *text, const ::Error *err );
+		void	Event( __int64 now, SessionEvent kind );
+
+	private:
+		void	Put( __int64 now, SessionEvent kind );
+		void	PutVarint( unsigned __int64 v );
+		void	PutString( const char *data, int length );
+		void	PutString( const StrPtr &s ) { PutString( s.Text(), s.Length() ); }
+
+		StrBuf	_buf;
+		StrBuf	_scratch;
+		__int64	_start;
+		__int64	_frequency;
+		bool	_recording;
+	};
+
+	//================================================================
+	// Cursor over a loaded session.  Reads past the end or malformed
+	// lengths set Bad() instead of throwing, the caller checks it.
+	//
+	class SessionReader
+	{
+	public:
+		SessionReader( const char *data, int length, int offset );
+
+		int		Offset() const { return (int)( _p - _data ); }
+		bool	AtEnd() const { return _p >= _end; }
+		bool	Bad() const { return _bad; }
+
+		int		GetByte();
+		unsigned __int64 GetVarint();
+		void	GetString( StrRef &s );
+
+		// skips one event (the kind byte has already been read)
+		void	Skip( int kind );
+
+	private:
+		const char*	_data;
+		const char*	_p;
+		const char*	_end;
+		bool		_bad;
+	};
+
+	//================================================================
+	// Appends recorded runs to a session file.  Set on a ClientApi with
+	// SetSessionRecorder; thread safe.
+	//
+	public ref class SessionRecorder : public System::IDisposable
+	{
+	public:
+		SessionRecorder( System::String^ path );
+		~SessionRecorder();
+
+		property System::String^ Path { System::String^ get() { return _path; } }
+		property int Runs { int get() { return _runs; } }
+
+		void Close();
+
+	internal:
+		void Append( const SessionTape &tape );
+
+	private:
+		System::String^			_path;
+		System::IO::FileStream^	_stream;
+		int						_runs;
+	};
+
+	//================================================================
+	// Plays a session file back in place of the server.  A ClientApi with
+	// SetSessionReplay never connects; each Run takes the next recorded run
+	// (which must be for the same command) and feeds its callbacks through
+	// the same ClientUserDelegate a live run would use.
+	//
+	// Runs are handed out in order under a lock, so one replay can be
+	// shared by several connections.
+	//
+	public ref class SessionReplay : public System::IDisposable
+	{
+	public:
+		SessionReplay( System::String^ path );
+		~SessionReplay();
+		!SessionReplay();
+
+		property System::String^ Path { System::String^ get() { return _path; } }
+
+		// number of runs in the file
+		property int Runs { int get() { return _runOffsets->Count; } }
+
+		// code page of the recording connection (0 for an empty session)
+		property int CodePage { int get() { return _codePage; } }
+
+		// wait out the recorded gaps between callbacks instead of replaying flat out
+		property bool OriginalTiming
+		{
+			bool get() { return _originalTiming; }
+			void set( bool value ) { _originalTiming = value; }
+		}
+
+		// start over from the first run when the last one has been played
+		property bool Loop
+		{
+			bool get() { return _loop; }
+			void set( bool value ) { _loop = value; }
+		}
+
+		void Rewind();
+
+		// command name followed by its arguments, for a run in [0, Runs)
+		array<System::String^>^ GetCommand( int run );
+
+	internal:
+		void Play( System::String^ func, System::Text::Encoding^ encoding, ClientUserDelegate *cud, CommandCancellation *cancellation );
+
+	private:
+		int  NextRun();
+		void Wait( System::Diagnostics::Stopwatch^ clock, unsigned __int64 micros );
+
+		System::String^		_path;
+		StrBuf*				_data;
+		System::Collections::Generic::List<int>^ _runOffsets;
+		int					_next;
+		int					_codePage;
+		bool				_originalTiming;
+		bool				_loop;
+	};
+}
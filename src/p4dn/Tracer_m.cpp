@@ -0,0 +1,166 @@
+/*
+ * P4.Net *
+Copyright (c) 2007-2010 Shawn Hladky
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+and associated documentation files (the "Software"), to deal in the Software without 
+restriction, including without limitation the rights to use, copy, modify, merge, publish, 
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or 
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+ */
+
+
+#include "StdAfx.h"
+#include "Tracer_m.h"
+
+using namespace System::Threading;
+
+p4dn::TraceBuffer::TraceBuffer( int capacity, int generation )
+{
+	_events = gcnew array<TraceEvent>( capacity );
+	_head = 0;
+	_generation = generation;
+	_owner = Thread::CurrentThread;
+	_threadId = Thread::CurrentThread->ManagedThreadId;
+	_threadName = Thread::CurrentThread->Name;
+}
+
+void p4dn::TraceBuffer::Add( System::Int64 start, System::Int64 duration, TracePoint point, System::String^ detail )
+{
+	System::Int64 head = _head;
+	TraceEvent% e = _events[ (int)( head % _events->Length ) ];
+	e.Start = start;
+	e.Duration = duration;
+	e.Point = point;
+	e.Detail = detail;
+
+	// publish the event only after it has been written
+	Thread::VolatileWrite( _head, head + 1 );
+}
+
+array<p4dn::TraceEvent>^ p4dn::TraceBuffer::Snapshot()
+{
+	int capacity = _events->Length;
+	System::Int64 head = Thread::VolatileRead( _head );
+	System::Int64 first = head > capacity ? head - capacity : 0;
+
+	array<TraceEvent>^ copy = gcnew array<TraceEvent>( (int)( head - first ) );
+	for ( System::Int64 i = first; i < head; i++ )
+	{
+		copy[ (int)( i - first ) ] = _events[ (int)( i % capacity ) ];
+	}
+
+	// the writer may have lapped us while copying, drop what it overwrote,
+	// including the slot of event "now" it may be writing into right now
+	System::Int64 now = Thread::VolatileRead( _head );
+	System::Int64 valid = now + 1 > capacity ? now + 1 - capacity : 0;
+	if ( valid <= first ) return copy;
+
+	int skip = (int)System::Math::Min( valid - first, (System::Int64)copy->Length );
+	array<TraceEvent>^ ret = gcnew array<TraceEvent>( copy->Length - skip );
+	System::Array::Copy( copy, skip, ret, 0, ret->Length );
+	return ret;
+}
+
+void p4dn::Tracer::Start( int eventsPerThread )
+{
+	if ( eventsPerThread <= 0 ) throw gcnew System::ArgumentOutOfRangeException( "eventsPerThread" );
+
+	Monitor::Enter( _lock );
+	try
+	{
+		if ( _capacity != eventsPerThread )
+		{
+			// buffers are sized when they are created, start over
+			_capacity = eventsPerThread;
+			_buffers->Clear();
+			_generation++;
+		}
+		_enabled = true;
+	}
+	finally
+	{
+		Monitor::Exit( _lock );
+	}
+}
+
+void p4dn::Tracer::Stop()
+{
+	_enabled = false;
+}
+
+void p4dn::Tracer::Clear()
+{
+	Monitor::Enter( _lock );
+	try
+	{
+		_buffers->Clear();
+		_generation++;
+	}
+	finally
+	{
+		Monitor::Exit( _lock );
+	}
+}
+
+p4dn::TraceBuffer^ p4dn::Tracer::Current()
+{
+	TraceBuffer^ b = _current;
+	if ( b != nullptr && b->Generation == _generation ) return b;
+
+	Monitor::Enter( _lock );
+	try
+	{
+		// keep only the most recent buffers of threads that have exited
+		int retired = 0;
+		for ( int i = _buffers->Count - 1; i >= 0; i-- )
+		{
+			if ( _buffers[i]->OwnerAlive ) continue;
+			if ( ++retired > RetiredBuffers ) _buffers->RemoveAt( i );
+		}
+
+		b = gcnew TraceBuffer( _capacity, _generation );
+		_buffers->Add( b );
+	}
+	finally
+	{
+		Monitor::Exit( _lock );
+	}
+	_current = b;
+	return b;
+}
+
+void p4dn::Tracer::Complete( TracePoint point, System::Int64 start, System::String^ detail )
+{
+	if ( !_enabled ) return;
+	System::Int64 now = Timestamp();
+	Current()->Add( start, now - start, point, detail );
+}
+
+void p4dn::Tracer::Instant( TracePoint point, System::String^ detail )
+{
+	if ( !_enabled ) return;
+	Current()->Add( Timestamp(), -1, point, detail );
+}
+
+array<p4dn::TraceBuffer^>^ p4dn::Tracer::GetBuffers()
+{
+	Monitor::Enter( _lock );
+	try
+	{
+		return _buffers->ToArray();
+	}
+	finally
+	{
+		Monitor::Exit( _lock );
+	}
+}
@@ -0,0 +1,135 @@
+/*
+ * P4.Net *
+Copyright (c) 2007-2010 Shawn Hladky
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+and associated documentation files (the "Software"), to deal in the Software without 
+restriction, including without limitation the rights to use, copy, modify, merge, publish, 
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or 
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+ */
+
+
+#pragma once
+
+#include "StdAfx.h"
+
+namespace p4dn {
+
+	//================================================================
+	// Points in the bridge that can be traced.
+	//
+	public enum class TracePoint
+	{
+		Init,
+		Run,
+		Final,
+		InputData,
+		HandleError,
+		Message,
+		OutputError,
+		OutputInfo,
+		OutputBinary,
+		OutputText,
+		OutputStat,
+		Prompt,
+		ErrorPause,
+		Edit,
+		Resolve,
+		Help,
+		Finished,
+		Managed,
+		Connect,
+		Reconnect,
+		Disconnect
+	};
+
+	//================================================================
+	// One traced span (Duration >= 0) or instant event (Duration < 0).
+	// Times are System::Diagnostics::Stopwatch timestamps.
+	//
+	public value struct TraceEvent
+	{
+		System::Int64	Start;
+		System::Int64	Duration;
+		TracePoint		Point;
+		System::String^	Detail;
+	};
+
+	//================================================================
+	// Fixed size ring of events written by a single thread.  The owning
+	// thread never takes a lock; readers copy the ring and drop anything
+	// that was overwritten while they were copying.
+	//
+	public ref class TraceBuffer
+	{
+	public:
+		property int ThreadId				{ int get() { return _threadId; } }
+		property System::String^ ThreadName	{ System::String^ get() { return _threadName; } }
+
+		// events still in the ring, oldest first
+		array<TraceEvent>^ Snapshot();
+
+	internal:
+		TraceBuffer( int capacity, int generation );
+		void Add( System::Int64 start, System::Int64 duration, TracePoint point, System::String^ detail );
+		property int Generation				{ int get() { return _generation; } }
+		property bool OwnerAlive			{ bool get() { return _owner->IsAlive; } }
+
+	private:
+		array<TraceEvent>^	_events;
+		System::Int64		_head;
+		int					_generation;
+		System::Threading::Thread^	_owner;
+		int					_threadId;
+		System::String^		_threadName;
+	};
+
+	//================================================================
+	// Opt-in timeline tracer.  Each thread writes to its own TraceBuffer,
+	// so recording is lock free; only the first event on a thread takes
+	// a lock to register the buffer.  Registering also drops the buffers
+	// of exited threads beyond the last RetiredBuffers of them, so short
+	// lived threads don't hold on to a ring each until Clear().
+	//
+	public ref class Tracer abstract sealed
+	{
+	public:
+		static property bool Enabled	{ bool get() { return _enabled; } }
+
+		static void Start( int eventsPerThread );
+		static void Stop();
+		static void Clear();
+
+		static System::Int64 Timestamp()	{ return System::Diagnostics::Stopwatch::GetTimestamp(); }
+
+		// records a span from start to now
+		static void Complete( TracePoint point, System::Int64 start, System::String^ detail );
+		static void Instant( TracePoint point, System::String^ detail );
+
+		static array<TraceBuffer^>^ GetBuffers();
+
+	private:
+		static TraceBuffer^ Current();
+
+		literal int								RetiredBuffers = 8;
+
+		[System::ThreadStatic]
+		static TraceBuffer^						_current;
+
+		static System::Collections::Generic::List<TraceBuffer^>^ _buffers = gcnew System::Collections::Generic::List<TraceBuffer^>();
+		static System::Object^					_lock = gcnew System::Object();
+		static bool								_enabled = false;
+		static int								_capacity = 0;
+		static int								_generation = 0;
+	};
+}
@@ -0,0 +1,130 @@
+/*
+ * P4.Net *
+Copyright (c) 2007-2010 Shawn Hladky
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+and associated documentation files (the "Software"), to deal in the Software without 
+restriction, including without limitation the rights to use, copy, modify, merge, publish, 
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or 
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+ */
+
+
+#include "StdAfx.h"
+#include "ValuePool_m.h"
+#include "ByteHash.h"
+
+p4dn::ValuePool::ValuePool( System::Text::Encoding^ encoding, RunCountersState &counters )
+	: _counters( counters )
+{
+	// the table is only allocated once something is pooled
+	_table = NULL;
+	_size = 0;
+	_count = 0;
+	_encoding = encoding;
+}
+
+p4dn::ValuePool::~ValuePool()
+{
+	for (int i = 0; i < _size; i++)
+	{
+		if (_table[i].bytes != NULL) delete [] _table[i].bytes;
+	}
+	if (_table != NULL) delete [] _table;
+	_strings = nullptr;
+}
+
+void p4dn::ValuePool::AddField( const char *name, int length )
+{
+	bool isField;
+	Get( name, length, true, isField );
+}
+
+System::String^ p4dn::ValuePool::Key( const StrPtr &key, bool &poolValue )
+{
+	return Get( key.Text(), key.Length(), false, poolValue );
+}
+
+System::String^ p4dn::ValuePool::Value( const StrPtr &value, bool poolValue )
+{
+	int length = value.Length();
+	if ( length <= MaxShortValue || ( poolValue && length <= MaxFieldValue ) )
+	{
+		bool isField;
+		return Get( value.Text(), length, false, isField );
+	}
+	return gcnew System::String( value.Text(), 0, length, _encoding );
+}
+
+System::String^ p4dn::ValuePool::Get( const char *p, int length, bool field, bool &isField )
+{
+	if ( _count * 2 >= _size && _count < MaxEntries ) Grow();
+	_counters.poolLookups++;
+
+	array<System::String^>^ strings = _strings;
+	unsigned hash = HashBytes( p, length );
+	int mask = _size - 1;
+	for (int i = hash & mask; ; i = (i + 1) & mask)
+	{
+		Entry &e = _table[i];
+		if ( e.bytes == NULL )
+		{
+			System::String^ s = gcnew System::String( p, 0, length, _encoding );
+			isField = field;
+			if ( _count < MaxEntries )
+			{
+				e.hash = hash;
+				e.length = length;
+				e.bytes = new char[length + 1];
+				memcpy( e.bytes, p, length );
+				e.field = field;
+				strings[i] = s;
+				_count++;
+				_counters.poolEntries++;
+			}
+			return s;
+		}
+		if ( e.hash == hash && e.length == length && memcmp( e.bytes, p, length ) == 0 )
+		{
+			if ( field ) e.field = true;
+			isField = e.field;
+			_counters.poolHits++;
+
+			// roughly what the string we didn't allocate would have cost
+			_counters.poolBytesSaved += 20 + 2 * length;
+			return strings[i];
+		}
+	}
+}
+
+void p4dn::ValuePool::Grow()
+{
+	int size = (_size == 0) ? 256 : _size * 2;
+	Entry *table = new Entry[size];
+	memset( table, 0, sizeof(Entry) * size );
+	array<System::String^>^ strings = gcnew array<System::String^>( size );
+	array<System::String^>^ old = _strings;
+
+	for (int i = 0; i < _size; i++)
+	{
+		if ( _table[i].bytes == NULL ) continue;
+		int j = _table[i].hash & (size - 1);
+		while ( table[j].bytes != NULL ) j = (j + 1) & (size - 1);
+		table[j] = _table[i];
+		strings[j] = old[i];
+	}
+
+	if (_table != NULL) delete [] _table;
+	_table = table;
+	_size = size;
+	_strings = strings;
+}
@@ -0,0 +1,79 @@
+/*
+ * P4.Net *
+Copyright (c) 2007-2010 Shawn Hladky
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+and associated documentation files (the "Software"), to deal in the Software without 
+restriction, including without limitation the rights to use, copy, modify, merge, publish, 
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the 
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or 
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+ */
+
+
+#pragma once
+
+#include "StdAfx.h"
+#include "RunCounters_m.h"
+#include <vcclr.h>
+
+namespace p4dn {
+
+	//================================================================
+	// Per-run pool of managed strings for tagged keys and repeated
+	// values, looked up by their bytes so a repeat costs a hash and a
+	// memcmp instead of a decode and an allocation.
+	//
+	// Keys are always pooled.  Values are pooled when they belong to a
+	// field registered with AddField (up to MaxFieldValue bytes) or are
+	// at most MaxShortValue bytes long; anything else is converted as
+	// usual.  The table stops taking new entries at MaxEntries, so a
+	// run of unique values can't grow it without bound.
+	//
+	class ValuePool
+	{
+	public:
+		enum { MaxEntries = 16384, MaxFieldValue = 64, MaxShortValue = 4 };
+
+		ValuePool( System::Text::Encoding^ encoding, RunCountersState &counters );
+		~ValuePool();
+
+		// pool every value of this field, e.g. "headAction" or "user"
+		void				AddField( const char *name, int length );
+
+		// poolValue is set when values of this key's field should be pooled
+		System::String^		Key( const StrPtr &key, bool &poolValue );
+		System::String^		Value( const StrPtr &value, bool poolValue );
+
+	private:
+		struct Entry
+		{
+			unsigned	hash;
+			int			length;
+			char		*bytes;		// NULL for an empty slot
+			bool		field;
+		};
+
+		System::String^		Get( const char *p, int length, bool field, bool &isField );
+		void				Grow();
+
+		Entry						*_table;
+		int							_size;		// power of two, at most half full
+		int							_count;
+		gcroot<array<System::String^>^>	_strings;	// parallel to _table
+		gcroot<System::Text::Encoding^>	_encoding;
+		RunCountersState			&_counters;
+
+		ValuePool( const ValuePool & );
+		void operator =( const ValuePool & );
+	};
+
+} // end namespace